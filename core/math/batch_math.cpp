@@ -0,0 +1,788 @@
+/**************************************************************************/
+/*  batch_math.cpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "batch_math.h"
+
+#include "core/math/aabb.h"
+#include "core/math/transform_3d.h"
+
+#include <limits>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BATCH_MATH_SSE2_FLOAT
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define BATCH_MATH_NEON_FLOAT
+#include <arm_neon.h>
+#endif
+
+// The kernels working on Vector3, AABB and the like only have SIMD paths when real_t is float.
+#ifndef REAL_T_IS_DOUBLE
+#if defined(BATCH_MATH_SSE2_FLOAT)
+#define BATCH_MATH_SSE2
+#elif defined(BATCH_MATH_NEON_FLOAT)
+#define BATCH_MATH_NEON
+#endif
+#endif
+
+// The SIMD paths do the same operations in the same order as the scalar ones, so they give the
+// same results as long as the compiler doesn't contract the scalar code into FMA instructions.
+
+bool BatchMath::simd_enabled = true;
+
+bool BatchMath::has_simd() {
+#if defined(BATCH_MATH_SSE2_FLOAT) || defined(BATCH_MATH_NEON_FLOAT)
+	return true;
+#else
+	return false;
+#endif
+}
+
+/* FLOAT ARRAYS */
+
+#if defined(BATCH_MATH_SSE2_FLOAT)
+#define BATCH_MATH_FLOAT4
+typedef __m128 Float4;
+
+static _FORCE_INLINE_ Float4 _load4(const float *p_src) { return _mm_loadu_ps(p_src); }
+static _FORCE_INLINE_ void _store4(float *p_dst, Float4 p_value) { _mm_storeu_ps(p_dst, p_value); }
+static _FORCE_INLINE_ Float4 _splat4(float p_value) { return _mm_set1_ps(p_value); }
+static _FORCE_INLINE_ Float4 _add(Float4 p_a, Float4 p_b) { return _mm_add_ps(p_a, p_b); }
+static _FORCE_INLINE_ Float4 _sub(Float4 p_a, Float4 p_b) { return _mm_sub_ps(p_a, p_b); }
+static _FORCE_INLINE_ Float4 _mul(Float4 p_a, Float4 p_b) { return _mm_mul_ps(p_a, p_b); }
+// Both are exactly MIN() and MAX(), including which operand is returned for NaN.
+static _FORCE_INLINE_ Float4 _min(Float4 p_a, Float4 p_b) { return _mm_min_ps(p_a, p_b); }
+static _FORCE_INLINE_ Float4 _max(Float4 p_a, Float4 p_b) { return _mm_max_ps(p_a, p_b); }
+#elif defined(BATCH_MATH_NEON_FLOAT)
+#define BATCH_MATH_FLOAT4
+typedef float32x4_t Float4;
+
+static _FORCE_INLINE_ Float4 _load4(const float *p_src) { return vld1q_f32(p_src); }
+static _FORCE_INLINE_ void _store4(float *p_dst, Float4 p_value) { vst1q_f32(p_dst, p_value); }
+static _FORCE_INLINE_ Float4 _splat4(float p_value) { return vdupq_n_f32(p_value); }
+static _FORCE_INLINE_ Float4 _add(Float4 p_a, Float4 p_b) { return vaddq_f32(p_a, p_b); }
+static _FORCE_INLINE_ Float4 _sub(Float4 p_a, Float4 p_b) { return vsubq_f32(p_a, p_b); }
+static _FORCE_INLINE_ Float4 _mul(Float4 p_a, Float4 p_b) { return vmulq_f32(p_a, p_b); }
+// Not vminq_f32() and vmaxq_f32(), which propagate NaN unlike MIN() and MAX().
+static _FORCE_INLINE_ Float4 _min(Float4 p_a, Float4 p_b) { return vbslq_f32(vcltq_f32(p_a, p_b), p_a, p_b); }
+static _FORCE_INLINE_ Float4 _max(Float4 p_a, Float4 p_b) { return vbslq_f32(vcgtq_f32(p_a, p_b), p_a, p_b); }
+#endif
+
+template <typename T>
+static _FORCE_INLINE_ T _add(T p_a, T p_b) { return p_a + p_b; }
+template <typename T>
+static _FORCE_INLINE_ T _sub(T p_a, T p_b) { return p_a - p_b; }
+template <typename T>
+static _FORCE_INLINE_ T _mul(T p_a, T p_b) { return p_a * p_b; }
+template <typename T>
+static _FORCE_INLINE_ T _min(T p_a, T p_b) { return MIN(p_a, p_b); }
+template <typename T>
+static _FORCE_INLINE_ T _max(T p_a, T p_b) { return MAX(p_a, p_b); }
+
+// Operands of the kernels below, either an array or the same value for every element.
+template <typename T>
+struct _BatchArray {
+	const T *ptr;
+	_FORCE_INLINE_ T get(uint32_t p_index) const { return ptr[p_index]; }
+#ifdef BATCH_MATH_FLOAT4
+	_FORCE_INLINE_ Float4 get4(uint32_t p_index) const { return _load4(ptr + p_index); }
+#endif
+};
+
+template <typename T>
+struct _BatchValue {
+	T value;
+	_FORCE_INLINE_ T get(uint32_t p_index) const { return value; }
+#ifdef BATCH_MATH_FLOAT4
+	_FORCE_INLINE_ Float4 get4(uint32_t p_index) const { return _splat4(value); }
+#endif
+};
+
+struct _BatchAdd {
+	template <typename V>
+	static _FORCE_INLINE_ V op(V p_a, V p_b) { return _add(p_a, p_b); }
+};
+
+struct _BatchMultiply {
+	template <typename V>
+	static _FORCE_INLINE_ V op(V p_a, V p_b) { return _mul(p_a, p_b); }
+};
+
+struct _BatchMultiplyAdd {
+	template <typename V>
+	static _FORCE_INLINE_ V op(V p_a, V p_b, V p_c) { return _add(_mul(p_a, p_b), p_c); }
+};
+
+struct _BatchClamp {
+	// Same as CLAMP() as long as p_min <= p_max.
+	template <typename V>
+	static _FORCE_INLINE_ V op(V p_a, V p_min, V p_max) { return _min(p_max, _max(p_min, p_a)); }
+};
+
+struct _BatchLerp {
+	template <typename V>
+	static _FORCE_INLINE_ V op(V p_from, V p_to, V p_weight) { return _add(p_from, _mul(p_weight, _sub(p_to, p_from))); }
+};
+
+template <typename O, typename T, typename A, typename B>
+static void _batch_map(A p_a, B p_b, T *p_dst, uint32_t p_count) {
+	uint32_t i = 0;
+#ifdef BATCH_MATH_FLOAT4
+	if constexpr (std::is_same<T, float>::value) {
+		if (BatchMath::is_simd_enabled()) {
+			for (; i + 4 <= p_count; i += 4) {
+				_store4(p_dst + i, O::op(p_a.get4(i), p_b.get4(i)));
+			}
+		}
+	}
+#endif
+	for (; i < p_count; i++) {
+		p_dst[i] = O::op(p_a.get(i), p_b.get(i));
+	}
+}
+
+template <typename O, typename T, typename A, typename B, typename C>
+static void _batch_map(A p_a, B p_b, C p_c, T *p_dst, uint32_t p_count) {
+	uint32_t i = 0;
+#ifdef BATCH_MATH_FLOAT4
+	if constexpr (std::is_same<T, float>::value) {
+		if (BatchMath::is_simd_enabled()) {
+			for (; i + 4 <= p_count; i += 4) {
+				_store4(p_dst + i, O::op(p_a.get4(i), p_b.get4(i), p_c.get4(i)));
+			}
+		}
+	}
+#endif
+	for (; i < p_count; i++) {
+		p_dst[i] = O::op(p_a.get(i), p_b.get(i), p_c.get(i));
+	}
+}
+
+struct _BatchDot {
+	template <typename V>
+	static _FORCE_INLINE_ V term(V p_a, V p_b) { return _mul(p_a, p_b); }
+	template <typename V>
+	static _FORCE_INLINE_ V combine(V p_a, V p_b) { return _add(p_a, p_b); }
+};
+
+struct _BatchSum {
+	template <typename V>
+	static _FORCE_INLINE_ V term(V p_a, V p_b) { return p_a; }
+	template <typename V>
+	static _FORCE_INLINE_ V combine(V p_a, V p_b) { return _add(p_a, p_b); }
+};
+
+struct _BatchMin {
+	template <typename V>
+	static _FORCE_INLINE_ V term(V p_a, V p_b) { return p_a; }
+	template <typename V>
+	static _FORCE_INLINE_ V combine(V p_a, V p_b) { return _min(p_a, p_b); }
+};
+
+struct _BatchMax {
+	template <typename V>
+	static _FORCE_INLINE_ V term(V p_a, V p_b) { return p_a; }
+	template <typename V>
+	static _FORCE_INLINE_ V combine(V p_a, V p_b) { return _max(p_a, p_b); }
+};
+
+// Lane k accumulates the elements at k, k + 4, k + 8... up to the last multiple of 4, then the lanes
+// are combined pairwise and the remaining elements added in order. The scalar path keeps the same
+// lanes so that both give the same result.
+template <typename O, typename T, typename B>
+static T _batch_reduce(const T *p_a, B p_b, uint32_t p_count, T p_identity) {
+	if (p_count == 0) {
+		return 0;
+	}
+
+	T lanes[4] = { p_identity, p_identity, p_identity, p_identity };
+	uint32_t i = 0;
+#ifdef BATCH_MATH_FLOAT4
+	if constexpr (std::is_same<T, float>::value) {
+		if (BatchMath::is_simd_enabled()) {
+			Float4 acc = _splat4(p_identity);
+			for (; i + 4 <= p_count; i += 4) {
+				acc = O::combine(acc, O::term(_load4(p_a + i), p_b.get4(i)));
+			}
+			_store4(lanes, acc);
+		}
+	}
+#endif
+	for (; i + 4 <= p_count; i += 4) {
+		for (uint32_t k = 0; k < 4; k++) {
+			lanes[k] = O::combine(lanes[k], O::term(p_a[i + k], p_b.get(i + k)));
+		}
+	}
+
+	T result = O::combine(O::combine(lanes[0], lanes[1]), O::combine(lanes[2], lanes[3]));
+	for (; i < p_count; i++) {
+		result = O::combine(result, O::term(p_a[i], p_b.get(i)));
+	}
+	return result;
+}
+
+template <typename T>
+static void _batch_prefix_sum(const T *p_src, T *p_dst, uint32_t p_count) {
+	T total = 0;
+	for (uint32_t i = 0; i < p_count; i++) {
+		total += p_src[i];
+		p_dst[i] = total;
+	}
+}
+
+#define BATCH_MATH_FLOAT_KERNELS(m_type)                                                                                                                     \
+	void BatchMath::add(const m_type *p_a, const m_type *p_b, m_type *p_dst, uint32_t p_count) {                                                             \
+		_batch_map<_BatchAdd>(_BatchArray<m_type>{ p_a }, _BatchArray<m_type>{ p_b }, p_dst, p_count);                                                       \
+	}                                                                                                                                                        \
+	void BatchMath::add(const m_type *p_src, m_type p_value, m_type *p_dst, uint32_t p_count) {                                                              \
+		_batch_map<_BatchAdd>(_BatchArray<m_type>{ p_src }, _BatchValue<m_type>{ p_value }, p_dst, p_count);                                                 \
+	}                                                                                                                                                        \
+	void BatchMath::multiply(const m_type *p_a, const m_type *p_b, m_type *p_dst, uint32_t p_count) {                                                        \
+		_batch_map<_BatchMultiply>(_BatchArray<m_type>{ p_a }, _BatchArray<m_type>{ p_b }, p_dst, p_count);                                                  \
+	}                                                                                                                                                        \
+	void BatchMath::multiply(const m_type *p_src, m_type p_value, m_type *p_dst, uint32_t p_count) {                                                         \
+		_batch_map<_BatchMultiply>(_BatchArray<m_type>{ p_src }, _BatchValue<m_type>{ p_value }, p_dst, p_count);                                            \
+	}                                                                                                                                                        \
+	void BatchMath::multiply_add(const m_type *p_src, const m_type *p_multipliers, const m_type *p_addends, m_type *p_dst, uint32_t p_count) {               \
+		_batch_map<_BatchMultiplyAdd>(_BatchArray<m_type>{ p_src }, _BatchArray<m_type>{ p_multipliers }, _BatchArray<m_type>{ p_addends }, p_dst, p_count); \
+	}                                                                                                                                                        \
+	void BatchMath::multiply_add(const m_type *p_src, m_type p_multiplier, m_type p_addend, m_type *p_dst, uint32_t p_count) {                               \
+		_batch_map<_BatchMultiplyAdd>(_BatchArray<m_type>{ p_src }, _BatchValue<m_type>{ p_multiplier }, _BatchValue<m_type>{ p_addend }, p_dst, p_count);   \
+	}                                                                                                                                                        \
+	void BatchMath::clamp(const m_type *p_src, m_type p_min, m_type p_max, m_type *p_dst, uint32_t p_count) {                                                \
+		_batch_map<_BatchClamp>(_BatchArray<m_type>{ p_src }, _BatchValue<m_type>{ p_min }, _BatchValue<m_type>{ p_max }, p_dst, p_count);                   \
+	}                                                                                                                                                        \
+	void BatchMath::lerp(const m_type *p_from, const m_type *p_to, m_type p_weight, m_type *p_dst, uint32_t p_count) {                                       \
+		_batch_map<_BatchLerp>(_BatchArray<m_type>{ p_from }, _BatchArray<m_type>{ p_to }, _BatchValue<m_type>{ p_weight }, p_dst, p_count);                 \
+	}                                                                                                                                                        \
+	m_type BatchMath::dot(const m_type *p_a, const m_type *p_b, uint32_t p_count) {                                                                          \
+		return _batch_reduce<_BatchDot>(p_a, _BatchArray<m_type>{ p_b }, p_count, (m_type)0);                                                                \
+	}                                                                                                                                                        \
+	m_type BatchMath::sum(const m_type *p_src, uint32_t p_count) {                                                                                           \
+		return _batch_reduce<_BatchSum>(p_src, _BatchValue<m_type>{ 0 }, p_count, (m_type)0);                                                                \
+	}                                                                                                                                                        \
+	m_type BatchMath::min(const m_type *p_src, uint32_t p_count) {                                                                                           \
+		return _batch_reduce<_BatchMin>(p_src, _BatchValue<m_type>{ 0 }, p_count, std::numeric_limits<m_type>::infinity());                                  \
+	}                                                                                                                                                        \
+	m_type BatchMath::max(const m_type *p_src, uint32_t p_count) {                                                                                           \
+		return _batch_reduce<_BatchMax>(p_src, _BatchValue<m_type>{ 0 }, p_count, -std::numeric_limits<m_type>::infinity());                                 \
+	}                                                                                                                                                        \
+	void BatchMath::prefix_sum(const m_type *p_src, m_type *p_dst, uint32_t p_count) {                                                                       \
+		_batch_prefix_sum(p_src, p_dst, p_count);                                                                                                            \
+	}
+
+BATCH_MATH_FLOAT_KERNELS(float)
+BATCH_MATH_FLOAT_KERNELS(double)
+
+#undef BATCH_MATH_FLOAT_KERNELS
+
+/* XFORM */
+
+static void _xform_scalar(const Transform3D &p_transform, const Vector3 *p_src, Vector3 *p_dst, uint32_t p_from, uint32_t p_count) {
+	for (uint32_t i = p_from; i < p_count; i++) {
+		p_dst[i] = p_transform.xform(p_src[i]);
+	}
+}
+
+#ifdef BATCH_MATH_SSE2
+// Transposes 4 packed Vector3 (12 floats in 3 registers) to one register per axis, and back.
+static _FORCE_INLINE_ void _sse_deinterleave(__m128 p_a, __m128 p_b, __m128 p_c, __m128 &r_x, __m128 &r_y, __m128 &r_z) {
+	// p_a = x0 y0 z0 x1, p_b = y1 z1 x2 y2, p_c = z2 x3 y3 z3.
+	__m128 t = _mm_shuffle_ps(p_b, p_c, _MM_SHUFFLE(0, 1, 0, 2));
+	r_x = _mm_shuffle_ps(p_a, t, _MM_SHUFFLE(2, 0, 3, 0));
+	r_y = _mm_shuffle_ps(_mm_shuffle_ps(p_a, p_b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(p_b, p_c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+	r_z = _mm_shuffle_ps(_mm_shuffle_ps(p_a, p_b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(p_c, p_c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+static _FORCE_INLINE_ void _sse_interleave(__m128 p_x, __m128 p_y, __m128 p_z, __m128 &r_a, __m128 &r_b, __m128 &r_c) {
+	r_a = _mm_shuffle_ps(_mm_unpacklo_ps(p_x, p_y), _mm_shuffle_ps(p_z, p_x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 1, 0));
+	r_b = _mm_shuffle_ps(_mm_shuffle_ps(p_y, p_z, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(p_x, p_y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+	r_c = _mm_shuffle_ps(_mm_shuffle_ps(p_z, p_x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(p_y, p_z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+}
+#endif
+
+void BatchMath::xform(const Transform3D &p_transform, const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count) {
+	uint32_t i = 0;
+
+#if defined(BATCH_MATH_SSE2)
+	if (simd_enabled) {
+		const Basis &b = p_transform.basis;
+		const __m128 r00 = _mm_set1_ps(b.rows[0][0]), r01 = _mm_set1_ps(b.rows[0][1]), r02 = _mm_set1_ps(b.rows[0][2]);
+		const __m128 r10 = _mm_set1_ps(b.rows[1][0]), r11 = _mm_set1_ps(b.rows[1][1]), r12 = _mm_set1_ps(b.rows[1][2]);
+		const __m128 r20 = _mm_set1_ps(b.rows[2][0]), r21 = _mm_set1_ps(b.rows[2][1]), r22 = _mm_set1_ps(b.rows[2][2]);
+		const __m128 ox = _mm_set1_ps(p_transform.origin.x), oy = _mm_set1_ps(p_transform.origin.y), oz = _mm_set1_ps(p_transform.origin.z);
+
+		const float *src = (const float *)p_src;
+		float *dst = (float *)p_dst;
+		for (; i + 4 <= p_count; i += 4) {
+			__m128 x, y, z;
+			_sse_deinterleave(_mm_loadu_ps(src + i * 3), _mm_loadu_ps(src + i * 3 + 4), _mm_loadu_ps(src + i * 3 + 8), x, y, z);
+
+			__m128 tx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(r00, x), _mm_mul_ps(r01, y)), _mm_mul_ps(r02, z)), ox);
+			__m128 ty = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(r10, x), _mm_mul_ps(r11, y)), _mm_mul_ps(r12, z)), oy);
+			__m128 tz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(r20, x), _mm_mul_ps(r21, y)), _mm_mul_ps(r22, z)), oz);
+
+			__m128 a, bb, c;
+			_sse_interleave(tx, ty, tz, a, bb, c);
+			_mm_storeu_ps(dst + i * 3, a);
+			_mm_storeu_ps(dst + i * 3 + 4, bb);
+			_mm_storeu_ps(dst + i * 3 + 8, c);
+		}
+	}
+#elif defined(BATCH_MATH_NEON)
+	if (simd_enabled) {
+		const Basis &b = p_transform.basis;
+		const float32x4_t r00 = vdupq_n_f32(b.rows[0][0]), r01 = vdupq_n_f32(b.rows[0][1]), r02 = vdupq_n_f32(b.rows[0][2]);
+		const float32x4_t r10 = vdupq_n_f32(b.rows[1][0]), r11 = vdupq_n_f32(b.rows[1][1]), r12 = vdupq_n_f32(b.rows[1][2]);
+		const float32x4_t r20 = vdupq_n_f32(b.rows[2][0]), r21 = vdupq_n_f32(b.rows[2][1]), r22 = vdupq_n_f32(b.rows[2][2]);
+		const float32x4_t ox = vdupq_n_f32(p_transform.origin.x), oy = vdupq_n_f32(p_transform.origin.y), oz = vdupq_n_f32(p_transform.origin.z);
+
+		const float *src = (const float *)p_src;
+		float *dst = (float *)p_dst;
+		for (; i + 4 <= p_count; i += 4) {
+			float32x4x3_t v = vld3q_f32(src + i * 3);
+
+			float32x4x3_t t;
+			t.val[0] = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_f32(r00, v.val[0]), vmulq_f32(r01, v.val[1])), vmulq_f32(r02, v.val[2])), ox);
+			t.val[1] = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_f32(r10, v.val[0]), vmulq_f32(r11, v.val[1])), vmulq_f32(r12, v.val[2])), oy);
+			t.val[2] = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_f32(r20, v.val[0]), vmulq_f32(r21, v.val[1])), vmulq_f32(r22, v.val[2])), oz);
+
+			vst3q_f32(dst + i * 3, t);
+		}
+	}
+#endif
+
+	_xform_scalar(p_transform, p_src, p_dst, i, p_count);
+}
+
+/* VECTOR3 LENGTHS */
+
+// NEON only has square roots and divisions on AArch64.
+#if defined(BATCH_MATH_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#define BATCH_MATH_NEON_SQRT
+#endif
+
+void BatchMath::length(const Vector3 *p_src, float *r_lengths, uint32_t p_count) {
+	uint32_t i = 0;
+
+#if defined(BATCH_MATH_SSE2)
+	if (simd_enabled) {
+		const float *src = (const float *)p_src;
+		for (; i + 4 <= p_count; i += 4) {
+			__m128 x, y, z;
+			_sse_deinterleave(_mm_loadu_ps(src + i * 3), _mm_loadu_ps(src + i * 3 + 4), _mm_loadu_ps(src + i * 3 + 8), x, y, z);
+			__m128 length_sq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+			_mm_storeu_ps(r_lengths + i, _mm_sqrt_ps(length_sq));
+		}
+	}
+#elif defined(BATCH_MATH_NEON_SQRT)
+	if (simd_enabled) {
+		const float *src = (const float *)p_src;
+		for (; i + 4 <= p_count; i += 4) {
+			float32x4x3_t v = vld3q_f32(src + i * 3);
+			float32x4_t length_sq = vaddq_f32(vaddq_f32(vmulq_f32(v.val[0], v.val[0]), vmulq_f32(v.val[1], v.val[1])), vmulq_f32(v.val[2], v.val[2]));
+			vst1q_f32(r_lengths + i, vsqrtq_f32(length_sq));
+		}
+	}
+#endif
+
+	for (; i < p_count; i++) {
+		r_lengths[i] = p_src[i].length();
+	}
+}
+
+void BatchMath::normalize(const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count) {
+	uint32_t i = 0;
+
+#if defined(BATCH_MATH_SSE2)
+	if (simd_enabled) {
+		const __m128 zero = _mm_setzero_ps();
+		const float *src = (const float *)p_src;
+		float *dst = (float *)p_dst;
+		for (; i + 4 <= p_count; i += 4) {
+			__m128 x, y, z;
+			_sse_deinterleave(_mm_loadu_ps(src + i * 3), _mm_loadu_ps(src + i * 3 + 4), _mm_loadu_ps(src + i * 3 + 8), x, y, z);
+			__m128 length_sq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+			// Zero length vectors become zero rather than NaN.
+			__m128 is_zero = _mm_cmpeq_ps(length_sq, zero);
+			__m128 length = _mm_sqrt_ps(length_sq);
+			x = _mm_andnot_ps(is_zero, _mm_div_ps(x, length));
+			y = _mm_andnot_ps(is_zero, _mm_div_ps(y, length));
+			z = _mm_andnot_ps(is_zero, _mm_div_ps(z, length));
+
+			__m128 a, b, c;
+			_sse_interleave(x, y, z, a, b, c);
+			_mm_storeu_ps(dst + i * 3, a);
+			_mm_storeu_ps(dst + i * 3 + 4, b);
+			_mm_storeu_ps(dst + i * 3 + 8, c);
+		}
+	}
+#elif defined(BATCH_MATH_NEON_SQRT)
+	if (simd_enabled) {
+		const float32x4_t zero = vdupq_n_f32(0);
+		const float *src = (const float *)p_src;
+		float *dst = (float *)p_dst;
+		for (; i + 4 <= p_count; i += 4) {
+			float32x4x3_t v = vld3q_f32(src + i * 3);
+			float32x4_t length_sq = vaddq_f32(vaddq_f32(vmulq_f32(v.val[0], v.val[0]), vmulq_f32(v.val[1], v.val[1])), vmulq_f32(v.val[2], v.val[2]));
+			uint32x4_t is_zero = vceqq_f32(length_sq, zero);
+			float32x4_t length = vsqrtq_f32(length_sq);
+			for (int j = 0; j < 3; j++) {
+				v.val[j] = vbslq_f32(is_zero, zero, vdivq_f32(v.val[j], length));
+			}
+			vst3q_f32(dst + i * 3, v);
+		}
+	}
+#endif
+
+	for (; i < p_count; i++) {
+		p_dst[i] = p_src[i].normalized();
+	}
+}
+
+/* XFORM AND MERGE AABBS */
+
+static AABB _xform_merge_scalar(const Transform3D *p_transforms, const AABB *p_aabbs, AABB *r_aabbs, uint32_t p_count) {
+	AABB merged;
+	for (uint32_t i = 0; i < p_count; i++) {
+		AABB aabb = p_transforms[i].xform(p_aabbs[i]);
+		if (r_aabbs) {
+			r_aabbs[i] = aabb;
+		}
+		if (i == 0) {
+			merged = aabb;
+		} else {
+			merged.merge_with(aabb);
+		}
+	}
+	return merged;
+}
+
+AABB BatchMath::xform_merge(const Transform3D *p_transforms, const AABB *p_aabbs, AABB *r_aabbs, uint32_t p_count) {
+	if (p_count == 0) {
+		return AABB();
+	}
+
+#if defined(BATCH_MATH_SSE2)
+	if (simd_enabled) {
+		// One AABB at a time, with the lanes holding the x, y and z axes (the last one is unused).
+		// Loads and stores never touch memory outside of the arrays.
+		__m128 merged_pos = _mm_setzero_ps();
+		__m128 merged_size = _mm_setzero_ps();
+
+		for (uint32_t i = 0; i < p_count; i++) {
+			const float *t = &p_transforms[i].basis.rows[0].x;
+			__m128 col0, col1, col2;
+			_sse_deinterleave(_mm_loadu_ps(t), _mm_loadu_ps(t + 4), _mm_loadu_ps(t + 8), col0, col1, col2);
+			__m128 origin = _mm_loadu_ps(t + 8);
+			origin = _mm_shuffle_ps(origin, origin, _MM_SHUFFLE(3, 3, 2, 1));
+
+			const float *a = &p_aabbs[i].position.x;
+			__m128 min = _mm_loadu_ps(a);
+			__m128 size = _mm_loadu_ps(a + 2);
+			size = _mm_shuffle_ps(size, size, _MM_SHUFFLE(3, 3, 2, 1));
+			__m128 max = _mm_add_ps(min, size);
+
+			__m128 tmin = origin;
+			__m128 tmax = origin;
+
+#define XFORM_AABB_AXIS(m_col, m_axis)                                                             \
+	{                                                                                              \
+		__m128 e = _mm_mul_ps(m_col, _mm_shuffle_ps(min, min, _MM_SHUFFLE(m_axis, m_axis, m_axis, m_axis))); \
+		__m128 f = _mm_mul_ps(m_col, _mm_shuffle_ps(max, max, _MM_SHUFFLE(m_axis, m_axis, m_axis, m_axis))); \
+		tmin = _mm_add_ps(tmin, _mm_min_ps(e, f));                                                 \
+		tmax = _mm_add_ps(tmax, _mm_max_ps(f, e));                                                 \
+	}
+			XFORM_AABB_AXIS(col0, 0)
+			XFORM_AABB_AXIS(col1, 1)
+			XFORM_AABB_AXIS(col2, 2)
+#undef XFORM_AABB_AXIS
+
+			__m128 tsize = _mm_sub_ps(tmax, tmin);
+
+			if (r_aabbs) {
+				float *r = &r_aabbs[i].position.x;
+				// Position first (spilling into size.x), then position.z and the size.
+				_mm_storeu_ps(r, tmin);
+				__m128 u = _mm_shuffle_ps(tmin, tsize, _MM_SHUFFLE(0, 0, 2, 2));
+				_mm_storeu_ps(r + 2, _mm_shuffle_ps(u, tsize, _MM_SHUFFLE(2, 1, 2, 0)));
+			}
+
+			// Same as AABB::merge_with().
+			if (i == 0) {
+				merged_pos = tmin;
+				merged_size = tsize;
+			} else {
+				__m128 end_1 = _mm_add_ps(merged_size, merged_pos);
+				__m128 end_2 = _mm_add_ps(tsize, tmin);
+				merged_pos = _mm_min_ps(merged_pos, tmin);
+				merged_size = _mm_sub_ps(_mm_max_ps(end_1, end_2), merged_pos);
+			}
+		}
+
+		float pos[4], size[4];
+		_mm_storeu_ps(pos, merged_pos);
+		_mm_storeu_ps(size, merged_size);
+		return AABB(Vector3(pos[0], pos[1], pos[2]), Vector3(size[0], size[1], size[2]));
+	}
+#elif defined(BATCH_MATH_NEON)
+	if (simd_enabled) {
+		float32x4_t merged_pos = vdupq_n_f32(0);
+		float32x4_t merged_size = vdupq_n_f32(0);
+
+		for (uint32_t i = 0; i < p_count; i++) {
+			const float *t = &p_transforms[i].basis.rows[0].x;
+			// Rows and origin, read as 4 packed Vector3, give the columns with the origin in the last lane.
+			float32x4x3_t cols = vld3q_f32(t);
+			float32x4_t origin = vextq_f32(vld1q_f32(t + 8), vld1q_f32(t + 8), 1);
+
+			const float *a = &p_aabbs[i].position.x;
+			float32x4_t min = vld1q_f32(a);
+			float32x4_t size = vld1q_f32(a + 2);
+			size = vextq_f32(size, size, 1);
+			float32x4_t max = vaddq_f32(min, size);
+
+			float max_axes[4];
+			vst1q_f32(max_axes, max);
+
+			float32x4_t tmin = origin;
+			float32x4_t tmax = origin;
+			for (int j = 0; j < 3; j++) {
+				float32x4_t e = vmulq_f32(cols.val[j], vdupq_n_f32(a[j]));
+				float32x4_t f = vmulq_f32(cols.val[j], vdupq_n_f32(max_axes[j]));
+				uint32x4_t e_less = vcltq_f32(e, f);
+				tmin = vaddq_f32(tmin, vbslq_f32(e_less, e, f));
+				tmax = vaddq_f32(tmax, vbslq_f32(e_less, f, e));
+			}
+
+			float32x4_t tsize = vsubq_f32(tmax, tmin);
+
+			if (r_aabbs) {
+				float *r = &r_aabbs[i].position.x;
+				vst1q_f32(r, tmin);
+				// position.z followed by the size.
+				vst1q_f32(r + 2, vextq_f32(vdupq_n_f32(vgetq_lane_f32(tmin, 2)), tsize, 3));
+			}
+
+			if (i == 0) {
+				merged_pos = tmin;
+				merged_size = tsize;
+			} else {
+				float32x4_t end_1 = vaddq_f32(merged_size, merged_pos);
+				float32x4_t end_2 = vaddq_f32(tsize, tmin);
+				merged_pos = vbslq_f32(vcltq_f32(merged_pos, tmin), merged_pos, tmin);
+				merged_size = vsubq_f32(vbslq_f32(vcgtq_f32(end_1, end_2), end_1, end_2), merged_pos);
+			}
+		}
+
+		return AABB(Vector3(vgetq_lane_f32(merged_pos, 0), vgetq_lane_f32(merged_pos, 1), vgetq_lane_f32(merged_pos, 2)),
+				Vector3(vgetq_lane_f32(merged_size, 0), vgetq_lane_f32(merged_size, 1), vgetq_lane_f32(merged_size, 2)));
+	}
+#endif
+
+	return _xform_merge_scalar(p_transforms, p_aabbs, r_aabbs, p_count);
+}
+
+/* CULL */
+
+static uint32_t _cull_scalar(const Plane *p_planes, int p_plane_count, const AABB *p_aabbs, uint32_t p_count, uint32_t *r_indices) {
+	uint32_t count = 0;
+	for (uint32_t i = 0; i < p_count; i++) {
+		const AABB &aabb = p_aabbs[i];
+		Vector3 half_extents = aabb.size * 0.5f;
+		Vector3 ofs = aabb.position + half_extents;
+
+		bool over = false;
+		for (int j = 0; j < p_plane_count; j++) {
+			const Plane &p = p_planes[j];
+			Vector3 point(
+					(p.normal.x > 0) ? -half_extents.x : half_extents.x,
+					(p.normal.y > 0) ? -half_extents.y : half_extents.y,
+					(p.normal.z > 0) ? -half_extents.z : half_extents.z);
+			point += ofs;
+			if (p.is_point_over(point)) {
+				over = true;
+				break;
+			}
+		}
+
+		if (!over) {
+			r_indices[count++] = i;
+		}
+	}
+	return count;
+}
+
+uint32_t BatchMath::cull(const Plane *p_planes, int p_plane_count, const AABB *p_aabbs, uint32_t p_count, uint32_t *r_indices) {
+	// Planes are tested 4 at a time, with enough groups for the usual frustums (6 planes) and a bit more.
+	const int MAX_PLANE_GROUPS = 4;
+	const int group_count = (p_plane_count + 3) / 4;
+
+#if defined(BATCH_MATH_SSE2)
+	if (simd_enabled && group_count <= MAX_PLANE_GROUPS) {
+		struct PlaneGroup {
+			__m128 nx, ny, nz, d;
+			__m128 sx, sy, sz; // Sign to apply to the half extents.
+		};
+		PlaneGroup groups[MAX_PLANE_GROUPS];
+
+		for (int g = 0; g < group_count; g++) {
+			alignas(16) float data[7][4];
+			for (int k = 0; k < 4; k++) {
+				int j = g * 4 + k;
+				if (j < p_plane_count) {
+					const Plane &p = p_planes[j];
+					data[0][k] = p.normal.x;
+					data[1][k] = p.normal.y;
+					data[2][k] = p.normal.z;
+					data[3][k] = p.d;
+					data[4][k] = (p.normal.x > 0) ? -0.0f : 0.0f;
+					data[5][k] = (p.normal.y > 0) ? -0.0f : 0.0f;
+					data[6][k] = (p.normal.z > 0) ? -0.0f : 0.0f;
+				} else {
+					// Padding, nothing is ever over it.
+					data[0][k] = data[1][k] = data[2][k] = 0.0f;
+					data[3][k] = FLT_MAX;
+					data[4][k] = data[5][k] = data[6][k] = 0.0f;
+				}
+			}
+			groups[g].nx = _mm_load_ps(data[0]);
+			groups[g].ny = _mm_load_ps(data[1]);
+			groups[g].nz = _mm_load_ps(data[2]);
+			groups[g].d = _mm_load_ps(data[3]);
+			groups[g].sx = _mm_load_ps(data[4]);
+			groups[g].sy = _mm_load_ps(data[5]);
+			groups[g].sz = _mm_load_ps(data[6]);
+		}
+
+		const __m128 half = _mm_set1_ps(0.5f);
+		uint32_t count = 0;
+		for (uint32_t i = 0; i < p_count; i++) {
+			const float *a = &p_aabbs[i].position.x;
+			__m128 position = _mm_loadu_ps(a);
+			__m128 size = _mm_loadu_ps(a + 2);
+			size = _mm_shuffle_ps(size, size, _MM_SHUFFLE(3, 3, 2, 1));
+			__m128 half_extents = _mm_mul_ps(size, half);
+			__m128 ofs = _mm_add_ps(position, half_extents);
+
+			__m128 hx = _mm_shuffle_ps(half_extents, half_extents, _MM_SHUFFLE(0, 0, 0, 0));
+			__m128 hy = _mm_shuffle_ps(half_extents, half_extents, _MM_SHUFFLE(1, 1, 1, 1));
+			__m128 hz = _mm_shuffle_ps(half_extents, half_extents, _MM_SHUFFLE(2, 2, 2, 2));
+			__m128 ox = _mm_shuffle_ps(ofs, ofs, _MM_SHUFFLE(0, 0, 0, 0));
+			__m128 oy = _mm_shuffle_ps(ofs, ofs, _MM_SHUFFLE(1, 1, 1, 1));
+			__m128 oz = _mm_shuffle_ps(ofs, ofs, _MM_SHUFFLE(2, 2, 2, 2));
+
+			__m128 over = _mm_setzero_ps();
+			for (int g = 0; g < group_count; g++) {
+				const PlaneGroup &pg = groups[g];
+				__m128 px = _mm_add_ps(_mm_xor_ps(hx, pg.sx), ox);
+				__m128 py = _mm_add_ps(_mm_xor_ps(hy, pg.sy), oy);
+				__m128 pz = _mm_add_ps(_mm_xor_ps(hz, pg.sz), oz);
+				__m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(pg.nx, px), _mm_mul_ps(pg.ny, py)), _mm_mul_ps(pg.nz, pz));
+				over = _mm_or_ps(over, _mm_cmpgt_ps(dot, pg.d));
+			}
+
+			r_indices[count] = i;
+			count += _mm_movemask_ps(over) == 0;
+		}
+		return count;
+	}
+#elif defined(BATCH_MATH_NEON)
+	if (simd_enabled && group_count <= MAX_PLANE_GROUPS) {
+		struct PlaneGroup {
+			float32x4_t nx, ny, nz, d;
+			uint32x4_t sx, sy, sz; // Sign to apply to the half extents.
+		};
+		PlaneGroup groups[MAX_PLANE_GROUPS];
+
+		for (int g = 0; g < group_count; g++) {
+			float data[4][4];
+			uint32_t signs[3][4];
+			for (int k = 0; k < 4; k++) {
+				int j = g * 4 + k;
+				if (j < p_plane_count) {
+					const Plane &p = p_planes[j];
+					data[0][k] = p.normal.x;
+					data[1][k] = p.normal.y;
+					data[2][k] = p.normal.z;
+					data[3][k] = p.d;
+					signs[0][k] = (p.normal.x > 0) ? 0x80000000 : 0;
+					signs[1][k] = (p.normal.y > 0) ? 0x80000000 : 0;
+					signs[2][k] = (p.normal.z > 0) ? 0x80000000 : 0;
+				} else {
+					data[0][k] = data[1][k] = data[2][k] = 0.0f;
+					data[3][k] = FLT_MAX;
+					signs[0][k] = signs[1][k] = signs[2][k] = 0;
+				}
+			}
+			groups[g].nx = vld1q_f32(data[0]);
+			groups[g].ny = vld1q_f32(data[1]);
+			groups[g].nz = vld1q_f32(data[2]);
+			groups[g].d = vld1q_f32(data[3]);
+			groups[g].sx = vld1q_u32(signs[0]);
+			groups[g].sy = vld1q_u32(signs[1]);
+			groups[g].sz = vld1q_u32(signs[2]);
+		}
+
+		uint32_t count = 0;
+		for (uint32_t i = 0; i < p_count; i++) {
+			const AABB &aabb = p_aabbs[i];
+			Vector3 half_extents = aabb.size * 0.5f;
+			Vector3 ofs = aabb.position + half_extents;
+
+			uint32x4_t hx = vreinterpretq_u32_f32(vdupq_n_f32(half_extents.x));
+			uint32x4_t hy = vreinterpretq_u32_f32(vdupq_n_f32(half_extents.y));
+			uint32x4_t hz = vreinterpretq_u32_f32(vdupq_n_f32(half_extents.z));
+			float32x4_t ox = vdupq_n_f32(ofs.x);
+			float32x4_t oy = vdupq_n_f32(ofs.y);
+			float32x4_t oz = vdupq_n_f32(ofs.z);
+
+			uint32x4_t over = vdupq_n_u32(0);
+			for (int g = 0; g < group_count; g++) {
+				const PlaneGroup &pg = groups[g];
+				float32x4_t px = vaddq_f32(vreinterpretq_f32_u32(veorq_u32(hx, pg.sx)), ox);
+				float32x4_t py = vaddq_f32(vreinterpretq_f32_u32(veorq_u32(hy, pg.sy)), oy);
+				float32x4_t pz = vaddq_f32(vreinterpretq_f32_u32(veorq_u32(hz, pg.sz)), oz);
+				float32x4_t dot = vaddq_f32(vaddq_f32(vmulq_f32(pg.nx, px), vmulq_f32(pg.ny, py)), vmulq_f32(pg.nz, pz));
+				over = vorrq_u32(over, vcgtq_f32(dot, pg.d));
+			}
+
+			uint32x2_t folded = vorr_u32(vget_low_u32(over), vget_high_u32(over));
+			r_indices[count] = i;
+			count += (vget_lane_u32(folded, 0) | vget_lane_u32(folded, 1)) == 0;
+		}
+		return count;
+	}
+#endif
+
+	return _cull_scalar(p_planes, p_plane_count, p_aabbs, p_count, r_indices);
+}
@@ -0,0 +1,110 @@
+/**************************************************************************/
+/*  batch_math.h                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef BATCH_MATH_H
+#define BATCH_MATH_H
+
+#include "core/math/math_defs.h"
+#include "core/typedefs.h"
+
+struct AABB;
+struct Plane;
+struct Transform3D;
+struct Vector3;
+
+// Kernels working on whole arrays at once, using SSE2 or NEON when available (single precision only)
+// and a scalar fallback otherwise. Results are the same as applying the scalar functions they
+// mirror (Transform3D::xform, AABB::merge_with, AABB::intersects_convex_shape) to each element.
+class BatchMath {
+	static bool simd_enabled;
+
+public:
+	// Element-wise operations, where p_dst may be the same array as any of the sources. The
+	// double precision versions always take the scalar path.
+	static void add(const float *p_a, const float *p_b, float *p_dst, uint32_t p_count);
+	static void add(const double *p_a, const double *p_b, double *p_dst, uint32_t p_count);
+	static void add(const float *p_src, float p_value, float *p_dst, uint32_t p_count);
+	static void add(const double *p_src, double p_value, double *p_dst, uint32_t p_count);
+	static void multiply(const float *p_a, const float *p_b, float *p_dst, uint32_t p_count);
+	static void multiply(const double *p_a, const double *p_b, double *p_dst, uint32_t p_count);
+	static void multiply(const float *p_src, float p_value, float *p_dst, uint32_t p_count);
+	static void multiply(const double *p_src, double p_value, double *p_dst, uint32_t p_count);
+	// p_src * p_multiplier + p_addend, rounded after each operation (not a fused multiply-add).
+	static void multiply_add(const float *p_src, const float *p_multipliers, const float *p_addends, float *p_dst, uint32_t p_count);
+	static void multiply_add(const double *p_src, const double *p_multipliers, const double *p_addends, double *p_dst, uint32_t p_count);
+	static void multiply_add(const float *p_src, float p_multiplier, float p_addend, float *p_dst, uint32_t p_count);
+	static void multiply_add(const double *p_src, double p_multiplier, double p_addend, double *p_dst, uint32_t p_count);
+	// Same as CLAMP() and Math::lerp().
+	static void clamp(const float *p_src, float p_min, float p_max, float *p_dst, uint32_t p_count);
+	static void clamp(const double *p_src, double p_min, double p_max, double *p_dst, uint32_t p_count);
+	static void lerp(const float *p_from, const float *p_to, float p_weight, float *p_dst, uint32_t p_count);
+	static void lerp(const double *p_from, const double *p_to, double p_weight, double *p_dst, uint32_t p_count);
+
+	// Reductions. Sums are accumulated in 4 interleaved lanes on both paths, so they don't depend on
+	// whether SIMD is used, but can differ slightly from a plain loop. MIN() and MAX() are used for
+	// comparisons. Empty arrays give 0.
+	static float dot(const float *p_a, const float *p_b, uint32_t p_count);
+	static double dot(const double *p_a, const double *p_b, uint32_t p_count);
+	static float sum(const float *p_src, uint32_t p_count);
+	static double sum(const double *p_src, uint32_t p_count);
+	static float min(const float *p_src, uint32_t p_count);
+	static double min(const double *p_src, uint32_t p_count);
+	static float max(const float *p_src, uint32_t p_count);
+	static double max(const double *p_src, uint32_t p_count);
+
+	// Running total, in order (each element depends on the previous one, so this one is scalar).
+	static void prefix_sum(const float *p_src, float *p_dst, uint32_t p_count);
+	static void prefix_sum(const double *p_src, double *p_dst, uint32_t p_count);
+
+	// Same as Vector3::length() and Vector3::normalize() on each vector. Lengths are
+	// rounded to float in double precision builds.
+	static void length(const Vector3 *p_src, float *r_lengths, uint32_t p_count);
+	static void normalize(const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count);
+
+	// Same as p_transform.xform() on each point. p_src and p_dst may be the same array.
+	static void xform(const Transform3D &p_transform, const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count);
+
+	// Transforms each AABB by the transform at the same index, storing the results in r_aabbs (if not
+	// null, may be the same as p_aabbs), and returns all of them merged.
+	static AABB xform_merge(const Transform3D *p_transforms, const AABB *p_aabbs, AABB *r_aabbs, uint32_t p_count);
+
+	// Writes to r_indices the indices of the AABBs that are not fully over any of the planes (like the
+	// plane test of AABB::intersects_convex_shape), returning how many were written. r_indices must
+	// have room for p_count elements.
+	static uint32_t cull(const Plane *p_planes, int p_plane_count, const AABB *p_aabbs, uint32_t p_count, uint32_t *r_indices);
+
+	static bool has_simd();
+	// Allows comparing against the scalar path, in tests and benchmarks.
+	static void set_simd_enabled(bool p_enabled) { simd_enabled = p_enabled; }
+	static bool is_simd_enabled() { return simd_enabled && has_simd(); }
+};
+
+#endif // BATCH_MATH_H
@@ -60,6 +60,8 @@
 
 template <typename T, int NUM_TREES = 1, bool USE_PAIRS = false, int MAX_ITEMS = 32, typename USER_PAIR_TEST_FUNCTION = BVH_DummyPairTestFunction<T>, typename USER_CULL_TEST_FUNCTION = BVH_DummyCullTestFunction<T>, typename BOUNDS = AABB, typename POINT = Vector3, bool BVH_THREAD_SAFE = true>
 class BVH_Manager {
+	friend class TestBVHInternalsAccessor;
+
 public:
 	// note we are using uint32_t instead of BVHHandle, losing type safety, but this
 	// is for compatibility with octree
@@ -399,6 +401,33 @@ public:
 		return params.result_count_overall;
 	}
 
+	// Packet versions of cull_segment() and cull_aabb(), which cull up to BVH_Packet::SIZE segments or
+	// AABBs in a single traversal. Results for query n are written from p_result_array + n * p_result_max
+	// (the same for p_subindex_array), and their count to r_result_counts[n].
+	void cull_segment_packet(const POINT *p_from, const POINT *p_to, int p_count, T **p_result_array, int p_result_max, int *r_result_counts, const T *p_tester, uint32_t p_tree_collision_mask = 0xFFFFFFFF, int *p_subindex_array = nullptr) {
+		BVH_LOCKED_FUNCTION
+		BVH_ASSERT((p_count <= BVH_Packet<BOUNDS, POINT>::SIZE));
+		typename BVHTREE_CLASS::CullPacketParams params;
+
+		for (int n = 0; n < p_count; n++) {
+			params.packet.set_segment(n, p_from[n], p_to[n]);
+		}
+
+		_cull_packet(params, p_count, p_result_array, p_result_max, r_result_counts, p_tester, p_tree_collision_mask, p_subindex_array);
+	}
+
+	void cull_aabb_packet(const BOUNDS *p_aabbs, int p_count, T **p_result_array, int p_result_max, int *r_result_counts, const T *p_tester, uint32_t p_tree_collision_mask = 0xFFFFFFFF, int *p_subindex_array = nullptr) {
+		BVH_LOCKED_FUNCTION
+		BVH_ASSERT((p_count <= BVH_Packet<BOUNDS, POINT>::SIZE));
+		typename BVHTREE_CLASS::CullPacketParams params;
+
+		for (int n = 0; n < p_count; n++) {
+			params.packet.set_aabb(n, p_aabbs[n]);
+		}
+
+		_cull_packet(params, p_count, p_result_array, p_result_max, r_result_counts, p_tester, p_tree_collision_mask, p_subindex_array);
+	}
+
 	int cull_convex(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, const T *p_tester, uint32_t p_tree_collision_mask = 0xFFFFFFFF) {
 		BVH_LOCKED_FUNCTION
 		if (!p_convex.size()) {
@@ -774,6 +803,20 @@ private:
 	LocalVector<BVHHandle, uint32_t, true> changed_items;
 	uint32_t _tick = 1; // Start from 1 so items with 0 indicate never updated.
 
+	void _cull_packet(typename BVHTREE_CLASS::CullPacketParams &r_params, int p_count, T **p_result_array, int p_result_max, int *r_result_counts, const T *p_tester, uint32_t p_tree_collision_mask, int *p_subindex_array) {
+		r_params.result_max = p_result_max;
+		r_params.result_array = p_result_array;
+		r_params.subindex_array = p_subindex_array;
+		r_params.tester = p_tester;
+		r_params.tree_collision_mask = p_tree_collision_mask;
+
+		tree.cull_packet(r_params);
+
+		for (int n = 0; n < p_count; n++) {
+			r_result_counts[n] = r_params.result_counts[n];
+		}
+	}
+
 	class BVHLockedFunction {
 	public:
 		BVHLockedFunction(Mutex *p_mutex, bool p_thread_safe) {
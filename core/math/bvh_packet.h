@@ -0,0 +1,171 @@
+/**************************************************************************/
+/*  bvh_packet.h                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef BVH_PACKET_H
+#define BVH_PACKET_H
+
+#if !defined(REAL_T_IS_DOUBLE) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define BVH_PACKET_SSE2
+#include <emmintrin.h>
+#endif
+
+// A group of segments or bounding boxes culled together in a single traversal of the tree.
+// Lanes are stored per axis, so a node or item can be tested against all of them at once
+// (using SSE2 for single precision 3D bounds). Tests are conservative: a lane may hit bounds
+// it only touches within rounding error, which is fine for culling.
+template <typename BOUNDS = AABB, typename POINT = Vector3>
+struct BVH_Packet {
+	static constexpr int SIZE = 4;
+	static constexpr int AXIS_COUNT = POINT::AXIS_COUNT;
+
+	enum Type {
+		TYPE_SEGMENT,
+		TYPE_AABB,
+	};
+
+	Type type = TYPE_SEGMENT;
+	// Bit n is set if lane n is in use.
+	uint32_t lanes = 0;
+
+	// For segments, the start point and inverse direction, which is 0 along axes the segment
+	// doesn't move on. For bounding boxes, the min and max.
+	alignas(16) real_t a[AXIS_COUNT][SIZE] = {};
+	alignas(16) real_t b[AXIS_COUNT][SIZE] = {};
+
+	void set_segment(int p_lane, const POINT &p_from, const POINT &p_to) {
+		type = TYPE_SEGMENT;
+		lanes |= 1 << p_lane;
+		for (int axis = 0; axis < AXIS_COUNT; axis++) {
+			real_t length = p_to[axis] - p_from[axis];
+			a[axis][p_lane] = p_from[axis];
+			b[axis][p_lane] = length != 0 ? 1 / length : 0;
+		}
+	}
+
+	void set_aabb(int p_lane, const BOUNDS &p_aabb) {
+		type = TYPE_AABB;
+		lanes |= 1 << p_lane;
+		for (int axis = 0; axis < AXIS_COUNT; axis++) {
+			a[axis][p_lane] = p_aabb.position[axis];
+			b[axis][p_lane] = p_aabb.position[axis] + p_aabb.size[axis];
+		}
+	}
+
+	// Returns which of p_lanes intersect the bounds.
+	uint32_t test(const BVH_ABB<BOUNDS, POINT> &p_abb, uint32_t p_lanes) const {
+#ifdef BVH_PACKET_SSE2
+		if constexpr (AXIS_COUNT == 3) {
+			return (type == TYPE_SEGMENT ? _test_segments_sse2(p_abb) : _test_aabbs_sse2(p_abb)) & p_lanes;
+		}
+#endif
+		uint32_t result = 0;
+		for (int lane = 0; lane < SIZE; lane++) {
+			if ((p_lanes & (1 << lane)) && (type == TYPE_SEGMENT ? _test_segment(p_abb, lane) : _test_aabb(p_abb, lane))) {
+				result |= 1 << lane;
+			}
+		}
+		return result;
+	}
+
+private:
+	// Along the segment, the slabs are crossed at fractions which must overlap within [0, 1].
+	// Segments parallel to a slab must start inside it instead.
+	bool _test_segment(const BVH_ABB<BOUNDS, POINT> &p_abb, int p_lane) const {
+		real_t enter = 0;
+		real_t exit = 1;
+		for (int axis = 0; axis < AXIS_COUNT; axis++) {
+			real_t from = a[axis][p_lane];
+			real_t inv_length = b[axis][p_lane];
+			real_t lo = p_abb.min[axis];
+			real_t hi = -p_abb.neg_max[axis];
+			if (inv_length == 0) {
+				if (from < lo || from > hi) {
+					return false;
+				}
+				continue;
+			}
+			real_t t1 = (lo - from) * inv_length;
+			real_t t2 = (hi - from) * inv_length;
+			enter = MAX(enter, MIN(t1, t2));
+			exit = MIN(exit, MAX(t1, t2));
+		}
+		return enter <= exit + CMP_EPSILON;
+	}
+
+	bool _test_aabb(const BVH_ABB<BOUNDS, POINT> &p_abb, int p_lane) const {
+		for (int axis = 0; axis < AXIS_COUNT; axis++) {
+			if (a[axis][p_lane] > -p_abb.neg_max[axis] || b[axis][p_lane] < p_abb.min[axis]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+#ifdef BVH_PACKET_SSE2
+	uint32_t _test_segments_sse2(const BVH_ABB<BOUNDS, POINT> &p_abb) const {
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 all = _mm_cmpeq_ps(zero, zero);
+		__m128 enter = zero;
+		__m128 exit = one;
+		__m128 inside = all;
+		for (int axis = 0; axis < 3; axis++) {
+			__m128 from = _mm_load_ps(a[axis]);
+			__m128 inv_length = _mm_load_ps(b[axis]);
+			__m128 lo = _mm_set1_ps(p_abb.min[axis]);
+			__m128 hi = _mm_set1_ps(-p_abb.neg_max[axis]);
+			__m128 t1 = _mm_mul_ps(_mm_sub_ps(lo, from), inv_length);
+			__m128 t2 = _mm_mul_ps(_mm_sub_ps(hi, from), inv_length);
+			__m128 flat = _mm_cmpeq_ps(inv_length, zero);
+			// Flat lanes keep [0, 1] along this axis, and must start within the slab.
+			enter = _mm_max_ps(enter, _mm_andnot_ps(flat, _mm_min_ps(t1, t2)));
+			exit = _mm_min_ps(exit, _mm_or_ps(_mm_and_ps(flat, one), _mm_andnot_ps(flat, _mm_max_ps(t1, t2))));
+			__m128 within = _mm_and_ps(_mm_cmpge_ps(from, lo), _mm_cmple_ps(from, hi));
+			inside = _mm_and_ps(inside, _mm_or_ps(_mm_andnot_ps(flat, all), within));
+		}
+		__m128 hit = _mm_and_ps(inside, _mm_cmple_ps(enter, _mm_add_ps(exit, _mm_set1_ps(CMP_EPSILON))));
+		return _mm_movemask_ps(hit);
+	}
+
+	uint32_t _test_aabbs_sse2(const BVH_ABB<BOUNDS, POINT> &p_abb) const {
+		__m128 hit = _mm_cmpeq_ps(_mm_setzero_ps(), _mm_setzero_ps());
+		for (int axis = 0; axis < 3; axis++) {
+			__m128 lo = _mm_set1_ps(p_abb.min[axis]);
+			__m128 hi = _mm_set1_ps(-p_abb.neg_max[axis]);
+			hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_load_ps(a[axis]), hi));
+			hit = _mm_and_ps(hit, _mm_cmpge_ps(_mm_load_ps(b[axis]), lo));
+		}
+		return _mm_movemask_ps(hit);
+	}
+#endif
+};
+
+#endif // BVH_PACKET_H
@@ -42,6 +42,7 @@
 
 #include "core/math/aabb.h"
 #include "core/math/bvh_abb.h"
+#include "core/math/bvh_packet.h"
 #include "core/math/geometry_3d.h"
 #include "core/math/vector3.h"
 #include "core/templates/local_vector.h"
@@ -49,6 +50,7 @@
 #include <limits.h>
 
 #define BVHABB_CLASS BVH_ABB<BOUNDS, POINT>
+#define BVHPACKET_CLASS BVH_Packet<BOUNDS, POINT>
 
 // not sure if this is better yet so making optional
 #define BVH_EXPAND_LEAF_AABBS
@@ -287,6 +289,8 @@ private:
 			_leaves.free(leaf_id);
 		}
 
+		// no longer a leaf, in case it is still in the dirty list
+		node.clear();
 		_nodes.free(p_node_id);
 	}
 
@@ -363,8 +367,9 @@ private:
 			// only have to refit if it is an edge item
 			// This is a VERY EXPENSIVE STEP
 			// we defer the refit updates until the update function is called once per frame
-			if (refit) {
+			if (refit && !leaf.is_dirty()) {
 				leaf.set_dirty(true);
+				_dirty_leaf_nodes.push_back(owner_node_id);
 			}
 		} else {
 			// remove node if empty
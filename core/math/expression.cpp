@@ -32,6 +32,8 @@
 #include "expression.h"
 
 #include "core/object/class_db.h"
+#include "core/os/thread.h"
+#include "core/variant/variant_internal.h"
 
 Error Expression::_get_token(Token &r_token) {
 	while (true) {
@@ -1236,235 +1238,398 @@ bool Expression::_compile_expression() {
 	return false;
 }
 
-bool Expression::_execute(const Array &p_inputs, Object *p_instance, Expression::ENode *p_node, Variant &r_ret, bool p_const_calls_only, String &r_error_str) {
+// Values of these types are shared by every copy, so a folded one would be the same instance on every execution and
+// modifying a returned value would change what later executions return.
+static bool _has_reference_semantics(Variant::Type p_type) {
+	return p_type == Variant::OBJECT || p_type == Variant::ARRAY || p_type == Variant::DICTIONARY || (p_type >= Variant::PACKED_BYTE_ARRAY && p_type < Variant::VARIANT_MAX);
+}
+
+int Expression::_add_register() {
+	return (register_count++ << ADDRESS_TYPE_BITS) | ADDRESS_REGISTER;
+}
+
+int Expression::_add_constant(const Variant &p_value) {
+	constants.push_back(p_value);
+	return ((constants.size() - 1) << ADDRESS_TYPE_BITS) | ADDRESS_CONSTANT;
+}
+
+int Expression::_compile_node(ENode *p_node) {
+	Instruction instruction;
+	LocalVector<ENode *> children;
+	bool foldable = true;
+
 	switch (p_node->type) {
 		case Expression::ENode::TYPE_INPUT: {
-			const Expression::InputNode *in = static_cast<const Expression::InputNode *>(p_node);
-			if (in->index < 0 || in->index >= p_inputs.size()) {
-				r_error_str = vformat(RTR("Invalid input %d (not passed) in expression"), in->index);
-				return true;
+			return (static_cast<InputNode *>(p_node)->index << ADDRESS_TYPE_BITS) | ADDRESS_INPUT;
+		}
+		case Expression::ENode::TYPE_CONSTANT: {
+			return _add_constant(static_cast<ConstantNode *>(p_node)->value);
+		}
+		case Expression::ENode::TYPE_SELF: {
+			if (self_register < 0) {
+				self_register = _add_register() >> ADDRESS_TYPE_BITS;
 			}
-			r_ret = p_inputs[in->index];
+			return (self_register << ADDRESS_TYPE_BITS) | ADDRESS_SELF;
+		}
+		case Expression::ENode::TYPE_OPERATOR: {
+			OperatorNode *op = static_cast<OperatorNode *>(p_node);
+			instruction.opcode = Instruction::OPCODE_OPERATOR;
+			instruction.op = op->op;
+			// Division by zero prints an error, which should happen when executing.
+			foldable = op->op != Variant::OP_DIVIDE && op->op != Variant::OP_MODULE;
+			children.push_back(op->nodes[0]);
+			// Unary operators get null as the second operand.
+			children.push_back(op->nodes[1]);
 		} break;
-		case Expression::ENode::TYPE_CONSTANT: {
-			const Expression::ConstantNode *c = static_cast<const Expression::ConstantNode *>(p_node);
-			r_ret = c->value;
-
+		case Expression::ENode::TYPE_INDEX: {
+			IndexNode *index = static_cast<IndexNode *>(p_node);
+			instruction.opcode = Instruction::OPCODE_INDEX;
+			children.push_back(index->base);
+			children.push_back(index->index);
 		} break;
-		case Expression::ENode::TYPE_SELF: {
-			if (!p_instance) {
-				r_error_str = RTR("self can't be used because instance is null (not passed)");
-				return true;
+		case Expression::ENode::TYPE_NAMED_INDEX: {
+			NamedIndexNode *index = static_cast<NamedIndexNode *>(p_node);
+			instruction.opcode = Instruction::OPCODE_NAMED_INDEX;
+			instruction.name = index->name;
+			children.push_back(index->base);
+		} break;
+		case Expression::ENode::TYPE_ARRAY: {
+			// Never folded, each execution returns a new array.
+			instruction.opcode = Instruction::OPCODE_ARRAY;
+			foldable = false;
+			for (ENode *element : static_cast<ArrayNode *>(p_node)->array) {
+				children.push_back(element);
 			}
-			r_ret = p_instance;
 		} break;
-		case Expression::ENode::TYPE_OPERATOR: {
-			const Expression::OperatorNode *op = static_cast<const Expression::OperatorNode *>(p_node);
-
-			Variant a;
-			bool ret = _execute(p_inputs, p_instance, op->nodes[0], a, p_const_calls_only, r_error_str);
-			if (ret) {
-				return true;
+		case Expression::ENode::TYPE_DICTIONARY: {
+			instruction.opcode = Instruction::OPCODE_DICTIONARY;
+			foldable = false;
+			for (ENode *element : static_cast<DictionaryNode *>(p_node)->dict) {
+				children.push_back(element);
 			}
-
-			Variant b;
-
-			if (op->nodes[1]) {
-				ret = _execute(p_inputs, p_instance, op->nodes[1], b, p_const_calls_only, r_error_str);
-				if (ret) {
-					return true;
-				}
+		} break;
+		case Expression::ENode::TYPE_CONSTRUCTOR: {
+			ConstructorNode *constructor = static_cast<ConstructorNode *>(p_node);
+			instruction.opcode = Instruction::OPCODE_CONSTRUCT;
+			instruction.data_type = constructor->data_type;
+			foldable = !_has_reference_semantics(constructor->data_type);
+			for (ENode *argument : constructor->arguments) {
+				children.push_back(argument);
 			}
-
-			bool valid = true;
-			Variant::evaluate(op->op, a, b, r_ret, valid);
-			if (!valid) {
-				r_error_str = vformat(RTR("Invalid operands to operator %s, %s and %s."), Variant::get_operator_name(op->op), Variant::get_type_name(a.get_type()), Variant::get_type_name(b.get_type()));
-				return true;
+		} break;
+		case Expression::ENode::TYPE_BUILTIN_FUNC: {
+			BuiltinFuncNode *bifunc = static_cast<BuiltinFuncNode *>(p_node);
+			instruction.opcode = Instruction::OPCODE_CALL_UTILITY;
+			instruction.name = bifunc->func;
+			// Only math functions are known not to have side effects.
+			foldable = Variant::has_utility_function(bifunc->func) && Variant::get_utility_function_type(bifunc->func) == Variant::UTILITY_FUNC_TYPE_MATH;
+			for (ENode *argument : bifunc->arguments) {
+				children.push_back(argument);
 			}
-
 		} break;
-		case Expression::ENode::TYPE_INDEX: {
-			const Expression::IndexNode *index = static_cast<const Expression::IndexNode *>(p_node);
-
-			Variant base;
-			bool ret = _execute(p_inputs, p_instance, index->base, base, p_const_calls_only, r_error_str);
-			if (ret) {
-				return true;
+		case Expression::ENode::TYPE_CALL: {
+			CallNode *call = static_cast<CallNode *>(p_node);
+			instruction.opcode = Instruction::OPCODE_CALL;
+			instruction.name = call->method;
+			instruction.scratch = _add_register() >> ADDRESS_TYPE_BITS;
+			foldable = false;
+			children.push_back(call->base);
+			for (ENode *argument : call->arguments) {
+				children.push_back(argument);
 			}
+		} break;
+	}
 
-			Variant idx;
-
-			ret = _execute(p_inputs, p_instance, index->index, idx, p_const_calls_only, r_error_str);
-			if (ret) {
-				return true;
-			}
+	LocalVector<int> addresses;
+	for (ENode *child : children) {
+		int address = child ? _compile_node(child) : _add_constant(Variant());
+		foldable = foldable && (address & ADDRESS_TYPE_MASK) == ADDRESS_CONSTANT;
+		addresses.push_back(address);
+	}
 
-			bool valid;
-			r_ret = base.get(idx, &valid);
-			if (!valid) {
-				r_error_str = vformat(RTR("Invalid index of type %s for base type %s"), Variant::get_type_name(idx.get_type()), Variant::get_type_name(base.get_type()));
-				return true;
-			}
+	if (foldable) {
+		// All operands are constant, so the result is as well. If it fails, the error is left for execution to report.
+		LocalVector<const Variant *> args;
+		for (int address : addresses) {
+			args.push_back(&constants[address >> ADDRESS_TYPE_BITS]);
+		}
+		Variant folded;
+		String error;
+		// Operators and indexing may also produce containers, e.g. when indexing a constant of a nested type.
+		if (!_run_instruction(instruction, args.ptr(), folded, nullptr, false, error) && !_has_reference_semantics(folded.get_type())) {
+			return _add_constant(folded);
+		}
+	}
 
-		} break;
-		case Expression::ENode::TYPE_NAMED_INDEX: {
-			const Expression::NamedIndexNode *index = static_cast<const Expression::NamedIndexNode *>(p_node);
+	instruction.target = _add_register() >> ADDRESS_TYPE_BITS;
+	instruction.operand_begin = operands.size();
+	instruction.operand_count = addresses.size();
+	max_operand_count = MAX(max_operand_count, instruction.operand_count);
+	for (int address : addresses) {
+		operands.push_back(address);
+	}
 
-			Variant base;
-			bool ret = _execute(p_inputs, p_instance, index->base, base, p_const_calls_only, r_error_str);
-			if (ret) {
-				return true;
-			}
+	code.push_back(instruction);
+	return (instruction.target << ADDRESS_TYPE_BITS) | ADDRESS_REGISTER;
+}
 
-			bool valid;
-			r_ret = base.get_named(index->name, valid);
-			if (!valid) {
-				r_error_str = vformat(RTR("Invalid named index '%s' for base type %s"), String(index->name), Variant::get_type_name(base.get_type()));
-				return true;
-			}
+void Expression::_compile() {
+	code.clear();
+	operands.clear();
+	constants.clear();
+	register_count = 0;
+	max_operand_count = 0;
+	self_register = -1;
 
-		} break;
-		case Expression::ENode::TYPE_ARRAY: {
-			const Expression::ArrayNode *array = static_cast<const Expression::ArrayNode *>(p_node);
+	result_address = _compile_node(root);
 
-			Array arr;
-			arr.resize(array->array.size());
-			for (int i = 0; i < array->array.size(); i++) {
-				Variant value;
-				bool ret = _execute(p_inputs, p_instance, array->array[i], value, p_const_calls_only, r_error_str);
+	// The tree isn't needed anymore.
+	memdelete(nodes);
+	nodes = nullptr;
+	root = nullptr;
+}
 
-				if (ret) {
-					return true;
-				}
-				arr[i] = value;
+const Variant *Expression::_get_operand(int p_address, const Array &p_inputs, Object *p_instance, Variant *p_registers, String &r_error_str) {
+	int index = p_address >> ADDRESS_TYPE_BITS;
+	switch (p_address & ADDRESS_TYPE_MASK) {
+		case ADDRESS_CONSTANT: {
+			return &constants[index];
+		}
+		case ADDRESS_INPUT: {
+			if (index >= p_inputs.size()) {
+				r_error_str = vformat(RTR("Invalid input %d (not passed) in expression"), index);
+				return nullptr;
+			}
+			return &p_inputs[index];
+		}
+		case ADDRESS_SELF: {
+			if (!p_instance) {
+				r_error_str = RTR("self can't be used because instance is null (not passed)");
+				return nullptr;
 			}
+		} break;
+	}
+	return &p_registers[index];
+}
 
-			r_ret = arr;
+bool Expression::_update_validated_types(Instruction &p_instruction, const Variant **p_args, uint32_t p_count) {
+	// Expressions usually get the same types every time, so fast paths are only looked up again when they change.
+	bool changed = p_instruction.validated_types.size() != p_count;
+	for (uint32_t i = 0; !changed && i < p_count; i++) {
+		changed = p_instruction.validated_types[i] != p_args[i]->get_type();
+	}
+	if (!changed) {
+		return false;
+	}
 
-		} break;
-		case Expression::ENode::TYPE_DICTIONARY: {
-			const Expression::DictionaryNode *dictionary = static_cast<const Expression::DictionaryNode *>(p_node);
+	p_instruction.validated_types.resize(p_count);
+	for (uint32_t i = 0; i < p_count; i++) {
+		p_instruction.validated_types[i] = p_args[i]->get_type();
+	}
+	return true;
+}
 
-			Dictionary d;
-			for (int i = 0; i < dictionary->dict.size(); i += 2) {
-				Variant key;
-				bool ret = _execute(p_inputs, p_instance, dictionary->dict[i + 0], key, p_const_calls_only, r_error_str);
+bool Expression::_run_instruction(Instruction &p_instruction, const Variant **p_args, Variant &r_target, Variant *p_registers, bool p_const_calls_only, String &r_error_str) {
+	Variant &target = r_target;
 
-				if (ret) {
-					return true;
-				}
+	switch (p_instruction.opcode) {
+		case Instruction::OPCODE_OPERATOR: {
+			const Variant *a = p_args[0];
+			const Variant *b = p_args[1];
 
-				Variant value;
-				ret = _execute(p_inputs, p_instance, dictionary->dict[i + 1], value, p_const_calls_only, r_error_str);
-				if (ret) {
-					return true;
+			if (_update_validated_types(p_instruction, p_args, 2)) {
+				p_instruction.validated_operator = nullptr;
+				// Validated divisions don't check for zero, nor validated shifts for negative operands.
+				if (p_instruction.op != Variant::OP_DIVIDE && p_instruction.op != Variant::OP_MODULE && p_instruction.op != Variant::OP_SHIFT_LEFT && p_instruction.op != Variant::OP_SHIFT_RIGHT) {
+					p_instruction.validated_operator = Variant::get_validated_operator_evaluator(p_instruction.op, a->get_type(), b->get_type());
+					p_instruction.validated_return_type = Variant::get_operator_return_type(p_instruction.op, a->get_type(), b->get_type());
 				}
-
-				d[key] = value;
 			}
 
-			r_ret = d;
-		} break;
-		case Expression::ENode::TYPE_CONSTRUCTOR: {
-			const Expression::ConstructorNode *constructor = static_cast<const Expression::ConstructorNode *>(p_node);
-
-			Vector<Variant> arr;
-			Vector<const Variant *> argp;
-			arr.resize(constructor->arguments.size());
-			argp.resize(constructor->arguments.size());
-
-			for (int i = 0; i < constructor->arguments.size(); i++) {
-				Variant value;
-				bool ret = _execute(p_inputs, p_instance, constructor->arguments[i], value, p_const_calls_only, r_error_str);
-
-				if (ret) {
+			if (p_instruction.validated_operator) {
+				if (target.get_type() != p_instruction.validated_return_type) {
+					VariantInternal::initialize(&target, p_instruction.validated_return_type);
+				}
+				p_instruction.validated_operator(a, b, &target);
+			} else {
+				bool valid = true;
+				Variant::evaluate(p_instruction.op, *a, *b, target, valid);
+				if (!valid) {
+					r_error_str = vformat(RTR("Invalid operands to operator %s, %s and %s."), Variant::get_operator_name(p_instruction.op), Variant::get_type_name(a->get_type()), Variant::get_type_name(b->get_type()));
 					return true;
 				}
-				arr.write[i] = value;
-				argp.write[i] = &arr[i];
 			}
-
-			Callable::CallError ce;
-			Variant::construct(constructor->data_type, r_ret, (const Variant **)argp.ptr(), argp.size(), ce);
-
-			if (ce.error != Callable::CallError::CALL_OK) {
-				r_error_str = vformat(RTR("Invalid arguments to construct '%s'"), Variant::get_type_name(constructor->data_type));
+		} break;
+		case Instruction::OPCODE_INDEX: {
+			bool valid;
+			target = p_args[0]->get(*p_args[1], &valid);
+			if (!valid) {
+				r_error_str = vformat(RTR("Invalid index of type %s for base type %s"), Variant::get_type_name(p_args[1]->get_type()), Variant::get_type_name(p_args[0]->get_type()));
 				return true;
 			}
-
 		} break;
-		case Expression::ENode::TYPE_BUILTIN_FUNC: {
-			const Expression::BuiltinFuncNode *bifunc = static_cast<const Expression::BuiltinFuncNode *>(p_node);
+		case Instruction::OPCODE_NAMED_INDEX: {
+			const Variant *base = p_args[0];
 
-			Vector<Variant> arr;
-			Vector<const Variant *> argp;
-			arr.resize(bifunc->arguments.size());
-			argp.resize(bifunc->arguments.size());
+			if (_update_validated_types(p_instruction, p_args, 1)) {
+				p_instruction.validated_getter = Variant::get_member_validated_getter(base->get_type(), p_instruction.name);
+				if (p_instruction.validated_getter) {
+					p_instruction.validated_return_type = Variant::get_member_type(base->get_type(), p_instruction.name);
+				}
+			}
 
-			for (int i = 0; i < bifunc->arguments.size(); i++) {
-				Variant value;
-				bool ret = _execute(p_inputs, p_instance, bifunc->arguments[i], value, p_const_calls_only, r_error_str);
-				if (ret) {
+			if (p_instruction.validated_getter) {
+				if (target.get_type() != p_instruction.validated_return_type) {
+					VariantInternal::initialize(&target, p_instruction.validated_return_type);
+				}
+				p_instruction.validated_getter(base, &target);
+			} else {
+				bool valid;
+				target = base->get_named(p_instruction.name, valid);
+				if (!valid) {
+					r_error_str = vformat(RTR("Invalid named index '%s' for base type %s"), String(p_instruction.name), Variant::get_type_name(base->get_type()));
 					return true;
 				}
-				arr.write[i] = value;
-				argp.write[i] = &arr[i];
 			}
-
-			r_ret = Variant(); //may not return anything
+		} break;
+		case Instruction::OPCODE_ARRAY: {
+			Array arr;
+			arr.resize(p_instruction.operand_count);
+			for (uint32_t i = 0; i < p_instruction.operand_count; i++) {
+				arr[i] = *p_args[i];
+			}
+			target = arr;
+		} break;
+		case Instruction::OPCODE_DICTIONARY: {
+			Dictionary d;
+			for (uint32_t i = 0; i < p_instruction.operand_count; i += 2) {
+				d[*p_args[i + 0]] = *p_args[i + 1];
+			}
+			target = d;
+		} break;
+		case Instruction::OPCODE_CONSTRUCT: {
 			Callable::CallError ce;
-			Variant::call_utility_function(bifunc->func, &r_ret, (const Variant **)argp.ptr(), argp.size(), ce);
+			Variant::construct(p_instruction.data_type, target, p_args, p_instruction.operand_count, ce);
 			if (ce.error != Callable::CallError::CALL_OK) {
-				r_error_str = "Builtin call failed: " + Variant::get_call_error_text(bifunc->func, (const Variant **)argp.ptr(), argp.size(), ce);
+				r_error_str = vformat(RTR("Invalid arguments to construct '%s'"), Variant::get_type_name(p_instruction.data_type));
 				return true;
 			}
-
 		} break;
-		case Expression::ENode::TYPE_CALL: {
-			const Expression::CallNode *call = static_cast<const Expression::CallNode *>(p_node);
-
-			Variant base;
-			bool ret = _execute(p_inputs, p_instance, call->base, base, p_const_calls_only, r_error_str);
-
-			if (ret) {
+		case Instruction::OPCODE_CALL_UTILITY: {
+			target = Variant(); // May not return anything.
+			Callable::CallError ce;
+			Variant::call_utility_function(p_instruction.name, &target, p_args, p_instruction.operand_count, ce);
+			if (ce.error != Callable::CallError::CALL_OK) {
+				r_error_str = "Builtin call failed: " + Variant::get_call_error_text(p_instruction.name, p_args, p_instruction.operand_count, ce);
 				return true;
 			}
-
-			Vector<Variant> arr;
-			Vector<const Variant *> argp;
-			arr.resize(call->arguments.size());
-			argp.resize(call->arguments.size());
-
-			for (int i = 0; i < call->arguments.size(); i++) {
-				Variant value;
-				ret = _execute(p_inputs, p_instance, call->arguments[i], value, p_const_calls_only, r_error_str);
-
-				if (ret) {
-					return true;
+		} break;
+		case Instruction::OPCODE_CALL: {
+			const Variant **args = p_args + 1;
+			const int argcount = p_instruction.operand_count - 1;
+
+			if (_update_validated_types(p_instruction, p_args, p_instruction.operand_count)) {
+				p_instruction.validated_call = nullptr;
+				const Variant::Type type = p_args[0]->get_type();
+				const StringName &method = p_instruction.name;
+				if (Variant::has_builtin_method(type, method) && !Variant::is_builtin_method_static(type, method)) {
+					p_instruction.validated_call = Variant::get_validated_builtin_method_for_arguments(type, method, p_instruction.validated_types.ptr() + 1, argcount);
+					p_instruction.validated_has_return = Variant::has_builtin_method_return_value(type, method);
+					p_instruction.validated_return_type = Variant::get_builtin_method_return_type(type, method);
+					p_instruction.validated_is_const = Variant::is_builtin_method_const(type, method);
 				}
-				arr.write[i] = value;
-				argp.write[i] = &arr[i];
 			}
 
+			// Methods that may modify the base are called on a copy, which is released right after.
+			Variant &scratch = p_registers[p_instruction.scratch];
 			Callable::CallError ce;
-			if (p_const_calls_only) {
-				base.call_const(call->method, (const Variant **)argp.ptr(), argp.size(), r_ret, ce);
+			if (p_instruction.validated_call && p_instruction.validated_is_const) {
+				if (p_instruction.validated_has_return && target.get_type() != p_instruction.validated_return_type) {
+					VariantInternal::initialize(&target, p_instruction.validated_return_type);
+				}
+				p_instruction.validated_call(const_cast<Variant *>(p_args[0]), args, argcount, &target);
+			} else if (p_instruction.validated_call && !p_const_calls_only) {
+				scratch = *p_args[0];
+				if (p_instruction.validated_has_return) {
+					VariantInternal::initialize(&target, p_instruction.validated_return_type);
+				} else {
+					target = Variant();
+				}
+				p_instruction.validated_call(&scratch, args, argcount, &target);
+				scratch = Variant();
 			} else {
-				base.callp(call->method, (const Variant **)argp.ptr(), argp.size(), r_ret, ce);
+				scratch = *p_args[0];
+				if (p_const_calls_only) {
+					scratch.call_const(p_instruction.name, args, argcount, target, ce);
+				} else {
+					scratch.callp(p_instruction.name, args, argcount, target, ce);
+				}
+				scratch = Variant();
 			}
 
 			if (ce.error != Callable::CallError::CALL_OK) {
-				r_error_str = vformat(RTR("On call to '%s':"), String(call->method));
+				r_error_str = vformat(RTR("On call to '%s':"), String(p_instruction.name));
 				return true;
 			}
-
 		} break;
 	}
 	return false;
 }
 
+bool Expression::_execute(const Array &p_inputs, Object *p_instance, bool p_const_calls_only, Variant &r_ret, String &r_error_str) {
+	// Each execution gets its own registers, on the stack unless the expression is unusually large.
+	const bool on_stack = register_count <= MAX_STACK_REGISTERS;
+	LocalVector<Variant> heap_registers;
+	Variant *registers = nullptr;
+	if (on_stack) {
+		registers = (Variant *)alloca(sizeof(Variant) * MAX(register_count, 1u));
+		for (uint32_t i = 0; i < register_count; i++) {
+			memnew_placement(&registers[i], Variant);
+		}
+	} else {
+		heap_registers.resize(register_count);
+		registers = heap_registers.ptr();
+	}
+	const Variant **args = (const Variant **)alloca(sizeof(const Variant *) * MAX(max_operand_count, 1u));
+
+	if (self_register >= 0) {
+		registers[self_register] = p_instance;
+	}
+	const bool failed = _execute_code(p_inputs, p_instance, p_const_calls_only, registers, args, r_ret, r_error_str);
+
+	if (on_stack) {
+		for (uint32_t i = 0; i < register_count; i++) {
+			registers[i].~Variant();
+		}
+	}
+	return failed;
+}
+
+bool Expression::_execute_code(const Array &p_inputs, Object *p_instance, bool p_const_calls_only, Variant *p_registers, const Variant **p_args, Variant &r_ret, String &r_error_str) {
+	for (Instruction &instruction : code) {
+		for (uint32_t i = 0; i < instruction.operand_count; i++) {
+			p_args[i] = _get_operand(operands[instruction.operand_begin + i], p_inputs, p_instance, p_registers, r_error_str);
+			if (!p_args[i]) {
+				return true;
+			}
+		}
+
+		if (_run_instruction(instruction, p_args, p_registers[instruction.target], p_registers, p_const_calls_only, r_error_str)) {
+			return true;
+		}
+	}
+
+	const Variant *result = _get_operand(result_address, p_inputs, p_instance, p_registers, r_error_str);
+	if (!result) {
+		return true;
+	}
+	r_ret = *result;
+	return false;
+}
+
 Error Expression::parse(const String &p_expression, const Vector<String> &p_input_names) {
+	ERR_FAIL_COND_V_MSG(executing_thread.load(std::memory_order_acquire) != Thread::UNASSIGNED_ID, ERR_BUSY, "Can't parse an Expression while it's being executed.");
+
 	if (nodes) {
 		memdelete(nodes);
 		nodes = nullptr;
@@ -1485,19 +1650,37 @@ Error Expression::parse(const String &p_expression, const Vector<String> &p_inpu
 			memdelete(nodes);
 		}
 		nodes = nullptr;
+		code.clear();
+		constants.clear();
+		register_count = 0;
 		return ERR_INVALID_PARAMETER;
 	}
 
+	_compile();
+
 	return OK;
 }
 
 Variant Expression::execute(const Array &p_inputs, Object *p_base, bool p_show_error, bool p_const_calls_only) {
 	ERR_FAIL_COND_V_MSG(error_set, Variant(), vformat("There was previously a parse error: %s.", error_str));
 
+	// Nested executions on the same thread are fine, they have their own registers.
+	const Thread::ID caller = Thread::get_caller_id();
+	if (executing_thread.load(std::memory_order_acquire) != caller) {
+		uint64_t expected = Thread::UNASSIGNED_ID;
+		ERR_FAIL_COND_V_MSG(!executing_thread.compare_exchange_strong(expected, caller, std::memory_order_acq_rel), Variant(), "An Expression can't be executed by several threads at once, use one Expression per thread.");
+	}
+	execute_depth++;
+
 	execution_error = false;
 	Variant output;
 	String error_txt;
-	bool err = _execute(p_inputs, p_base, root, output, p_const_calls_only, error_txt);
+	bool err = _execute(p_inputs, p_base, p_const_calls_only, output, error_txt);
+
+	if (--execute_depth == 0) {
+		executing_thread.store(Thread::UNASSIGNED_ID, std::memory_order_release);
+	}
+
 	if (err) {
 		execution_error = true;
 		error_str = error_txt;
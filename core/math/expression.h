@@ -33,6 +33,7 @@
 #define EXPRESSION_H
 
 #include "core/object/ref_counted.h"
+#include "core/templates/local_vector.h"
 
 class Expression : public RefCounted {
 	BRCLASS(Expression, RefCounted);
@@ -257,8 +258,81 @@ private:
 
 	Vector<String> input_names;
 
+	// Once parsed, the tree is compiled to a flat list of instructions reading and writing registers. Every
+	// node gets its own register, constants (including the ones folded at compile time) are stored once,
+	// and inputs are read in place, so executing again with the same types doesn't allocate.
+	enum AddressType {
+		ADDRESS_REGISTER,
+		ADDRESS_CONSTANT,
+		ADDRESS_INPUT,
+		ADDRESS_SELF,
+		ADDRESS_TYPE_BITS = 2,
+		ADDRESS_TYPE_MASK = (1 << ADDRESS_TYPE_BITS) - 1,
+	};
+
+	struct Instruction {
+		enum Opcode {
+			OPCODE_OPERATOR,
+			OPCODE_INDEX,
+			OPCODE_NAMED_INDEX,
+			OPCODE_ARRAY,
+			OPCODE_DICTIONARY,
+			OPCODE_CONSTRUCT,
+			OPCODE_CALL_UTILITY,
+			OPCODE_CALL,
+		};
+
+		Opcode opcode = OPCODE_OPERATOR;
+		int target = 0;
+		// Range in `operands`. For indexing and calls, the base comes first.
+		uint32_t operand_begin = 0;
+		uint32_t operand_count = 0;
+
+		Variant::Operator op = Variant::OP_ADD;
+		Variant::Type data_type = Variant::NIL;
+		StringName name;
+		// Register holding a copy of the base for calls that may modify it.
+		int scratch = 0;
+
+		// Validated operator, getter or method resolved for the types seen on the last execution, if any.
+		LocalVector<Variant::Type> validated_types;
+		Variant::Type validated_return_type = Variant::NIL;
+		Variant::ValidatedOperatorEvaluator validated_operator = nullptr;
+		Variant::ValidatedGetter validated_getter = nullptr;
+		Variant::ValidatedBuiltInMethod validated_call = nullptr;
+		bool validated_has_return = false;
+		bool validated_is_const = false;
+	};
+
+	LocalVector<Instruction> code;
+	LocalVector<int> operands;
+	// Only written when compiling, so executions share them.
+	LocalVector<Variant> constants;
+	// Registers belong to each execution, so an execution nested in another (through a call made by the
+	// expression) doesn't overwrite the registers of the outer one. They're on the stack up to this count.
+	static constexpr uint32_t MAX_STACK_REGISTERS = 128;
+	uint32_t register_count = 0;
+	uint32_t max_operand_count = 0;
+	int result_address = 0;
+	int self_register = -1;
+
+	// Instructions cache what they resolved for the types of the last execution, so executions may nest on one
+	// thread but not run on several threads at once.
+	std::atomic<uint64_t> executing_thread = { 0 };
+	uint32_t execute_depth = 0;
+
+	int _add_register();
+	int _add_constant(const Variant &p_value);
+	int _compile_node(ENode *p_node);
+	void _compile();
+
+	const Variant *_get_operand(int p_address, const Array &p_inputs, Object *p_instance, Variant *p_registers, String &r_error_str);
+	bool _update_validated_types(Instruction &p_instruction, const Variant **p_args, uint32_t p_count);
+	bool _run_instruction(Instruction &p_instruction, const Variant **p_args, Variant &r_target, Variant *p_registers, bool p_const_calls_only, String &r_error_str);
+
 	bool execution_error = false;
-	bool _execute(const Array &p_inputs, Object *p_instance, Expression::ENode *p_node, Variant &r_ret, bool p_const_calls_only, String &r_error_str);
+	bool _execute(const Array &p_inputs, Object *p_instance, bool p_const_calls_only, Variant &r_ret, String &r_error_str);
+	bool _execute_code(const Array &p_inputs, Object *p_instance, bool p_const_calls_only, Variant *p_registers, const Variant **p_args, Variant &r_ret, String &r_error_str);
 
 protected:
 	static void _bind_methods();
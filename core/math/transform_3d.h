@@ -34,6 +34,7 @@
 
 #include "core/math/aabb.h"
 #include "core/math/basis.h"
+#include "core/math/batch_math.h"
 #include "core/math/plane.h"
 #include "core/templates/vector.h"
 
@@ -216,12 +217,7 @@ Vector<Vector3> Transform3D::xform(const Vector<Vector3> &p_array) const {
 	Vector<Vector3> array;
 	array.resize(p_array.size());
 
-	const Vector3 *r = p_array.ptr();
-	Vector3 *w = array.ptrw();
-
-	for (int i = 0; i < p_array.size(); ++i) {
-		w[i] = xform(r[i]);
-	}
+	BatchMath::xform(*this, p_array.ptr(), array.ptrw(), p_array.size());
 	return array;
 }
 
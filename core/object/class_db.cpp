@@ -1762,6 +1762,45 @@ StringName ClassDB::get_property_getter(const StringName &p_class, const StringN
 	return StringName();
 }
 
+// Returns the method `set_property()` dispatches to for this class and property, or `nullptr` if it doesn't go through a plain setter.
+MethodBind *ClassDB::get_property_setter_method(const StringName &p_class, const StringName &p_property) {
+	OBJTYPE_RLOCK;
+
+	ClassInfo *check = classes.getptr(p_class);
+	while (check) {
+		const PropertySetGet *psg = check->property_setget.getptr(p_property);
+		if (psg) {
+			return psg->index < 0 ? psg->_setptr : nullptr;
+		}
+
+		check = check->inherits_ptr;
+	}
+
+	return nullptr;
+}
+
+// Returns the method `get_property()` dispatches to for this class and property, or `nullptr` if it doesn't go through a plain getter.
+MethodBind *ClassDB::get_property_getter_method(const StringName &p_class, const StringName &p_property) {
+	OBJTYPE_RLOCK;
+
+	ClassInfo *check = classes.getptr(p_class);
+	while (check) {
+		const PropertySetGet *psg = check->property_setget.getptr(p_property);
+		if (psg) {
+			return psg->index < 0 ? psg->_getptr : nullptr;
+		}
+
+		// Constants, methods and signals of a derived class take precedence over inherited properties.
+		if (check->constant_map.has(p_property) || check->method_map.has(p_property) || check->signal_map.has(p_property)) {
+			return nullptr;
+		}
+
+		check = check->inherits_ptr;
+	}
+
+	return nullptr;
+}
+
 bool ClassDB::has_property(const StringName &p_class, const StringName &p_property, bool p_no_inheritance) {
 	ClassInfo *type = classes.getptr(p_class);
 	ClassInfo *check = type;
@@ -40,6 +40,7 @@
 // Needs to come after method_bind and object have been included.
 #include "core/object/callable_method_pointer.h"
 #include "core/templates/hash_set.h"
+#include "core/templates/swiss_hash_map.h"
 
 #include <type_traits>
 
@@ -106,7 +107,7 @@ public:
 
 		ObjectBRExtension *brextension = nullptr;
 
-		HashMap<StringName, MethodBind *> method_map;
+		SwissHashMap<StringName, MethodBind *> method_map;
 		HashMap<StringName, LocalVector<MethodBind *>> method_map_compatibility;
 		HashMap<StringName, int64_t> constant_map;
 		struct EnumInfo {
@@ -440,6 +441,8 @@ public:
 	static Variant::Type get_property_type(const StringName &p_class, const StringName &p_property, bool *r_is_valid = nullptr);
 	static StringName get_property_setter(const StringName &p_class, const StringName &p_property);
 	static StringName get_property_getter(const StringName &p_class, const StringName &p_property);
+	static MethodBind *get_property_setter_method(const StringName &p_class, const StringName &p_property);
+	static MethodBind *get_property_getter_method(const StringName &p_class, const StringName &p_property);
 
 	static bool has_method(const StringName &p_class, const StringName &p_method, bool p_no_inheritance = false);
 	static void set_method_flags(const StringName &p_class, const StringName &p_method, int p_flags);
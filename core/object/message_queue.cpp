@@ -59,6 +59,42 @@
 		mutex.unlock();                           \
 	}
 
+SafeNumeric<uint64_t> CallQueue::serial_counter;
+thread_local CallQueue::SubQueueCache CallQueue::sub_queue_cache;
+thread_local CallQueue::ThreadSubQueues CallQueue::thread_sub_queues;
+
+CallQueue::ThreadSubQueues::~ThreadSubQueues() {
+	for (SubQueue *sub_queue : sub_queues) {
+		sub_queue->lock.lock();
+		if (sub_queue->queue) {
+			sub_queue->thread_exited = true;
+			sub_queue->queue->sub_queues_exited.increment();
+		}
+		sub_queue->lock.unlock();
+		if (sub_queue->refcount.unref()) {
+			memdelete(sub_queue);
+		}
+	}
+}
+
+void CallQueue::ThreadSubQueues::prune() {
+	// Drop the sub-queues of queues that were destroyed.
+	for (uint32_t i = 0; i < sub_queues.size();) {
+		SubQueue *sub_queue = sub_queues[i];
+		sub_queue->lock.lock();
+		bool dead = sub_queue->queue == nullptr;
+		sub_queue->lock.unlock();
+		if (!dead) {
+			i++;
+			continue;
+		}
+		sub_queues.remove_at_unordered(i);
+		if (sub_queue->refcount.unref()) {
+			memdelete(sub_queue);
+		}
+	}
+}
+
 void CallQueue::_add_page() {
 	if (pages_used == page_bytes.size()) {
 		pages.push_back(allocator->alloc());
@@ -68,6 +104,189 @@ void CallQueue::_add_page() {
 	pages_used++;
 }
 
+CallQueue::SubQueue *CallQueue::_get_sub_queue() {
+	if (this == MessageQueue::thread_singleton) {
+		return nullptr; // Only used from this thread, no locking needed at all.
+	}
+
+	Thread::ID caller_id = Thread::get_caller_id();
+	if (caller_id == owner_thread) {
+		return nullptr;
+	}
+
+	if (likely(sub_queue_cache.serial == serial)) {
+		return sub_queue_cache.sub_queue;
+	}
+
+	MutexLock lock(mutex);
+
+	if (sub_queues_exited.get() > 0) {
+		_splice_sub_queues(); // Make room for this thread.
+	}
+
+	SubQueue *sub_queue = nullptr;
+	for (SubQueue *E : sub_queues) {
+		if (E->thread == caller_id) {
+			sub_queue = E;
+			break;
+		}
+	}
+
+	if (!sub_queue) {
+		if (sub_queues.size() >= MAX_SUB_QUEUES) {
+			return nullptr;
+		}
+		sub_queue = memnew(SubQueue);
+		sub_queue->refcount.init(2);
+		sub_queue->queue = this;
+		sub_queue->thread = caller_id;
+		sub_queues.push_back(sub_queue);
+		thread_sub_queues.prune();
+		thread_sub_queues.sub_queues.push_back(sub_queue);
+	}
+
+	sub_queue_cache.serial = serial;
+	sub_queue_cache.sub_queue = sub_queue;
+	return sub_queue;
+}
+
+void CallQueue::_splice_sub_queues() {
+	// The mutex is recursive, this also covers queues flushed as a thread singleton override.
+	MutexLock lock(mutex);
+
+	for (uint32_t sub_queue_index = 0; sub_queue_index < sub_queues.size(); sub_queue_index++) {
+		SubQueue *sub_queue = sub_queues[sub_queue_index];
+		sub_queue->lock.lock();
+		if (!sub_queue->pending) {
+			if (sub_queue->thread_exited) {
+				_free_sub_queue(sub_queue_index--);
+			} else {
+				sub_queue->lock.unlock();
+			}
+			continue;
+		}
+
+		if (pages_used > 0 && page_bytes[pages_used - 1] == 0) {
+			pages_used--; // An empty page in the middle would end the flush early.
+		}
+
+		bool pages_taken = false;
+		for (uint32_t i = 0; i < sub_queue->pages_used; i++) {
+			Page *page = sub_queue->pages[i];
+			if (pages_used < pages.size()) {
+				// Trade it for a spare page, so neither side needs to allocate later.
+				sub_queue->pages[i] = pages[pages_used];
+				pages[pages_used] = page;
+				page_bytes[pages_used] = sub_queue->page_bytes[i];
+			} else {
+				sub_queue->pages[i] = nullptr;
+				pages_taken = true;
+				pages.push_back(page);
+				page_bytes.push_back(sub_queue->page_bytes[i]);
+			}
+			pages_used++;
+		}
+
+		if (pages_taken) {
+			uint32_t count = 0;
+			for (uint32_t i = 0; i < sub_queue->pages.size(); i++) {
+				if (sub_queue->pages[i]) {
+					sub_queue->pages[count++] = sub_queue->pages[i];
+				}
+			}
+			sub_queue->pages.resize(count);
+			sub_queue->page_bytes.resize(count);
+		}
+
+		sub_queue->pages_used = 0;
+		sub_queue->pending = false;
+		sub_queues_pending.decrement();
+
+		if (sub_queue->thread_exited) {
+			_free_sub_queue(sub_queue_index--);
+			continue;
+		}
+
+		sub_queue->lock.unlock();
+	}
+}
+
+void CallQueue::_free_sub_queue(uint32_t p_index) {
+	// Called with the mutex and the sub-queue lock held, once its messages were spliced.
+	// Its thread is gone, so it won't be written to anymore.
+	SubQueue *sub_queue = sub_queues[p_index];
+	for (Page *page : sub_queue->pages) {
+		allocator->free(page);
+	}
+	sub_queue->pages.clear();
+	sub_queue->page_bytes.clear();
+	sub_queue->queue = nullptr;
+	sub_queue->lock.unlock();
+	if (sub_queue->refcount.unref()) {
+		memdelete(sub_queue);
+	}
+	sub_queues.remove_at(p_index);
+	sub_queues_exited.decrement();
+}
+
+uint8_t *CallQueue::_begin_message(uint32_t p_room_needed, SubQueue *&r_sub_queue) {
+	r_sub_queue = _get_sub_queue();
+
+	if (r_sub_queue) {
+		r_sub_queue->lock.lock();
+
+		uint32_t &used = r_sub_queue->pages_used;
+		if (used == 0 || (r_sub_queue->page_bytes[used - 1] + p_room_needed) > uint32_t(PAGE_SIZE_BYTES)) {
+			if (used == max_pages) {
+				r_sub_queue->lock.unlock();
+				return nullptr;
+			}
+			if (used == r_sub_queue->pages.size()) {
+				r_sub_queue->pages.push_back(allocator->alloc());
+				r_sub_queue->page_bytes.push_back(0);
+			}
+			r_sub_queue->page_bytes[used] = 0;
+			used++;
+		}
+
+		return &r_sub_queue->pages[used - 1]->data[r_sub_queue->page_bytes[used - 1]];
+	}
+
+	LOCK_MUTEX;
+
+	if (unlikely(sub_queues_pending.get() > 0)) {
+		// Keep the order with messages that other threads pushed before this one.
+		_splice_sub_queues();
+	}
+
+	_ensure_first_page();
+
+	if ((page_bytes[pages_used - 1] + p_room_needed) > uint32_t(PAGE_SIZE_BYTES)) {
+		if (pages_used == max_pages) {
+			UNLOCK_MUTEX;
+			return nullptr;
+		}
+		_add_page();
+	}
+
+	return &pages[pages_used - 1]->data[page_bytes[pages_used - 1]];
+}
+
+void CallQueue::_end_message(uint32_t p_room_needed, SubQueue *p_sub_queue) {
+	if (p_sub_queue) {
+		p_sub_queue->page_bytes[p_sub_queue->pages_used - 1] += p_room_needed;
+		if (!p_sub_queue->pending) {
+			p_sub_queue->pending = true;
+			sub_queues_pending.increment();
+		}
+		p_sub_queue->lock.unlock();
+		return;
+	}
+
+	page_bytes[pages_used - 1] += p_room_needed;
+	UNLOCK_MUTEX;
+}
+
 Error CallQueue::push_callp(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
 	return push_callablep(Callable(p_id, p_method), p_args, p_argcount, p_show_error);
 }
@@ -89,24 +308,14 @@ Error CallQueue::push_callablep(const Callable &p_callable, const Variant **p_ar
 
 	ERR_FAIL_COND_V_MSG(room_needed > uint32_t(PAGE_SIZE_BYTES), ERR_INVALID_PARAMETER, "Message is too large to fit on a page (" + itos(PAGE_SIZE_BYTES) + " bytes), consider passing less arguments.");
 
-	LOCK_MUTEX;
-
-	_ensure_first_page();
-
-	if ((page_bytes[pages_used - 1] + room_needed) > uint32_t(PAGE_SIZE_BYTES)) {
-		if (pages_used == max_pages) {
-			fprintf(stderr, "Failed method: %s. Message queue out of memory. %s\n", String(p_callable).utf8().get_data(), error_text.utf8().get_data());
-			statistics();
-			UNLOCK_MUTEX;
-			return ERR_OUT_OF_MEMORY;
-		}
-		_add_page();
+	SubQueue *sub_queue = nullptr;
+	uint8_t *buffer_end = _begin_message(room_needed, sub_queue);
+	if (!buffer_end) {
+		fprintf(stderr, "Failed method: %s. Message queue out of memory. %s\n", String(p_callable).utf8().get_data(), error_text.utf8().get_data());
+		statistics();
+		return ERR_OUT_OF_MEMORY;
 	}
 
-	Page *page = pages[pages_used - 1];
-
-	uint8_t *buffer_end = &page->data[page_bytes[pages_used - 1]];
-
 	Message *msg = memnew_placement(buffer_end, Message);
 	msg->args = p_argcount;
 	msg->callable = p_callable;
@@ -127,37 +336,26 @@ Error CallQueue::push_callablep(const Callable &p_callable, const Variant **p_ar
 		*v = *p_args[i];
 	}
 
-	page_bytes[pages_used - 1] += room_needed;
-
-	UNLOCK_MUTEX;
+	_end_message(room_needed, sub_queue);
 
 	return OK;
 }
 
 Error CallQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value) {
-	LOCK_MUTEX;
 	uint32_t room_needed = sizeof(Message) + sizeof(Variant);
 
-	_ensure_first_page();
-
-	if ((page_bytes[pages_used - 1] + room_needed) > uint32_t(PAGE_SIZE_BYTES)) {
-		if (pages_used == max_pages) {
-			String type;
-			if (ObjectDB::get_instance(p_id)) {
-				type = ObjectDB::get_instance(p_id)->get_class();
-			}
-			fprintf(stderr, "Failed set: %s: %s target ID: %s. Message queue out of memory. %s\n", type.utf8().get_data(), String(p_prop).utf8().get_data(), itos(p_id).utf8().get_data(), error_text.utf8().get_data());
-			statistics();
-
-			UNLOCK_MUTEX;
-			return ERR_OUT_OF_MEMORY;
+	SubQueue *sub_queue = nullptr;
+	uint8_t *buffer_end = _begin_message(room_needed, sub_queue);
+	if (!buffer_end) {
+		String type;
+		if (ObjectDB::get_instance(p_id)) {
+			type = ObjectDB::get_instance(p_id)->get_class();
 		}
-		_add_page();
+		fprintf(stderr, "Failed set: %s: %s target ID: %s. Message queue out of memory. %s\n", type.utf8().get_data(), String(p_prop).utf8().get_data(), itos(p_id).utf8().get_data(), error_text.utf8().get_data());
+		statistics();
+		return ERR_OUT_OF_MEMORY;
 	}
 
-	Page *page = pages[pages_used - 1];
-	uint8_t *buffer_end = &page->data[page_bytes[pages_used - 1]];
-
 	Message *msg = memnew_placement(buffer_end, Message);
 	msg->args = 1;
 	msg->callable = Callable(p_id, p_prop);
@@ -168,32 +366,23 @@ Error CallQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant
 	Variant *v = memnew_placement(buffer_end, Variant);
 	*v = p_value;
 
-	page_bytes[pages_used - 1] += room_needed;
-	UNLOCK_MUTEX;
+	_end_message(room_needed, sub_queue);
 
 	return OK;
 }
 
 Error CallQueue::push_notification(ObjectID p_id, int p_notification) {
 	ERR_FAIL_COND_V(p_notification < 0, ERR_INVALID_PARAMETER);
-	LOCK_MUTEX;
 	uint32_t room_needed = sizeof(Message);
 
-	_ensure_first_page();
-
-	if ((page_bytes[pages_used - 1] + room_needed) > uint32_t(PAGE_SIZE_BYTES)) {
-		if (pages_used == max_pages) {
-			fprintf(stderr, "Failed notification: %d target ID: %s. Message queue out of memory. %s\n", p_notification, itos(p_id).utf8().get_data(), error_text.utf8().get_data());
-			statistics();
-			UNLOCK_MUTEX;
-			return ERR_OUT_OF_MEMORY;
-		}
-		_add_page();
+	SubQueue *sub_queue = nullptr;
+	uint8_t *buffer_end = _begin_message(room_needed, sub_queue);
+	if (!buffer_end) {
+		fprintf(stderr, "Failed notification: %d target ID: %s. Message queue out of memory. %s\n", p_notification, itos(p_id).utf8().get_data(), error_text.utf8().get_data());
+		statistics();
+		return ERR_OUT_OF_MEMORY;
 	}
 
-	Page *page = pages[pages_used - 1];
-	uint8_t *buffer_end = &page->data[page_bytes[pages_used - 1]];
-
 	Message *msg = memnew_placement(buffer_end, Message);
 
 	msg->type = TYPE_NOTIFICATION;
@@ -201,15 +390,17 @@ Error CallQueue::push_notification(ObjectID p_id, int p_notification) {
 	//msg->target;
 	msg->notification = p_notification;
 
-	page_bytes[pages_used - 1] += room_needed;
-	UNLOCK_MUTEX;
+	_end_message(room_needed, sub_queue);
 
 	return OK;
 }
 
 void CallQueue::_call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error) {
 	const Variant **argptrs = nullptr;
-	if (p_argcount) {
+	const Variant *single_argptr = p_args;
+	if (p_argcount == 1) {
+		argptrs = &single_argptr;
+	} else if (p_argcount) {
 		argptrs = (const Variant **)alloca(sizeof(Variant *) * p_argcount);
 		for (int i = 0; i < p_argcount; i++) {
 			argptrs[i] = &p_args[i];
@@ -227,7 +418,7 @@ void CallQueue::_call_function(const Callable &p_callable, const Variant *p_args
 Error CallQueue::flush() {
 	LOCK_MUTEX;
 
-	if (pages.size() == 0) {
+	if (pages.size() == 0 && sub_queues_pending.get() == 0 && sub_queues_exited.get() == 0) {
 		// Never allocated
 		UNLOCK_MUTEX;
 		return OK; // Do nothing.
@@ -240,10 +431,23 @@ Error CallQueue::flush() {
 
 	flushing = true;
 
+	if (sub_queues_exited.get() > 0) {
+		_splice_sub_queues(); // Releases the sub-queues of threads that exited.
+	}
+
 	uint32_t i = 0;
 	uint32_t offset = 0;
 
-	while (i < pages_used && offset < page_bytes[i]) {
+	while (true) {
+		if (i >= pages_used || offset >= page_bytes[i]) {
+			// Pick up what other threads pushed, including during this flush.
+			if (sub_queues_pending.get() == 0) {
+				break;
+			}
+			_splice_sub_queues();
+			continue;
+		}
+
 		Page *page = pages[i];
 
 		//lock on each iteration, so a call can re-add itself to the message queue
@@ -309,6 +513,10 @@ Error CallQueue::flush() {
 void CallQueue::clear() {
 	LOCK_MUTEX;
 
+	if (sub_queues_pending.get() > 0) {
+		_splice_sub_queues();
+	}
+
 	if (pages.size() == 0) {
 		UNLOCK_MUTEX;
 		return; // Nothing to clear.
@@ -349,6 +557,10 @@ void CallQueue::clear() {
 
 void CallQueue::statistics() {
 	LOCK_MUTEX;
+
+	if (sub_queues_pending.get() > 0) {
+		_splice_sub_queues();
+	}
 	HashMap<StringName, int> set_count;
 	HashMap<int, int> notify_count;
 	HashMap<Callable, int> call_count;
@@ -447,6 +659,9 @@ bool CallQueue::is_flushing() const {
 }
 
 bool CallQueue::has_messages() const {
+	if (sub_queues_pending.get() > 0) {
+		return true;
+	}
 	if (pages_used == 0) {
 		return false;
 	}
@@ -461,6 +676,14 @@ int CallQueue::get_max_buffer_usage() const {
 	return pages.size() * PAGE_SIZE_BYTES;
 }
 
+int CallQueue::get_sub_queue_count() const {
+	return sub_queues.size();
+}
+
+int CallQueue::get_thread_sub_queue_count() {
+	return thread_sub_queues.sub_queues.size();
+}
+
 CallQueue::CallQueue(Allocator *p_custom_allocator, uint32_t p_max_pages, const String &p_error_text) {
 	if (p_custom_allocator) {
 		allocator = p_custom_allocator;
@@ -471,6 +694,8 @@ CallQueue::CallQueue(Allocator *p_custom_allocator, uint32_t p_max_pages, const
 	}
 	max_pages = p_max_pages;
 	error_text = p_error_text;
+	owner_thread = Thread::get_caller_id();
+	serial = serial_counter.increment();
 }
 
 CallQueue::~CallQueue() {
@@ -479,6 +704,17 @@ CallQueue::~CallQueue() {
 	for (uint32_t i = 0; i < pages.size(); i++) {
 		allocator->free(pages[i]);
 	}
+	for (SubQueue *sub_queue : sub_queues) {
+		sub_queue->lock.lock();
+		sub_queue->queue = nullptr;
+		sub_queue->lock.unlock();
+		for (uint32_t i = 0; i < sub_queue->pages.size(); i++) {
+			allocator->free(sub_queue->pages[i]);
+		}
+		if (sub_queue->refcount.unref()) {
+			memdelete(sub_queue);
+		}
+	}
 	if (!allocator_is_custom) {
 		memdelete(allocator);
 	}
@@ -510,6 +746,7 @@ MessageQueue::MessageQueue() :
 				"Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_mb' in project settings.") {
 	ERR_FAIL_COND_MSG(main_singleton != nullptr, "A MessageQueue singleton already exists.");
 	main_singleton = this;
+	owner_thread = Thread::get_main_id(); // Flushed by the main thread, even if created before it was made main.
 }
 
 MessageQueue::~MessageQueue() {
@@ -33,9 +33,12 @@
 #define MESSAGE_QUEUE_H
 
 #include "core/object/object_id.h"
+#include "core/os/spin_lock.h"
+#include "core/os/thread.h"
 #include "core/os/thread_safe.h"
 #include "core/templates/local_vector.h"
 #include "core/templates/paged_allocator.h"
+#include "core/templates/safe_refcount.h"
 #include "core/variant/variant.h"
 
 class Object;
@@ -78,6 +81,55 @@ private:
 	uint32_t pages_used = 0;
 	bool flushing = false;
 
+	// Threads other than the owner (the one that created the queue, or the main thread for the
+	// MessageQueue) write to their own sub-queue, so they don't contend on the mutex with each other
+	// or with flush(). Its pages are spliced into the main list, without copying the messages, whenever
+	// the owner pushes, flushes or clears, which keeps the order of each thread's messages.
+	// Messages pushed from different threads are not flushed in the order they were pushed across
+	// threads: each sub-queue is spliced as a whole, after the messages already in the main list.
+	// When its thread exits, a sub-queue is flagged and the queue reclaims it on the next flush, or when
+	// another thread needs a new sub-queue. When the queue is destroyed first, the thread drops its
+	// reference the next time it registers a sub-queue, or when it exits.
+	// Both the queue and the thread hold a reference, as either can go away first.
+	struct SubQueue {
+		SpinLock lock;
+		SafeRefCount refcount;
+		CallQueue *queue = nullptr; // Cleared when the queue is destroyed.
+		Thread::ID thread = Thread::UNASSIGNED_ID;
+		LocalVector<Page *> pages;
+		LocalVector<uint32_t> page_bytes;
+		uint32_t pages_used = 0;
+		bool pending = false;
+		bool thread_exited = false;
+	};
+
+	enum {
+		// Threads running at the same time beyond this use the mutex.
+		MAX_SUB_QUEUES = 64,
+	};
+
+	struct SubQueueCache {
+		uint64_t serial = 0;
+		SubQueue *sub_queue = nullptr;
+	};
+
+	// Releases the sub-queues of a thread when it exits.
+	struct ThreadSubQueues {
+		LocalVector<SubQueue *> sub_queues;
+		void prune();
+		~ThreadSubQueues();
+	};
+
+	Thread::ID owner_thread = Thread::UNASSIGNED_ID;
+	uint64_t serial = 0;
+	LocalVector<SubQueue *> sub_queues;
+	SafeNumeric<uint32_t> sub_queues_pending;
+	SafeNumeric<uint32_t> sub_queues_exited;
+
+	static SafeNumeric<uint64_t> serial_counter;
+	static thread_local SubQueueCache sub_queue_cache;
+	static thread_local ThreadSubQueues thread_sub_queues;
+
 #ifdef DEV_ENABLED
 	bool is_current_thread_override = false;
 #endif
@@ -101,6 +153,12 @@ private:
 
 	void _add_page();
 
+	SubQueue *_get_sub_queue();
+	void _splice_sub_queues();
+	void _free_sub_queue(uint32_t p_index);
+	uint8_t *_begin_message(uint32_t p_room_needed, SubQueue *&r_sub_queue);
+	void _end_message(uint32_t p_room_needed, SubQueue *p_sub_queue);
+
 	void _call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error);
 
 	String error_text;
@@ -109,12 +167,21 @@ public:
 	Error push_callp(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error = false);
 	template <typename... VarArgs>
 	Error push_call(ObjectID p_id, const StringName &p_method, VarArgs... p_args) {
-		Variant args[sizeof...(p_args) + 1] = { p_args..., Variant() }; // +1 makes sure zero sized arrays are also supported.
-		const Variant *argptrs[sizeof...(p_args) + 1];
-		for (uint32_t i = 0; i < sizeof...(p_args); i++) {
-			argptrs[i] = &args[i];
+		// Small calls are the most common ones, don't build an array for them.
+		if constexpr (sizeof...(p_args) == 0) {
+			return push_callp(p_id, p_method, nullptr, 0);
+		} else if constexpr (sizeof...(p_args) == 1) {
+			const Variant arg = Variant(p_args...);
+			const Variant *argptr = &arg;
+			return push_callp(p_id, p_method, &argptr, 1);
+		} else {
+			Variant args[sizeof...(p_args)] = { p_args... };
+			const Variant *argptrs[sizeof...(p_args)];
+			for (uint32_t i = 0; i < sizeof...(p_args); i++) {
+				argptrs[i] = &args[i];
+			}
+			return push_callp(p_id, p_method, (const Variant **)argptrs, sizeof...(p_args));
 		}
-		return push_callp(p_id, p_method, sizeof...(p_args) == 0 ? nullptr : (const Variant **)argptrs, sizeof...(p_args));
 	}
 
 	Error push_callablep(const Callable &p_callable, const Variant **p_args, int p_argcount, bool p_show_error = false);
@@ -123,23 +190,41 @@ public:
 
 	template <typename... VarArgs>
 	Error push_callable(const Callable &p_callable, VarArgs... p_args) {
-		Variant args[sizeof...(p_args) + 1] = { p_args..., Variant() }; // +1 makes sure zero sized arrays are also supported.
-		const Variant *argptrs[sizeof...(p_args) + 1];
-		for (uint32_t i = 0; i < sizeof...(p_args); i++) {
-			argptrs[i] = &args[i];
+		// Small calls are the most common ones, don't build an array for them.
+		if constexpr (sizeof...(p_args) == 0) {
+			return push_callablep(p_callable, nullptr, 0);
+		} else if constexpr (sizeof...(p_args) == 1) {
+			const Variant arg = Variant(p_args...);
+			const Variant *argptr = &arg;
+			return push_callablep(p_callable, &argptr, 1);
+		} else {
+			Variant args[sizeof...(p_args)] = { p_args... };
+			const Variant *argptrs[sizeof...(p_args)];
+			for (uint32_t i = 0; i < sizeof...(p_args); i++) {
+				argptrs[i] = &args[i];
+			}
+			return push_callablep(p_callable, (const Variant **)argptrs, sizeof...(p_args));
 		}
-		return push_callablep(p_callable, sizeof...(p_args) == 0 ? nullptr : (const Variant **)argptrs, sizeof...(p_args));
 	}
 
 	Error push_callp(Object *p_object, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error = false);
 	template <typename... VarArgs>
 	Error push_call(Object *p_object, const StringName &p_method, VarArgs... p_args) {
-		Variant args[sizeof...(p_args) + 1] = { p_args..., Variant() }; // +1 makes sure zero sized arrays are also supported.
-		const Variant *argptrs[sizeof...(p_args) + 1];
-		for (uint32_t i = 0; i < sizeof...(p_args); i++) {
-			argptrs[i] = &args[i];
+		// Small calls are the most common ones, don't build an array for them.
+		if constexpr (sizeof...(p_args) == 0) {
+			return push_callp(p_object, p_method, nullptr, 0);
+		} else if constexpr (sizeof...(p_args) == 1) {
+			const Variant arg = Variant(p_args...);
+			const Variant *argptr = &arg;
+			return push_callp(p_object, p_method, &argptr, 1);
+		} else {
+			Variant args[sizeof...(p_args)] = { p_args... };
+			const Variant *argptrs[sizeof...(p_args)];
+			for (uint32_t i = 0; i < sizeof...(p_args); i++) {
+				argptrs[i] = &args[i];
+			}
+			return push_callp(p_object, p_method, (const Variant **)argptrs, sizeof...(p_args));
 		}
-		return push_callp(p_object, p_method, sizeof...(p_args) == 0 ? nullptr : (const Variant **)argptrs, sizeof...(p_args));
 	}
 
 	Error push_notification(Object *p_object, int p_notification);
@@ -153,6 +238,8 @@ public:
 
 	bool is_flushing() const;
 	int get_max_buffer_usage() const;
+	int get_sub_queue_count() const;
+	static int get_thread_sub_queue_count();
 
 	CallQueue(Allocator *p_custom_allocator = nullptr, uint32_t p_max_pages = 8192, const String &p_error_text = String());
 	virtual ~CallQueue();
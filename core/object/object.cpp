@@ -44,21 +44,6 @@
 
 #ifdef DEBUG_ENABLED
 
-struct _ObjectDebugLock {
-	ObjectID obj_id;
-
-	_ObjectDebugLock(Object *p_obj) {
-		obj_id = p_obj->get_instance_id();
-		p_obj->_lock_index.ref();
-	}
-	~_ObjectDebugLock() {
-		Object *obj_ptr = ObjectDB::get_instance(obj_id);
-		if (likely(obj_ptr)) {
-			obj_ptr->_lock_index.unref();
-		}
-	}
-};
-
 #define OBJ_DEBUG_LOCK _ObjectDebugLock _debug_lock(this);
 
 #else
@@ -1077,6 +1062,7 @@ void Object::add_user_signal(const MethodInfo &p_signal) {
 	SignalData s;
 	s.user = p_signal;
 	signal_map[p_signal.name] = s;
+	signal_map_version++;
 }
 
 bool Object::_has_user_signal(const StringName &p_name) const {
@@ -1098,6 +1084,7 @@ void Object::_remove_user_signal(const StringName &p_name) {
 	}
 
 	signal_map.erase(p_name);
+	signal_map_version++;
 }
 
 Error Object::_emit_signal(const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
@@ -1128,6 +1115,65 @@ Error Object::_emit_signal(const Variant **p_args, int p_argcount, Callable::Cal
 	return emit_signalp(signal, args, argc);
 }
 
+Object::SignalData::Snapshot *Object::SignalData::get_snapshot() {
+	Snapshot *current = snapshot.load(std::memory_order_acquire);
+	if (!current) {
+		Snapshot *created = memnew(Snapshot);
+		created->refcount.init(); // Held by this SignalData.
+		created->entries.resize(slot_map.size());
+		uint32_t i = 0;
+		for (const KeyValue<Callable, Slot> &slot_kv : slot_map) {
+			Snapshot::Entry &entry = created->entries[i++];
+			entry.callable = slot_kv.value.conn.callable;
+			entry.flags = slot_kv.value.conn.flags;
+			created->has_one_shot |= bool(entry.flags & CONNECT_ONE_SHOT);
+		}
+
+		// Another thread emitting at the same time may have published one first, use that instead.
+		if (snapshot.compare_exchange_strong(current, created, std::memory_order_acq_rel, std::memory_order_acquire)) {
+			current = created;
+		} else {
+			memdelete(created);
+		}
+	}
+
+	current->refcount.ref();
+	return current;
+}
+
+void Object::SignalData::invalidate_snapshot() {
+	Snapshot *current = snapshot.exchange(nullptr, std::memory_order_acq_rel);
+	if (current) {
+		unref_snapshot(current);
+	}
+}
+
+void Object::SignalData::unref_snapshot(Snapshot *p_snapshot) {
+	if (p_snapshot->refcount.unref()) {
+		memdelete(p_snapshot);
+	}
+}
+
+Object::SignalData::SignalData(const SignalData &p_from) :
+		user(p_from.user),
+		slot_map(p_from.slot_map),
+		removable(p_from.removable) {
+}
+
+Object::SignalData &Object::SignalData::operator=(const SignalData &p_from) {
+	if (this != &p_from) {
+		invalidate_snapshot();
+		user = p_from.user;
+		slot_map = p_from.slot_map;
+		removable = p_from.removable;
+	}
+	return *this;
+}
+
+Object::SignalData::~SignalData() {
+	invalidate_snapshot();
+}
+
 Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int p_argcount) {
 	if (_block_signals) {
 		return ERR_CANT_ACQUIRE_RESOURCE; //no emit, signals blocked
@@ -1144,35 +1190,61 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 		return ERR_UNAVAILABLE;
 	}
 
+	return _emit_signal_data(p_name, s, p_args, p_argcount);
+}
+
+Error Object::emit_signal_handlep(SignalHandle &p_handle, const Variant **p_args, int p_argcount) {
+	if (_block_signals) {
+		return ERR_CANT_ACQUIRE_RESOURCE; //no emit, signals blocked
+	}
+
+	if (unlikely(p_handle.version != signal_map_version || p_handle.owner != _instance_id)) {
+		p_handle.data = signal_map.getptr(p_handle.name);
+		p_handle.owner = _instance_id;
+		p_handle.version = signal_map_version;
+#ifdef DEBUG_ENABLED
+		if (!p_handle.data) {
+			// Only checked when resolving, the handle stays valid until something is connected.
+			bool signal_is_valid = ClassDB::has_signal(get_class_name(), p_handle.name);
+			ERR_FAIL_COND_V_MSG(!signal_is_valid && !script.is_null() && !Ref<Script>(script)->has_script_signal(p_handle.name), ERR_UNAVAILABLE, vformat("Can't emit non-existing signal \"%s\".", p_handle.name));
+		}
+#endif
+	}
+
+	if (!p_handle.data) {
+		//not connected? just return
+		return ERR_UNAVAILABLE;
+	}
+
+	return _emit_signal_data(p_handle.name, p_handle.data, p_args, p_argcount);
+}
+
+Error Object::_emit_signal_data(const StringName &p_name, SignalData *p_signal_data, const Variant **p_args, int p_argcount) {
 	// If this is a ref-counted object, prevent it from being destroyed during signal emission,
 	// which is needed in certain edge cases; e.g., https://github.com/godotengine/godot/issues/73889.
 	Ref<RefCounted> rc = Ref<RefCounted>(Object::cast_to<RefCounted>(this));
 
 	// Ensure that disconnecting the signal or even deleting the object
 	// will not affect the signal calling.
-	Callable *slot_callables = (Callable *)alloca(sizeof(Callable) * s->slot_map.size());
-	uint32_t *slot_flags = (uint32_t *)alloca(sizeof(uint32_t) * s->slot_map.size());
-	uint32_t slot_count = 0;
-
-	for (const KeyValue<Callable, SignalData::Slot> &slot_kv : s->slot_map) {
-		memnew_placement(&slot_callables[slot_count], Callable(slot_kv.value.conn.callable));
-		slot_flags[slot_count] = slot_kv.value.conn.flags;
-		++slot_count;
-	}
+	SignalData::Snapshot *snapshot = p_signal_data->get_snapshot();
+	const SignalData::Snapshot::Entry *entries = snapshot->entries.ptr();
+	const uint32_t slot_count = snapshot->entries.size();
 
-	DEV_ASSERT(slot_count == s->slot_map.size());
+	DEV_ASSERT(slot_count == p_signal_data->slot_map.size());
 
 	// Disconnect all one-shot connections before emitting to prevent recursion.
-	for (uint32_t i = 0; i < slot_count; ++i) {
-		bool disconnect = slot_flags[i] & CONNECT_ONE_SHOT;
+	if (snapshot->has_one_shot) {
+		for (uint32_t i = 0; i < slot_count; ++i) {
+			bool disconnect = entries[i].flags & CONNECT_ONE_SHOT;
 #ifdef TOOLS_ENABLED
-		if (disconnect && (slot_flags[i] & CONNECT_PERSIST) && Engine::get_singleton()->is_editor_hint()) {
-			// This signal was connected from the editor, and is being edited. Just don't disconnect for now.
-			disconnect = false;
-		}
+			if (disconnect && (entries[i].flags & CONNECT_PERSIST) && Engine::get_singleton()->is_editor_hint()) {
+				// This signal was connected from the editor, and is being edited. Just don't disconnect for now.
+				disconnect = false;
+			}
 #endif
-		if (disconnect) {
-			_disconnect(p_name, slot_callables[i]);
+			if (disconnect) {
+				_disconnect(p_name, entries[i].callable);
+			}
 		}
 	}
 
@@ -1181,8 +1253,8 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 	Error err = OK;
 
 	for (uint32_t i = 0; i < slot_count; ++i) {
-		const Callable &callable = slot_callables[i];
-		const uint32_t &flags = slot_flags[i];
+		const Callable &callable = entries[i].callable;
+		const uint32_t &flags = entries[i].flags;
 
 		if (!callable.is_valid()) {
 			// Target might have been deleted during signal callback, this is expected and OK.
@@ -1218,9 +1290,7 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 		}
 	}
 
-	for (uint32_t i = 0; i < slot_count; ++i) {
-		slot_callables[i].~Callable();
-	}
+	SignalData::unref_snapshot(snapshot);
 
 	return err;
 }
@@ -1405,6 +1475,7 @@ Error Object::connect(const StringName &p_signal, const Callable &p_callable, ui
 
 		signal_map[p_signal] = SignalData();
 		s = &signal_map[p_signal];
+		signal_map_version++;
 	}
 
 	//compare with the base callable, so binds can be ignored
@@ -1435,6 +1506,7 @@ Error Object::connect(const StringName &p_signal, const Callable &p_callable, ui
 
 	//use callable version as key, so binds can be ignored
 	s->slot_map[*p_callable.get_base_comparator()] = slot;
+	s->invalidate_snapshot();
 
 	return OK;
 }
@@ -1510,10 +1582,12 @@ bool Object::_disconnect(const StringName &p_signal, const Callable &p_callable,
 	}
 
 	s->slot_map.erase(*p_callable.get_base_comparator());
+	s->invalidate_snapshot();
 
 	if (s->slot_map.is_empty() && ClassDB::has_signal(get_class_name(), p_signal)) {
 		//not user signal, delete
 		signal_map.erase(p_signal);
+		signal_map_version++;
 	}
 
 	return true;
@@ -2146,6 +2220,7 @@ Object::~Object() {
 		}
 
 		signal_map.erase(E.key);
+		signal_map_version++;
 	}
 
 	// Disconnect signals that connect to this object.
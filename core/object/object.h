@@ -42,6 +42,7 @@
 #include "core/templates/list.h"
 #include "core/templates/rb_map.h"
 #include "core/templates/safe_refcount.h"
+#include "core/templates/swiss_hash_map.h"
 #include "core/variant/callable_bind.h"
 #include "core/variant/variant.h"
 
@@ -588,6 +589,31 @@ public:
 		Connection(const Variant &p_variant);
 	};
 
+private:
+	struct SignalData;
+
+public:
+	// Resolves a signal once and keeps it until the connections of the object change, so repeated
+	// emissions through emit_signal_handle() don't need to hash the name. Valid for any object, it's
+	// re-resolved when used with a different one. The owner is kept by ID, which is never reused,
+	// so a new object allocated where a freed one was doesn't match.
+	struct SignalHandle {
+	private:
+		friend class Object;
+
+		StringName name;
+		ObjectID owner;
+		SignalData *data = nullptr;
+		uint32_t version = 0;
+
+	public:
+		_FORCE_INLINE_ const StringName &get_name() const { return name; }
+
+		SignalHandle() {}
+		SignalHandle(const StringName &p_name) :
+				name(p_name) {}
+	};
+
 private:
 #ifdef DEBUG_ENABLED
 	friend struct _ObjectDebugLock;
@@ -605,12 +631,38 @@ private:
 			List<Connection>::Element *cE = nullptr;
 		};
 
+		// Flat copy of the slots, built on the first emission after they change. Emitters hold a
+		// reference while walking it, so connections can be changed (or the object freed) meanwhile.
+		// Several threads may emit the same signal, so the first one to build it publishes it atomically.
+		// It's only dropped when connections change, which must not happen while other threads emit.
+		struct Snapshot {
+			struct Entry {
+				Callable callable;
+				uint32_t flags = 0;
+			};
+
+			LocalVector<Entry> entries;
+			SafeRefCount refcount;
+			bool has_one_shot = false;
+		};
+
 		MethodInfo user;
 		HashMap<Callable, Slot, HashableHasher<Callable>> slot_map;
+		std::atomic<Snapshot *> snapshot = { nullptr };
 		bool removable = false;
+
+		Snapshot *get_snapshot();
+		void invalidate_snapshot();
+		static void unref_snapshot(Snapshot *p_snapshot);
+
+		SignalData() {}
+		SignalData(const SignalData &p_from);
+		SignalData &operator=(const SignalData &p_from);
+		~SignalData();
 	};
 
-	HashMap<StringName, SignalData> signal_map;
+	SwissHashMap<StringName, SignalData> signal_map;
+	uint32_t signal_map_version = 1; // Changes when entries are added or removed, invalidating SignalHandles.
 	List<Connection> connections;
 #ifdef DEBUG_ENABLED
 	SafeRefCount _lock_index;
@@ -638,6 +690,7 @@ private:
 	bool _has_user_signal(const StringName &p_name) const;
 	void _remove_user_signal(const StringName &p_name);
 	Error _emit_signal(const Variant **p_args, int p_argcount, Callable::CallError &r_error);
+	Error _emit_signal_data(const StringName &p_name, SignalData *p_signal_data, const Variant **p_args, int p_argcount);
 	TypedArray<Dictionary> _get_signal_list() const;
 	TypedArray<Dictionary> _get_signal_connection_list(const StringName &p_signal) const;
 	TypedArray<Dictionary> _get_incoming_connections() const;
@@ -898,6 +951,8 @@ public:
 
 #ifdef TOOLS_ENABLED
 	void set_edited(bool p_edited);
+	// Flags the object as edited the way `set()` does, without bumping the edited version.
+	_FORCE_INLINE_ void mark_edited() { _edited = true; }
 	bool is_edited() const;
 	// This function is used to check when something changed beyond a point, it's used mainly for generating previews.
 	uint32_t get_edited_version() const;
@@ -922,6 +977,18 @@ public:
 	}
 
 	MTVIRTUAL Error emit_signalp(const StringName &p_name, const Variant **p_args, int p_argcount);
+
+	template <typename... VarArgs>
+	Error emit_signal_handle(SignalHandle &p_handle, VarArgs... p_args) {
+		Variant args[sizeof...(p_args) + 1] = { p_args..., Variant() }; // +1 makes sure zero sized arrays are also supported.
+		const Variant *argptrs[sizeof...(p_args) + 1];
+		for (uint32_t i = 0; i < sizeof...(p_args); i++) {
+			argptrs[i] = &args[i];
+		}
+		return emit_signal_handlep(p_handle, sizeof...(p_args) == 0 ? nullptr : (const Variant **)argptrs, sizeof...(p_args));
+	}
+
+	MTVIRTUAL Error emit_signal_handlep(SignalHandle &p_handle, const Variant **p_args, int p_argcount);
 	MTVIRTUAL bool has_signal(const StringName &p_name) const;
 	MTVIRTUAL void get_signal_list(List<MethodInfo> *p_signals) const;
 	MTVIRTUAL void get_signal_connection_list(const StringName &p_signal, List<Connection> *p_connections) const;
@@ -1054,4 +1121,24 @@ public:
 	static int get_object_count();
 };
 
+#ifdef DEBUG_ENABLED
+
+// Keeps an object from being freed while one of its methods runs, for callers that bypass `Object::callp()`.
+struct _ObjectDebugLock {
+	ObjectID obj_id;
+
+	_ObjectDebugLock(Object *p_obj) {
+		obj_id = p_obj->get_instance_id();
+		p_obj->_lock_index.ref();
+	}
+	~_ObjectDebugLock() {
+		Object *obj_ptr = ObjectDB::get_instance(obj_id);
+		if (likely(obj_ptr)) {
+			obj_ptr->_lock_index.unref();
+		}
+	}
+};
+
+#endif
+
 #endif // OBJECT_H
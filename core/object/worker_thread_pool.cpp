@@ -86,6 +86,10 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 	bool low_priority = p_task->low_priority;
 #endif
 
+	MemoryTagScope memory_tag_scope(p_task->memory_tag);
+
+	LocalVector<Task *> ready_tasks; // Dependents released by the completion of this task or group.
+
 	if (p_task->group) {
 		// Handling a group
 		bool do_post = false;
@@ -119,6 +123,10 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 		if (do_post) {
 			p_task->group->done_semaphore.post();
 			p_task->group->completed.set_to(true);
+
+			// Dependents registered before the flag was set must be released here; later ones will see it.
+			MutexLock task_lock(task_mutex);
+			_release_dependents(p_task->group->dependents, ready_tasks);
 		}
 		uint32_t max_users = p_task->group->tasks_used + 1; // Add 1 because the thread waiting for it is also user. Read before to avoid another thread freeing task after increment.
 		uint32_t finished_users = p_task->group->finished.increment();
@@ -146,6 +154,7 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 		task_mutex.lock();
 		p_task->completed = true;
 		p_task->pool_thread_index = -1;
+		_release_dependents(p_task->dependents, ready_tasks);
 		if (p_task->waiting_user) {
 			p_task->done_semaphore.post(p_task->waiting_user);
 		}
@@ -177,14 +186,19 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 	set_current_thread_safe_for_nodes(safe_for_nodes_backup);
 	MessageQueue::set_thread_singleton_override(call_queue_backup);
 #endif
+
+	if (!ready_tasks.is_empty()) {
+		_post_ready_tasks(ready_tasks);
+	}
 }
 
 void WorkerThreadPool::_thread_function(void *p_user) {
 	ThreadData *thread_data = (ThreadData *)p_user;
 
 	while (true) {
-		Task *task_to_process = nullptr;
-		{
+		// Local and stolen tasks can be taken without touching the task mutex.
+		Task *task_to_process = singleton->_pop_local_or_steal(thread_data);
+		if (!task_to_process) {
 			MutexLock lock(singleton->task_mutex);
 
 			bool exit = singleton->_handle_runlevel(thread_data, lock);
@@ -197,9 +211,10 @@ void WorkerThreadPool::_thread_function(void *p_user) {
 			if (singleton->task_queue.first()) {
 				task_to_process = singleton->task_queue.first()->self();
 				singleton->task_queue.remove(singleton->task_queue.first());
-			} else {
+			} else if (singleton->_are_local_queues_empty()) {
 				thread_data->cond_var.wait(lock);
 			}
+			// Otherwise, some task was pushed to a local queue in the meantime. Loop again to steal it.
 		}
 
 		if (task_to_process) {
@@ -234,7 +249,10 @@ void WorkerThreadPool::_post_tasks(Task **p_tasks, uint32_t p_count, bool p_high
 	for (uint32_t i = 0; i < p_count; i++) {
 		p_tasks[i]->low_priority = !p_high_priority;
 		if (p_high_priority || low_priority_threads_used < max_low_priority_threads) {
-			task_queue.add_last(&p_tasks[i]->task_elem);
+			// Pool threads keep what they post in their own queue, so it can be popped (or stolen) without locking.
+			if (!caller_pool_thread || !caller_pool_thread->local_queue.push(p_tasks[i])) {
+				task_queue.add_last(&p_tasks[i]->task_elem);
+			}
 			if (!p_high_priority) {
 				low_priority_threads_used++;
 			}
@@ -325,11 +343,107 @@ bool WorkerThreadPool::_try_promote_low_priority_task() {
 	}
 }
 
+WorkerThreadPool::Task *WorkerThreadPool::_pop_local_or_steal(ThreadData *p_thread_data) {
+	Task *task = nullptr;
+	if (p_thread_data->local_queue.pop(task)) {
+		return task;
+	}
+
+	uint32_t thread_count = threads.size();
+	for (uint32_t i = 1; i < thread_count; i++) {
+		ThreadData &victim = threads[(p_thread_data->index + i) % thread_count];
+		while (true) {
+			WorkStealingQueue<Task *>::StealResult result = victim.local_queue.steal(task);
+			if (result == WorkStealingQueue<Task *>::STEAL_OK) {
+				return task;
+			} else if (result == WorkStealingQueue<Task *>::STEAL_EMPTY) {
+				break;
+			}
+			// Lost a race, so there may be more; try again.
+		}
+	}
+
+	return nullptr;
+}
+
+bool WorkerThreadPool::_are_local_queues_empty() const {
+	for (uint32_t i = 0; i < threads.size(); i++) {
+		if (!threads[i].local_queue.is_empty()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Must be called with the task mutex held. Returns the number of dependencies still pending.
+uint32_t WorkerThreadPool::_register_dependencies(Task *p_dependent, const LocalVector<TaskID> &p_dependencies) {
+	for (const TaskID &dependency_id : p_dependencies) {
+		Task **taskp = tasks.getptr(dependency_id);
+		if (taskp) {
+			if (!(*taskp)->completed) {
+				(*taskp)->dependents.push_back(p_dependent);
+				p_dependent->pending_dependencies++;
+			}
+			continue;
+		}
+
+		Group **groupp = groups.getptr(dependency_id);
+		if (groupp) {
+			if (!(*groupp)->completed.is_set()) {
+				(*groupp)->dependents.push_back(p_dependent);
+				p_dependent->pending_dependencies++;
+			}
+			continue;
+		}
+
+		ERR_PRINT(vformat("Invalid Task or Group ID used as a dependency: %d.", dependency_id));
+	}
+	return p_dependent->pending_dependencies;
+}
+
+// Must be called with the task mutex held.
+void WorkerThreadPool::_release_dependents(LocalVector<Task *> &p_dependents, LocalVector<Task *> &r_ready_tasks) {
+	for (Task *dependent : p_dependents) {
+		DEV_ASSERT(dependent->pending_dependencies > 0);
+		dependent->pending_dependencies--;
+		if (dependent->pending_dependencies == 0) {
+			if (dependent->group) {
+				for (Task *group_task : dependent->group->deferred_tasks) {
+					r_ready_tasks.push_back(group_task);
+				}
+				dependent->group->deferred_tasks.reset();
+			} else {
+				r_ready_tasks.push_back(dependent);
+			}
+		}
+	}
+	p_dependents.reset();
+}
+
+void WorkerThreadPool::_post_ready_tasks(LocalVector<Task *> &p_ready_tasks) {
+	MutexLock<BinaryMutex> lock(task_mutex);
+
+	// Post runs of tasks with the same priority together.
+	uint32_t from = 0;
+	while (from < p_ready_tasks.size()) {
+		uint32_t to = from + 1;
+		while (to < p_ready_tasks.size() && p_ready_tasks[to]->low_priority == p_ready_tasks[from]->low_priority) {
+			to++;
+		}
+		_post_tasks(&p_ready_tasks[from], to - from, !p_ready_tasks[from]->low_priority, lock);
+		from = to;
+	}
+}
+
 WorkerThreadPool::TaskID WorkerThreadPool::add_native_task(void (*p_func)(void *), void *p_userdata, bool p_high_priority, const String &p_description) {
 	return _add_task(Callable(), p_func, p_userdata, nullptr, p_high_priority, p_description);
 }
 
-WorkerThreadPool::TaskID WorkerThreadPool::_add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description) {
+WorkerThreadPool::TaskID WorkerThreadPool::add_native_task_after(const LocalVector<TaskID> &p_dependencies, void (*p_func)(void *), void *p_userdata, bool p_high_priority, const String &p_description) {
+	return _add_task(Callable(), p_func, p_userdata, nullptr, p_high_priority, p_description, &p_dependencies);
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::_add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description, const LocalVector<TaskID> *p_dependencies) {
 	MutexLock<BinaryMutex> lock(task_mutex);
 
 	// Get a free task
@@ -340,9 +454,16 @@ WorkerThreadPool::TaskID WorkerThreadPool::_add_task(const Callable &p_callable,
 	task->native_func = p_func;
 	task->native_func_userdata = p_userdata;
 	task->description = p_description;
+	task->memory_tag = Memory::get_current_tag();
 	task->template_userdata = p_template_userdata;
+	task->low_priority = !p_high_priority; // Kept in case posting is deferred.
 	tasks.insert(id, task);
 
+	if (p_dependencies && _register_dependencies(task, *p_dependencies) > 0) {
+		// Will be posted by the last dependency to complete.
+		return id;
+	}
+
 	_post_tasks(&task, 1, p_high_priority, lock);
 
 	return id;
@@ -480,7 +601,7 @@ void WorkerThreadPool::_wait_collaboratively(ThreadData *p_caller_pool_thread, T
 				if (was_signaled) {
 					// This thread was awaken for some additional reason, but it's about to exit.
 					// Let's find out what may be pending and forward the requests.
-					uint32_t to_process = task_queue.first() ? 1 : 0;
+					uint32_t to_process = (task_queue.first() || !_are_local_queues_empty()) ? 1 : 0;
 					uint32_t to_promote = p_caller_pool_thread->current_task->low_priority && low_priority_task_queue.first() ? 1 : 0;
 					if (to_process || to_promote) {
 						// This thread must be left alone since it won't loop again.
@@ -498,7 +619,8 @@ void WorkerThreadPool::_wait_collaboratively(ThreadData *p_caller_pool_thread, T
 				}
 			}
 
-			if (singleton->task_queue.first()) {
+			task_to_process = _pop_local_or_steal(p_caller_pool_thread);
+			if (!task_to_process && task_queue.first()) {
 				task_to_process = task_queue.first()->self();
 				task_queue.remove(task_queue.first());
 			}
@@ -544,7 +666,7 @@ bool WorkerThreadPool::_handle_runlevel(ThreadData *p_thread_data, MutexLock<Bin
 		} break;
 		case RUNLEVEL_PRE_EXIT_LANGUAGES: {
 			if (!p_thread_data->pre_exited_languages) {
-				if (!task_queue.first() && !low_priority_task_queue.first()) {
+				if (!task_queue.first() && !low_priority_task_queue.first() && _are_local_queues_empty()) {
 					p_thread_data->pre_exited_languages = true;
 					runlevel_data.pre_exit_languages.num_idle_threads++;
 					control_cond_var.notify_all();
@@ -607,7 +729,7 @@ void WorkerThreadPool::notify_yield_over(TaskID p_task_id) {
 	td.cond_var.notify_one();
 }
 
-WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description) {
+WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description, const LocalVector<TaskID> *p_dependencies) {
 	ERR_FAIL_COND_V(p_elements < 0, INVALID_TASK_ID);
 	if (p_tasks < 0) {
 		p_tasks = MAX(1u, threads.size());
@@ -642,9 +764,20 @@ WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_ca
 			task->group = group;
 			task->callable = p_callable;
 			task->template_userdata = p_template_userdata;
+			task->memory_tag = Memory::get_current_tag();
+			task->low_priority = !p_high_priority; // Kept in case posting is deferred.
 			tasks_posted[i] = task;
 			// No task ID is used.
 		}
+
+		// A group with no elements is complete right away, so it can't wait for dependencies.
+		if (p_dependencies && _register_dependencies(tasks_posted[0], *p_dependencies) > 0) {
+			// Will be posted by the last dependency to complete.
+			for (int i = 0; i < p_tasks; i++) {
+				group->deferred_tasks.push_back(tasks_posted[i]);
+			}
+			p_tasks = 0;
+		}
 	}
 
 	groups[id] = group;
@@ -658,6 +791,10 @@ WorkerThreadPool::GroupID WorkerThreadPool::add_native_group_task(void (*p_func)
 	return _add_group_task(Callable(), p_func, p_userdata, nullptr, p_elements, p_tasks, p_high_priority, p_description);
 }
 
+WorkerThreadPool::GroupID WorkerThreadPool::add_native_group_task_after(const LocalVector<TaskID> &p_dependencies, void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description) {
+	return _add_group_task(Callable(), p_func, p_userdata, nullptr, p_elements, p_tasks, p_high_priority, p_description, &p_dependencies);
+}
+
 WorkerThreadPool::GroupID WorkerThreadPool::add_group_task(const Callable &p_action, int p_elements, int p_tasks, bool p_high_priority, const String &p_description) {
 	return _add_group_task(p_action, nullptr, nullptr, nullptr, p_elements, p_tasks, p_high_priority, p_description);
 }
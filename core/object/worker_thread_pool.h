@@ -41,6 +41,7 @@
 #include "core/templates/paged_allocator.h"
 #include "core/templates/rid.h"
 #include "core/templates/safe_refcount.h"
+#include "core/templates/work_stealing_queue.h"
 
 class WorkerThreadPool : public Object {
 	BRCLASS(WorkerThreadPool, Object)
@@ -70,6 +71,8 @@ private:
 		SafeFlag completed;
 		SafeNumeric<uint32_t> finished;
 		uint32_t tasks_used = 0;
+		LocalVector<Task *> dependents; // Tasks (or heads of groups) to release on completion.
+		LocalVector<Task *> deferred_tasks; // The tasks of this group, while it has dependencies pending.
 	};
 
 	struct Task {
@@ -89,6 +92,9 @@ private:
 		bool low_priority = false;
 		BaseTemplateUserdata *template_userdata = nullptr;
 		int pool_thread_index = -1;
+		LocalVector<Task *> dependents; // Tasks (or heads of groups) to release on completion.
+		uint32_t pending_dependencies = 0; // For a group, this is kept in its first task.
+		Memory::Tag memory_tag = Memory::TAG_UNTAGGED; // Inherited from the thread that added the task.
 
 		void free_template_userdata();
 		Task() :
@@ -104,7 +110,7 @@ private:
 	PagedAllocator<Group, false, GROUPS_PAGE_SIZE> group_allocator;
 
 	SelfList<Task>::List low_priority_task_queue;
-	SelfList<Task>::List task_queue;
+	SelfList<Task>::List task_queue; // Shared queue, for tasks posted from outside the pool (or overflowing a local queue).
 
 	BinaryMutex task_mutex;
 
@@ -120,6 +126,9 @@ private:
 		Task *current_task = nullptr;
 		Task *awaited_task = nullptr; // Null if not awaiting the condition variable, or special value (YIELDING).
 		ConditionVariable cond_var;
+		// Tasks posted from this thread. Pushed only by it (under the task mutex, so sleepers can't miss them),
+		// but popped by it and stolen by the other pool threads without locking.
+		WorkStealingQueue<Task *> local_queue;
 
 		ThreadData() :
 				signaled(false),
@@ -176,6 +185,9 @@ private:
 
 	bool _try_promote_low_priority_task();
 
+	Task *_pop_local_or_steal(ThreadData *p_thread_data);
+	bool _are_local_queues_empty() const;
+
 	static WorkerThreadPool *singleton;
 
 #ifdef THREADS_ENABLED
@@ -187,8 +199,12 @@ private:
 	static thread_local UnlockableLocks unlockable_locks[MAX_UNLOCKABLE_LOCKS];
 #endif
 
-	TaskID _add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description);
-	GroupID _add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description);
+	TaskID _add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description, const LocalVector<TaskID> *p_dependencies = nullptr);
+	GroupID _add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description, const LocalVector<TaskID> *p_dependencies = nullptr);
+
+	uint32_t _register_dependencies(Task *p_dependent, const LocalVector<TaskID> &p_dependencies);
+	void _release_dependents(LocalVector<Task *> &p_dependents, LocalVector<Task *> &r_ready_tasks);
+	void _post_ready_tasks(LocalVector<Task *> &p_ready_tasks);
 
 	template <typename C, typename M, typename U>
 	struct TaskUserData : public BaseTemplateUserdata {
@@ -255,6 +271,32 @@ public:
 	}
 	GroupID add_native_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String());
 	GroupID add_group_task(const Callable &p_action, int p_elements, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String());
+
+	// Dependent tasks and groups are only queued once every task and group in `p_dependencies` has completed,
+	// so a chain of phases can be submitted at once, instead of the caller blocking between them.
+	// Every task and group still has to be waited for, to release it. Once a dependent has completed,
+	// its dependencies have too, so waiting for them afterwards doesn't block.
+	template <typename C, typename M, typename U>
+	TaskID add_template_task_after(const LocalVector<TaskID> &p_dependencies, C *p_instance, M p_method, U p_userdata, bool p_high_priority = false, const String &p_description = String()) {
+		typedef TaskUserData<C, M, U> TUD;
+		TUD *ud = memnew(TUD);
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+		return _add_task(Callable(), nullptr, nullptr, ud, p_high_priority, p_description, &p_dependencies);
+	}
+	TaskID add_native_task_after(const LocalVector<TaskID> &p_dependencies, void (*p_func)(void *), void *p_userdata, bool p_high_priority = false, const String &p_description = String());
+
+	template <typename C, typename M, typename U>
+	GroupID add_template_group_task_after(const LocalVector<TaskID> &p_dependencies, C *p_instance, M p_method, U p_userdata, int p_elements, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String()) {
+		typedef GroupUserData<C, M, U> GroupUD;
+		GroupUD *ud = memnew(GroupUD);
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+		return _add_group_task(Callable(), nullptr, nullptr, ud, p_elements, p_tasks, p_high_priority, p_description, &p_dependencies);
+	}
+	GroupID add_native_group_task_after(const LocalVector<TaskID> &p_dependencies, void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String());
 	uint32_t get_group_processed_element_count(GroupID p_group) const;
 	bool is_group_task_completed(GroupID p_group) const;
 	void wait_for_group_task_completion(GroupID p_group);
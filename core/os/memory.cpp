@@ -32,6 +32,7 @@
 #include "memory.h"
 
 #include "core/error/error_macros.h"
+#include "core/os/spin_lock.h"
 #include "core/templates/safe_refcount.h"
 
 #include <stdio.h>
@@ -67,6 +68,90 @@ SafeNumeric<uint64_t> Memory::max_usage;
 
 SafeNumeric<uint64_t> Memory::alloc_count;
 
+#ifdef MEMORY_TAGS_ENABLED
+thread_local Memory::Tag Memory::current_tag = Memory::TAG_UNTAGGED;
+
+// Every thread counts its own allocations, so allocating never writes to a cache line another
+// thread uses, and readers sum the counters of all threads. Only the owning thread writes its
+// counters, so plain loads and stores are enough. Memory freed by another thread than the one that
+// allocated it is subtracted from the counters of the freeing thread, so a single thread's usage
+// may be negative.
+//
+// All of this is constant initialized and trivially destructible, as memory is allocated before
+// and after any dynamic initialization or destruction.
+struct MemoryTagThreadCounters {
+	std::atomic<int64_t> usage[Memory::TAG_MAX] = {};
+	std::atomic<uint64_t> allocs[Memory::TAG_MAX] = {};
+	MemoryTagThreadCounters *prev = nullptr;
+	MemoryTagThreadCounters *next = nullptr;
+	bool registered = false;
+	bool retired = false;
+};
+
+static SpinLock tag_threads_lock;
+static MemoryTagThreadCounters *tag_threads = nullptr;
+// Counters of the threads that exited.
+static std::atomic<int64_t> retired_tag_usage[Memory::TAG_MAX] = {};
+static std::atomic<uint64_t> retired_tag_allocs[Memory::TAG_MAX] = {};
+
+static thread_local MemoryTagThreadCounters thread_tag_counters;
+
+// Folds the counters of a thread into the retired ones when it exits.
+struct MemoryTagThreadExit {
+	bool armed = false;
+
+	~MemoryTagThreadExit() {
+		MemoryTagThreadCounters &counters = thread_tag_counters;
+		tag_threads_lock.lock();
+		for (int i = 0; i < Memory::TAG_MAX; i++) {
+			retired_tag_usage[i].fetch_add(counters.usage[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+			retired_tag_allocs[i].fetch_add(counters.allocs[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+		if (counters.prev) {
+			counters.prev->next = counters.next;
+		} else {
+			tag_threads = counters.next;
+		}
+		if (counters.next) {
+			counters.next->prev = counters.prev;
+		}
+		counters.registered = false;
+		counters.retired = true;
+		tag_threads_lock.unlock();
+	}
+};
+
+static thread_local MemoryTagThreadExit thread_tag_exit;
+
+void Memory::_tag_counters_add(Tag p_tag, int64_t p_usage, uint64_t p_allocs) {
+	MemoryTagThreadCounters &counters = thread_tag_counters;
+	if (unlikely(!counters.registered)) {
+		if (counters.retired) {
+			// Allocations made by thread local destructors that run after ours.
+			retired_tag_usage[p_tag].fetch_add(p_usage, std::memory_order_relaxed);
+			retired_tag_allocs[p_tag].fetch_add(p_allocs, std::memory_order_relaxed);
+			return;
+		}
+
+		// Using the exit guard constructs it, so it's destroyed when the thread exits.
+		thread_tag_exit.armed = true;
+		tag_threads_lock.lock();
+		counters.next = tag_threads;
+		if (tag_threads) {
+			tag_threads->prev = &counters;
+		}
+		tag_threads = &counters;
+		counters.registered = true;
+		tag_threads_lock.unlock();
+	}
+
+	counters.usage[p_tag].store(counters.usage[p_tag].load(std::memory_order_relaxed) + p_usage, std::memory_order_relaxed);
+	if (p_allocs) {
+		counters.allocs[p_tag].store(counters.allocs[p_tag].load(std::memory_order_relaxed) + p_allocs, std::memory_order_relaxed);
+	}
+}
+#endif
+
 inline bool is_power_of_2(size_t x) { return x && ((x & (x - 1U)) == 0U); }
 
 void *Memory::alloc_aligned_static(size_t p_bytes, size_t p_alignment) {
@@ -100,7 +185,7 @@ void Memory::free_aligned_static(void *p_memory) {
 }
 
 void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
-#ifdef DEBUG_ENABLED
+#ifdef MEMORY_TAGS_ENABLED
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
@@ -116,7 +201,13 @@ void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 		uint8_t *s8 = (uint8_t *)mem;
 
 		uint64_t *s = (uint64_t *)(s8 + SIZE_OFFSET);
+#ifdef MEMORY_TAGS_ENABLED
+		const Tag tag = current_tag;
+		*s = p_bytes | (uint64_t(tag) << TAG_SHIFT);
+		_tag_counters_add(tag, p_bytes, 1);
+#else
 		*s = p_bytes;
+#endif
 
 #ifdef DEBUG_ENABLED
 		uint64_t new_mem_usage = mem_usage.add(p_bytes);
@@ -135,7 +226,7 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 
 	uint8_t *mem = (uint8_t *)p_memory;
 
-#ifdef DEBUG_ENABLED
+#ifdef MEMORY_TAGS_ENABLED
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
@@ -145,34 +236,48 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 		mem -= DATA_OFFSET;
 		uint64_t *s = (uint64_t *)(mem + SIZE_OFFSET);
 
+#ifdef MEMORY_TAGS_ENABLED
+		// The allocation stays attributed to the subsystem that made it.
+		const uint64_t tag_bits = *s & ~SIZE_MASK;
+		const uint64_t old_bytes = *s & SIZE_MASK;
+		_tag_counters_add(Tag(tag_bits >> TAG_SHIFT), int64_t(p_bytes) - int64_t(old_bytes), 0);
+#else
+		const uint64_t tag_bits = 0;
+#endif
+
 #ifdef DEBUG_ENABLED
-		if (p_bytes > *s) {
-			uint64_t new_mem_usage = mem_usage.add(p_bytes - *s);
+		if (p_bytes > old_bytes) {
+			uint64_t new_mem_usage = mem_usage.add(p_bytes - old_bytes);
 			max_usage.exchange_if_greater(new_mem_usage);
 		} else {
-			mem_usage.sub(*s - p_bytes);
+			mem_usage.sub(old_bytes - p_bytes);
 		}
 #endif
 
 		if (p_bytes == 0) {
+			alloc_count.decrement();
 			free(mem);
 			return nullptr;
 		} else {
-			*s = p_bytes;
-
 			mem = (uint8_t *)realloc(mem, p_bytes + DATA_OFFSET);
 			ERR_FAIL_NULL_V(mem, nullptr);
 
 			s = (uint64_t *)(mem + SIZE_OFFSET);
 
-			*s = p_bytes;
+			*s = p_bytes | tag_bits;
 
 			return mem + DATA_OFFSET;
 		}
 	} else {
+		if (p_bytes == 0) {
+			alloc_count.decrement();
+			free(mem);
+			return nullptr;
+		}
+
 		mem = (uint8_t *)realloc(mem, p_bytes);
 
-		ERR_FAIL_COND_V(mem == nullptr && p_bytes > 0, nullptr);
+		ERR_FAIL_NULL_V(mem, nullptr);
 
 		return mem;
 	}
@@ -183,7 +288,7 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 
 	uint8_t *mem = (uint8_t *)p_ptr;
 
-#ifdef DEBUG_ENABLED
+#ifdef MEMORY_TAGS_ENABLED
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
@@ -194,9 +299,13 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 	if (prepad) {
 		mem -= DATA_OFFSET;
 
-#ifdef DEBUG_ENABLED
+#ifdef MEMORY_TAGS_ENABLED
 		uint64_t *s = (uint64_t *)(mem + SIZE_OFFSET);
-		mem_usage.sub(*s);
+		const uint64_t bytes = *s & SIZE_MASK;
+		_tag_counters_add(Tag(*s >> TAG_SHIFT), -int64_t(bytes), 0);
+#ifdef DEBUG_ENABLED
+		mem_usage.sub(bytes);
+#endif
 #endif
 
 		free(mem);
@@ -225,6 +334,237 @@ uint64_t Memory::get_mem_max_usage() {
 #endif
 }
 
+uint64_t Memory::get_alloc_count() {
+	return alloc_count.get();
+}
+
+const char *Memory::get_tag_name(Tag p_tag) {
+	static const char *names[TAG_MAX] = {
+		"untagged",
+		"rendering",
+		"physics",
+		"scripting",
+		"resources",
+		"audio",
+		"navigation",
+	};
+	ERR_FAIL_INDEX_V(p_tag, TAG_MAX, "");
+	return names[p_tag];
+}
+
+uint64_t Memory::get_tag_usage(Tag p_tag) {
+	ERR_FAIL_INDEX_V(p_tag, TAG_MAX, 0);
+#ifdef MEMORY_TAGS_ENABLED
+	tag_threads_lock.lock();
+	int64_t usage = retired_tag_usage[p_tag].load(std::memory_order_relaxed);
+	for (const MemoryTagThreadCounters *counters = tag_threads; counters; counters = counters->next) {
+		usage += counters->usage[p_tag].load(std::memory_order_relaxed);
+	}
+	tag_threads_lock.unlock();
+	return MAX(usage, 0);
+#else
+	return 0;
+#endif
+}
+
+uint64_t Memory::get_tag_alloc_count(Tag p_tag) {
+	ERR_FAIL_INDEX_V(p_tag, TAG_MAX, 0);
+#ifdef MEMORY_TAGS_ENABLED
+	tag_threads_lock.lock();
+	uint64_t allocs = retired_tag_allocs[p_tag].load(std::memory_order_relaxed);
+	for (const MemoryTagThreadCounters *counters = tag_threads; counters; counters = counters->next) {
+		allocs += counters->allocs[p_tag].load(std::memory_order_relaxed);
+	}
+	tag_threads_lock.unlock();
+	return allocs;
+#else
+	return 0;
+#endif
+}
+
+SafeNumeric<uint64_t> FrameAllocator::frame;
+SafeNumeric<uint64_t> FrameAllocator::peak_usage;
+
+struct FrameArena {
+	static constexpr size_t ALIGN = alignof(max_align_t);
+	static constexpr size_t MIN_CHUNK_SIZE = 64 * 1024;
+
+	struct Chunk {
+		Chunk *prev = nullptr;
+		size_t size = 0; // Usable bytes, after the header.
+	};
+
+	struct Block {
+		FrameArena *arena = nullptr;
+		size_t size = 0; // Requested bytes, after the header.
+	};
+
+	static constexpr size_t CHUNK_HEADER_SIZE = (sizeof(Chunk) + ALIGN - 1) & ~(ALIGN - 1);
+	static constexpr size_t BLOCK_HEADER_SIZE = (sizeof(Block) + ALIGN - 1) & ~(ALIGN - 1);
+
+	Chunk *chunk = nullptr; // The newest one; older ones are linked through `prev`.
+	size_t offset = 0; // Within the newest chunk.
+	size_t used_in_prev_chunks = 0;
+	SafeNumeric<uint32_t> live_allocations;
+	uint64_t frame = 0;
+	size_t frame_peak = 0;
+
+	_FORCE_INLINE_ static size_t block_footprint(size_t p_bytes) {
+		return BLOCK_HEADER_SIZE + ((p_bytes + ALIGN - 1) & ~(ALIGN - 1));
+	}
+
+	_FORCE_INLINE_ uint8_t *chunk_data(Chunk *p_chunk) const {
+		return (uint8_t *)p_chunk + CHUNK_HEADER_SIZE;
+	}
+
+	_FORCE_INLINE_ bool is_top(Block *p_block) const {
+		return chunk && (uint8_t *)p_block + block_footprint(p_block->size) == chunk_data(chunk) + offset;
+	}
+
+	void publish_peak() {
+		FrameAllocator::peak_usage.exchange_if_greater(frame_peak);
+	}
+
+	void free_chunks() {
+		while (chunk) {
+			Chunk *prev = chunk->prev;
+			Memory::free_static(chunk);
+			chunk = prev;
+		}
+		offset = 0;
+		used_in_prev_chunks = 0;
+	}
+
+	// Only when nothing is allocated. If more than one chunk was needed, replace them by a single one as big as all.
+	void rewind() {
+		if (chunk && chunk->prev) {
+			size_t total = 0;
+			for (Chunk *c = chunk; c; c = c->prev) {
+				total += c->size;
+			}
+			free_chunks();
+			add_chunk(total);
+		}
+		offset = 0;
+		used_in_prev_chunks = 0;
+	}
+
+	void add_chunk(size_t p_min_size) {
+		size_t size = MAX(MIN_CHUNK_SIZE, p_min_size);
+		if (chunk) {
+			size = MAX(size, chunk->size * 2);
+		}
+		Chunk *new_chunk = (Chunk *)Memory::alloc_static(CHUNK_HEADER_SIZE + size);
+		CRASH_COND_MSG(!new_chunk, "Out of memory");
+		new_chunk->prev = chunk;
+		new_chunk->size = size;
+		if (chunk) {
+			used_in_prev_chunks += offset;
+		}
+		chunk = new_chunk;
+		offset = 0;
+	}
+
+	void *alloc(size_t p_bytes) {
+		uint64_t current_frame = FrameAllocator::frame.get();
+		if (unlikely(frame != current_frame)) {
+			publish_peak();
+			frame_peak = 0;
+			frame = current_frame;
+		}
+		if (live_allocations.get() == 0 && (offset || used_in_prev_chunks)) {
+			rewind();
+		}
+
+		size_t footprint = block_footprint(p_bytes);
+		if (unlikely(!chunk || offset + footprint > chunk->size)) {
+			add_chunk(footprint);
+		}
+
+		Block *block = (Block *)(chunk_data(chunk) + offset);
+		block->arena = this;
+		block->size = p_bytes;
+		offset += footprint;
+		live_allocations.increment();
+
+		size_t used = used_in_prev_chunks + offset;
+		if (used > frame_peak) {
+			frame_peak = used;
+		}
+
+		return (uint8_t *)block + BLOCK_HEADER_SIZE;
+	}
+
+	~FrameArena() {
+		publish_peak();
+		if (live_allocations.get() == 0) {
+			free_chunks();
+		}
+		// Otherwise, something allocated here outlived the thread. Leak rather than crash.
+	}
+};
+
+static thread_local FrameArena frame_arena;
+
+void *FrameAllocator::alloc(size_t p_memory) {
+	return frame_arena.alloc(p_memory);
+}
+
+void *FrameAllocator::realloc(void *p_ptr, size_t p_memory) {
+	if (!p_ptr) {
+		return frame_arena.alloc(p_memory);
+	}
+	if (p_memory == 0) {
+		free(p_ptr);
+		return nullptr;
+	}
+
+	FrameArena::Block *block = (FrameArena::Block *)((uint8_t *)p_ptr - FrameArena::BLOCK_HEADER_SIZE);
+
+	if (block->arena == &frame_arena && frame_arena.is_top(block)) {
+		// Grow or shrink in place if the chunk allows.
+		size_t old_footprint = FrameArena::block_footprint(block->size);
+		size_t new_footprint = FrameArena::block_footprint(p_memory);
+		if (frame_arena.offset - old_footprint + new_footprint <= frame_arena.chunk->size) {
+			frame_arena.offset = frame_arena.offset - old_footprint + new_footprint;
+			block->size = p_memory;
+			size_t used = frame_arena.used_in_prev_chunks + frame_arena.offset;
+			if (used > frame_arena.frame_peak) {
+				frame_arena.frame_peak = used;
+			}
+			return p_ptr;
+		}
+	}
+
+	void *new_ptr = frame_arena.alloc(p_memory);
+	memcpy(new_ptr, p_ptr, MIN(block->size, p_memory));
+	free(p_ptr);
+	return new_ptr;
+}
+
+void FrameAllocator::free(void *p_ptr) {
+	ERR_FAIL_NULL(p_ptr);
+
+	FrameArena::Block *block = (FrameArena::Block *)((uint8_t *)p_ptr - FrameArena::BLOCK_HEADER_SIZE);
+	FrameArena *arena = block->arena;
+
+	if (arena == &frame_arena && arena->is_top(block)) {
+		// Latest allocation of this thread, give the space back right away.
+		arena->offset -= FrameArena::block_footprint(block->size);
+	}
+	// Other blocks are reclaimed when the arena is rewound.
+	arena->live_allocations.decrement();
+}
+
+void FrameAllocator::next_frame() {
+	frame.increment();
+}
+
+uint64_t FrameAllocator::get_peak_usage() {
+	// The calling thread's current frame hasn't been published yet.
+	return MAX(peak_usage.get(), (uint64_t)frame_arena.frame_peak);
+}
+
 _GlobalNil::_GlobalNil() {
 	left = this;
 	right = this;
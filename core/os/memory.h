@@ -39,7 +39,27 @@
 #include <new>
 #include <type_traits>
 
+// Debug builds always have the size header memory tags need, release builds
+// opt in with the `memory_tags` build option.
+#if defined(DEBUG_ENABLED) && !defined(MEMORY_TAGS_ENABLED)
+#define MEMORY_TAGS_ENABLED
+#endif
+
 class Memory {
+public:
+	// Subsystems allocations are attributed to, see MemoryTagScope.
+	enum Tag : uint8_t {
+		TAG_UNTAGGED,
+		TAG_RENDERING,
+		TAG_PHYSICS,
+		TAG_SCRIPTING,
+		TAG_RESOURCES,
+		TAG_AUDIO,
+		TAG_NAVIGATION,
+		TAG_MAX,
+	};
+
+private:
 #ifdef DEBUG_ENABLED
 	static SafeNumeric<uint64_t> mem_usage;
 	static SafeNumeric<uint64_t> max_usage;
@@ -47,6 +67,17 @@ class Memory {
 
 	static SafeNumeric<uint64_t> alloc_count;
 
+#ifdef MEMORY_TAGS_ENABLED
+	// The tag of an allocation is kept in the top byte of its size header.
+	static constexpr uint32_t TAG_SHIFT = 56;
+	static constexpr uint64_t SIZE_MASK = (uint64_t(1) << TAG_SHIFT) - 1;
+
+	static thread_local Tag current_tag;
+
+	// Counters are kept per thread, see memory.cpp.
+	static void _tag_counters_add(Tag p_tag, int64_t p_usage, uint64_t p_allocs);
+#endif
+
 public:
 	// Alignment:  ↓ max_align_t        ↓ uint64_t          ↓ max_align_t
 	//             ┌─────────────────┬──┬────────────────┬──┬───────────...
@@ -90,14 +121,81 @@ public:
 	static uint64_t get_mem_available();
 	static uint64_t get_mem_usage();
 	static uint64_t get_mem_max_usage();
+	// Number of live allocations made through alloc_static().
+	static uint64_t get_alloc_count();
+
+	// Memory tags. Without MEMORY_TAGS_ENABLED, the tag is ignored and the counters stay at zero.
+	static constexpr bool has_tags() {
+#ifdef MEMORY_TAGS_ENABLED
+		return true;
+#else
+		return false;
+#endif
+	}
+	static const char *get_tag_name(Tag p_tag);
+	static uint64_t get_tag_usage(Tag p_tag); // Live bytes.
+	static uint64_t get_tag_alloc_count(Tag p_tag); // Allocations made since startup, for rates.
+
+#ifdef MEMORY_TAGS_ENABLED
+	_FORCE_INLINE_ static Tag get_current_tag() { return current_tag; }
+	_FORCE_INLINE_ static void set_current_tag(Tag p_tag) { current_tag = p_tag; }
+#else
+	_FORCE_INLINE_ static Tag get_current_tag() { return TAG_UNTAGGED; }
+	_FORCE_INLINE_ static void set_current_tag(Tag p_tag) {}
+#endif
+};
+
+// Attributes the allocations made by the current thread to a subsystem, until
+// the scope ends. Scopes nest, restoring the enclosing tag when they end.
+class MemoryTagScope {
+#ifdef MEMORY_TAGS_ENABLED
+	Memory::Tag previous;
+
+public:
+	_FORCE_INLINE_ explicit MemoryTagScope(Memory::Tag p_tag) {
+		previous = Memory::get_current_tag();
+		Memory::set_current_tag(p_tag);
+	}
+	_FORCE_INLINE_ ~MemoryTagScope() {
+		Memory::set_current_tag(previous);
+	}
+#else
+public:
+	_FORCE_INLINE_ explicit MemoryTagScope(Memory::Tag p_tag) {}
+#endif
 };
 
 class DefaultAllocator {
 public:
 	_FORCE_INLINE_ static void *alloc(size_t p_memory) { return Memory::alloc_static(p_memory, false); }
+	_FORCE_INLINE_ static void *realloc(void *p_ptr, size_t p_memory) { return Memory::realloc_static(p_ptr, p_memory, false); }
 	_FORCE_INLINE_ static void free(void *p_ptr) { Memory::free_static(p_ptr, false); }
 };
 
+// Thread-local bump allocator for transient data, i.e., scratch containers
+// that are built and thrown away within a frame, like
+// `LocalVector<T, uint32_t, false, false, FrameAllocator>`.
+// Allocating is a pointer bump; freeing the latest allocation (or growing it)
+// happens in place. The arena of each thread is rewound once all the memory
+// allocated from it has been freed, and it's consolidated into a single chunk
+// at the first allocation of each frame, so steady-state frames don't hit malloc.
+// Memory may be freed from another thread, but it must not outlive the frame
+// (nor the thread that allocated it).
+class FrameAllocator {
+	static SafeNumeric<uint64_t> frame;
+	static SafeNumeric<uint64_t> peak_usage;
+
+	friend struct FrameArena;
+
+public:
+	static void *alloc(size_t p_memory);
+	static void *realloc(void *p_ptr, size_t p_memory);
+	static void free(void *p_ptr);
+
+	static void next_frame(); // Called once per `Main::iteration()`.
+	static uint64_t get_peak_usage(); // Most memory used by a thread in a single frame, in bytes.
+};
+
 void *operator new(size_t p_size, const char *p_description); ///< operator new that takes a description and uses MemoryStaticPool
 void *operator new(size_t p_size, void *(*p_allocfunc)(size_t p_size)); ///< operator new that takes a description and uses MemoryStaticPool
 
@@ -246,4 +344,13 @@ public:
 	_FORCE_INLINE_ void delete_allocation(T *p_allocation) { memdelete(p_allocation); }
 };
 
+// For `HashMap` and friends, to have their elements allocated by `FrameAllocator`.
+template <typename T>
+class FrameTypedAllocator {
+public:
+	template <typename... Args>
+	_FORCE_INLINE_ T *new_allocation(const Args &&...p_args) { return memnew_allocator(T(p_args...), FrameAllocator); }
+	_FORCE_INLINE_ void delete_allocation(T *p_allocation) { memdelete_allocator<T, FrameAllocator>(p_allocation); }
+};
+
 #endif // MEMORY_H
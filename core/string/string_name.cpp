@@ -68,25 +68,106 @@ StringName _scs_create(const char *p_chr, bool p_static) {
 	return (p_chr[0] ? StringName(StaticCString::create(p_chr), p_static) : StringName());
 }
 
+template <typename T>
+StringName::_Data *StringName::_find(const Shard &p_shard, uint32_t p_hash, const T &p_name) {
+	if (!p_shard.table) {
+		return nullptr;
+	}
+
+	_Data *data = p_shard.table[p_hash & (p_shard.len - 1)];
+	while (data) {
+		// compare hash first
+		if (data->hash == p_hash && data->operator==(p_name)) {
+			break;
+		}
+		data = data->next;
+	}
+	return data;
+}
+
+void StringName::_insert(Shard &p_shard, _Data *p_data) {
+	if (unlikely(p_shard.count >= p_shard.len)) {
+		// Grow to keep chains short, rehashing into the new buckets.
+		uint32_t new_len = p_shard.len ? p_shard.len * 2 : (uint32_t)STRING_TABLE_SHARD_MIN_LEN;
+		_Data **new_table = (_Data **)Memory::alloc_static(sizeof(_Data *) * new_len);
+		for (uint32_t i = 0; i < new_len; i++) {
+			new_table[i] = nullptr;
+		}
+
+		for (uint32_t i = 0; i < p_shard.len; i++) {
+			_Data *d = p_shard.table[i];
+			while (d) {
+				_Data *next = d->next;
+				uint32_t new_idx = d->hash & (new_len - 1);
+				d->prev = nullptr;
+				d->next = new_table[new_idx];
+				if (new_table[new_idx]) {
+					new_table[new_idx]->prev = d;
+				}
+				new_table[new_idx] = d;
+				d = next;
+			}
+		}
+
+		if (p_shard.table) {
+			Memory::free_static(p_shard.table);
+		}
+		p_shard.table = new_table;
+		p_shard.len = new_len;
+	}
+
+	uint32_t idx = p_data->hash & (p_shard.len - 1);
+	p_data->next = p_shard.table[idx];
+	p_data->prev = nullptr;
+	if (p_shard.table[idx]) {
+		p_shard.table[idx]->prev = p_data;
+	}
+	p_shard.table[idx] = p_data;
+	p_shard.count++;
+}
+
+void StringName::_remove(Shard &p_shard, _Data *p_data) {
+	if (p_data->prev) {
+		p_data->prev->next = p_data->next;
+	} else {
+		uint32_t idx = p_data->hash & (p_shard.len - 1);
+		if (p_shard.table[idx] != p_data) {
+			ERR_PRINT("BUG!");
+		}
+		p_shard.table[idx] = p_data->next;
+	}
+
+	if (p_data->next) {
+		p_data->next->prev = p_data->prev;
+	}
+	p_shard.count--;
+}
+
 void StringName::setup() {
 	ERR_FAIL_COND(configured);
-	for (int i = 0; i < STRING_TABLE_LEN; i++) {
-		_table[i] = nullptr;
+	for (Shard &shard : shards) {
+		shard.table = nullptr;
+		shard.len = 0;
+		shard.count = 0;
 	}
 	configured = true;
 }
 
 void StringName::cleanup() {
-	MutexLock lock(mutex);
+	for (Shard &shard : shards) {
+		shard.mutex.lock();
+	}
 
 #ifdef DEBUG_ENABLED
 	if (unlikely(debug_stringname)) {
 		Vector<_Data *> data;
-		for (int i = 0; i < STRING_TABLE_LEN; i++) {
-			_Data *d = _table[i];
-			while (d) {
-				data.push_back(d);
-				d = d->next;
+		for (const Shard &shard : shards) {
+			for (uint32_t i = 0; i < shard.len; i++) {
+				_Data *d = shard.table[i];
+				while (d) {
+					data.push_back(d);
+					d = d->next;
+				}
 			}
 		}
 
@@ -109,34 +190,48 @@ void StringName::cleanup() {
 	}
 #endif
 	int lost_strings = 0;
-	for (int i = 0; i < STRING_TABLE_LEN; i++) {
-		while (_table[i]) {
-			_Data *d = _table[i];
-			if (d->static_count.get() != d->refcount.get()) {
-				lost_strings++;
-
-				if (OS::get_singleton()->is_stdout_verbose()) {
-					String dname = String(d->cname ? d->cname : d->name);
-
-					print_line(vformat("Orphan StringName: %s (static: %d, total: %d)", dname, d->static_count.get(), d->refcount.get()));
+	for (Shard &shard : shards) {
+		for (uint32_t i = 0; i < shard.len; i++) {
+			while (shard.table[i]) {
+				_Data *d = shard.table[i];
+				if (d->static_count.get() != d->refcount.get()) {
+					lost_strings++;
+
+					if (OS::get_singleton()->is_stdout_verbose()) {
+						String dname = String(d->cname ? d->cname : d->name);
+
+						print_line(vformat("Orphan StringName: %s (static: %d, total: %d)", dname, d->static_count.get(), d->refcount.get()));
+					}
 				}
+
+				shard.table[i] = shard.table[i]->next;
+				memdelete(d);
 			}
+		}
 
-			_table[i] = _table[i]->next;
-			memdelete(d);
+		if (shard.table) {
+			Memory::free_static(shard.table);
 		}
+		shard.table = nullptr;
+		shard.len = 0;
+		shard.count = 0;
 	}
 	if (lost_strings) {
 		print_verbose(vformat("StringName: %d unclaimed string names at exit.", lost_strings));
 	}
 	configured = false;
+
+	for (Shard &shard : shards) {
+		shard.mutex.unlock();
+	}
 }
 
 void StringName::unref() {
 	ERR_FAIL_COND(!configured);
 
 	if (_data && _data->refcount.unref()) {
-		MutexLock lock(mutex);
+		Shard &shard = _get_shard(_data->hash);
+		MutexLock lock(shard.mutex);
 
 		if (CoreGlobals::leak_reporting_enabled && _data->static_count.get() > 0) {
 			if (_data->cname) {
@@ -145,18 +240,7 @@ void StringName::unref() {
 				ERR_PRINT("BUG: Unreferenced static string to 0: " + String(_data->name));
 			}
 		}
-		if (_data->prev) {
-			_data->prev->next = _data->next;
-		} else {
-			if (_table[_data->idx] != _data) {
-				ERR_PRINT("BUG!");
-			}
-			_table[_data->idx] = _data->next;
-		}
-
-		if (_data->next) {
-			_data->next->prev = _data->prev;
-		}
+		_remove(shard, _data);
 		memdelete(_data);
 	}
 
@@ -261,7 +345,7 @@ StringName::StringName(const StringName &p_name) {
 }
 
 void StringName::assign_static_unique_class_name(StringName *ptr, const char *p_name) {
-	MutexLock lock(mutex);
+	MutexLock lock(static_unique_class_name_mutex);
 	if (*ptr == StringName()) {
 		*ptr = StringName(p_name, true);
 	}
@@ -276,21 +360,12 @@ StringName::StringName(const char *p_name, bool p_static) {
 		return; //empty, ignore
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
+	Shard &shard = _get_shard(hash);
+	MutexLock lock(shard.mutex);
 
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->operator==(p_name)) {
-			break;
-		}
-		_data = _data->next;
-	}
+	_data = _find(shard, hash, p_name);
 
 	if (_data && _data->refcount.ref()) {
 		// exists
@@ -310,10 +385,7 @@ StringName::StringName(const char *p_name, bool p_static) {
 	_data->refcount.init();
 	_data->static_count.set(p_static ? 1 : 0);
 	_data->hash = hash;
-	_data->idx = idx;
 	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
 
 #ifdef DEBUG_ENABLED
 	if (unlikely(debug_stringname)) {
@@ -322,10 +394,7 @@ StringName::StringName(const char *p_name, bool p_static) {
 		_data->static_count.increment();
 	}
 #endif
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_insert(shard, _data);
 }
 
 StringName::StringName(const StaticCString &p_static_string, bool p_static) {
@@ -335,21 +404,12 @@ StringName::StringName(const StaticCString &p_static_string, bool p_static) {
 
 	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_static_string.ptr);
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
+	Shard &shard = _get_shard(hash);
+	MutexLock lock(shard.mutex);
 
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->operator==(p_static_string.ptr)) {
-			break;
-		}
-		_data = _data->next;
-	}
+	_data = _find(shard, hash, p_static_string.ptr);
 
 	if (_data && _data->refcount.ref()) {
 		// exists
@@ -369,10 +429,7 @@ StringName::StringName(const StaticCString &p_static_string, bool p_static) {
 	_data->refcount.init();
 	_data->static_count.set(p_static ? 1 : 0);
 	_data->hash = hash;
-	_data->idx = idx;
 	_data->cname = p_static_string.ptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
 #ifdef DEBUG_ENABLED
 	if (unlikely(debug_stringname)) {
 		// Keep in memory, force static.
@@ -380,10 +437,7 @@ StringName::StringName(const StaticCString &p_static_string, bool p_static) {
 		_data->static_count.increment();
 	}
 #endif
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_insert(shard, _data);
 }
 
 StringName::StringName(const String &p_name, bool p_static) {
@@ -395,19 +449,12 @@ StringName::StringName(const String &p_name, bool p_static) {
 		return;
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = p_name.hash();
-	uint32_t idx = hash & STRING_TABLE_MASK;
 
-	_data = _table[idx];
+	Shard &shard = _get_shard(hash);
+	MutexLock lock(shard.mutex);
 
-	while (_data) {
-		if (_data->hash == hash && _data->operator==(p_name)) {
-			break;
-		}
-		_data = _data->next;
-	}
+	_data = _find(shard, hash, p_name);
 
 	if (_data && _data->refcount.ref()) {
 		// exists
@@ -427,10 +474,7 @@ StringName::StringName(const String &p_name, bool p_static) {
 	_data->refcount.init();
 	_data->static_count.set(p_static ? 1 : 0);
 	_data->hash = hash;
-	_data->idx = idx;
 	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
 #ifdef DEBUG_ENABLED
 	if (unlikely(debug_stringname)) {
 		// Keep in memory, force static.
@@ -439,10 +483,7 @@ StringName::StringName(const String &p_name, bool p_static) {
 	}
 #endif
 
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_insert(shard, _data);
 }
 
 StringName StringName::search(const char *p_name) {
@@ -453,20 +494,12 @@ StringName StringName::search(const char *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
-	uint32_t idx = hash & STRING_TABLE_MASK;
 
-	_Data *_data = _table[idx];
+	Shard &shard = _get_shard(hash);
+	MutexLock lock(shard.mutex);
 
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->operator==(p_name)) {
-			break;
-		}
-		_data = _data->next;
-	}
+	_Data *_data = _find(shard, hash, p_name);
 
 	if (_data && _data->refcount.ref()) {
 #ifdef DEBUG_ENABLED
@@ -489,21 +522,12 @@ StringName StringName::search(const char32_t *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
+	Shard &shard = _get_shard(hash);
+	MutexLock lock(shard.mutex);
 
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->operator==(p_name)) {
-			break;
-		}
-		_data = _data->next;
-	}
+	_Data *_data = _find(shard, hash, p_name);
 
 	if (_data && _data->refcount.ref()) {
 		return StringName(_data);
@@ -515,21 +539,12 @@ StringName StringName::search(const char32_t *p_name) {
 StringName StringName::search(const String &p_name) {
 	ERR_FAIL_COND_V(p_name.is_empty(), StringName());
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = p_name.hash();
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
+	Shard &shard = _get_shard(hash);
+	MutexLock lock(shard.mutex);
 
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->operator==(p_name)) {
-			break;
-		}
-		_data = _data->next;
-	}
+	_Data *_data = _find(shard, hash, p_name);
 
 	if (_data && _data->refcount.ref()) {
 #ifdef DEBUG_ENABLED
@@ -46,10 +46,12 @@ struct StaticCString {
 };
 
 class StringName {
+	// The table is split in shards, picked by the top bits of the hash, each with its own lock
+	// and its own bucket array (indexed by the bottom bits), which grows with the load.
 	enum {
-		STRING_TABLE_BITS = 16,
-		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRING_TABLE_SHARD_BITS = 6,
+		STRING_TABLE_SHARDS = 1 << STRING_TABLE_SHARD_BITS,
+		STRING_TABLE_SHARD_MIN_LEN = 1024,
 	};
 
 	struct _Data {
@@ -66,14 +68,29 @@ class StringName {
 		bool operator==(const char *p_name) const;
 		bool operator!=(const char *p_name) const;
 
-		int idx = 0;
 		uint32_t hash = 0;
 		_Data *prev = nullptr;
 		_Data *next = nullptr;
 		_Data() {}
 	};
 
-	static inline _Data *_table[STRING_TABLE_LEN];
+	// No member initializers, shards only live in static storage and are reset in setup().
+	struct Shard {
+		Mutex mutex;
+		_Data **table;
+		uint32_t len; // Always a power of 2, or 0 before the first insertion.
+		uint32_t count;
+	};
+
+	static inline Shard shards[STRING_TABLE_SHARDS];
+
+	_FORCE_INLINE_ static Shard &_get_shard(uint32_t p_hash) {
+		return shards[p_hash >> (32 - STRING_TABLE_SHARD_BITS)];
+	}
+	template <typename T>
+	static _Data *_find(const Shard &p_shard, uint32_t p_hash, const T &p_name);
+	static void _insert(Shard &p_shard, _Data *p_data);
+	static void _remove(Shard &p_shard, _Data *p_data);
 
 	_Data *_data = nullptr;
 
@@ -81,7 +98,7 @@ class StringName {
 	friend void register_core_types();
 	friend void unregister_core_types();
 	friend class Main;
-	static inline Mutex mutex;
+	static inline Mutex static_unique_class_name_mutex;
 	static void setup();
 	static void cleanup();
 	static uint32_t get_empty_hash();
@@ -0,0 +1,275 @@
+/**************************************************************************/
+/*  small_vector.h                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SMALL_VECTOR_H
+#define SMALL_VECTOR_H
+
+#include "core/error/error_macros.h"
+#include "core/templates/vector.h"
+
+#include <initializer_list>
+#include <type_traits>
+
+/**
+ * A Vector that keeps up to N elements inline, without touching the heap.
+ * Past that, elements move to a regular Vector, so larger arrays keep its
+ * copy-on-write semantics: copying a SmallVector, or converting it to and
+ * from a Vector, shares the buffer instead of duplicating it.
+ *
+ * Use it for short, frequently created arrays, like the vertices of a face
+ * or the points of a contact, which would otherwise allocate every time.
+ */
+template <typename T, uint32_t N = 4>
+class SmallVector {
+	static_assert(N > 0, "SmallVector needs room for at least one inline element.");
+
+public:
+	typedef typename CowData<T>::Size Size;
+	static constexpr uint32_t INLINE_CAPACITY = N;
+
+private:
+	// Elements are inline while `heap` is empty, and only in `heap` otherwise.
+	Vector<T> heap;
+	uint32_t inline_count = 0;
+	alignas(T) uint8_t inline_data[N * sizeof(T)];
+
+	_FORCE_INLINE_ T *_inline_ptr() {
+		return reinterpret_cast<T *>(inline_data);
+	}
+
+	_FORCE_INLINE_ const T *_inline_ptr() const {
+		return reinterpret_cast<const T *>(inline_data);
+	}
+
+	void _destroy_inline(uint32_t p_from) {
+		if constexpr (!std::is_trivially_destructible_v<T>) {
+			T *data = _inline_ptr();
+			for (uint32_t i = p_from; i < inline_count; i++) {
+				data[i].~T();
+			}
+		}
+		inline_count = p_from;
+	}
+
+	// Moves the inline elements to the heap, reserving room for p_size elements.
+	void _spill(Size p_size) {
+		heap.resize(p_size);
+		T *w = heap.ptrw();
+		T *data = _inline_ptr();
+		for (uint32_t i = 0; i < inline_count; i++) {
+			w[i] = data[i];
+		}
+		_destroy_inline(0);
+	}
+
+	void _copy_from(const SmallVector &p_from) {
+		if (p_from.is_inline()) {
+			const T *src = p_from._inline_ptr();
+			T *data = _inline_ptr();
+			for (uint32_t i = 0; i < p_from.inline_count; i++) {
+				memnew_placement(&data[i], T(src[i]));
+			}
+			inline_count = p_from.inline_count;
+		} else {
+			heap = p_from.heap;
+		}
+	}
+
+	void _copy_from(const Vector<T> &p_from) {
+		if (p_from.size() > (Size)N) {
+			heap = p_from;
+			return;
+		}
+		const T *src = p_from.ptr();
+		T *data = _inline_ptr();
+		for (Size i = 0; i < p_from.size(); i++) {
+			memnew_placement(&data[i], T(src[i]));
+		}
+		inline_count = p_from.size();
+	}
+
+public:
+	_FORCE_INLINE_ bool is_inline() const { return heap.is_empty(); }
+	_FORCE_INLINE_ Size size() const { return is_inline() ? (Size)inline_count : heap.size(); }
+	_FORCE_INLINE_ bool is_empty() const { return size() == 0; }
+
+	_FORCE_INLINE_ const T *ptr() const {
+		return is_inline() ? _inline_ptr() : heap.ptr();
+	}
+
+	// Makes the heap buffer unique first, when it is shared.
+	_FORCE_INLINE_ T *ptrw() {
+		return is_inline() ? _inline_ptr() : heap.ptrw();
+	}
+
+	_FORCE_INLINE_ const T &operator[](Size p_index) const {
+		CRASH_BAD_INDEX(p_index, size());
+		return ptr()[p_index];
+	}
+
+	_FORCE_INLINE_ T &operator[](Size p_index) {
+		CRASH_BAD_INDEX(p_index, size());
+		return ptrw()[p_index];
+	}
+
+	_FORCE_INLINE_ const T &get(Size p_index) const {
+		return operator[](p_index);
+	}
+
+	_FORCE_INLINE_ void set(Size p_index, const T &p_elem) {
+		operator[](p_index) = p_elem;
+	}
+
+	void push_back(T p_elem) {
+		if (is_inline()) {
+			if (likely(inline_count < N)) {
+				memnew_placement(&_inline_ptr()[inline_count++], T(p_elem));
+				return;
+			}
+			_spill(N + 1);
+			heap.ptrw()[N] = p_elem;
+			return;
+		}
+		heap.push_back(p_elem);
+	}
+
+	void remove_at(Size p_index) {
+		ERR_FAIL_INDEX(p_index, size());
+		if (!is_inline()) {
+			heap.remove_at(p_index);
+			return;
+		}
+		T *data = _inline_ptr();
+		for (uint32_t i = p_index; i + 1 < inline_count; i++) {
+			data[i] = data[i + 1];
+		}
+		_destroy_inline(inline_count - 1);
+	}
+
+	_FORCE_INLINE_ bool erase(const T &p_val) {
+		Size idx = find(p_val);
+		if (idx >= 0) {
+			remove_at(idx);
+			return true;
+		}
+		return false;
+	}
+
+	void resize(Size p_size) {
+		ERR_FAIL_COND(p_size < 0);
+		if (!is_inline()) {
+			// Resizing to zero frees the heap buffer and makes the vector inline again.
+			heap.resize(p_size);
+			return;
+		}
+		if (p_size > (Size)N) {
+			_spill(p_size);
+			return;
+		}
+		if (p_size < (Size)inline_count) {
+			_destroy_inline(p_size);
+		} else {
+			T *data = _inline_ptr();
+			for (uint32_t i = inline_count; i < p_size; i++) {
+				memnew_placement(&data[i], T);
+			}
+			inline_count = p_size;
+		}
+	}
+
+	_FORCE_INLINE_ void clear() { resize(0); }
+
+	Size find(const T &p_val, Size p_from = 0) const {
+		const T *data = ptr();
+		const Size count = size();
+		for (Size i = p_from; i < count; i++) {
+			if (data[i] == p_val) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	bool has(const T &p_val) const {
+		return find(p_val) != -1;
+	}
+
+	// Iteration only reads, use ptrw() to modify elements in place.
+	_FORCE_INLINE_ const T *begin() const { return ptr(); }
+	_FORCE_INLINE_ const T *end() const { return ptr() + size(); }
+
+	// Shares the heap buffer, if any.
+	operator Vector<T>() const {
+		if (!is_inline()) {
+			return heap;
+		}
+		Vector<T> ret;
+		ret.resize(inline_count);
+		T *w = ret.ptrw();
+		const T *data = _inline_ptr();
+		for (uint32_t i = 0; i < inline_count; i++) {
+			w[i] = data[i];
+		}
+		return ret;
+	}
+
+	void operator=(const SmallVector &p_from) {
+		if (this == &p_from) {
+			return;
+		}
+		clear();
+		_copy_from(p_from);
+	}
+
+	void operator=(const Vector<T> &p_from) {
+		clear();
+		_copy_from(p_from);
+	}
+
+	_FORCE_INLINE_ SmallVector() {}
+	_FORCE_INLINE_ SmallVector(std::initializer_list<T> p_init) {
+		if (p_init.size() > N) {
+			heap = Vector<T>(p_init);
+			return;
+		}
+		for (const T &element : p_init) {
+			push_back(element);
+		}
+	}
+	_FORCE_INLINE_ SmallVector(const SmallVector &p_from) { _copy_from(p_from); }
+	_FORCE_INLINE_ SmallVector(const Vector<T> &p_from) { _copy_from(p_from); }
+
+	_FORCE_INLINE_ ~SmallVector() {
+		_destroy_inline(0);
+	}
+};
+
+#endif // SMALL_VECTOR_H
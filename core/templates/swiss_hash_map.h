@@ -0,0 +1,729 @@
+/**************************************************************************/
+/*  swiss_hash_map.h                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SWISS_HASH_MAP_H
+#define SWISS_HASH_MAP_H
+
+#include "core/templates/hash_map.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SWISS_HASH_MAP_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define SWISS_HASH_MAP_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// A group of control bytes, probed together. Each control byte is either
+// CTRL_EMPTY, CTRL_DELETED or the 7 low bits of the hash of a full slot.
+// Matching returns a bit mask with one set bit per matching slot, use
+// `lowest()` to get the slot index of the lowest one.
+struct SwissHashMapGroup {
+	static constexpr uint32_t WIDTH = 16;
+	static constexpr int8_t CTRL_EMPTY = -128;
+	static constexpr int8_t CTRL_DELETED = -2;
+
+#ifdef SWISS_HASH_MAP_NEON
+	// NEON has no movemask, the mask is built with 4 bits per slot.
+	static constexpr uint32_t MASK_SHIFT = 2;
+	static constexpr uint64_t MASK_BITS = 0x8888888888888888ULL;
+#else
+	static constexpr uint32_t MASK_SHIFT = 0;
+#endif
+
+	static _FORCE_INLINE_ uint32_t lowest(uint64_t p_mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+		unsigned long index;
+#ifdef _WIN64
+		_BitScanForward64(&index, p_mask);
+#else
+		_BitScanForward(&index, (unsigned long)p_mask); // Masks are 16 bits wide without NEON.
+#endif
+		return (uint32_t)index >> MASK_SHIFT;
+#else
+		return (uint32_t)__builtin_ctzll(p_mask) >> MASK_SHIFT;
+#endif
+	}
+
+#if defined(SWISS_HASH_MAP_SSE2)
+	__m128i ctrl;
+
+	_FORCE_INLINE_ explicit SwissHashMapGroup(const int8_t *p_ctrl) {
+		ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_ctrl));
+	}
+
+	_FORCE_INLINE_ uint64_t match(int8_t p_h2) const {
+		return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(p_h2)));
+	}
+
+	_FORCE_INLINE_ uint64_t match_empty_or_deleted() const {
+		// Both special values have the sign bit set.
+		return (uint32_t)_mm_movemask_epi8(ctrl);
+	}
+#elif defined(SWISS_HASH_MAP_NEON)
+	int8x16_t ctrl;
+
+	static _FORCE_INLINE_ uint64_t _to_mask(uint8x16_t p_cmp) {
+		const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(p_cmp), 4);
+		return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & MASK_BITS;
+	}
+
+	_FORCE_INLINE_ explicit SwissHashMapGroup(const int8_t *p_ctrl) {
+		ctrl = vld1q_s8(p_ctrl);
+	}
+
+	_FORCE_INLINE_ uint64_t match(int8_t p_h2) const {
+		return _to_mask(vceqq_s8(ctrl, vdupq_n_s8(p_h2)));
+	}
+
+	_FORCE_INLINE_ uint64_t match_empty_or_deleted() const {
+		return _to_mask(vcltq_s8(ctrl, vdupq_n_s8(0)));
+	}
+#else
+	const int8_t *ctrl = nullptr;
+
+	_FORCE_INLINE_ explicit SwissHashMapGroup(const int8_t *p_ctrl) {
+		ctrl = p_ctrl;
+	}
+
+	_FORCE_INLINE_ uint64_t match(int8_t p_h2) const {
+		uint64_t mask = 0;
+		for (uint32_t i = 0; i < WIDTH; i++) {
+			mask |= (uint64_t)(ctrl[i] == p_h2) << i;
+		}
+		return mask;
+	}
+
+	_FORCE_INLINE_ uint64_t match_empty_or_deleted() const {
+		uint64_t mask = 0;
+		for (uint32_t i = 0; i < WIDTH; i++) {
+			mask |= (uint64_t)(ctrl[i] < 0) << i;
+		}
+		return mask;
+	}
+#endif
+
+	_FORCE_INLINE_ uint64_t match_empty() const {
+		return match(CTRL_EMPTY);
+	}
+};
+
+/**
+ * A HashMap implementation based on "Swiss tables". The index is split in
+ * groups of 16 control bytes, each holding 7 bits of the hash of its slot,
+ * which are compared all at once using SSE2 or NEON. Only slots whose
+ * control byte matches are checked against the full hash and the key, and
+ * a lookup stops at the first group that has an empty slot. Erased slots
+ * become tombstones unless their group already has an empty slot, and are
+ * cleaned up when the table is rehashed.
+ *
+ * Like HashMap, keys and values are stored in a double linked list by
+ * insertion order, so iteration order is stable and pointers to values are
+ * valid until their element is erased. The API matches HashMap, making it a
+ * drop-in replacement for lookup heavy maps.
+ *
+ * The assignment operator copy the pairs from one map to the other.
+ */
+template <typename TKey, typename TValue,
+		typename Hasher = HashMapHasherDefault,
+		typename Comparator = HashMapComparatorDefault<TKey>,
+		typename Allocator = DefaultTypedAllocator<HashMapElement<TKey, TValue>>>
+class SwissHashMap {
+public:
+	// Must be a power of two, and a multiple of the group width.
+	static constexpr uint32_t MIN_CAPACITY = SwissHashMapGroup::WIDTH;
+	static constexpr uint32_t MAX_CAPACITY = 1u << 30;
+
+private:
+	Allocator element_alloc;
+	int8_t *ctrl = nullptr;
+	uint32_t *hashes = nullptr;
+	HashMapElement<TKey, TValue> **elements = nullptr;
+	HashMapElement<TKey, TValue> *head_element = nullptr;
+	HashMapElement<TKey, TValue> *tail_element = nullptr;
+
+	uint32_t capacity = MIN_CAPACITY;
+	uint32_t num_elements = 0;
+	// Insertions left until the table needs a rehash. Tombstones count as used slots.
+	uint32_t growth_left = 0;
+
+	static _FORCE_INLINE_ uint32_t _hash(const TKey &p_key) {
+		return Hasher::hash(p_key);
+	}
+
+	static _FORCE_INLINE_ int8_t _get_h2(uint32_t p_hash) {
+		return (int8_t)(p_hash & 0x7F);
+	}
+
+	static _FORCE_INLINE_ uint32_t _get_h1(uint32_t p_hash) {
+		return p_hash >> 7;
+	}
+
+	static _FORCE_INLINE_ uint32_t _get_max_load(uint32_t p_capacity) {
+		return p_capacity - p_capacity / 8; // 87.5% max occupancy.
+	}
+
+	bool _lookup_pos_with_hash(const TKey &p_key, uint32_t p_hash, uint32_t &r_pos) const {
+		if (num_elements == 0) {
+			return false; // Failed lookups, no elements.
+		}
+
+		const uint32_t group_mask = capacity / SwissHashMapGroup::WIDTH - 1;
+		const int8_t h2 = _get_h2(p_hash);
+		uint32_t group = _get_h1(p_hash) & group_mask;
+
+		// Triangular probing over a power of two group count visits every group.
+		for (uint32_t step = 1;; step++) {
+			const uint32_t base = group * SwissHashMapGroup::WIDTH;
+			const SwissHashMapGroup g(ctrl + base);
+
+			for (uint64_t mask = g.match(h2); mask != 0; mask &= mask - 1) {
+				const uint32_t pos = base + SwissHashMapGroup::lowest(mask);
+				if (hashes[pos] == p_hash && Comparator::compare(elements[pos]->data.key, p_key)) {
+					r_pos = pos;
+					return true;
+				}
+			}
+
+			if (g.match_empty() != 0) {
+				return false;
+			}
+
+			group = (group + step) & group_mask;
+		}
+	}
+
+	_FORCE_INLINE_ bool _lookup_pos(const TKey &p_key, uint32_t &r_pos) const {
+		if (num_elements == 0) {
+			return false; // Don't hash the key needlessly.
+		}
+		return _lookup_pos_with_hash(p_key, _hash(p_key), r_pos);
+	}
+
+	uint32_t _find_insert_pos(uint32_t p_hash) const {
+		const uint32_t group_mask = capacity / SwissHashMapGroup::WIDTH - 1;
+		uint32_t group = _get_h1(p_hash) & group_mask;
+
+		for (uint32_t step = 1;; step++) {
+			const uint32_t base = group * SwissHashMapGroup::WIDTH;
+			const uint64_t mask = SwissHashMapGroup(ctrl + base).match_empty_or_deleted();
+			if (mask != 0) {
+				return base + SwissHashMapGroup::lowest(mask);
+			}
+			group = (group + step) & group_mask;
+		}
+	}
+
+	void _insert_with_hash(uint32_t p_hash, HashMapElement<TKey, TValue> *p_value) {
+		const uint32_t pos = _find_insert_pos(p_hash);
+		if (ctrl[pos] == SwissHashMapGroup::CTRL_EMPTY) {
+			growth_left--;
+		}
+		ctrl[pos] = _get_h2(p_hash);
+		hashes[pos] = p_hash;
+		elements[pos] = p_value;
+		num_elements++;
+	}
+
+	// Frees a slot, leaving a tombstone only if probing may have gone past its group.
+	void _clear_slot(uint32_t p_pos) {
+		const uint32_t base = p_pos & ~(SwissHashMapGroup::WIDTH - 1);
+		if (SwissHashMapGroup(ctrl + base).match_empty() != 0) {
+			ctrl[p_pos] = SwissHashMapGroup::CTRL_EMPTY;
+			growth_left++;
+		} else {
+			ctrl[p_pos] = SwissHashMapGroup::CTRL_DELETED;
+		}
+		elements[p_pos] = nullptr;
+		num_elements--;
+	}
+
+	void _allocate(uint32_t p_capacity) {
+		capacity = p_capacity;
+		ctrl = reinterpret_cast<int8_t *>(Memory::alloc_static(sizeof(int8_t) * capacity));
+		hashes = reinterpret_cast<uint32_t *>(Memory::alloc_static(sizeof(uint32_t) * capacity));
+		elements = reinterpret_cast<HashMapElement<TKey, TValue> **>(Memory::alloc_static(sizeof(HashMapElement<TKey, TValue> *) * capacity));
+		memset(ctrl, SwissHashMapGroup::CTRL_EMPTY, capacity);
+		growth_left = _get_max_load(capacity);
+	}
+
+	void _resize_and_rehash(uint32_t p_new_capacity) {
+		const uint32_t old_capacity = capacity;
+		int8_t *old_ctrl = ctrl;
+		uint32_t *old_hashes = hashes;
+		HashMapElement<TKey, TValue> **old_elements = elements;
+
+		_allocate(p_new_capacity);
+
+		if (old_ctrl == nullptr) {
+			// Nothing to do.
+			return;
+		}
+
+		num_elements = 0;
+		for (uint32_t i = 0; i < old_capacity; i++) {
+			if (old_ctrl[i] < 0) {
+				continue; // Empty or deleted.
+			}
+			_insert_with_hash(old_hashes[i], old_elements[i]);
+		}
+
+		Memory::free_static(old_ctrl);
+		Memory::free_static(old_hashes);
+		Memory::free_static(old_elements);
+	}
+
+	// Makes sure there is room for one more element.
+	bool _prepare_insert() {
+		if (likely(growth_left > 0)) {
+			return true;
+		}
+		if (ctrl == nullptr) {
+			// Allocate on demand to save memory.
+			_allocate(capacity);
+		} else if (num_elements < _get_max_load(capacity) / 2) {
+			// Mostly tombstones, rehash in place to reclaim them.
+			_resize_and_rehash(capacity);
+		} else {
+			ERR_FAIL_COND_V_MSG(capacity >= MAX_CAPACITY, false, "Hash table maximum capacity reached, aborting insertion.");
+			_resize_and_rehash(capacity * 2);
+		}
+		return true;
+	}
+
+	_FORCE_INLINE_ HashMapElement<TKey, TValue> *_insert(const TKey &p_key, const TValue &p_value, bool p_front_insert = false) {
+		const uint32_t hash = _hash(p_key);
+		uint32_t pos = 0;
+		bool exists = _lookup_pos_with_hash(p_key, hash, pos);
+
+		if (exists) {
+			elements[pos]->data.value = p_value;
+			return elements[pos];
+		} else {
+			if (unlikely(!_prepare_insert())) {
+				return nullptr;
+			}
+
+			HashMapElement<TKey, TValue> *elem = element_alloc.new_allocation(HashMapElement<TKey, TValue>(p_key, p_value));
+
+			if (tail_element == nullptr) {
+				head_element = elem;
+				tail_element = elem;
+			} else if (p_front_insert) {
+				head_element->prev = elem;
+				elem->next = head_element;
+				head_element = elem;
+			} else {
+				tail_element->next = elem;
+				elem->prev = tail_element;
+				tail_element = elem;
+			}
+
+			_insert_with_hash(hash, elem);
+			return elem;
+		}
+	}
+
+public:
+	_FORCE_INLINE_ uint32_t get_capacity() const { return capacity; }
+	_FORCE_INLINE_ uint32_t size() const { return num_elements; }
+
+	/* Standard Godot Container API */
+
+	bool is_empty() const {
+		return num_elements == 0;
+	}
+
+	void clear() {
+		if (ctrl == nullptr) {
+			return;
+		}
+
+		HashMapElement<TKey, TValue> *E = head_element;
+		while (E != nullptr) {
+			HashMapElement<TKey, TValue> *next = E->next;
+			element_alloc.delete_allocation(E);
+			E = next;
+		}
+
+		memset(ctrl, SwissHashMapGroup::CTRL_EMPTY, capacity);
+		growth_left = _get_max_load(capacity);
+		tail_element = nullptr;
+		head_element = nullptr;
+		num_elements = 0;
+	}
+
+	void sort() {
+		if (num_elements < 2) {
+			return; // An empty or single element map is already sorted.
+		}
+		// Use insertion sort because we want this operation to be fast for the
+		// common case where the input is already sorted or nearly sorted.
+		HashMapElement<TKey, TValue> *inserting = head_element->next;
+		while (inserting != nullptr) {
+			HashMapElement<TKey, TValue> *after = nullptr;
+			for (HashMapElement<TKey, TValue> *current = inserting->prev; current != nullptr; current = current->prev) {
+				if (_hashmap_variant_less_than(inserting->data.key, current->data.key)) {
+					after = current;
+				} else {
+					break;
+				}
+			}
+			HashMapElement<TKey, TValue> *next = inserting->next;
+			if (after != nullptr) {
+				// Modify the elements around `inserting` to remove it from its current position.
+				inserting->prev->next = next;
+				if (next == nullptr) {
+					tail_element = inserting->prev;
+				} else {
+					next->prev = inserting->prev;
+				}
+				// Modify `before` and `after` to insert `inserting` between them.
+				HashMapElement<TKey, TValue> *before = after->prev;
+				if (before == nullptr) {
+					head_element = inserting;
+				} else {
+					before->next = inserting;
+				}
+				after->prev = inserting;
+				// Point `inserting` to its new surroundings.
+				inserting->prev = before;
+				inserting->next = after;
+			}
+			inserting = next;
+		}
+	}
+
+	TValue &get(const TKey &p_key) {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		CRASH_COND_MSG(!exists, "SwissHashMap key not found.");
+		return elements[pos]->data.value;
+	}
+
+	const TValue &get(const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		CRASH_COND_MSG(!exists, "SwissHashMap key not found.");
+		return elements[pos]->data.value;
+	}
+
+	const TValue *getptr(const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+
+		if (exists) {
+			return &elements[pos]->data.value;
+		}
+		return nullptr;
+	}
+
+	TValue *getptr(const TKey &p_key) {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+
+		if (exists) {
+			return &elements[pos]->data.value;
+		}
+		return nullptr;
+	}
+
+	_FORCE_INLINE_ bool has(const TKey &p_key) const {
+		uint32_t _pos = 0;
+		return _lookup_pos(p_key, _pos);
+	}
+
+	bool erase(const TKey &p_key) {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+
+		if (!exists) {
+			return false;
+		}
+
+		HashMapElement<TKey, TValue> *element = elements[pos];
+		_clear_slot(pos);
+
+		if (head_element == element) {
+			head_element = element->next;
+		}
+
+		if (tail_element == element) {
+			tail_element = element->prev;
+		}
+
+		if (element->prev) {
+			element->prev->next = element->next;
+		}
+
+		if (element->next) {
+			element->next->prev = element->prev;
+		}
+
+		element_alloc.delete_allocation(element);
+		return true;
+	}
+
+	// Replace the key of an entry in-place, without invalidating iterators or changing the entries position during iteration.
+	// p_old_key must exist in the map and p_new_key must not, unless it is equal to p_old_key.
+	bool replace_key(const TKey &p_old_key, const TKey &p_new_key) {
+		if (p_old_key == p_new_key) {
+			return true;
+		}
+		uint32_t pos = 0;
+		ERR_FAIL_COND_V(_lookup_pos(p_new_key, pos), false);
+		ERR_FAIL_COND_V(!_lookup_pos(p_old_key, pos), false);
+		HashMapElement<TKey, TValue> *element = elements[pos];
+
+		// _insert_with_hash will increment the element count again.
+		_clear_slot(pos);
+		_prepare_insert(); // The freed slot may be a tombstone that doesn't count as free.
+
+		// Update the HashMapElement with the new key and reinsert it.
+		const_cast<TKey &>(element->data.key) = p_new_key;
+		_insert_with_hash(_hash(p_new_key), element);
+
+		return true;
+	}
+
+	// Reserves space for a number of elements, useful to avoid many resizes and rehashes.
+	// If adding a known (possibly large) number of elements at once, must be larger than old capacity.
+	void reserve(uint32_t p_new_capacity) {
+		ERR_FAIL_COND_MSG(p_new_capacity > _get_max_load(MAX_CAPACITY), "Hash table maximum capacity reached, can't reserve.");
+		uint32_t new_capacity = next_power_of_2(MAX(MIN_CAPACITY, p_new_capacity));
+		if (_get_max_load(new_capacity) < p_new_capacity) {
+			new_capacity *= 2;
+		}
+
+		if (new_capacity <= capacity) {
+			return;
+		}
+
+		if (ctrl == nullptr) {
+			capacity = new_capacity;
+			return; // Unallocated yet.
+		}
+		_resize_and_rehash(new_capacity);
+	}
+
+	/** Iterator API **/
+
+	struct ConstIterator {
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> &operator*() const {
+			return E->data;
+		}
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> *operator->() const { return &E->data; }
+		_FORCE_INLINE_ ConstIterator &operator++() {
+			if (E) {
+				E = E->next;
+			}
+			return *this;
+		}
+		_FORCE_INLINE_ ConstIterator &operator--() {
+			if (E) {
+				E = E->prev;
+			}
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const ConstIterator &b) const { return E == b.E; }
+		_FORCE_INLINE_ bool operator!=(const ConstIterator &b) const { return E != b.E; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return E != nullptr;
+		}
+
+		_FORCE_INLINE_ ConstIterator(const HashMapElement<TKey, TValue> *p_E) { E = p_E; }
+		_FORCE_INLINE_ ConstIterator() {}
+		_FORCE_INLINE_ ConstIterator(const ConstIterator &p_it) { E = p_it.E; }
+		_FORCE_INLINE_ void operator=(const ConstIterator &p_it) {
+			E = p_it.E;
+		}
+
+	private:
+		const HashMapElement<TKey, TValue> *E = nullptr;
+	};
+
+	struct Iterator {
+		_FORCE_INLINE_ KeyValue<TKey, TValue> &operator*() const {
+			return E->data;
+		}
+		_FORCE_INLINE_ KeyValue<TKey, TValue> *operator->() const { return &E->data; }
+		_FORCE_INLINE_ Iterator &operator++() {
+			if (E) {
+				E = E->next;
+			}
+			return *this;
+		}
+		_FORCE_INLINE_ Iterator &operator--() {
+			if (E) {
+				E = E->prev;
+			}
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const Iterator &b) const { return E == b.E; }
+		_FORCE_INLINE_ bool operator!=(const Iterator &b) const { return E != b.E; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return E != nullptr;
+		}
+
+		_FORCE_INLINE_ Iterator(HashMapElement<TKey, TValue> *p_E) { E = p_E; }
+		_FORCE_INLINE_ Iterator() {}
+		_FORCE_INLINE_ Iterator(const Iterator &p_it) { E = p_it.E; }
+		_FORCE_INLINE_ void operator=(const Iterator &p_it) {
+			E = p_it.E;
+		}
+
+		operator ConstIterator() const {
+			return ConstIterator(E);
+		}
+
+	private:
+		HashMapElement<TKey, TValue> *E = nullptr;
+	};
+
+	_FORCE_INLINE_ Iterator begin() {
+		return Iterator(head_element);
+	}
+	_FORCE_INLINE_ Iterator end() {
+		return Iterator(nullptr);
+	}
+	_FORCE_INLINE_ Iterator last() {
+		return Iterator(tail_element);
+	}
+
+	_FORCE_INLINE_ Iterator find(const TKey &p_key) {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		if (!exists) {
+			return end();
+		}
+		return Iterator(elements[pos]);
+	}
+
+	_FORCE_INLINE_ void remove(const Iterator &p_iter) {
+		if (p_iter) {
+			erase(p_iter->key);
+		}
+	}
+
+	_FORCE_INLINE_ ConstIterator begin() const {
+		return ConstIterator(head_element);
+	}
+	_FORCE_INLINE_ ConstIterator end() const {
+		return ConstIterator(nullptr);
+	}
+	_FORCE_INLINE_ ConstIterator last() const {
+		return ConstIterator(tail_element);
+	}
+
+	_FORCE_INLINE_ ConstIterator find(const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		if (!exists) {
+			return end();
+		}
+		return ConstIterator(elements[pos]);
+	}
+
+	/* Indexing */
+
+	const TValue &operator[](const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		CRASH_COND(!exists);
+		return elements[pos]->data.value;
+	}
+
+	TValue &operator[](const TKey &p_key) {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		if (!exists) {
+			return _insert(p_key, TValue())->data.value;
+		} else {
+			return elements[pos]->data.value;
+		}
+	}
+
+	/* Insert */
+
+	Iterator insert(const TKey &p_key, const TValue &p_value, bool p_front_insert = false) {
+		return Iterator(_insert(p_key, p_value, p_front_insert));
+	}
+
+	/* Constructors */
+
+	SwissHashMap(const SwissHashMap &p_other) {
+		reserve(p_other.num_elements);
+
+		for (const KeyValue<TKey, TValue> &E : p_other) {
+			insert(E.key, E.value);
+		}
+	}
+
+	void operator=(const SwissHashMap &p_other) {
+		if (this == &p_other) {
+			return; // Ignore self assignment.
+		}
+		if (num_elements != 0) {
+			clear();
+		}
+
+		reserve(p_other.num_elements);
+
+		for (const KeyValue<TKey, TValue> &E : p_other) {
+			insert(E.key, E.value);
+		}
+	}
+
+	SwissHashMap(uint32_t p_initial_capacity) {
+		reserve(p_initial_capacity);
+	}
+	SwissHashMap() {}
+
+	~SwissHashMap() {
+		clear();
+
+		if (ctrl != nullptr) {
+			Memory::free_static(ctrl);
+			Memory::free_static(hashes);
+			Memory::free_static(elements);
+		}
+	}
+};
+
+#endif // SWISS_HASH_MAP_H
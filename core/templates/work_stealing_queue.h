@@ -0,0 +1,144 @@
+/**************************************************************************/
+/*  work_stealing_queue.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef WORK_STEALING_QUEUE_H
+#define WORK_STEALING_QUEUE_H
+
+#include "core/typedefs.h"
+
+#include <atomic>
+#include <type_traits>
+
+// Fixed-capacity, lock-free work-stealing deque (Chase-Lev, with the memory
+// orderings from "Correct and Efficient Work-Stealing for Weak Memory Models").
+// - Only the owner thread may call push() and pop(). They operate on the bottom end (LIFO).
+// - Any thread may call steal(). It operates on the top end (FIFO).
+// The capacity is fixed so the buffer never has to be reclaimed while other threads
+// may be reading it; push() returns false when full and the caller must fall back
+// to some other queue.
+
+template <typename T, uint32_t CAPACITY = 1024>
+class WorkStealingQueue {
+	static_assert(std::is_trivially_copyable_v<T>);
+	static_assert(std::atomic<T>::is_always_lock_free);
+	static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "Capacity must be a power of two.");
+
+	static constexpr int64_t MASK = CAPACITY - 1;
+
+	// Padded apart, since top is written by thieves and bottom by the owner.
+	// Padding is used instead of alignas() because this may live in memory
+	// coming from Memory::alloc_static(), which doesn't honor over-alignment.
+	static constexpr uint32_t CACHE_LINE_SIZE = 64;
+
+	std::atomic<int64_t> top = 0;
+	uint8_t _pad_top[CACHE_LINE_SIZE - sizeof(std::atomic<int64_t>)];
+	std::atomic<int64_t> bottom = 0;
+	uint8_t _pad_bottom[CACHE_LINE_SIZE - sizeof(std::atomic<int64_t>)];
+	std::atomic<T> buffer[CAPACITY];
+
+public:
+	enum StealResult {
+		STEAL_OK,
+		STEAL_EMPTY,
+		STEAL_ABORT, // Lost a race against another thief or the owner; retrying may succeed.
+	};
+
+	// Owner only.
+	_FORCE_INLINE_ bool push(T p_value) {
+		int64_t b = bottom.load(std::memory_order_relaxed);
+		int64_t t = top.load(std::memory_order_acquire);
+		if (unlikely(b - t >= (int64_t)CAPACITY)) {
+			return false;
+		}
+		buffer[b & MASK].store(p_value, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	// Owner only.
+	_FORCE_INLINE_ bool pop(T &r_value) {
+		int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+		bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t t = top.load(std::memory_order_relaxed);
+
+		if (t > b) {
+			// Empty.
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return false;
+		}
+
+		r_value = buffer[b & MASK].load(std::memory_order_relaxed);
+		if (t == b) {
+			// Last element, race against thieves.
+			bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return won;
+		}
+		return true;
+	}
+
+	// Any thread.
+	_FORCE_INLINE_ StealResult steal(T &r_value) {
+		int64_t t = top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t b = bottom.load(std::memory_order_acquire);
+
+		if (t >= b) {
+			return STEAL_EMPTY;
+		}
+
+		T value = buffer[t & MASK].load(std::memory_order_relaxed);
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			return STEAL_ABORT;
+		}
+		r_value = value;
+		return STEAL_OK;
+	}
+
+	// Any thread. Only a hint, unless the caller knows no push is happening concurrently.
+	_FORCE_INLINE_ bool is_empty() const {
+		int64_t t = top.load(std::memory_order_acquire);
+		int64_t b = bottom.load(std::memory_order_acquire);
+		return t >= b;
+	}
+
+	_FORCE_INLINE_ uint32_t get_capacity() const { return CAPACITY; }
+
+	WorkStealingQueue() {
+		for (uint32_t i = 0; i < CAPACITY; i++) {
+			buffer[i].store(T(), std::memory_order_relaxed);
+		}
+	}
+};
+
+#endif // WORK_STEALING_QUEUE_H
@@ -589,6 +589,10 @@ public:
 	static bool has_builtin_method(Variant::Type p_type, const StringName &p_method);
 
 	static ValidatedBuiltInMethod get_validated_builtin_method(Variant::Type p_type, const StringName &p_method);
+	// Returns the validated call to use when the arguments are known to be of exactly these types, or null if a
+	// regular call is needed to convert or check them. The call stores its result in place, so the return value
+	// must be initialized to get_builtin_method_return_type() beforehand (see VariantInternal::initialize()).
+	static ValidatedBuiltInMethod get_validated_builtin_method_for_arguments(Variant::Type p_type, const StringName &p_method, const Variant::Type *p_argument_types, int p_argument_count);
 	static PTRBuiltInMethod get_ptr_builtin_method(Variant::Type p_type, const StringName &p_method);
 
 	static MethodInfo get_builtin_method_info(Variant::Type p_type, const StringName &p_method);
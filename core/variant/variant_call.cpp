@@ -35,6 +35,7 @@
 #include "core/debugger/engine_debugger.h"
 #include "core/io/compression.h"
 #include "core/io/marshalls.h"
+#include "core/math/batch_math.h"
 #include "core/object/class_db.h"
 #include "core/os/os.h"
 #include "core/templates/local_vector.h"
@@ -663,6 +664,63 @@ static _FORCE_INLINE_ void vc_ptrcall(void (*method)(T *, P...), void *p_base, c
 		return p_instance->get(p_index);                                                          \
 	}
 
+// Bulk operations on float arrays, done in place through BatchMath unless they return a value.
+#define VARCALL_PACKED_FLOAT_OPERATIONS(m_packed_type, m_type)                                                                                             \
+	static void func_##m_packed_type##_add_scalar(m_packed_type *p_instance, double p_value) {                                                             \
+		m_type *w = p_instance->ptrw();                                                                                                                    \
+		BatchMath::add(w, (m_type)p_value, w, p_instance->size());                                                                                         \
+	}                                                                                                                                                      \
+	static void func_##m_packed_type##_add_array(m_packed_type *p_instance, const m_packed_type &p_array) {                                                \
+		ERR_FAIL_COND_MSG(p_array.size() != p_instance->size(), "Arrays must have the same size.");                                                        \
+		m_type *w = p_instance->ptrw();                                                                                                                    \
+		BatchMath::add(w, p_array.ptr(), w, p_instance->size());                                                                                           \
+	}                                                                                                                                                      \
+	static void func_##m_packed_type##_multiply_scalar(m_packed_type *p_instance, double p_value) {                                                        \
+		m_type *w = p_instance->ptrw();                                                                                                                    \
+		BatchMath::multiply(w, (m_type)p_value, w, p_instance->size());                                                                                    \
+	}                                                                                                                                                      \
+	static void func_##m_packed_type##_multiply_array(m_packed_type *p_instance, const m_packed_type &p_array) {                                           \
+		ERR_FAIL_COND_MSG(p_array.size() != p_instance->size(), "Arrays must have the same size.");                                                        \
+		m_type *w = p_instance->ptrw();                                                                                                                    \
+		BatchMath::multiply(w, p_array.ptr(), w, p_instance->size());                                                                                      \
+	}                                                                                                                                                      \
+	static void func_##m_packed_type##_multiply_add_scalar(m_packed_type *p_instance, double p_multiplier, double p_addend) {                              \
+		m_type *w = p_instance->ptrw();                                                                                                                    \
+		BatchMath::multiply_add(w, (m_type)p_multiplier, (m_type)p_addend, w, p_instance->size());                                                         \
+	}                                                                                                                                                      \
+	static void func_##m_packed_type##_multiply_add_array(m_packed_type *p_instance, const m_packed_type &p_multipliers, const m_packed_type &p_addends) { \
+		ERR_FAIL_COND_MSG(p_multipliers.size() != p_instance->size() || p_addends.size() != p_instance->size(), "Arrays must have the same size.");        \
+		m_type *w = p_instance->ptrw();                                                                                                                    \
+		BatchMath::multiply_add(w, p_multipliers.ptr(), p_addends.ptr(), w, p_instance->size());                                                           \
+	}                                                                                                                                                      \
+	static void func_##m_packed_type##_clamp(m_packed_type *p_instance, double p_min, double p_max) {                                                      \
+		ERR_FAIL_COND_MSG(p_min > p_max, "The minimum must not be greater than the maximum.");                                                             \
+		m_type *w = p_instance->ptrw();                                                                                                                    \
+		BatchMath::clamp(w, (m_type)p_min, (m_type)p_max, w, p_instance->size());                                                                          \
+	}                                                                                                                                                      \
+	static void func_##m_packed_type##_lerp(m_packed_type *p_instance, const m_packed_type &p_to, double p_weight) {                                       \
+		ERR_FAIL_COND_MSG(p_to.size() != p_instance->size(), "Arrays must have the same size.");                                                           \
+		m_type *w = p_instance->ptrw();                                                                                                                    \
+		BatchMath::lerp(w, p_to.ptr(), (m_type)p_weight, w, p_instance->size());                                                                           \
+	}                                                                                                                                                      \
+	static void func_##m_packed_type##_prefix_sum(m_packed_type *p_instance) {                                                                             \
+		m_type *w = p_instance->ptrw();                                                                                                                    \
+		BatchMath::prefix_sum(w, w, p_instance->size());                                                                                                   \
+	}                                                                                                                                                      \
+	static double func_##m_packed_type##_dot(m_packed_type *p_instance, const m_packed_type &p_array) {                                                    \
+		ERR_FAIL_COND_V_MSG(p_array.size() != p_instance->size(), 0, "Arrays must have the same size.");                                                   \
+		return BatchMath::dot(p_instance->ptr(), p_array.ptr(), p_instance->size());                                                                       \
+	}                                                                                                                                                      \
+	static double func_##m_packed_type##_sum(m_packed_type *p_instance) {                                                                                  \
+		return BatchMath::sum(p_instance->ptr(), p_instance->size());                                                                                      \
+	}                                                                                                                                                      \
+	static double func_##m_packed_type##_min(m_packed_type *p_instance) {                                                                                  \
+		return BatchMath::min(p_instance->ptr(), p_instance->size());                                                                                      \
+	}                                                                                                                                                      \
+	static double func_##m_packed_type##_max(m_packed_type *p_instance) {                                                                                  \
+		return BatchMath::max(p_instance->ptr(), p_instance->size());                                                                                      \
+	}
+
 struct _VariantCall {
 	VARCALL_PACKED_GETTER(PackedByteArray, uint8_t)
 	VARCALL_PACKED_GETTER(PackedColorArray, Color)
@@ -675,6 +733,46 @@ struct _VariantCall {
 	VARCALL_PACKED_GETTER(PackedVector3Array, Vector3)
 	VARCALL_PACKED_GETTER(PackedVector4Array, Vector4)
 
+	VARCALL_PACKED_FLOAT_OPERATIONS(PackedFloat32Array, float)
+	VARCALL_PACKED_FLOAT_OPERATIONS(PackedFloat64Array, double)
+
+	// Vector3 arrays are handled as flat arrays of real_t where it makes no difference.
+	static void func_PackedVector3Array_add_array(PackedVector3Array *p_instance, const PackedVector3Array &p_array) {
+		ERR_FAIL_COND_MSG(p_array.size() != p_instance->size(), "Arrays must have the same size.");
+		real_t *w = (real_t *)p_instance->ptrw();
+		BatchMath::add(w, (const real_t *)p_array.ptr(), w, p_instance->size() * 3);
+	}
+
+	static void func_PackedVector3Array_multiply_scalar(PackedVector3Array *p_instance, double p_value) {
+		real_t *w = (real_t *)p_instance->ptrw();
+		BatchMath::multiply(w, (real_t)p_value, w, p_instance->size() * 3);
+	}
+
+	static void func_PackedVector3Array_multiply_array(PackedVector3Array *p_instance, const PackedVector3Array &p_array) {
+		ERR_FAIL_COND_MSG(p_array.size() != p_instance->size(), "Arrays must have the same size.");
+		real_t *w = (real_t *)p_instance->ptrw();
+		BatchMath::multiply(w, (const real_t *)p_array.ptr(), w, p_instance->size() * 3);
+	}
+
+	static void func_PackedVector3Array_lerp(PackedVector3Array *p_instance, const PackedVector3Array &p_to, double p_weight) {
+		ERR_FAIL_COND_MSG(p_to.size() != p_instance->size(), "Arrays must have the same size.");
+		real_t *w = (real_t *)p_instance->ptrw();
+		BatchMath::lerp(w, (const real_t *)p_to.ptr(), (real_t)p_weight, w, p_instance->size() * 3);
+	}
+
+	static void func_PackedVector3Array_normalize(PackedVector3Array *p_instance) {
+		Vector3 *w = p_instance->ptrw();
+		BatchMath::normalize(w, w, p_instance->size());
+	}
+
+	// Always 32-bit, so the API doesn't depend on the precision of the build.
+	static PackedFloat32Array func_PackedVector3Array_get_lengths(PackedVector3Array *p_instance) {
+		PackedFloat32Array lengths;
+		lengths.resize(p_instance->size());
+		BatchMath::length(p_instance->ptr(), lengths.ptrw(), p_instance->size());
+		return lengths;
+	}
+
 	static String func_PackedByteArray_get_string_from_ascii(PackedByteArray *p_instance) {
 		String s;
 		if (p_instance->size() > 0) {
@@ -1321,6 +1419,24 @@ Variant::ValidatedBuiltInMethod Variant::get_validated_builtin_method(Variant::T
 	return method->validated_call;
 }
 
+Variant::ValidatedBuiltInMethod Variant::get_validated_builtin_method_for_arguments(Variant::Type p_type, const StringName &p_method, const Variant::Type *p_argument_types, int p_argument_count) {
+	ERR_FAIL_INDEX_V(p_type, Variant::VARIANT_MAX, nullptr);
+	const VariantBuiltInMethodInfo *method = builtin_method_info[p_type].lookup_ptr(p_method);
+	ERR_FAIL_NULL_V(method, nullptr);
+
+	// Vararg methods check their arguments at runtime, and validated calls don't fill in default arguments.
+	if (method->is_vararg || p_argument_count != method->argument_count) {
+		return nullptr;
+	}
+	for (int i = 0; i < p_argument_count; i++) {
+		// NIL stands for a type that isn't known, which needs a regular call like arguments taking any Variant.
+		if (p_argument_types[i] == Variant::NIL || p_argument_types[i] != method->get_argument_type(i)) {
+			return nullptr;
+		}
+	}
+	return method->validated_call;
+}
+
 Variant::PTRBuiltInMethod Variant::get_ptr_builtin_method(Variant::Type p_type, const StringName &p_method) {
 	ERR_FAIL_INDEX_V(p_type, Variant::VARIANT_MAX, nullptr);
 	const VariantBuiltInMethodInfo *method = builtin_method_info[p_type].lookup_ptr(p_method);
@@ -2422,6 +2538,41 @@ static void _register_variant_builtin_methods_array() {
 	bind_function(PackedByteArray, to_float32_array, _VariantCall::func_PackedByteArray_decode_float_array, sarray(), varray());
 	bind_function(PackedByteArray, to_float64_array, _VariantCall::func_PackedByteArray_decode_double_array, sarray(), varray());
 
+	bind_functionnc(PackedFloat32Array, add_scalar, _VariantCall::func_PackedFloat32Array_add_scalar, sarray("value"), varray());
+	bind_functionnc(PackedFloat32Array, add_array, _VariantCall::func_PackedFloat32Array_add_array, sarray("array"), varray());
+	bind_functionnc(PackedFloat32Array, multiply_scalar, _VariantCall::func_PackedFloat32Array_multiply_scalar, sarray("value"), varray());
+	bind_functionnc(PackedFloat32Array, multiply_array, _VariantCall::func_PackedFloat32Array_multiply_array, sarray("array"), varray());
+	bind_functionnc(PackedFloat32Array, multiply_add_scalar, _VariantCall::func_PackedFloat32Array_multiply_add_scalar, sarray("multiplier", "addend"), varray());
+	bind_functionnc(PackedFloat32Array, multiply_add_array, _VariantCall::func_PackedFloat32Array_multiply_add_array, sarray("multipliers", "addends"), varray());
+	bind_functionnc(PackedFloat32Array, clamp, _VariantCall::func_PackedFloat32Array_clamp, sarray("min", "max"), varray());
+	bind_functionnc(PackedFloat32Array, lerp, _VariantCall::func_PackedFloat32Array_lerp, sarray("to", "weight"), varray());
+	bind_functionnc(PackedFloat32Array, prefix_sum, _VariantCall::func_PackedFloat32Array_prefix_sum, sarray(), varray());
+	bind_function(PackedFloat32Array, dot, _VariantCall::func_PackedFloat32Array_dot, sarray("array"), varray());
+	bind_function(PackedFloat32Array, sum, _VariantCall::func_PackedFloat32Array_sum, sarray(), varray());
+	bind_function(PackedFloat32Array, min, _VariantCall::func_PackedFloat32Array_min, sarray(), varray());
+	bind_function(PackedFloat32Array, max, _VariantCall::func_PackedFloat32Array_max, sarray(), varray());
+
+	bind_functionnc(PackedFloat64Array, add_scalar, _VariantCall::func_PackedFloat64Array_add_scalar, sarray("value"), varray());
+	bind_functionnc(PackedFloat64Array, add_array, _VariantCall::func_PackedFloat64Array_add_array, sarray("array"), varray());
+	bind_functionnc(PackedFloat64Array, multiply_scalar, _VariantCall::func_PackedFloat64Array_multiply_scalar, sarray("value"), varray());
+	bind_functionnc(PackedFloat64Array, multiply_array, _VariantCall::func_PackedFloat64Array_multiply_array, sarray("array"), varray());
+	bind_functionnc(PackedFloat64Array, multiply_add_scalar, _VariantCall::func_PackedFloat64Array_multiply_add_scalar, sarray("multiplier", "addend"), varray());
+	bind_functionnc(PackedFloat64Array, multiply_add_array, _VariantCall::func_PackedFloat64Array_multiply_add_array, sarray("multipliers", "addends"), varray());
+	bind_functionnc(PackedFloat64Array, clamp, _VariantCall::func_PackedFloat64Array_clamp, sarray("min", "max"), varray());
+	bind_functionnc(PackedFloat64Array, lerp, _VariantCall::func_PackedFloat64Array_lerp, sarray("to", "weight"), varray());
+	bind_functionnc(PackedFloat64Array, prefix_sum, _VariantCall::func_PackedFloat64Array_prefix_sum, sarray(), varray());
+	bind_function(PackedFloat64Array, dot, _VariantCall::func_PackedFloat64Array_dot, sarray("array"), varray());
+	bind_function(PackedFloat64Array, sum, _VariantCall::func_PackedFloat64Array_sum, sarray(), varray());
+	bind_function(PackedFloat64Array, min, _VariantCall::func_PackedFloat64Array_min, sarray(), varray());
+	bind_function(PackedFloat64Array, max, _VariantCall::func_PackedFloat64Array_max, sarray(), varray());
+
+	bind_functionnc(PackedVector3Array, add_array, _VariantCall::func_PackedVector3Array_add_array, sarray("array"), varray());
+	bind_functionnc(PackedVector3Array, multiply_scalar, _VariantCall::func_PackedVector3Array_multiply_scalar, sarray("value"), varray());
+	bind_functionnc(PackedVector3Array, multiply_array, _VariantCall::func_PackedVector3Array_multiply_array, sarray("array"), varray());
+	bind_functionnc(PackedVector3Array, lerp, _VariantCall::func_PackedVector3Array_lerp, sarray("to", "weight"), varray());
+	bind_functionnc(PackedVector3Array, normalize, _VariantCall::func_PackedVector3Array_normalize, sarray(), varray());
+	bind_function(PackedVector3Array, get_lengths, _VariantCall::func_PackedVector3Array_get_lengths, sarray(), varray());
+
 	bind_functionnc(PackedByteArray, encode_u8, _VariantCall::func_PackedByteArray_encode_u8, sarray("byte_offset", "value"), varray());
 	bind_functionnc(PackedByteArray, encode_s8, _VariantCall::func_PackedByteArray_encode_s8, sarray("byte_offset", "value"), varray());
 	bind_functionnc(PackedByteArray, encode_u16, _VariantCall::func_PackedByteArray_encode_u16, sarray("byte_offset", "value"), varray());
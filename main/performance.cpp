@@ -98,6 +98,19 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(PIPELINE_COMPILATIONS_SURFACE);
 	BIND_ENUM_CONSTANT(PIPELINE_COMPILATIONS_DRAW);
 	BIND_ENUM_CONSTANT(PIPELINE_COMPILATIONS_SPECIALIZATION);
+	BIND_ENUM_CONSTANT(MEMORY_FRAME_ALLOCATOR_PEAK);
+	BIND_ENUM_CONSTANT(MEMORY_TAG_RENDERING);
+	BIND_ENUM_CONSTANT(MEMORY_TAG_PHYSICS);
+	BIND_ENUM_CONSTANT(MEMORY_TAG_SCRIPTING);
+	BIND_ENUM_CONSTANT(MEMORY_TAG_RESOURCES);
+	BIND_ENUM_CONSTANT(MEMORY_TAG_AUDIO);
+	BIND_ENUM_CONSTANT(MEMORY_TAG_NAVIGATION);
+	BIND_ENUM_CONSTANT(MEMORY_TAG_RENDERING_ALLOC_RATE);
+	BIND_ENUM_CONSTANT(MEMORY_TAG_PHYSICS_ALLOC_RATE);
+	BIND_ENUM_CONSTANT(MEMORY_TAG_SCRIPTING_ALLOC_RATE);
+	BIND_ENUM_CONSTANT(MEMORY_TAG_RESOURCES_ALLOC_RATE);
+	BIND_ENUM_CONSTANT(MEMORY_TAG_AUDIO_ALLOC_RATE);
+	BIND_ENUM_CONSTANT(MEMORY_TAG_NAVIGATION_ALLOC_RATE);
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
 
@@ -154,6 +167,19 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		PNAME("pipeline/compilations_surface"),
 		PNAME("pipeline/compilations_draw"),
 		PNAME("pipeline/compilations_specialization"),
+		PNAME("memory/frame_allocator_peak"),
+		PNAME("memory/rendering"),
+		PNAME("memory/physics"),
+		PNAME("memory/scripting"),
+		PNAME("memory/resources"),
+		PNAME("memory/audio"),
+		PNAME("memory/navigation"),
+		PNAME("memory/rendering_allocs_per_second"),
+		PNAME("memory/physics_allocs_per_second"),
+		PNAME("memory/scripting_allocs_per_second"),
+		PNAME("memory/resources_allocs_per_second"),
+		PNAME("memory/audio_allocs_per_second"),
+		PNAME("memory/navigation_allocs_per_second"),
 	};
 
 	return names[p_monitor];
@@ -175,6 +201,32 @@ double Performance::get_monitor(Monitor p_monitor) const {
 			return Memory::get_mem_max_usage();
 		case MEMORY_MESSAGE_BUFFER_MAX:
 			return MessageQueue::get_singleton()->get_max_buffer_usage();
+		case MEMORY_FRAME_ALLOCATOR_PEAK:
+			return FrameAllocator::get_peak_usage();
+		case MEMORY_TAG_RENDERING:
+			return Memory::get_tag_usage(Memory::TAG_RENDERING);
+		case MEMORY_TAG_PHYSICS:
+			return Memory::get_tag_usage(Memory::TAG_PHYSICS);
+		case MEMORY_TAG_SCRIPTING:
+			return Memory::get_tag_usage(Memory::TAG_SCRIPTING);
+		case MEMORY_TAG_RESOURCES:
+			return Memory::get_tag_usage(Memory::TAG_RESOURCES);
+		case MEMORY_TAG_AUDIO:
+			return Memory::get_tag_usage(Memory::TAG_AUDIO);
+		case MEMORY_TAG_NAVIGATION:
+			return Memory::get_tag_usage(Memory::TAG_NAVIGATION);
+		case MEMORY_TAG_RENDERING_ALLOC_RATE:
+			return _get_memory_tag_alloc_rate(Memory::TAG_RENDERING);
+		case MEMORY_TAG_PHYSICS_ALLOC_RATE:
+			return _get_memory_tag_alloc_rate(Memory::TAG_PHYSICS);
+		case MEMORY_TAG_SCRIPTING_ALLOC_RATE:
+			return _get_memory_tag_alloc_rate(Memory::TAG_SCRIPTING);
+		case MEMORY_TAG_RESOURCES_ALLOC_RATE:
+			return _get_memory_tag_alloc_rate(Memory::TAG_RESOURCES);
+		case MEMORY_TAG_AUDIO_ALLOC_RATE:
+			return _get_memory_tag_alloc_rate(Memory::TAG_AUDIO);
+		case MEMORY_TAG_NAVIGATION_ALLOC_RATE:
+			return _get_memory_tag_alloc_rate(Memory::TAG_NAVIGATION);
 		case OBJECT_COUNT:
 			return ObjectDB::get_object_count();
 		case OBJECT_RESOURCE_COUNT:
@@ -297,12 +349,44 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
 
 	};
 
 	return types[p_monitor];
 }
 
+double Performance::_get_memory_tag_alloc_rate(Memory::Tag p_tag) const {
+	const uint64_t usec = OS::get_singleton()->get_ticks_usec();
+	const uint64_t elapsed = usec - _memory_tag_sample_usec;
+	if (elapsed >= 1000000) {
+		for (int i = 0; i < Memory::TAG_MAX; i++) {
+			const uint64_t count = Memory::get_tag_alloc_count(Memory::Tag(i));
+			_memory_tag_alloc_rates[i] = _memory_tag_sample_usec == 0 ? 0.0 : (count - _memory_tag_alloc_counts[i]) * 1000000.0 / elapsed;
+			_memory_tag_alloc_counts[i] = count;
+		}
+		_memory_tag_sample_usec = usec;
+	}
+	return _memory_tag_alloc_rates[p_tag];
+}
+
 void Performance::set_process_time(double p_pt) {
 	_process_time = p_pt;
 }
@@ -66,6 +66,13 @@ class Performance : public Object {
 	HashMap<StringName, MonitorCall> _monitor_map;
 	uint64_t _monitor_modification_time;
 
+	// Allocation rates of the memory tags, sampled at most once per second.
+	mutable uint64_t _memory_tag_sample_usec = 0;
+	mutable uint64_t _memory_tag_alloc_counts[Memory::TAG_MAX] = {};
+	mutable double _memory_tag_alloc_rates[Memory::TAG_MAX] = {};
+
+	double _get_memory_tag_alloc_rate(Memory::Tag p_tag) const;
+
 public:
 	enum Monitor {
 		TIME_FPS,
@@ -107,6 +114,19 @@ public:
 		PIPELINE_COMPILATIONS_SURFACE,
 		PIPELINE_COMPILATIONS_DRAW,
 		PIPELINE_COMPILATIONS_SPECIALIZATION,
+		MEMORY_FRAME_ALLOCATOR_PEAK,
+		MEMORY_TAG_RENDERING,
+		MEMORY_TAG_PHYSICS,
+		MEMORY_TAG_SCRIPTING,
+		MEMORY_TAG_RESOURCES,
+		MEMORY_TAG_AUDIO,
+		MEMORY_TAG_NAVIGATION,
+		MEMORY_TAG_RENDERING_ALLOC_RATE,
+		MEMORY_TAG_PHYSICS_ALLOC_RATE,
+		MEMORY_TAG_SCRIPTING_ALLOC_RATE,
+		MEMORY_TAG_RESOURCES_ALLOC_RATE,
+		MEMORY_TAG_AUDIO_ALLOC_RATE,
+		MEMORY_TAG_NAVIGATION_ALLOC_RATE,
 		MONITOR_MAX
 	};
 
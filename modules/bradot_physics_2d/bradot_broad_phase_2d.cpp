@@ -33,5 +33,17 @@
 
 BradotBroadPhase2D::CreateFunction BradotBroadPhase2D::create_func = nullptr;
 
+void BradotBroadPhase2D::cull_segment_packet(const Vector2 *p_from, const Vector2 *p_to, int p_count, BradotCollisionObject2D **p_results, int p_max_results, int *r_result_counts, int *p_result_indices) {
+	for (int i = 0; i < p_count; i++) {
+		r_result_counts[i] = cull_segment(p_from[i], p_to[i], p_results + i * p_max_results, p_max_results, p_result_indices ? p_result_indices + i * p_max_results : nullptr);
+	}
+}
+
+void BradotBroadPhase2D::cull_aabb_packet(const Rect2 *p_aabbs, int p_count, BradotCollisionObject2D **p_results, int p_max_results, int *r_result_counts, int *p_result_indices) {
+	for (int i = 0; i < p_count; i++) {
+		r_result_counts[i] = cull_aabb(p_aabbs[i], p_results + i * p_max_results, p_max_results, p_result_indices ? p_result_indices + i * p_max_results : nullptr);
+	}
+}
+
 BradotBroadPhase2D::~BradotBroadPhase2D() {
 }
@@ -82,6 +82,14 @@ int BradotBroadPhase2DBVH::cull_aabb(const Rect2 &p_aabb, BradotCollisionObject2
 	return bvh.cull_aabb(p_aabb, p_results, p_max_results, nullptr, 0xFFFFFFFF, p_result_indices);
 }
 
+void BradotBroadPhase2DBVH::cull_segment_packet(const Vector2 *p_from, const Vector2 *p_to, int p_count, BradotCollisionObject2D **p_results, int p_max_results, int *r_result_counts, int *p_result_indices) {
+	bvh.cull_segment_packet(p_from, p_to, p_count, p_results, p_max_results, r_result_counts, nullptr, 0xFFFFFFFF, p_result_indices);
+}
+
+void BradotBroadPhase2DBVH::cull_aabb_packet(const Rect2 *p_aabbs, int p_count, BradotCollisionObject2D **p_results, int p_max_results, int *r_result_counts, int *p_result_indices) {
+	bvh.cull_aabb_packet(p_aabbs, p_count, p_results, p_max_results, r_result_counts, nullptr, 0xFFFFFFFF, p_result_indices);
+}
+
 void *BradotBroadPhase2DBVH::_pair_callback(void *self, uint32_t p_A, BradotCollisionObject2D *p_object_A, int subindex_A, uint32_t p_B, BradotCollisionObject2D *p_object_B, int subindex_B) {
 	BradotBroadPhase2DBVH *bpo = static_cast<BradotBroadPhase2DBVH *>(self);
 	if (!bpo->pair_callback) {
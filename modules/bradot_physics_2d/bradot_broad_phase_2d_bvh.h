@@ -89,6 +89,8 @@ public:
 
 	virtual int cull_segment(const Vector2 &p_from, const Vector2 &p_to, BradotCollisionObject2D **p_results, int p_max_results, int *p_result_indices = nullptr) override;
 	virtual int cull_aabb(const Rect2 &p_aabb, BradotCollisionObject2D **p_results, int p_max_results, int *p_result_indices = nullptr) override;
+	virtual void cull_segment_packet(const Vector2 *p_from, const Vector2 *p_to, int p_count, BradotCollisionObject2D **p_results, int p_max_results, int *r_result_counts, int *p_result_indices = nullptr) override;
+	virtual void cull_aabb_packet(const Rect2 *p_aabbs, int p_count, BradotCollisionObject2D **p_results, int p_max_results, int *r_result_counts, int *p_result_indices = nullptr) override;
 
 	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata) override;
 	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) override;
@@ -1289,6 +1289,8 @@ void BradotPhysicsServer2D::init() {
 }
 
 void BradotPhysicsServer2D::step(real_t p_step) {
+	MemoryTagScope memory_tag_scope(Memory::TAG_PHYSICS);
+
 	if (!active) {
 		return;
 	}
@@ -1311,6 +1313,8 @@ void BradotPhysicsServer2D::sync() {
 }
 
 void BradotPhysicsServer2D::flush_queries() {
+	MemoryTagScope memory_tag_scope(Memory::TAG_PHYSICS);
+
 	if (!active) {
 		return;
 	}
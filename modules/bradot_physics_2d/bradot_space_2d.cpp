@@ -34,6 +34,7 @@
 #include "bradot_collision_solver_2d.h"
 #include "bradot_physics_server_2d.h"
 
+#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 #include "core/templates/pair.h"
 
@@ -115,17 +116,13 @@ int BradotPhysicsDirectSpaceState2D::intersect_point(const PointParameters &p_pa
 	return cc;
 }
 
-bool BradotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
-	ERR_FAIL_COND_V(space->locked, false);
-
+bool BradotPhysicsDirectSpaceState2D::_intersect_ray(const RayParameters &p_parameters, const Vector2 &p_from, const Vector2 &p_to, RayResult &r_result, BradotCollisionObject2D *const *p_cull_results, const int *p_cull_subindices, int p_cull_count) const {
 	Vector2 begin, end;
 	Vector2 normal;
-	begin = p_parameters.from;
-	end = p_parameters.to;
+	begin = p_from;
+	end = p_to;
 	normal = (end - begin).normalized();
 
-	int amount = space->broadphase->cull_segment(begin, end, space->intersection_query_results, BradotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
-
 	//todo, create another array that references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
 
 	bool collided = false;
@@ -134,18 +131,18 @@ bool BradotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_param
 	const BradotCollisionObject2D *res_obj = nullptr;
 	real_t min_d = 1e10;
 
-	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+	for (int i = 0; i < p_cull_count; i++) {
+		if (!_can_collide_with(p_cull_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(p_cull_results[i]->get_self())) {
 			continue;
 		}
 
-		const BradotCollisionObject2D *col_obj = space->intersection_query_results[i];
+		const BradotCollisionObject2D *col_obj = p_cull_results[i];
 
-		int shape_idx = space->intersection_query_subindex_results[i];
+		int shape_idx = p_cull_subindices[i];
 		Transform2D inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
 
 		Vector2 local_from = inv_xform.xform(begin);
@@ -205,39 +202,34 @@ bool BradotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_param
 	return true;
 }
 
-int BradotPhysicsDirectSpaceState2D::intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) {
-	if (p_result_max <= 0) {
-		return 0;
-	}
-
-	BradotShape2D *shape = BradotPhysicsServer2D::bradot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
-	ERR_FAIL_NULL_V(shape, 0);
+bool BradotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
+	ERR_FAIL_COND_V(space->locked, false);
 
-	Rect2 aabb = p_parameters.transform.xform(shape->get_aabb());
-	aabb = aabb.merge(Rect2(aabb.position + p_parameters.motion, aabb.size)); //motion
-	aabb = aabb.grow(p_parameters.margin);
+	int amount = space->broadphase->cull_segment(p_parameters.from, p_parameters.to, space->intersection_query_results, BradotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
 
-	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, BradotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+	return _intersect_ray(p_parameters, p_parameters.from, p_parameters.to, r_result, space->intersection_query_results, space->intersection_query_subindex_results, amount);
+}
 
+int BradotPhysicsDirectSpaceState2D::_intersect_shape(const ShapeParameters &p_parameters, const BradotShape2D *p_shape, const Transform2D &p_transform, ShapeResult *r_results, int p_result_max, BradotCollisionObject2D *const *p_cull_results, const int *p_cull_subindices, int p_cull_count) const {
 	int cc = 0;
 
-	for (int i = 0; i < amount; i++) {
+	for (int i = 0; i < p_cull_count; i++) {
 		if (cc >= p_result_max) {
 			break;
 		}
 
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+		if (!_can_collide_with(p_cull_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(p_cull_results[i]->get_self())) {
 			continue;
 		}
 
-		const BradotCollisionObject2D *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const BradotCollisionObject2D *col_obj = p_cull_results[i];
+		int shape_idx = p_cull_subindices[i];
 
-		if (!BradotCollisionSolver2D::solve(shape, p_parameters.transform, p_parameters.motion, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
+		if (!BradotCollisionSolver2D::solve(p_shape, p_transform, p_parameters.motion, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
 			continue;
 		}
 
@@ -254,43 +246,55 @@ int BradotPhysicsDirectSpaceState2D::intersect_shape(const ShapeParameters &p_pa
 	return cc;
 }
 
-bool BradotPhysicsDirectSpaceState2D::cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe) {
+int BradotPhysicsDirectSpaceState2D::intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) {
+	if (p_result_max <= 0) {
+		return 0;
+	}
+
 	BradotShape2D *shape = BradotPhysicsServer2D::bradot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
-	ERR_FAIL_NULL_V(shape, false);
+	ERR_FAIL_NULL_V(shape, 0);
 
-	Rect2 aabb = p_parameters.transform.xform(shape->get_aabb());
-	aabb = aabb.merge(Rect2(aabb.position + p_parameters.motion, aabb.size)); //motion
-	aabb = aabb.grow(p_parameters.margin);
+	Rect2 aabb = _get_motion_aabb(shape, p_parameters.transform, p_parameters.motion, p_parameters.margin);
 
 	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, BradotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
 
+	return _intersect_shape(p_parameters, shape, p_parameters.transform, r_results, p_result_max, space->intersection_query_results, space->intersection_query_subindex_results, amount);
+}
+
+Rect2 BradotPhysicsDirectSpaceState2D::_get_motion_aabb(const BradotShape2D *p_shape, const Transform2D &p_transform, const Vector2 &p_motion, real_t p_margin) {
+	Rect2 aabb = p_transform.xform(p_shape->get_aabb());
+	aabb = aabb.merge(Rect2(aabb.position + p_motion, aabb.size)); //motion
+	return aabb.grow(p_margin);
+}
+
+void BradotPhysicsDirectSpaceState2D::_cast_motion(const ShapeParameters &p_parameters, const BradotShape2D *p_shape, const Transform2D &p_transform, const Vector2 &p_motion, real_t &p_closest_safe, real_t &p_closest_unsafe, BradotCollisionObject2D *const *p_cull_results, const int *p_cull_subindices, int p_cull_count) const {
 	real_t best_safe = 1;
 	real_t best_unsafe = 1;
 
-	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+	for (int i = 0; i < p_cull_count; i++) {
+		if (!_can_collide_with(p_cull_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(p_cull_results[i]->get_self())) {
 			continue; //ignore excluded
 		}
 
-		const BradotCollisionObject2D *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const BradotCollisionObject2D *col_obj = p_cull_results[i];
+		int shape_idx = p_cull_subindices[i];
 
 		Transform2D col_obj_xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
 		//test initial overlap, does it collide if going all the way?
-		if (!BradotCollisionSolver2D::solve(shape, p_parameters.transform, p_parameters.motion, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
+		if (!BradotCollisionSolver2D::solve(p_shape, p_transform, p_motion, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
 			continue;
 		}
 
 		//test initial overlap, ignore objects it's inside of.
-		if (BradotCollisionSolver2D::solve(shape, p_parameters.transform, Vector2(), col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
+		if (BradotCollisionSolver2D::solve(p_shape, p_transform, Vector2(), col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
 			continue;
 		}
 
-		Vector2 mnormal = p_parameters.motion.normalized();
+		Vector2 mnormal = p_motion.normalized();
 
 		//just do kinematic solving
 		real_t low = 0.0;
@@ -300,7 +304,7 @@ bool BradotPhysicsDirectSpaceState2D::cast_motion(const ShapeParameters &p_param
 			real_t fraction = low + (hi - low) * fraction_coeff;
 
 			Vector2 sep = mnormal; //important optimization for this to work fast enough
-			bool collided = BradotCollisionSolver2D::solve(shape, p_parameters.transform, p_parameters.motion * fraction, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, &sep, p_parameters.margin);
+			bool collided = BradotCollisionSolver2D::solve(p_shape, p_transform, p_motion * fraction, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, &sep, p_parameters.margin);
 
 			if (collided) {
 				hi = fraction;
@@ -333,10 +337,178 @@ bool BradotPhysicsDirectSpaceState2D::cast_motion(const ShapeParameters &p_param
 
 	p_closest_safe = best_safe;
 	p_closest_unsafe = best_unsafe;
+}
 
+bool BradotPhysicsDirectSpaceState2D::cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe) {
+	BradotShape2D *shape = BradotPhysicsServer2D::bradot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
+	ERR_FAIL_NULL_V(shape, false);
+
+	Rect2 aabb = _get_motion_aabb(shape, p_parameters.transform, p_parameters.motion, p_parameters.margin);
+
+	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, BradotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+
+	_cast_motion(p_parameters, shape, p_parameters.transform, p_parameters.motion, p_closest_safe, p_closest_unsafe, space->intersection_query_results, space->intersection_query_subindex_results, amount);
 	return true;
 }
 
+void BradotPhysicsDirectSpaceState2D::_intersect_ray_batch_group(uint32_t p_group, RayBatch *p_batch) {
+	// Each group has its own cull buffers, the broadphase itself is safe to query from several threads.
+	// Queries are culled in packets, which share a single traversal of the broadphase.
+	LocalVector<BradotCollisionObject2D *> cull_results;
+	LocalVector<int> cull_subindices;
+	cull_results.resize(BradotBroadPhase2D::PACKET_SIZE * BradotSpace2D::INTERSECTION_QUERY_MAX);
+	cull_subindices.resize(BradotBroadPhase2D::PACKET_SIZE * BradotSpace2D::INTERSECTION_QUERY_MAX);
+	int cull_counts[BradotBroadPhase2D::PACKET_SIZE];
+
+	const int begin = p_group * BATCH_QUERY_GROUP_SIZE;
+	const int end = MIN(begin + BATCH_QUERY_GROUP_SIZE, p_batch->count);
+	int hits = 0;
+	for (int i = begin; i < end; i += BradotBroadPhase2D::PACKET_SIZE) {
+		const int packet_count = MIN(BradotBroadPhase2D::PACKET_SIZE, end - i);
+		space->broadphase->cull_segment_packet(p_batch->from + i, p_batch->to + i, packet_count, cull_results.ptr(), BradotSpace2D::INTERSECTION_QUERY_MAX, cull_counts, cull_subindices.ptr());
+
+		for (int j = 0; j < packet_count; j++) {
+			const int offset = j * BradotSpace2D::INTERSECTION_QUERY_MAX;
+			if (_intersect_ray(*p_batch->parameters, p_batch->from[i + j], p_batch->to[i + j], p_batch->results[i + j], cull_results.ptr() + offset, cull_subindices.ptr() + offset, cull_counts[j])) {
+				hits++;
+			} else {
+				p_batch->results[i + j] = RayResult();
+			}
+		}
+	}
+	p_batch->hits.add(hits);
+}
+
+void BradotPhysicsDirectSpaceState2D::_intersect_shape_batch_group(uint32_t p_group, ShapeBatch *p_batch) {
+	const int begin = p_group * BATCH_QUERY_GROUP_SIZE;
+	const int end = MIN(begin + BATCH_QUERY_GROUP_SIZE, p_batch->count);
+	for (int i = begin; i < end; i++) {
+		p_batch->result_counts[i] = 0;
+	}
+
+	if (p_batch->result_max <= 0) {
+		return;
+	}
+
+	BradotShape2D *shape = BradotPhysicsServer2D::bradot_singleton->shape_owner.get_or_null(p_batch->parameters->shape_rid);
+	ERR_FAIL_NULL(shape);
+
+	LocalVector<BradotCollisionObject2D *> cull_results;
+	LocalVector<int> cull_subindices;
+	cull_results.resize(BradotBroadPhase2D::PACKET_SIZE * BradotSpace2D::INTERSECTION_QUERY_MAX);
+	cull_subindices.resize(BradotBroadPhase2D::PACKET_SIZE * BradotSpace2D::INTERSECTION_QUERY_MAX);
+	int cull_counts[BradotBroadPhase2D::PACKET_SIZE];
+	Transform2D transforms[BradotBroadPhase2D::PACKET_SIZE];
+	Rect2 aabbs[BradotBroadPhase2D::PACKET_SIZE];
+
+	for (int i = begin; i < end; i += BradotBroadPhase2D::PACKET_SIZE) {
+		const int packet_count = MIN(BradotBroadPhase2D::PACKET_SIZE, end - i);
+		for (int j = 0; j < packet_count; j++) {
+			transforms[j] = p_batch->parameters->transform;
+			transforms[j].set_origin(p_batch->origins[i + j]);
+			aabbs[j] = _get_motion_aabb(shape, transforms[j], p_batch->parameters->motion, p_batch->parameters->margin);
+		}
+
+		space->broadphase->cull_aabb_packet(aabbs, packet_count, cull_results.ptr(), BradotSpace2D::INTERSECTION_QUERY_MAX, cull_counts, cull_subindices.ptr());
+
+		for (int j = 0; j < packet_count; j++) {
+			const int offset = j * BradotSpace2D::INTERSECTION_QUERY_MAX;
+			p_batch->result_counts[i + j] = _intersect_shape(*p_batch->parameters, shape, transforms[j], p_batch->results + (i + j) * p_batch->result_max, p_batch->result_max, cull_results.ptr() + offset, cull_subindices.ptr() + offset, cull_counts[j]);
+		}
+	}
+}
+
+void BradotPhysicsDirectSpaceState2D::_cast_motion_batch_group(uint32_t p_group, ShapeBatch *p_batch) {
+	const int begin = p_group * BATCH_QUERY_GROUP_SIZE;
+	const int end = MIN(begin + BATCH_QUERY_GROUP_SIZE, p_batch->count);
+	for (int i = begin; i < end; i++) {
+		p_batch->closest_safe[i] = 1.0;
+		p_batch->closest_unsafe[i] = 1.0;
+	}
+
+	BradotShape2D *shape = BradotPhysicsServer2D::bradot_singleton->shape_owner.get_or_null(p_batch->parameters->shape_rid);
+	ERR_FAIL_NULL(shape);
+
+	LocalVector<BradotCollisionObject2D *> cull_results;
+	LocalVector<int> cull_subindices;
+	cull_results.resize(BradotBroadPhase2D::PACKET_SIZE * BradotSpace2D::INTERSECTION_QUERY_MAX);
+	cull_subindices.resize(BradotBroadPhase2D::PACKET_SIZE * BradotSpace2D::INTERSECTION_QUERY_MAX);
+	int cull_counts[BradotBroadPhase2D::PACKET_SIZE];
+	Transform2D transforms[BradotBroadPhase2D::PACKET_SIZE];
+	Rect2 aabbs[BradotBroadPhase2D::PACKET_SIZE];
+
+	for (int i = begin; i < end; i += BradotBroadPhase2D::PACKET_SIZE) {
+		const int packet_count = MIN(BradotBroadPhase2D::PACKET_SIZE, end - i);
+		for (int j = 0; j < packet_count; j++) {
+			transforms[j] = p_batch->parameters->transform;
+			transforms[j].set_origin(p_batch->origins[i + j]);
+			aabbs[j] = _get_motion_aabb(shape, transforms[j], p_batch->motions[i + j], p_batch->parameters->margin);
+		}
+
+		space->broadphase->cull_aabb_packet(aabbs, packet_count, cull_results.ptr(), BradotSpace2D::INTERSECTION_QUERY_MAX, cull_counts, cull_subindices.ptr());
+
+		for (int j = 0; j < packet_count; j++) {
+			const int offset = j * BradotSpace2D::INTERSECTION_QUERY_MAX;
+			_cast_motion(*p_batch->parameters, shape, transforms[j], p_batch->motions[i + j], p_batch->closest_safe[i + j], p_batch->closest_unsafe[i + j], cull_results.ptr() + offset, cull_subindices.ptr() + offset, cull_counts[j]);
+		}
+	}
+}
+
+template <typename B>
+void BradotPhysicsDirectSpaceState2D::_run_batch(void (BradotPhysicsDirectSpaceState2D::*p_method)(uint32_t, B *), B *p_batch, const String &p_description) {
+	const int group_count = (p_batch->count + BATCH_QUERY_GROUP_SIZE - 1) / BATCH_QUERY_GROUP_SIZE;
+	if (group_count <= 1) {
+		// Not worth waking up other threads.
+		for (int i = 0; i < group_count; i++) {
+			(this->*p_method)(i, p_batch);
+		}
+		return;
+	}
+
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, p_method, p_batch, group_count, -1, true, p_description);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+}
+
+int BradotPhysicsDirectSpaceState2D::intersect_ray_batch(const RayParameters &p_parameters, const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results) {
+	ERR_FAIL_COND_V(space->locked, 0);
+
+	RayBatch batch;
+	batch.parameters = &p_parameters;
+	batch.from = p_from;
+	batch.to = p_to;
+	batch.results = r_results;
+	batch.count = p_count;
+	_run_batch(&BradotPhysicsDirectSpaceState2D::_intersect_ray_batch_group, &batch, SNAME("Physics2DIntersectRayBatch"));
+
+	return batch.hits.get();
+}
+
+void BradotPhysicsDirectSpaceState2D::intersect_shape_batch(const ShapeParameters &p_parameters, const Vector2 *p_origins, int p_count, ShapeResult *r_results, int p_result_max, int *r_result_counts) {
+	ERR_FAIL_COND(space->locked);
+
+	ShapeBatch batch;
+	batch.parameters = &p_parameters;
+	batch.origins = p_origins;
+	batch.count = p_count;
+	batch.results = r_results;
+	batch.result_max = p_result_max;
+	batch.result_counts = r_result_counts;
+	_run_batch(&BradotPhysicsDirectSpaceState2D::_intersect_shape_batch_group, &batch, SNAME("Physics2DIntersectShapeBatch"));
+}
+
+void BradotPhysicsDirectSpaceState2D::cast_motion_batch(const ShapeParameters &p_parameters, const Vector2 *p_origins, const Vector2 *p_motions, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) {
+	ERR_FAIL_COND(space->locked);
+
+	ShapeBatch batch;
+	batch.parameters = &p_parameters;
+	batch.origins = p_origins;
+	batch.motions = p_motions;
+	batch.count = p_count;
+	batch.closest_safe = r_closest_safe;
+	batch.closest_unsafe = r_closest_unsafe;
+	_run_batch(&BradotPhysicsDirectSpaceState2D::_cast_motion_batch_group, &batch, SNAME("Physics2DCastMotionBatch"));
+}
+
 bool BradotPhysicsDirectSpaceState2D::collide_shape(const ShapeParameters &p_parameters, Vector2 *r_results, int p_result_max, int &r_result_count) {
 	if (p_result_max <= 0) {
 		return false;
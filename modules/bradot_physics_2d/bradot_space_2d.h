@@ -46,6 +46,42 @@
 class BradotPhysicsDirectSpaceState2D : public PhysicsDirectSpaceState2D {
 	BRCLASS(BradotPhysicsDirectSpaceState2D, PhysicsDirectSpaceState2D);
 
+	// Queries in a batch are split in groups of this size, each running as one task.
+	static constexpr int BATCH_QUERY_GROUP_SIZE = 64;
+
+	struct RayBatch {
+		const RayParameters *parameters = nullptr;
+		const Vector2 *from = nullptr;
+		const Vector2 *to = nullptr;
+		RayResult *results = nullptr;
+		int count = 0;
+		SafeNumeric<int> hits;
+	};
+
+	struct ShapeBatch {
+		const ShapeParameters *parameters = nullptr;
+		const Vector2 *origins = nullptr;
+		const Vector2 *motions = nullptr;
+		int count = 0;
+		ShapeResult *results = nullptr;
+		int result_max = 0;
+		int *result_counts = nullptr;
+		real_t *closest_safe = nullptr;
+		real_t *closest_unsafe = nullptr;
+	};
+
+	// These run the narrow phase on objects the caller already culled from the broadphase.
+	bool _intersect_ray(const RayParameters &p_parameters, const Vector2 &p_from, const Vector2 &p_to, RayResult &r_result, BradotCollisionObject2D *const *p_cull_results, const int *p_cull_subindices, int p_cull_count) const;
+	int _intersect_shape(const ShapeParameters &p_parameters, const BradotShape2D *p_shape, const Transform2D &p_transform, ShapeResult *r_results, int p_result_max, BradotCollisionObject2D *const *p_cull_results, const int *p_cull_subindices, int p_cull_count) const;
+	void _cast_motion(const ShapeParameters &p_parameters, const BradotShape2D *p_shape, const Transform2D &p_transform, const Vector2 &p_motion, real_t &p_closest_safe, real_t &p_closest_unsafe, BradotCollisionObject2D *const *p_cull_results, const int *p_cull_subindices, int p_cull_count) const;
+	static Rect2 _get_motion_aabb(const BradotShape2D *p_shape, const Transform2D &p_transform, const Vector2 &p_motion, real_t p_margin);
+
+	void _intersect_ray_batch_group(uint32_t p_group, RayBatch *p_batch);
+	void _intersect_shape_batch_group(uint32_t p_group, ShapeBatch *p_batch);
+	void _cast_motion_batch_group(uint32_t p_group, ShapeBatch *p_batch);
+	template <typename B>
+	void _run_batch(void (BradotPhysicsDirectSpaceState2D::*p_method)(uint32_t, B *), B *p_batch, const String &p_description);
+
 public:
 	BradotSpace2D *space = nullptr;
 
@@ -56,6 +92,10 @@ public:
 	virtual bool collide_shape(const ShapeParameters &p_parameters, Vector2 *r_results, int p_result_max, int &r_result_count) override;
 	virtual bool rest_info(const ShapeParameters &p_parameters, ShapeRestInfo *r_info) override;
 
+	virtual int intersect_ray_batch(const RayParameters &p_parameters, const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results) override;
+	virtual void intersect_shape_batch(const ShapeParameters &p_parameters, const Vector2 *p_origins, int p_count, ShapeResult *r_results, int p_result_max, int *r_result_counts) override;
+	virtual void cast_motion_batch(const ShapeParameters &p_parameters, const Vector2 *p_origins, const Vector2 *p_motions, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) override;
+
 	BradotPhysicsDirectSpaceState2D() {}
 };
 
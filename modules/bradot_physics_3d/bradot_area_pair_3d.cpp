@@ -93,6 +93,15 @@ void BradotAreaPair3D::solve(real_t p_step) {
 	// Nothing to do.
 }
 
+BradotConstraint3D::Key BradotAreaPair3D::get_key() const {
+	Key key;
+	key.object_A = area->get_state_id();
+	key.object_B = body->get_state_id();
+	key.shape_A = area_shape;
+	key.shape_B = body_shape;
+	return key;
+}
+
 BradotAreaPair3D::BradotAreaPair3D(BradotBody3D *p_body, int p_body_shape, BradotArea3D *p_area, int p_area_shape) {
 	body = p_body;
 	area = p_area;
@@ -176,6 +185,15 @@ void BradotArea2Pair3D::solve(real_t p_step) {
 	// Nothing to do.
 }
 
+BradotConstraint3D::Key BradotArea2Pair3D::get_key() const {
+	Key key;
+	key.object_A = area_a->get_state_id();
+	key.object_B = area_b->get_state_id();
+	key.shape_A = shape_a;
+	key.shape_B = shape_b;
+	return key;
+}
+
 BradotArea2Pair3D::BradotArea2Pair3D(BradotArea3D *p_area_a, int p_shape_a, BradotArea3D *p_area_b, int p_shape_b) {
 	area_a = p_area_a;
 	area_b = p_area_b;
@@ -271,6 +289,15 @@ void BradotAreaSoftBodyPair3D::solve(real_t p_step) {
 	// Nothing to do.
 }
 
+BradotConstraint3D::Key BradotAreaSoftBodyPair3D::get_key() const {
+	Key key;
+	key.object_A = area->get_state_id();
+	key.object_B = soft_body->get_state_id();
+	key.shape_A = area_shape;
+	key.shape_B = soft_body_shape;
+	return key;
+}
+
 BradotAreaSoftBodyPair3D::BradotAreaSoftBodyPair3D(BradotSoftBody3D *p_soft_body, int p_soft_body_shape, BradotArea3D *p_area, int p_area_shape) {
 	soft_body = p_soft_body;
 	area = p_area;
@@ -48,6 +48,8 @@ class BradotAreaPair3D : public BradotConstraint3D {
 	bool body_has_attached_area = false;
 
 public:
+	virtual Key get_key() const override;
+
 	virtual bool setup(real_t p_step) override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
@@ -69,6 +71,8 @@ class BradotArea2Pair3D : public BradotConstraint3D {
 	bool area_b_monitorable;
 
 public:
+	virtual Key get_key() const override;
+
 	virtual bool setup(real_t p_step) override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
@@ -88,6 +92,8 @@ class BradotAreaSoftBodyPair3D : public BradotConstraint3D {
 	bool body_has_attached_area = false;
 
 public:
+	virtual Key get_key() const override;
+
 	virtual bool setup(real_t p_step) override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
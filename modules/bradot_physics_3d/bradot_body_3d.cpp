@@ -34,6 +34,7 @@
 #include "bradot_area_3d.h"
 #include "bradot_body_direct_state_3d.h"
 #include "bradot_space_3d.h"
+#include "bradot_state_3d.h"
 
 void BradotBody3D::_mass_properties_changed() {
 	if (get_space() && !mass_properties_update_list.in_list()) {
@@ -799,6 +800,79 @@ bool BradotBody3D::sleep_test(real_t p_step) {
 	}
 }
 
+void BradotBody3D::save_state(BradotStateWriter3D &p_writer) const {
+	p_writer.put_transform(get_transform());
+	p_writer.put_transform(get_inv_transform());
+	p_writer.put_transform(new_transform);
+	p_writer.put_vector3(linear_velocity);
+	p_writer.put_vector3(angular_velocity);
+	p_writer.put_vector3(prev_linear_velocity);
+	p_writer.put_vector3(prev_angular_velocity);
+	p_writer.put_vector3(constant_linear_velocity);
+	p_writer.put_vector3(constant_angular_velocity);
+	p_writer.put_vector3(applied_force);
+	p_writer.put_vector3(applied_torque);
+	p_writer.put_vector3(constant_force);
+	p_writer.put_vector3(constant_torque);
+	p_writer.put_real(still_time);
+	p_writer.put_bool(active);
+	p_writer.put_bool(first_time_kinematic);
+	_save_shape_bounds(p_writer);
+}
+
+void BradotBody3D::_read_state(BradotStateReader3D &p_reader, SavedState &r_state) {
+	r_state.transform = p_reader.get_transform();
+	r_state.inv_transform = p_reader.get_transform();
+	r_state.new_transform = p_reader.get_transform();
+	r_state.linear_velocity = p_reader.get_vector3();
+	r_state.angular_velocity = p_reader.get_vector3();
+	r_state.prev_linear_velocity = p_reader.get_vector3();
+	r_state.prev_angular_velocity = p_reader.get_vector3();
+	r_state.constant_linear_velocity = p_reader.get_vector3();
+	r_state.constant_angular_velocity = p_reader.get_vector3();
+	r_state.applied_force = p_reader.get_vector3();
+	r_state.applied_torque = p_reader.get_vector3();
+	r_state.constant_force = p_reader.get_vector3();
+	r_state.constant_torque = p_reader.get_vector3();
+	r_state.still_time = p_reader.get_real();
+	r_state.active = p_reader.get_bool();
+	r_state.first_time_kinematic = p_reader.get_bool();
+	_read_shape_bounds(p_reader, r_state.shape_bounds);
+}
+
+void BradotBody3D::load_state(BradotStateReader3D &p_reader) {
+	SavedState state;
+	_read_state(p_reader, state);
+	ERR_FAIL_COND(p_reader.has_error());
+
+	new_transform = state.new_transform;
+	linear_velocity = state.linear_velocity;
+	angular_velocity = state.angular_velocity;
+	prev_linear_velocity = state.prev_linear_velocity;
+	prev_angular_velocity = state.prev_angular_velocity;
+	constant_linear_velocity = state.constant_linear_velocity;
+	constant_angular_velocity = state.constant_angular_velocity;
+	applied_force = state.applied_force;
+	applied_torque = state.applied_torque;
+	constant_force = state.constant_force;
+	constant_torque = state.constant_torque;
+	still_time = state.still_time;
+	first_time_kinematic = state.first_time_kinematic;
+
+	// The inverse is restored as is, recomputing it could round differently.
+	_set_transform(state.transform);
+	_set_inv_transform(state.inv_transform);
+	_update_transform_dependent();
+	_apply_shape_bounds(state.shape_bounds);
+	set_active(state.active);
+}
+
+bool BradotBody3D::validate_state(BradotStateReader3D &p_reader) {
+	SavedState state;
+	_read_state(p_reader, state);
+	return !p_reader.has_error();
+}
+
 void BradotBody3D::set_state_sync_callback(const Callable &p_callable) {
 	body_state_callback = p_callable;
 }
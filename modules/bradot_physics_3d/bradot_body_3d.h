@@ -39,6 +39,8 @@
 
 class BradotConstraint3D;
 class BradotPhysicsDirectBodyState3D;
+class BradotStateReader3D;
+class BradotStateWriter3D;
 
 class BradotBody3D : public BradotCollisionObject3D {
 	PhysicsServer3D::BodyMode mode = PhysicsServer3D::BODY_MODE_RIGID;
@@ -149,6 +151,29 @@ class BradotBody3D : public BradotCollisionObject3D {
 
 	void _update_transform_dependent();
 
+	// What save_state() writes, read in full before any of it is applied.
+	struct SavedState {
+		Transform3D transform;
+		Transform3D inv_transform;
+		Transform3D new_transform;
+		Vector3 linear_velocity;
+		Vector3 angular_velocity;
+		Vector3 prev_linear_velocity;
+		Vector3 prev_angular_velocity;
+		Vector3 constant_linear_velocity;
+		Vector3 constant_angular_velocity;
+		Vector3 applied_force;
+		Vector3 applied_torque;
+		Vector3 constant_force;
+		Vector3 constant_torque;
+		real_t still_time = 0.0;
+		bool active = false;
+		bool first_time_kinematic = false;
+		LocalVector<AABB> shape_bounds;
+	};
+
+	static void _read_state(BradotStateReader3D &p_reader, SavedState &r_state);
+
 	friend class BradotPhysicsDirectBodyState3D; // i give up, too many functions to expose
 
 public:
@@ -300,6 +325,12 @@ public:
 	void set_state(PhysicsServer3D::BodyState p_state, const Variant &p_variant);
 	Variant get_state(PhysicsServer3D::BodyState p_state) const;
 
+	// Motion state for space snapshots, configuration like mass or shapes isn't included.
+	void save_state(BradotStateWriter3D &p_writer) const;
+	void load_state(BradotStateReader3D &p_reader);
+	// Reads a state without loading it, returns whether it was complete.
+	static bool validate_state(BradotStateReader3D &p_reader);
+
 	_FORCE_INLINE_ void set_continuous_collision_detection(bool p_enable) { continuous_cd = p_enable; }
 	_FORCE_INLINE_ bool is_continuous_collision_detection_enabled() const { return continuous_cd; }
 
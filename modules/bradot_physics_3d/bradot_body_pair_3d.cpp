@@ -33,6 +33,7 @@
 
 #include "bradot_collision_solver_3d.h"
 #include "bradot_space_3d.h"
+#include "bradot_state_3d.h"
 
 #include "core/os/os.h"
 
@@ -598,6 +599,100 @@ void BradotBodyPair3D::solve(real_t p_step) {
 	}
 }
 
+BradotConstraint3D::Key BradotBodyPair3D::get_key() const {
+	Key key;
+	key.object_A = A->get_state_id();
+	key.object_B = B->get_state_id();
+	key.shape_A = shape_A;
+	key.shape_B = shape_B;
+	return key;
+}
+
+void BradotBodyPair3D::save_state(BradotStateWriter3D &p_writer) const {
+	p_writer.put_vector3(sep_axis);
+	p_writer.put_bool(collided);
+	p_writer.put_bool(check_ccd);
+	p_writer.put_vector3(offset_B);
+
+	p_writer.put_u32(contact_count);
+	for (int i = 0; i < contact_count; i++) {
+		const Contact &c = contacts[i];
+		p_writer.put_vector3(c.position);
+		p_writer.put_vector3(c.normal);
+		p_writer.put_u32(c.index_A);
+		p_writer.put_u32(c.index_B);
+		p_writer.put_vector3(c.local_A);
+		p_writer.put_vector3(c.local_B);
+		p_writer.put_vector3(c.acc_impulse);
+		p_writer.put_real(c.acc_normal_impulse);
+		p_writer.put_vector3(c.acc_tangent_impulse);
+		p_writer.put_real(c.acc_bias_impulse);
+		p_writer.put_real(c.acc_bias_impulse_center_of_mass);
+		p_writer.put_real(c.depth);
+		p_writer.put_bool(c.active);
+		p_writer.put_bool(c.used);
+	}
+}
+
+bool BradotBodyPair3D::_read_state(BradotStateReader3D &p_reader, SavedState &r_state) {
+	r_state.sep_axis = p_reader.get_vector3();
+	r_state.collided = p_reader.get_bool();
+	r_state.check_ccd = p_reader.get_bool();
+	r_state.offset_B = p_reader.get_vector3();
+
+	uint32_t count = p_reader.get_u32();
+	if (count > MAX_CONTACTS) {
+		return false;
+	}
+
+	r_state.contact_count = count;
+	for (int i = 0; i < r_state.contact_count; i++) {
+		Contact &c = r_state.contacts[i];
+		c.position = p_reader.get_vector3();
+		c.normal = p_reader.get_vector3();
+		c.index_A = p_reader.get_u32();
+		c.index_B = p_reader.get_u32();
+		c.local_A = p_reader.get_vector3();
+		c.local_B = p_reader.get_vector3();
+		c.acc_impulse = p_reader.get_vector3();
+		c.acc_normal_impulse = p_reader.get_real();
+		c.acc_tangent_impulse = p_reader.get_vector3();
+		c.acc_bias_impulse = p_reader.get_real();
+		c.acc_bias_impulse_center_of_mass = p_reader.get_real();
+		c.depth = p_reader.get_real();
+		c.active = p_reader.get_bool();
+		c.used = p_reader.get_bool();
+	}
+	return !p_reader.has_error();
+}
+
+void BradotBodyPair3D::load_state(BradotStateReader3D &p_reader) {
+	SavedState state;
+	ERR_FAIL_COND_MSG(!_read_state(p_reader, state), "Invalid body pair state.");
+
+	sep_axis = state.sep_axis;
+	collided = state.collided;
+	check_ccd = state.check_ccd;
+	offset_B = state.offset_B;
+	contact_count = state.contact_count;
+	for (int i = 0; i < contact_count; i++) {
+		contacts[i] = state.contacts[i];
+	}
+}
+
+bool BradotBodyPair3D::validate_state(BradotStateReader3D &p_reader) {
+	SavedState state;
+	return _read_state(p_reader, state);
+}
+
+void BradotBodyPair3D::clear_state() {
+	sep_axis = Vector3();
+	collided = false;
+	check_ccd = false;
+	offset_B = Vector3();
+	contact_count = 0;
+}
+
 BradotBodyPair3D::BradotBodyPair3D(BradotBody3D *p_A, int p_shape_A, BradotBody3D *p_B, int p_shape_B) :
 		BradotBodyContact3D(_arr, 2) {
 	A = p_A;
@@ -975,6 +1070,14 @@ void BradotBodySoftBodyPair3D::solve(real_t p_step) {
 	}
 }
 
+BradotConstraint3D::Key BradotBodySoftBodyPair3D::get_key() const {
+	Key key;
+	key.object_A = body->get_state_id();
+	key.object_B = soft_body->get_state_id();
+	key.shape_A = body_shape;
+	return key;
+}
+
 BradotBodySoftBodyPair3D::BradotBodySoftBodyPair3D(BradotBody3D *p_A, int p_shape_A, BradotSoftBody3D *p_B) :
 		BradotBodyContact3D(&body, 1) {
 	body = p_A;
@@ -98,6 +98,19 @@ class BradotBodyPair3D : public BradotBodyContact3D {
 	Contact contacts[MAX_CONTACTS];
 	int contact_count = 0;
 
+	// What save_state() writes, read in full before any of it is applied.
+	struct SavedState {
+		Vector3 sep_axis;
+		bool collided = false;
+		bool check_ccd = false;
+		Vector3 offset_B;
+		Contact contacts[MAX_CONTACTS];
+		int contact_count = 0;
+	};
+
+	// Returns false if the state is truncated or has too many contacts.
+	static bool _read_state(BradotStateReader3D &p_reader, SavedState &r_state);
+
 	static void _contact_added_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, const Vector3 &normal, void *p_userdata);
 
 	void contact_added_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, const Vector3 &normal);
@@ -106,6 +119,17 @@ class BradotBodyPair3D : public BradotBodyContact3D {
 	bool _test_ccd(real_t p_step, BradotBody3D *p_A, int p_shape_A, const Transform3D &p_xform_A, BradotBody3D *p_B, int p_shape_B, const Transform3D &p_xform_B);
 
 public:
+	virtual Key get_key() const override;
+
+	virtual bool has_state() const override { return true; }
+	virtual void save_state(BradotStateWriter3D &p_writer) const override;
+	virtual void load_state(BradotStateReader3D &p_reader) override;
+	virtual void clear_state() override;
+	// Reads a state without loading it, returns whether it was valid.
+	static bool validate_state(BradotStateReader3D &p_reader);
+
+	virtual bool is_overlapping() const override { return A->get_shape_aabb(shape_A).intersects(B->get_shape_aabb(shape_B)); }
+
 	virtual bool setup(real_t p_step) override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
@@ -134,6 +158,8 @@ class BradotBodySoftBodyPair3D : public BradotBodyContact3D {
 	void validate_contacts();
 
 public:
+	virtual Key get_key() const override;
+
 	virtual bool setup(real_t p_step) override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
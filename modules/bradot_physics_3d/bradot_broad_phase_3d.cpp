@@ -33,5 +33,17 @@
 
 BradotBroadPhase3D::CreateFunction BradotBroadPhase3D::create_func = nullptr;
 
+void BradotBroadPhase3D::cull_segment_packet(const Vector3 *p_from, const Vector3 *p_to, int p_count, BradotCollisionObject3D **p_results, int p_max_results, int *r_result_counts, int *p_result_indices) {
+	for (int i = 0; i < p_count; i++) {
+		r_result_counts[i] = cull_segment(p_from[i], p_to[i], p_results + i * p_max_results, p_max_results, p_result_indices ? p_result_indices + i * p_max_results : nullptr);
+	}
+}
+
+void BradotBroadPhase3D::cull_aabb_packet(const AABB *p_aabbs, int p_count, BradotCollisionObject3D **p_results, int p_max_results, int *r_result_counts, int *p_result_indices) {
+	for (int i = 0; i < p_count; i++) {
+		r_result_counts[i] = cull_aabb(p_aabbs[i], p_results + i * p_max_results, p_max_results, p_result_indices ? p_result_indices + i * p_max_results : nullptr);
+	}
+}
+
 BradotBroadPhase3D::~BradotBroadPhase3D() {
 }
@@ -62,6 +62,12 @@ public:
 	virtual int cull_segment(const Vector3 &p_from, const Vector3 &p_to, BradotCollisionObject3D **p_results, int p_max_results, int *p_result_indices = nullptr) = 0;
 	virtual int cull_aabb(const AABB &p_aabb, BradotCollisionObject3D **p_results, int p_max_results, int *p_result_indices = nullptr) = 0;
 
+	// Cull up to PACKET_SIZE queries at once. Results for query n start at p_results + n * p_max_results
+	// (and p_result_indices + n * p_max_results), with their count in r_result_counts[n].
+	static constexpr int PACKET_SIZE = 4;
+	virtual void cull_segment_packet(const Vector3 *p_from, const Vector3 *p_to, int p_count, BradotCollisionObject3D **p_results, int p_max_results, int *r_result_counts, int *p_result_indices = nullptr);
+	virtual void cull_aabb_packet(const AABB *p_aabbs, int p_count, BradotCollisionObject3D **p_results, int p_max_results, int *r_result_counts, int *p_result_indices = nullptr);
+
 	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata) = 0;
 	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) = 0;
 
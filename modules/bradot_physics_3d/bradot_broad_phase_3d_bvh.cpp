@@ -87,6 +87,14 @@ int BradotBroadPhase3DBVH::cull_aabb(const AABB &p_aabb, BradotCollisionObject3D
 	return bvh.cull_aabb(p_aabb, p_results, p_max_results, nullptr, 0xFFFFFFFF, p_result_indices);
 }
 
+void BradotBroadPhase3DBVH::cull_segment_packet(const Vector3 *p_from, const Vector3 *p_to, int p_count, BradotCollisionObject3D **p_results, int p_max_results, int *r_result_counts, int *p_result_indices) {
+	bvh.cull_segment_packet(p_from, p_to, p_count, p_results, p_max_results, r_result_counts, nullptr, 0xFFFFFFFF, p_result_indices);
+}
+
+void BradotBroadPhase3DBVH::cull_aabb_packet(const AABB *p_aabbs, int p_count, BradotCollisionObject3D **p_results, int p_max_results, int *r_result_counts, int *p_result_indices) {
+	bvh.cull_aabb_packet(p_aabbs, p_count, p_results, p_max_results, r_result_counts, nullptr, 0xFFFFFFFF, p_result_indices);
+}
+
 void *BradotBroadPhase3DBVH::_pair_callback(void *self, uint32_t p_A, BradotCollisionObject3D *p_object_A, int subindex_A, uint32_t p_B, BradotCollisionObject3D *p_object_B, int subindex_B) {
 	BradotBroadPhase3DBVH *bpo = static_cast<BradotBroadPhase3DBVH *>(self);
 	if (!bpo->pair_callback) {
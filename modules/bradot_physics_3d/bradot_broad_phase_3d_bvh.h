@@ -88,6 +88,8 @@ public:
 	virtual int cull_point(const Vector3 &p_point, BradotCollisionObject3D **p_results, int p_max_results, int *p_result_indices = nullptr) override;
 	virtual int cull_segment(const Vector3 &p_from, const Vector3 &p_to, BradotCollisionObject3D **p_results, int p_max_results, int *p_result_indices = nullptr) override;
 	virtual int cull_aabb(const AABB &p_aabb, BradotCollisionObject3D **p_results, int p_max_results, int *p_result_indices = nullptr) override;
+	virtual void cull_segment_packet(const Vector3 *p_from, const Vector3 *p_to, int p_count, BradotCollisionObject3D **p_results, int p_max_results, int *r_result_counts, int *p_result_indices = nullptr) override;
+	virtual void cull_aabb_packet(const AABB *p_aabbs, int p_count, BradotCollisionObject3D **p_results, int p_max_results, int *r_result_counts, int *p_result_indices = nullptr) override;
 
 	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata) override;
 	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) override;
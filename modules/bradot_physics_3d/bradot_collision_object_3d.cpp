@@ -33,6 +33,7 @@
 
 #include "bradot_physics_server_3d.h"
 #include "bradot_space_3d.h"
+#include "bradot_state_3d.h"
 
 void BradotCollisionObject3D::add_shape(BradotShape3D *p_shape, const Transform3D &p_transform, bool p_disabled) {
 	Shape s;
@@ -183,6 +184,37 @@ void BradotCollisionObject3D::_update_shapes() {
 	}
 }
 
+void BradotCollisionObject3D::_save_shape_bounds(BradotStateWriter3D &p_writer) const {
+	p_writer.put_u32(shapes.size());
+	for (const Shape &s : shapes) {
+		p_writer.put_vector3(s.aabb_cache.position);
+		p_writer.put_vector3(s.aabb_cache.size);
+	}
+}
+
+void BradotCollisionObject3D::_read_shape_bounds(BradotStateReader3D &p_reader, LocalVector<AABB> &r_bounds) {
+	uint32_t shape_count = p_reader.get_u32();
+	for (uint32_t i = 0; i < shape_count && !p_reader.has_error(); i++) {
+		AABB aabb;
+		aabb.position = p_reader.get_vector3();
+		aabb.size = p_reader.get_vector3();
+		r_bounds.push_back(aabb);
+	}
+}
+
+void BradotCollisionObject3D::_apply_shape_bounds(const LocalVector<AABB> &p_bounds) {
+	// Shapes added since keep the bounds of the current transform.
+	const uint32_t shape_count = MIN(p_bounds.size(), (uint32_t)shapes.size());
+	for (uint32_t i = 0; i < shape_count; i++) {
+		Shape &s = shapes.write[i];
+		if (s.disabled || !space || s.bpid == 0) {
+			continue;
+		}
+		s.aabb_cache = p_bounds[i];
+		space->get_broadphase()->move(s.bpid, p_bounds[i]);
+	}
+}
+
 void BradotCollisionObject3D::_update_shapes_with_motion(const Vector3 &p_motion) {
 	if (!space) {
 		return;
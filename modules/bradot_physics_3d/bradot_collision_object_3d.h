@@ -35,6 +35,7 @@
 #include "bradot_broad_phase_3d.h"
 #include "bradot_shape_3d.h"
 
+#include "core/templates/local_vector.h"
 #include "core/templates/self_list.h"
 #include "servers/physics_server_3d.h"
 
@@ -45,6 +46,8 @@
 #endif
 
 class BradotSpace3D;
+class BradotStateReader3D;
+class BradotStateWriter3D;
 
 class BradotCollisionObject3D : public BradotShapeOwner3D {
 public:
@@ -58,6 +61,7 @@ private:
 	Type type;
 	RID self;
 	ObjectID instance_id;
+	uint64_t state_id = 0;
 	uint32_t collision_layer = 1;
 	uint32_t collision_mask = 1;
 	real_t collision_priority = 1.0;
@@ -86,6 +90,11 @@ protected:
 	void _update_shapes_with_motion(const Vector3 &p_motion);
 	void _unregister_shapes();
 
+	// Shape bounds depend on past bounds and motion, not only on the transform, so states include them.
+	void _save_shape_bounds(BradotStateWriter3D &p_writer) const;
+	static void _read_shape_bounds(BradotStateReader3D &p_reader, LocalVector<AABB> &r_bounds);
+	void _apply_shape_bounds(const LocalVector<AABB> &p_bounds);
+
 	_FORCE_INLINE_ void _set_transform(const Transform3D &p_transform, bool p_update_shapes = true) {
 #ifdef DEBUG_ENABLED
 
@@ -114,6 +123,12 @@ public:
 	_FORCE_INLINE_ void set_instance_id(const ObjectID &p_instance_id) { instance_id = p_instance_id; }
 	_FORCE_INLINE_ ObjectID get_instance_id() const { return instance_id; }
 
+	// Identifies the object in space states and orders it in deterministic spaces. RIDs are used when no ID was
+	// assigned, but they differ between processes.
+	_FORCE_INLINE_ void set_state_id(uint64_t p_state_id) { state_id = p_state_id; }
+	_FORCE_INLINE_ uint64_t get_assigned_state_id() const { return state_id; }
+	_FORCE_INLINE_ uint64_t get_state_id() const { return state_id ? state_id : self.get_id(); }
+
 	void _shape_changed() override;
 
 	_FORCE_INLINE_ Type get_type() const { return type; }
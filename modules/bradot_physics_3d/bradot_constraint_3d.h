@@ -34,8 +34,38 @@
 
 class BradotBody3D;
 class BradotSoftBody3D;
+class BradotStateReader3D;
+class BradotStateWriter3D;
 
 class BradotConstraint3D {
+public:
+	// Identifies a constraint by the objects it acts on. Deterministic spaces process constraints
+	// sorted by key, so the order doesn't depend on when pairs were created or where they are in memory.
+	struct Key {
+		uint64_t object_A = 0;
+		uint64_t object_B = 0;
+		int shape_A = 0;
+		int shape_B = 0;
+
+		bool operator==(const Key &p_key) const {
+			return object_A == p_key.object_A && object_B == p_key.object_B && shape_A == p_key.shape_A && shape_B == p_key.shape_B;
+		}
+
+		bool operator<(const Key &p_key) const {
+			if (object_A != p_key.object_A) {
+				return object_A < p_key.object_A;
+			}
+			if (object_B != p_key.object_B) {
+				return object_B < p_key.object_B;
+			}
+			if (shape_A != p_key.shape_A) {
+				return shape_A < p_key.shape_A;
+			}
+			return shape_B < p_key.shape_B;
+		}
+	};
+
+private:
 	BradotBody3D **_body_ptr;
 	int _body_count;
 	uint64_t island_step;
@@ -72,6 +102,22 @@ public:
 	_FORCE_INLINE_ void disable_collisions_between_bodies(const bool p_disabled) { disabled_collisions_between_bodies = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled_collisions_between_bodies() const { return disabled_collisions_between_bodies; }
 
+	virtual Key get_key() const {
+		Key key;
+		key.object_A = self.get_id();
+		return key;
+	}
+
+	// Solver state kept between steps, like warm starting impulses, which space snapshots must include.
+	virtual bool has_state() const { return false; }
+	virtual void save_state(BradotStateWriter3D &p_writer) const {}
+	virtual void load_state(BradotStateReader3D &p_reader) {}
+	virtual void clear_state() {}
+
+	// Whether the bounds of the objects overlap. The broadphase keeps pairs for a while after their objects
+	// separate, for how long depends on how they moved.
+	virtual bool is_overlapping() const { return true; }
+
 	virtual bool setup(real_t p_step) = 0;
 	virtual bool pre_solve(real_t p_step) = 0;
 	virtual void solve(real_t p_step) = 0;
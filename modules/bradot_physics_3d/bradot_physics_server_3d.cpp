@@ -215,6 +215,20 @@ int BradotPhysicsServer3D::space_get_contact_count(RID p_space) const {
 	return space->get_debug_contact_count();
 }
 
+Vector<uint8_t> BradotPhysicsServer3D::space_get_state(RID p_space) const {
+	const BradotSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_NULL_V(space, Vector<uint8_t>());
+	ERR_FAIL_COND_V_MSG(space->is_locked(), Vector<uint8_t>(), "Space state can't be saved while the space is being stepped.");
+	return space->save_state();
+}
+
+void BradotPhysicsServer3D::space_set_state(RID p_space, const Vector<uint8_t> &p_state) {
+	BradotSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_NULL(space);
+	ERR_FAIL_COND_MSG(space->is_locked(), "Space state can't be restored while the space is being stepped.");
+	space->load_state(p_state);
+}
+
 RID BradotPhysicsServer3D::area_create() {
 	BradotArea3D *area = memnew(BradotArea3D);
 	RID rid = area_owner.make_rid(area);
@@ -409,6 +423,20 @@ uint32_t BradotPhysicsServer3D::area_get_collision_mask(RID p_area) const {
 	return area->get_collision_mask();
 }
 
+void BradotPhysicsServer3D::area_set_state_id(RID p_area, uint64_t p_id) {
+	BradotArea3D *area = area_owner.get_or_null(p_area);
+	ERR_FAIL_NULL(area);
+
+	area->set_state_id(p_id);
+}
+
+uint64_t BradotPhysicsServer3D::area_get_state_id(RID p_area) const {
+	const BradotArea3D *area = area_owner.get_or_null(p_area);
+	ERR_FAIL_NULL_V(area, 0);
+
+	return area->get_assigned_state_id();
+}
+
 void BradotPhysicsServer3D::area_set_monitorable(RID p_area, bool p_monitorable) {
 	BradotArea3D *area = area_owner.get_or_null(p_area);
 	ERR_FAIL_NULL(area);
@@ -622,6 +650,20 @@ real_t BradotPhysicsServer3D::body_get_collision_priority(RID p_body) const {
 	return body->get_collision_priority();
 }
 
+void BradotPhysicsServer3D::body_set_state_id(RID p_body, uint64_t p_id) {
+	BradotBody3D *body = body_owner.get_or_null(p_body);
+	ERR_FAIL_NULL(body);
+
+	body->set_state_id(p_id);
+}
+
+uint64_t BradotPhysicsServer3D::body_get_state_id(RID p_body) const {
+	const BradotBody3D *body = body_owner.get_or_null(p_body);
+	ERR_FAIL_NULL_V(body, 0);
+
+	return body->get_assigned_state_id();
+}
+
 void BradotPhysicsServer3D::body_attach_object_instance_id(RID p_body, ObjectID p_id) {
 	BradotBody3D *body = body_owner.get_or_null(p_body);
 	if (body) {
@@ -1012,6 +1054,20 @@ uint32_t BradotPhysicsServer3D::soft_body_get_collision_mask(RID p_body) const {
 	return soft_body->get_collision_mask();
 }
 
+void BradotPhysicsServer3D::soft_body_set_state_id(RID p_body, uint64_t p_id) {
+	BradotSoftBody3D *soft_body = soft_body_owner.get_or_null(p_body);
+	ERR_FAIL_NULL(soft_body);
+
+	soft_body->set_state_id(p_id);
+}
+
+uint64_t BradotPhysicsServer3D::soft_body_get_state_id(RID p_body) const {
+	const BradotSoftBody3D *soft_body = soft_body_owner.get_or_null(p_body);
+	ERR_FAIL_NULL_V(soft_body, 0);
+
+	return soft_body->get_assigned_state_id();
+}
+
 void BradotPhysicsServer3D::soft_body_add_collision_exception(RID p_body, RID p_body_b) {
 	BradotSoftBody3D *soft_body = soft_body_owner.get_or_null(p_body);
 	ERR_FAIL_NULL(soft_body);
@@ -1630,6 +1686,8 @@ void BradotPhysicsServer3D::init() {
 }
 
 void BradotPhysicsServer3D::step(real_t p_step) {
+	MemoryTagScope memory_tag_scope(Memory::TAG_PHYSICS);
+
 	if (!active) {
 		return;
 	}
@@ -1652,6 +1710,8 @@ void BradotPhysicsServer3D::sync() {
 }
 
 void BradotPhysicsServer3D::flush_queries() {
+	MemoryTagScope memory_tag_scope(Memory::TAG_PHYSICS);
+
 	if (!active) {
 		return;
 	}
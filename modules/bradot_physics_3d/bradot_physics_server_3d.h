@@ -118,6 +118,9 @@ public:
 	virtual Vector<Vector3> space_get_contacts(RID p_space) const override;
 	virtual int space_get_contact_count(RID p_space) const override;
 
+	virtual Vector<uint8_t> space_get_state(RID p_space) const override;
+	virtual void space_set_state(RID p_space, const Vector<uint8_t> &p_state) override;
+
 	/* AREA API */
 
 	virtual RID area_create() override;
@@ -155,6 +158,9 @@ public:
 	virtual void area_set_collision_mask(RID p_area, uint32_t p_mask) override;
 	virtual uint32_t area_get_collision_mask(RID p_area) const override;
 
+	virtual void area_set_state_id(RID p_area, uint64_t p_id) override;
+	virtual uint64_t area_get_state_id(RID p_area) const override;
+
 	virtual void area_set_monitorable(RID p_area, bool p_monitorable) override;
 
 	virtual void area_set_monitor_callback(RID p_area, const Callable &p_callback) override;
@@ -199,6 +205,9 @@ public:
 	virtual void body_set_collision_priority(RID p_body, real_t p_priority) override;
 	virtual real_t body_get_collision_priority(RID p_body) const override;
 
+	virtual void body_set_state_id(RID p_body, uint64_t p_id) override;
+	virtual uint64_t body_get_state_id(RID p_body) const override;
+
 	virtual void body_set_user_flags(RID p_body, uint32_t p_flags) override;
 	virtual uint32_t body_get_user_flags(RID p_body) const override;
 
@@ -271,6 +280,9 @@ public:
 	virtual void soft_body_set_collision_mask(RID p_body, uint32_t p_mask) override;
 	virtual uint32_t soft_body_get_collision_mask(RID p_body) const override;
 
+	virtual void soft_body_set_state_id(RID p_body, uint64_t p_id) override;
+	virtual uint64_t soft_body_get_state_id(RID p_body) const override;
+
 	virtual void soft_body_add_collision_exception(RID p_body, RID p_body_b) override;
 	virtual void soft_body_remove_collision_exception(RID p_body, RID p_body_b) override;
 	virtual void soft_body_get_collision_exceptions(RID p_body, List<RID> *p_exceptions) override;
@@ -192,7 +192,7 @@ void BradotSoftBody3D::update_normals_and_centroids() {
 	}
 }
 
-void BradotSoftBody3D::update_bounds() {
+bool BradotSoftBody3D::_compute_bounds() {
 	AABB prev_bounds = bounds;
 	prev_bounds.grow_by(collision_margin);
 
@@ -200,8 +200,7 @@ void BradotSoftBody3D::update_bounds() {
 
 	const uint32_t nodes_count = nodes.size();
 	if (nodes_count == 0) {
-		deinitialize_shape();
-		return;
+		return false;
 	}
 
 	bool first = true;
@@ -219,11 +218,21 @@ void BradotSoftBody3D::update_bounds() {
 		}
 	}
 
-	if (get_space()) {
-		initialize_shape(moved);
+	return moved;
+}
+
+void BradotSoftBody3D::_update_bounds_shape(bool p_moved) {
+	if (nodes.is_empty()) {
+		deinitialize_shape();
+	} else if (get_space()) {
+		initialize_shape(p_moved);
 	}
 }
 
+void BradotSoftBody3D::update_bounds() {
+	_update_bounds_shape(_compute_bounds());
+}
+
 void BradotSoftBody3D::update_constants() {
 	reset_link_rest_lengths();
 	update_link_constants();
@@ -1046,8 +1055,8 @@ void BradotSoftBody3D::predict_motion(real_t p_delta) {
 		node.f = Vector3();
 	}
 
-	// Bounds and tree update.
-	update_bounds();
+	// Bounds and tree update, the shape is updated later in update_shape().
+	bounds_moved = _compute_bounds();
 
 	// Node tree update.
 	for (const Node &node : nodes) {
@@ -1099,6 +1108,11 @@ void BradotSoftBody3D::solve_constraints(real_t p_delta) {
 	update_normals_and_centroids();
 }
 
+void BradotSoftBody3D::update_shape() {
+	_update_bounds_shape(bounds_moved);
+	bounds_moved = false;
+}
+
 void BradotSoftBody3D::solve_links(real_t kst, real_t ti) {
 	for (Link &link : links) {
 		if (link.c0 > 0) {
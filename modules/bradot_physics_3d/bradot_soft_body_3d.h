@@ -89,6 +89,7 @@ class BradotSoftBody3D : public BradotCollisionObject3D {
 	LocalVector<uint32_t> map_visual_to_physics;
 
 	AABB bounds;
+	bool bounds_moved = false;
 
 	real_t collision_margin = 0.05;
 
@@ -202,8 +203,11 @@ public:
 	void set_drag_coefficient(real_t p_val);
 	_FORCE_INLINE_ real_t get_drag_coefficient() const { return drag_coefficient; }
 
+	// These only modify the soft body's own data, so different soft bodies can be stepped in parallel.
+	// The broadphase is updated separately, with update_shape() from a single thread.
 	void predict_motion(real_t p_delta);
 	void solve_constraints(real_t p_delta);
+	void update_shape();
 
 	_FORCE_INLINE_ uint32_t get_node_index(void *p_node) const { return static_cast<Node *>(p_node)->index; }
 	_FORCE_INLINE_ uint32_t get_face_index(void *p_face) const { return static_cast<Face *>(p_face)->index; }
@@ -220,6 +224,8 @@ protected:
 
 private:
 	void update_normals_and_centroids();
+	bool _compute_bounds();
+	void _update_bounds_shape(bool p_moved);
 	void update_bounds();
 	void update_constants();
 	void update_area();
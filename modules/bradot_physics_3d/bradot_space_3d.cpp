@@ -33,8 +33,10 @@
 
 #include "bradot_collision_solver_3d.h"
 #include "bradot_physics_server_3d.h"
+#include "bradot_state_3d.h"
 
 #include "core/config/project_settings.h"
+#include "core/object/worker_thread_pool.h"
 
 #define TEST_MOTION_MARGIN_MIN_VALUE 0.0001
 #define TEST_MOTION_MIN_CONTACT_DEPTH_FACTOR 0.05
@@ -106,17 +108,13 @@ int BradotPhysicsDirectSpaceState3D::intersect_point(const PointParameters &p_pa
 	return cc;
 }
 
-bool BradotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
-	ERR_FAIL_COND_V(space->locked, false);
-
+bool BradotPhysicsDirectSpaceState3D::_intersect_ray(const RayParameters &p_parameters, const Vector3 &p_from, const Vector3 &p_to, RayResult &r_result, BradotCollisionObject3D *const *p_cull_results, const int *p_cull_subindices, int p_cull_count) const {
 	Vector3 begin, end;
 	Vector3 normal;
-	begin = p_parameters.from;
-	end = p_parameters.to;
+	begin = p_from;
+	end = p_to;
 	normal = (end - begin).normalized();
 
-	int amount = space->broadphase->cull_segment(begin, end, space->intersection_query_results, BradotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
-
 	//todo, create another array that references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
 
 	bool collided = false;
@@ -126,22 +124,22 @@ bool BradotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_param
 	const BradotCollisionObject3D *res_obj = nullptr;
 	real_t min_d = 1e10;
 
-	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+	for (int i = 0; i < p_cull_count; i++) {
+		if (!_can_collide_with(p_cull_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.pick_ray && !(space->intersection_query_results[i]->is_ray_pickable())) {
+		if (p_parameters.pick_ray && !(p_cull_results[i]->is_ray_pickable())) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(p_cull_results[i]->get_self())) {
 			continue;
 		}
 
-		const BradotCollisionObject3D *col_obj = space->intersection_query_results[i];
+		const BradotCollisionObject3D *col_obj = p_cull_results[i];
 
-		int shape_idx = space->intersection_query_subindex_results[i];
+		int shape_idx = p_cull_subindices[i];
 		Transform3D inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
 
 		Vector3 local_from = inv_xform.xform(begin);
@@ -206,41 +204,38 @@ bool BradotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_param
 	return true;
 }
 
-int BradotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) {
-	if (p_result_max <= 0) {
-		return 0;
-	}
-
-	BradotShape3D *shape = BradotPhysicsServer3D::bradot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
-	ERR_FAIL_NULL_V(shape, 0);
+bool BradotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
+	ERR_FAIL_COND_V(space->locked, false);
 
-	AABB aabb = p_parameters.transform.xform(shape->get_aabb());
+	int amount = space->broadphase->cull_segment(p_parameters.from, p_parameters.to, space->intersection_query_results, BradotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
 
-	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, BradotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+	return _intersect_ray(p_parameters, p_parameters.from, p_parameters.to, r_result, space->intersection_query_results, space->intersection_query_subindex_results, amount);
+}
 
+int BradotPhysicsDirectSpaceState3D::_intersect_shape(const ShapeParameters &p_parameters, const BradotShape3D *p_shape, const Transform3D &p_transform, ShapeResult *r_results, int p_result_max, BradotCollisionObject3D *const *p_cull_results, const int *p_cull_subindices, int p_cull_count) const {
 	int cc = 0;
 
 	//Transform3D ai = p_xform.affine_inverse();
 
-	for (int i = 0; i < amount; i++) {
+	for (int i = 0; i < p_cull_count; i++) {
 		if (cc >= p_result_max) {
 			break;
 		}
 
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+		if (!_can_collide_with(p_cull_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
 		//area can't be picked by ray (default)
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(p_cull_results[i]->get_self())) {
 			continue;
 		}
 
-		const BradotCollisionObject3D *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const BradotCollisionObject3D *col_obj = p_cull_results[i];
+		int shape_idx = p_cull_subindices[i];
 
-		if (!BradotCollisionSolver3D::solve_static(shape, p_parameters.transform, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), nullptr, nullptr, nullptr, p_parameters.margin, 0)) {
+		if (!BradotCollisionSolver3D::solve_static(p_shape, p_transform, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), nullptr, nullptr, nullptr, p_parameters.margin, 0)) {
 			continue;
 		}
 
@@ -261,55 +256,67 @@ int BradotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_pa
 	return cc;
 }
 
-bool BradotPhysicsDirectSpaceState3D::cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info) {
+int BradotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) {
+	if (p_result_max <= 0) {
+		return 0;
+	}
+
 	BradotShape3D *shape = BradotPhysicsServer3D::bradot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
-	ERR_FAIL_NULL_V(shape, false);
+	ERR_FAIL_NULL_V(shape, 0);
 
 	AABB aabb = p_parameters.transform.xform(shape->get_aabb());
-	aabb = aabb.merge(AABB(aabb.position + p_parameters.motion, aabb.size)); //motion
-	aabb = aabb.grow(p_parameters.margin);
 
 	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, BradotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
 
+	return _intersect_shape(p_parameters, shape, p_parameters.transform, r_results, p_result_max, space->intersection_query_results, space->intersection_query_subindex_results, amount);
+}
+
+AABB BradotPhysicsDirectSpaceState3D::_get_motion_aabb(const BradotShape3D *p_shape, const Transform3D &p_transform, const Vector3 &p_motion, real_t p_margin) {
+	AABB aabb = p_transform.xform(p_shape->get_aabb());
+	aabb = aabb.merge(AABB(aabb.position + p_motion, aabb.size)); //motion
+	return aabb.grow(p_margin);
+}
+
+void BradotPhysicsDirectSpaceState3D::_cast_motion(const ShapeParameters &p_parameters, BradotShape3D *p_shape, const Transform3D &p_transform, const Vector3 &p_motion, const AABB &p_aabb, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info, BradotCollisionObject3D *const *p_cull_results, const int *p_cull_subindices, int p_cull_count) const {
 	real_t best_safe = 1;
 	real_t best_unsafe = 1;
 
-	Transform3D xform_inv = p_parameters.transform.affine_inverse();
+	Transform3D xform_inv = p_transform.affine_inverse();
 	BradotMotionShape3D mshape;
-	mshape.shape = shape;
-	mshape.motion = xform_inv.basis.xform(p_parameters.motion);
+	mshape.shape = p_shape;
+	mshape.motion = xform_inv.basis.xform(p_motion);
 
 	bool best_first = true;
 
-	Vector3 motion_normal = p_parameters.motion.normalized();
+	Vector3 motion_normal = p_motion.normalized();
 
 	Vector3 closest_A, closest_B;
 
-	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+	for (int i = 0; i < p_cull_count; i++) {
+		if (!_can_collide_with(p_cull_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(p_cull_results[i]->get_self())) {
 			continue; //ignore excluded
 		}
 
-		const BradotCollisionObject3D *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const BradotCollisionObject3D *col_obj = p_cull_results[i];
+		int shape_idx = p_cull_subindices[i];
 
 		Vector3 point_A, point_B;
 		Vector3 sep_axis = motion_normal;
 
 		Transform3D col_obj_xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
 		//test initial overlap, does it collide if going all the way?
-		if (BradotCollisionSolver3D::solve_distance(&mshape, p_parameters.transform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, aabb, &sep_axis)) {
+		if (BradotCollisionSolver3D::solve_distance(&mshape, p_transform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, p_aabb, &sep_axis)) {
 			continue;
 		}
 
 		//test initial overlap, ignore objects it's inside of.
 		sep_axis = motion_normal;
 
-		if (!BradotCollisionSolver3D::solve_distance(shape, p_parameters.transform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, aabb, &sep_axis)) {
+		if (!BradotCollisionSolver3D::solve_distance(p_shape, p_transform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, p_aabb, &sep_axis)) {
 			continue;
 		}
 
@@ -320,11 +327,11 @@ bool BradotPhysicsDirectSpaceState3D::cast_motion(const ShapeParameters &p_param
 		for (int j = 0; j < 8; j++) { //steps should be customizable..
 			real_t fraction = low + (hi - low) * fraction_coeff;
 
-			mshape.motion = xform_inv.basis.xform(p_parameters.motion * fraction);
+			mshape.motion = xform_inv.basis.xform(p_motion * fraction);
 
 			Vector3 lA, lB;
 			Vector3 sep = motion_normal; //important optimization for this to work fast enough
-			bool collided = !BradotCollisionSolver3D::solve_distance(&mshape, p_parameters.transform, col_obj->get_shape(shape_idx), col_obj_xform, lA, lB, aabb, &sep);
+			bool collided = !BradotCollisionSolver3D::solve_distance(&mshape, p_transform, col_obj->get_shape(shape_idx), col_obj_xform, lA, lB, p_aabb, &sep);
 
 			if (collided) {
 				hi = fraction;
@@ -376,10 +383,185 @@ bool BradotPhysicsDirectSpaceState3D::cast_motion(const ShapeParameters &p_param
 
 	p_closest_safe = best_safe;
 	p_closest_unsafe = best_unsafe;
+}
+
+bool BradotPhysicsDirectSpaceState3D::cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info) {
+	BradotShape3D *shape = BradotPhysicsServer3D::bradot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
+	ERR_FAIL_NULL_V(shape, false);
+
+	AABB aabb = _get_motion_aabb(shape, p_parameters.transform, p_parameters.motion, p_parameters.margin);
+
+	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, BradotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
 
+	_cast_motion(p_parameters, shape, p_parameters.transform, p_parameters.motion, aabb, p_closest_safe, p_closest_unsafe, r_info, space->intersection_query_results, space->intersection_query_subindex_results, amount);
 	return true;
 }
 
+thread_local BradotPhysicsDirectSpaceState3D::BatchCullBuffers BradotPhysicsDirectSpaceState3D::batch_cull_buffers;
+
+BradotPhysicsDirectSpaceState3D::BatchCullBuffers &BradotPhysicsDirectSpaceState3D::_get_batch_cull_buffers() {
+	if (unlikely(batch_cull_buffers.results.is_empty())) {
+		batch_cull_buffers.results.resize(BradotBroadPhase3D::PACKET_SIZE * BradotSpace3D::INTERSECTION_QUERY_MAX);
+		batch_cull_buffers.subindices.resize(BradotBroadPhase3D::PACKET_SIZE * BradotSpace3D::INTERSECTION_QUERY_MAX);
+	}
+	return batch_cull_buffers;
+}
+
+void BradotPhysicsDirectSpaceState3D::_intersect_ray_batch_group(uint32_t p_group, RayBatch *p_batch) {
+	// Each thread has its own cull buffers, the broadphase itself is safe to query from several threads.
+	// Queries are culled in packets, which share a single traversal of the broadphase.
+	BatchCullBuffers &cull_buffers = _get_batch_cull_buffers();
+	BradotCollisionObject3D **cull_results = cull_buffers.results.ptr();
+	int *cull_subindices = cull_buffers.subindices.ptr();
+	int cull_counts[BradotBroadPhase3D::PACKET_SIZE];
+
+	const int begin = p_group * BATCH_QUERY_GROUP_SIZE;
+	const int end = MIN(begin + BATCH_QUERY_GROUP_SIZE, p_batch->count);
+	int hits = 0;
+	for (int i = begin; i < end; i += BradotBroadPhase3D::PACKET_SIZE) {
+		const int packet_count = MIN(BradotBroadPhase3D::PACKET_SIZE, end - i);
+		space->broadphase->cull_segment_packet(p_batch->from + i, p_batch->to + i, packet_count, cull_results, BradotSpace3D::INTERSECTION_QUERY_MAX, cull_counts, cull_subindices);
+
+		for (int j = 0; j < packet_count; j++) {
+			const int offset = j * BradotSpace3D::INTERSECTION_QUERY_MAX;
+			if (_intersect_ray(*p_batch->parameters, p_batch->from[i + j], p_batch->to[i + j], p_batch->results[i + j], cull_results + offset, cull_subindices + offset, cull_counts[j])) {
+				hits++;
+			} else {
+				p_batch->results[i + j] = RayResult();
+			}
+		}
+	}
+	p_batch->hits.add(hits);
+}
+
+void BradotPhysicsDirectSpaceState3D::_intersect_shape_batch_group(uint32_t p_group, ShapeBatch *p_batch) {
+	const int begin = p_group * BATCH_QUERY_GROUP_SIZE;
+	const int end = MIN(begin + BATCH_QUERY_GROUP_SIZE, p_batch->count);
+	for (int i = begin; i < end; i++) {
+		p_batch->result_counts[i] = 0;
+	}
+
+	if (p_batch->result_max <= 0) {
+		return;
+	}
+
+	BradotShape3D *shape = BradotPhysicsServer3D::bradot_singleton->shape_owner.get_or_null(p_batch->parameters->shape_rid);
+	ERR_FAIL_NULL(shape);
+
+	BatchCullBuffers &cull_buffers = _get_batch_cull_buffers();
+	BradotCollisionObject3D **cull_results = cull_buffers.results.ptr();
+	int *cull_subindices = cull_buffers.subindices.ptr();
+	int cull_counts[BradotBroadPhase3D::PACKET_SIZE];
+	Transform3D transforms[BradotBroadPhase3D::PACKET_SIZE];
+	AABB aabbs[BradotBroadPhase3D::PACKET_SIZE];
+
+	for (int i = begin; i < end; i += BradotBroadPhase3D::PACKET_SIZE) {
+		const int packet_count = MIN(BradotBroadPhase3D::PACKET_SIZE, end - i);
+		for (int j = 0; j < packet_count; j++) {
+			transforms[j] = p_batch->parameters->transform;
+			transforms[j].origin = p_batch->origins[i + j];
+			aabbs[j] = transforms[j].xform(shape->get_aabb());
+		}
+
+		space->broadphase->cull_aabb_packet(aabbs, packet_count, cull_results, BradotSpace3D::INTERSECTION_QUERY_MAX, cull_counts, cull_subindices);
+
+		for (int j = 0; j < packet_count; j++) {
+			const int offset = j * BradotSpace3D::INTERSECTION_QUERY_MAX;
+			p_batch->result_counts[i + j] = _intersect_shape(*p_batch->parameters, shape, transforms[j], p_batch->results + (i + j) * p_batch->result_max, p_batch->result_max, cull_results + offset, cull_subindices + offset, cull_counts[j]);
+		}
+	}
+}
+
+void BradotPhysicsDirectSpaceState3D::_cast_motion_batch_group(uint32_t p_group, ShapeBatch *p_batch) {
+	const int begin = p_group * BATCH_QUERY_GROUP_SIZE;
+	const int end = MIN(begin + BATCH_QUERY_GROUP_SIZE, p_batch->count);
+	for (int i = begin; i < end; i++) {
+		p_batch->closest_safe[i] = 1.0;
+		p_batch->closest_unsafe[i] = 1.0;
+	}
+
+	BradotShape3D *shape = BradotPhysicsServer3D::bradot_singleton->shape_owner.get_or_null(p_batch->parameters->shape_rid);
+	ERR_FAIL_NULL(shape);
+
+	BatchCullBuffers &cull_buffers = _get_batch_cull_buffers();
+	BradotCollisionObject3D **cull_results = cull_buffers.results.ptr();
+	int *cull_subindices = cull_buffers.subindices.ptr();
+	int cull_counts[BradotBroadPhase3D::PACKET_SIZE];
+	Transform3D transforms[BradotBroadPhase3D::PACKET_SIZE];
+	AABB aabbs[BradotBroadPhase3D::PACKET_SIZE];
+
+	for (int i = begin; i < end; i += BradotBroadPhase3D::PACKET_SIZE) {
+		const int packet_count = MIN(BradotBroadPhase3D::PACKET_SIZE, end - i);
+		for (int j = 0; j < packet_count; j++) {
+			transforms[j] = p_batch->parameters->transform;
+			transforms[j].origin = p_batch->origins[i + j];
+			aabbs[j] = _get_motion_aabb(shape, transforms[j], p_batch->motions[i + j], p_batch->parameters->margin);
+		}
+
+		space->broadphase->cull_aabb_packet(aabbs, packet_count, cull_results, BradotSpace3D::INTERSECTION_QUERY_MAX, cull_counts, cull_subindices);
+
+		for (int j = 0; j < packet_count; j++) {
+			const int offset = j * BradotSpace3D::INTERSECTION_QUERY_MAX;
+			_cast_motion(*p_batch->parameters, shape, transforms[j], p_batch->motions[i + j], aabbs[j], p_batch->closest_safe[i + j], p_batch->closest_unsafe[i + j], nullptr, cull_results + offset, cull_subindices + offset, cull_counts[j]);
+		}
+	}
+}
+
+template <typename B>
+void BradotPhysicsDirectSpaceState3D::_run_batch(void (BradotPhysicsDirectSpaceState3D::*p_method)(uint32_t, B *), B *p_batch, const String &p_description) {
+	const int group_count = (p_batch->count + BATCH_QUERY_GROUP_SIZE - 1) / BATCH_QUERY_GROUP_SIZE;
+	if (group_count <= 1) {
+		// Not worth waking up other threads.
+		for (int i = 0; i < group_count; i++) {
+			(this->*p_method)(i, p_batch);
+		}
+		return;
+	}
+
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, p_method, p_batch, group_count, -1, true, p_description);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+}
+
+int BradotPhysicsDirectSpaceState3D::intersect_ray_batch(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results) {
+	ERR_FAIL_COND_V(space->locked, 0);
+
+	RayBatch batch;
+	batch.parameters = &p_parameters;
+	batch.from = p_from;
+	batch.to = p_to;
+	batch.results = r_results;
+	batch.count = p_count;
+	_run_batch(&BradotPhysicsDirectSpaceState3D::_intersect_ray_batch_group, &batch, SNAME("Physics3DIntersectRayBatch"));
+
+	return batch.hits.get();
+}
+
+void BradotPhysicsDirectSpaceState3D::intersect_shape_batch(const ShapeParameters &p_parameters, const Vector3 *p_origins, int p_count, ShapeResult *r_results, int p_result_max, int *r_result_counts) {
+	ERR_FAIL_COND(space->locked);
+
+	ShapeBatch batch;
+	batch.parameters = &p_parameters;
+	batch.origins = p_origins;
+	batch.count = p_count;
+	batch.results = r_results;
+	batch.result_max = p_result_max;
+	batch.result_counts = r_result_counts;
+	_run_batch(&BradotPhysicsDirectSpaceState3D::_intersect_shape_batch_group, &batch, SNAME("Physics3DIntersectShapeBatch"));
+}
+
+void BradotPhysicsDirectSpaceState3D::cast_motion_batch(const ShapeParameters &p_parameters, const Vector3 *p_origins, const Vector3 *p_motions, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) {
+	ERR_FAIL_COND(space->locked);
+
+	ShapeBatch batch;
+	batch.parameters = &p_parameters;
+	batch.origins = p_origins;
+	batch.motions = p_motions;
+	batch.count = p_count;
+	batch.closest_safe = r_closest_safe;
+	batch.closest_unsafe = r_closest_unsafe;
+	_run_batch(&BradotPhysicsDirectSpaceState3D::_cast_motion_batch_group, &batch, SNAME("Physics3DCastMotionBatch"));
+}
+
 bool BradotPhysicsDirectSpaceState3D::collide_shape(const ShapeParameters &p_parameters, Vector3 *r_results, int p_result_max, int &r_result_count) {
 	if (p_result_max <= 0) {
 		return false;
@@ -1032,37 +1214,45 @@ bool BradotSpace3D::test_body_motion(BradotBody3D *p_body, const PhysicsServer3D
 void *BradotSpace3D::_broadphase_pair(BradotCollisionObject3D *A, int p_subindex_A, BradotCollisionObject3D *B, int p_subindex_B, void *p_self) {
 	BradotCollisionObject3D::Type type_A = A->get_type();
 	BradotCollisionObject3D::Type type_B = B->get_type();
-	if (type_A > type_B) {
+	BradotSpace3D *self = static_cast<BradotSpace3D *>(p_self);
+
+	bool swap = type_A > type_B;
+	if (type_A == type_B && self->deterministic) {
+		// The broadphase may report a pair either way around, order it by state ID so it is always set up the same.
+		uint64_t id_A = A->get_state_id();
+		uint64_t id_B = B->get_state_id();
+		swap = id_A > id_B || (id_A == id_B && p_subindex_A > p_subindex_B);
+	}
+
+	if (swap) {
 		SWAP(A, B);
 		SWAP(p_subindex_A, p_subindex_B);
 		SWAP(type_A, type_B);
 	}
 
-	BradotSpace3D *self = static_cast<BradotSpace3D *>(p_self);
-
 	self->collision_pairs++;
 
 	if (type_A == BradotCollisionObject3D::TYPE_AREA) {
 		BradotArea3D *area = static_cast<BradotArea3D *>(A);
 		if (type_B == BradotCollisionObject3D::TYPE_AREA) {
 			BradotArea3D *area_b = static_cast<BradotArea3D *>(B);
-			BradotArea2Pair3D *area2_pair = memnew(BradotArea2Pair3D(area_b, p_subindex_B, area, p_subindex_A));
+			BradotArea2Pair3D *area2_pair = self->area2_pair_allocator.alloc(area_b, p_subindex_B, area, p_subindex_A);
 			return area2_pair;
 		} else if (type_B == BradotCollisionObject3D::TYPE_SOFT_BODY) {
 			BradotSoftBody3D *softbody = static_cast<BradotSoftBody3D *>(B);
-			BradotAreaSoftBodyPair3D *soft_area_pair = memnew(BradotAreaSoftBodyPair3D(softbody, p_subindex_B, area, p_subindex_A));
+			BradotAreaSoftBodyPair3D *soft_area_pair = self->area_soft_body_pair_allocator.alloc(softbody, p_subindex_B, area, p_subindex_A);
 			return soft_area_pair;
 		} else {
 			BradotBody3D *body = static_cast<BradotBody3D *>(B);
-			BradotAreaPair3D *area_pair = memnew(BradotAreaPair3D(body, p_subindex_B, area, p_subindex_A));
+			BradotAreaPair3D *area_pair = self->area_pair_allocator.alloc(body, p_subindex_B, area, p_subindex_A);
 			return area_pair;
 		}
 	} else if (type_A == BradotCollisionObject3D::TYPE_BODY) {
 		if (type_B == BradotCollisionObject3D::TYPE_SOFT_BODY) {
-			BradotBodySoftBodyPair3D *soft_pair = memnew(BradotBodySoftBodyPair3D(static_cast<BradotBody3D *>(A), p_subindex_A, static_cast<BradotSoftBody3D *>(B)));
+			BradotBodySoftBodyPair3D *soft_pair = self->body_soft_body_pair_allocator.alloc(static_cast<BradotBody3D *>(A), p_subindex_A, static_cast<BradotSoftBody3D *>(B));
 			return soft_pair;
 		} else {
-			BradotBodyPair3D *b = memnew(BradotBodyPair3D(static_cast<BradotBody3D *>(A), p_subindex_A, static_cast<BradotBody3D *>(B), p_subindex_B));
+			BradotBodyPair3D *b = self->body_pair_allocator.alloc(static_cast<BradotBody3D *>(A), p_subindex_A, static_cast<BradotBody3D *>(B), p_subindex_B);
 			return b;
 		}
 	} else {
@@ -1079,8 +1269,27 @@ void BradotSpace3D::_broadphase_unpair(BradotCollisionObject3D *A, int p_subinde
 
 	BradotSpace3D *self = static_cast<BradotSpace3D *>(p_self);
 	self->collision_pairs--;
-	BradotConstraint3D *c = static_cast<BradotConstraint3D *>(p_data);
-	memdelete(c);
+
+	// Return the pair to the pool it was allocated from in _broadphase_pair(), which only depends on the types.
+	BradotCollisionObject3D::Type type_A = A->get_type();
+	BradotCollisionObject3D::Type type_B = B->get_type();
+	if (type_A > type_B) {
+		SWAP(type_A, type_B);
+	}
+
+	if (type_A == BradotCollisionObject3D::TYPE_AREA) {
+		if (type_B == BradotCollisionObject3D::TYPE_AREA) {
+			self->area2_pair_allocator.free(static_cast<BradotArea2Pair3D *>(p_data));
+		} else if (type_B == BradotCollisionObject3D::TYPE_SOFT_BODY) {
+			self->area_soft_body_pair_allocator.free(static_cast<BradotAreaSoftBodyPair3D *>(p_data));
+		} else {
+			self->area_pair_allocator.free(static_cast<BradotAreaPair3D *>(p_data));
+		}
+	} else if (type_B == BradotCollisionObject3D::TYPE_SOFT_BODY) {
+		self->body_soft_body_pair_allocator.free(static_cast<BradotBodySoftBodyPair3D *>(p_data));
+	} else {
+		self->body_pair_allocator.free(static_cast<BradotBodyPair3D *>(p_data));
+	}
 }
 
 const SelfList<BradotBody3D>::List &BradotSpace3D::get_active_body_list() const {
@@ -1213,6 +1422,9 @@ void BradotSpace3D::set_param(PhysicsServer3D::SpaceParameter p_param, real_t p_
 		case PhysicsServer3D::SPACE_PARAM_SOLVER_ITERATIONS:
 			solver_iterations = p_value;
 			break;
+		case PhysicsServer3D::SPACE_PARAM_DETERMINISTIC:
+			deterministic = p_value != 0;
+			break;
 	}
 }
 
@@ -1234,10 +1446,170 @@ real_t BradotSpace3D::get_param(PhysicsServer3D::SpaceParameter p_param) const {
 			return body_time_to_sleep;
 		case PhysicsServer3D::SPACE_PARAM_SOLVER_ITERATIONS:
 			return solver_iterations;
+		case PhysicsServer3D::SPACE_PARAM_DETERMINISTIC:
+			return deterministic ? 1 : 0;
 	}
 	return 0;
 }
 
+struct _StateBodySort {
+	_FORCE_INLINE_ bool operator()(const BradotBody3D *p_a, const BradotBody3D *p_b) const {
+		return p_a->get_state_id() < p_b->get_state_id();
+	}
+};
+
+struct _StateConstraint {
+	BradotConstraint3D::Key key;
+	BradotConstraint3D *constraint = nullptr;
+
+	_FORCE_INLINE_ bool operator<(const _StateConstraint &p_other) const { return key < p_other.key; }
+};
+
+static void _get_state_bodies(const HashSet<BradotCollisionObject3D *> &p_objects, LocalVector<BradotBody3D *> &r_bodies) {
+	for (BradotCollisionObject3D *E : p_objects) {
+		if (E->get_type() == BradotCollisionObject3D::TYPE_BODY) {
+			r_bodies.push_back(static_cast<BradotBody3D *>(E));
+		}
+	}
+	r_bodies.sort_custom<_StateBodySort>();
+}
+
+static void _get_state_constraints(const LocalVector<BradotBody3D *> &p_bodies, LocalVector<_StateConstraint> &r_constraints) {
+	for (const BradotBody3D *body : p_bodies) {
+		for (const KeyValue<BradotConstraint3D *, int> &E : body->get_constraint_map()) {
+			// Only visit each constraint from its first body.
+			if (E.value != 0 || !E.key->has_state()) {
+				continue;
+			}
+			_StateConstraint constraint;
+			constraint.key = E.key->get_key();
+			constraint.constraint = E.key;
+			r_constraints.push_back(constraint);
+		}
+	}
+	r_constraints.sort();
+}
+
+// Reads a whole state after its header without loading anything, so a damaged state can be rejected before the space
+// is changed. Each block must hold exactly what its object writes, only body pairs have constraint state.
+static bool _validate_state(BradotStateReader3D &p_reader) {
+	uint32_t body_count = p_reader.get_u32();
+	for (uint32_t i = 0; i < body_count && !p_reader.has_error(); i++) {
+		p_reader.get_u64();
+		uint32_t end = p_reader.begin_block();
+		if (!BradotBody3D::validate_state(p_reader) || p_reader.get_position() != end) {
+			return false;
+		}
+		p_reader.end_block(end);
+	}
+
+	uint32_t constraint_count = p_reader.get_u32();
+	for (uint32_t i = 0; i < constraint_count && !p_reader.has_error(); i++) {
+		p_reader.get_u64();
+		p_reader.get_u64();
+		p_reader.get_u32();
+		p_reader.get_u32();
+		uint32_t end = p_reader.begin_block();
+		if (!BradotBodyPair3D::validate_state(p_reader) || p_reader.get_position() != end) {
+			return false;
+		}
+		p_reader.end_block(end);
+	}
+
+	return !p_reader.has_error() && p_reader.is_at_end();
+}
+
+Vector<uint8_t> BradotSpace3D::save_state() const {
+	LocalVector<BradotBody3D *> bodies;
+	_get_state_bodies(objects, bodies);
+	LocalVector<_StateConstraint> constraints;
+	_get_state_constraints(bodies, constraints);
+
+	BradotStateWriter3D writer;
+	writer.put_u32(STATE_VERSION);
+	writer.put_u32(sizeof(real_t));
+
+	writer.put_u32(bodies.size());
+	for (const BradotBody3D *body : bodies) {
+		writer.put_u64(body->get_state_id());
+		uint32_t block = writer.begin_block();
+		body->save_state(writer);
+		writer.end_block(block);
+	}
+
+	writer.put_u32(constraints.size());
+	for (const _StateConstraint &E : constraints) {
+		writer.put_u64(E.key.object_A);
+		writer.put_u64(E.key.object_B);
+		writer.put_u32(E.key.shape_A);
+		writer.put_u32(E.key.shape_B);
+		uint32_t block = writer.begin_block();
+		E.constraint->save_state(writer);
+		writer.end_block(block);
+	}
+
+	return writer.get_data();
+}
+
+void BradotSpace3D::load_state(const Vector<uint8_t> &p_state) {
+	BradotStateReader3D reader(p_state.ptr(), p_state.size());
+	uint32_t version = reader.get_u32();
+	uint32_t real_size = reader.get_u32();
+	ERR_FAIL_COND_MSG(reader.has_error() || version != STATE_VERSION, "Invalid physics space state.");
+	ERR_FAIL_COND_MSG(real_size != sizeof(real_t), "Physics space state was saved with a different floating-point precision.");
+
+	// Nothing is loaded unless the whole state is valid.
+	BradotStateReader3D validator = reader;
+	ERR_FAIL_COND_MSG(!_validate_state(validator), "Physics space state is truncated or damaged.");
+
+	LocalVector<BradotBody3D *> bodies;
+	_get_state_bodies(objects, bodies);
+
+	// Both lists are sorted by ID, bodies that no longer exist are skipped.
+	uint32_t body_count = reader.get_u32();
+	uint32_t body_index = 0;
+	for (uint32_t i = 0; i < body_count && !reader.has_error(); i++) {
+		uint64_t id = reader.get_u64();
+		uint32_t end = reader.begin_block();
+		while (body_index < bodies.size() && bodies[body_index]->get_state_id() < id) {
+			body_index++;
+		}
+		if (body_index < bodies.size() && bodies[body_index]->get_state_id() == id) {
+			bodies[body_index]->load_state(reader);
+		}
+		reader.end_block(end);
+	}
+	ERR_FAIL_COND_MSG(reader.has_error(), "Physics space state is truncated.");
+
+	// Create the pairs for the restored transforms, so their contacts can be restored too.
+	broadphase->update();
+
+	LocalVector<_StateConstraint> constraints;
+	_get_state_constraints(bodies, constraints);
+	for (const _StateConstraint &E : constraints) {
+		E.constraint->clear_state();
+	}
+
+	uint32_t constraint_count = reader.get_u32();
+	uint32_t constraint_index = 0;
+	for (uint32_t i = 0; i < constraint_count && !reader.has_error(); i++) {
+		BradotConstraint3D::Key key;
+		key.object_A = reader.get_u64();
+		key.object_B = reader.get_u64();
+		key.shape_A = reader.get_u32();
+		key.shape_B = reader.get_u32();
+		uint32_t end = reader.begin_block();
+		while (constraint_index < constraints.size() && constraints[constraint_index].key < key) {
+			constraint_index++;
+		}
+		if (constraint_index < constraints.size() && constraints[constraint_index].key == key) {
+			constraints[constraint_index].constraint->load_state(reader);
+		}
+		reader.end_block(end);
+	}
+	ERR_FAIL_COND_MSG(reader.has_error(), "Physics space state is truncated.");
+}
+
 void BradotSpace3D::lock() {
 	locked = true;
 }
@@ -1263,6 +1635,7 @@ BradotSpace3D::BradotSpace3D() {
 	contact_max_separation = GLOBAL_GET("physics/3d/solver/contact_max_separation");
 	contact_max_allowed_penetration = GLOBAL_GET("physics/3d/solver/contact_max_allowed_penetration");
 	contact_bias = GLOBAL_GET("physics/3d/solver/default_contact_bias");
+	deterministic = GLOBAL_GET("physics/3d/solver/deterministic");
 
 	broadphase = BradotBroadPhase3D::create_func();
 	broadphase->set_pair_callback(_broadphase_pair, this);
@@ -42,11 +42,57 @@
 
 #include "core/config/project_settings.h"
 #include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/paged_allocator.h"
 #include "core/typedefs.h"
 
 class BradotPhysicsDirectSpaceState3D : public PhysicsDirectSpaceState3D {
 	BRCLASS(BradotPhysicsDirectSpaceState3D, PhysicsDirectSpaceState3D);
 
+	// Queries in a batch are split in groups of this size, each running as one task.
+	static constexpr int BATCH_QUERY_GROUP_SIZE = 64;
+
+	struct RayBatch {
+		const RayParameters *parameters = nullptr;
+		const Vector3 *from = nullptr;
+		const Vector3 *to = nullptr;
+		RayResult *results = nullptr;
+		int count = 0;
+		SafeNumeric<int> hits;
+	};
+
+	struct ShapeBatch {
+		const ShapeParameters *parameters = nullptr;
+		const Vector3 *origins = nullptr;
+		const Vector3 *motions = nullptr;
+		int count = 0;
+		ShapeResult *results = nullptr;
+		int result_max = 0;
+		int *result_counts = nullptr;
+		real_t *closest_safe = nullptr;
+		real_t *closest_unsafe = nullptr;
+	};
+
+	// Cull results of one packet of queries. Kept per thread, so batches only allocate them once for each worker.
+	struct BatchCullBuffers {
+		LocalVector<BradotCollisionObject3D *> results;
+		LocalVector<int> subindices;
+	};
+	static thread_local BatchCullBuffers batch_cull_buffers;
+	static BatchCullBuffers &_get_batch_cull_buffers();
+
+	// These run the narrow phase on objects the caller already culled from the broadphase.
+	bool _intersect_ray(const RayParameters &p_parameters, const Vector3 &p_from, const Vector3 &p_to, RayResult &r_result, BradotCollisionObject3D *const *p_cull_results, const int *p_cull_subindices, int p_cull_count) const;
+	int _intersect_shape(const ShapeParameters &p_parameters, const BradotShape3D *p_shape, const Transform3D &p_transform, ShapeResult *r_results, int p_result_max, BradotCollisionObject3D *const *p_cull_results, const int *p_cull_subindices, int p_cull_count) const;
+	void _cast_motion(const ShapeParameters &p_parameters, BradotShape3D *p_shape, const Transform3D &p_transform, const Vector3 &p_motion, const AABB &p_aabb, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info, BradotCollisionObject3D *const *p_cull_results, const int *p_cull_subindices, int p_cull_count) const;
+	static AABB _get_motion_aabb(const BradotShape3D *p_shape, const Transform3D &p_transform, const Vector3 &p_motion, real_t p_margin);
+
+	void _intersect_ray_batch_group(uint32_t p_group, RayBatch *p_batch);
+	void _intersect_shape_batch_group(uint32_t p_group, ShapeBatch *p_batch);
+	void _cast_motion_batch_group(uint32_t p_group, ShapeBatch *p_batch);
+	template <typename B>
+	void _run_batch(void (BradotPhysicsDirectSpaceState3D::*p_method)(uint32_t, B *), B *p_batch, const String &p_description);
+
 public:
 	BradotSpace3D *space = nullptr;
 
@@ -58,6 +104,10 @@ public:
 	virtual bool rest_info(const ShapeParameters &p_parameters, ShapeRestInfo *r_info) override;
 	virtual Vector3 get_closest_point_to_object_volume(RID p_object, const Vector3 p_point) const override;
 
+	virtual int intersect_ray_batch(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results) override;
+	virtual void intersect_shape_batch(const ShapeParameters &p_parameters, const Vector3 *p_origins, int p_count, ShapeResult *r_results, int p_result_max, int *r_result_counts) override;
+	virtual void cast_motion_batch(const ShapeParameters &p_parameters, const Vector3 *p_origins, const Vector3 *p_motions, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) override;
+
 	BradotPhysicsDirectSpaceState3D();
 };
 
@@ -92,9 +142,17 @@ private:
 
 	HashSet<BradotCollisionObject3D *> objects;
 
+	// Pairs are created and destroyed all the time as objects move, so they are recycled from pools.
+	PagedAllocator<BradotBodyPair3D, false, 256> body_pair_allocator;
+	PagedAllocator<BradotBodySoftBodyPair3D, false, 16> body_soft_body_pair_allocator;
+	PagedAllocator<BradotAreaPair3D, false, 64> area_pair_allocator;
+	PagedAllocator<BradotArea2Pair3D, false, 64> area2_pair_allocator;
+	PagedAllocator<BradotAreaSoftBodyPair3D, false, 16> area_soft_body_pair_allocator;
+
 	BradotArea3D *area = nullptr;
 
 	int solver_iterations = 0;
+	bool deterministic = false;
 
 	real_t contact_recycle_radius = 0.0;
 	real_t contact_max_separation = 0.0;
@@ -105,6 +163,8 @@ private:
 		INTERSECTION_QUERY_MAX = 2048
 	};
 
+	static constexpr uint32_t STATE_VERSION = 2;
+
 	BradotCollisionObject3D *intersection_query_results[INTERSECTION_QUERY_MAX];
 	int intersection_query_subindex_results[INTERSECTION_QUERY_MAX];
 
@@ -162,6 +222,7 @@ public:
 	const HashSet<BradotCollisionObject3D *> &get_objects() const;
 
 	_FORCE_INLINE_ int get_solver_iterations() const { return solver_iterations; }
+	_FORCE_INLINE_ bool is_deterministic() const { return deterministic; }
 	_FORCE_INLINE_ real_t get_contact_recycle_radius() const { return contact_recycle_radius; }
 	_FORCE_INLINE_ real_t get_contact_max_separation() const { return contact_max_separation; }
 	_FORCE_INLINE_ real_t get_contact_max_allowed_penetration() const { return contact_max_allowed_penetration; }
@@ -184,6 +245,12 @@ public:
 	void set_param(PhysicsServer3D::SpaceParameter p_param, real_t p_value);
 	real_t get_param(PhysicsServer3D::SpaceParameter p_param) const;
 
+	// Snapshot of the body motion and contact cache, for rollback in lockstep games.
+	// Objects are matched by state ID, which is their RID unless one was assigned, so
+	// without assigned IDs a state can only be restored into the space it was taken from.
+	Vector<uint8_t> save_state() const;
+	void load_state(const Vector<uint8_t> &p_state);
+
 	void set_island_count(int p_island_count) { island_count = p_island_count; }
 	int get_island_count() const { return island_count; }
 
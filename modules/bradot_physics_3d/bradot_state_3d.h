@@ -0,0 +1,164 @@
+/**************************************************************************/
+/*  bradot_state_3d.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef BRADOT_STATE_3D_H
+#define BRADOT_STATE_3D_H
+
+#include "core/io/marshalls.h"
+#include "core/math/transform_3d.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/vector.h"
+
+// Compact little endian encoding of simulation state, used to save and restore spaces.
+class BradotStateWriter3D {
+	LocalVector<uint8_t> data;
+
+	_FORCE_INLINE_ uint8_t *_grow(uint32_t p_size) {
+		uint32_t position = data.size();
+		data.resize(position + p_size);
+		return data.ptr() + position;
+	}
+
+public:
+	_FORCE_INLINE_ void put_bool(bool p_value) { *_grow(1) = p_value ? 1 : 0; }
+	_FORCE_INLINE_ void put_u32(uint32_t p_value) { encode_uint32(p_value, _grow(4)); }
+	_FORCE_INLINE_ void put_u64(uint64_t p_value) { encode_uint64(p_value, _grow(8)); }
+	_FORCE_INLINE_ void put_real(real_t p_value) { encode_real(p_value, _grow(sizeof(real_t))); }
+
+	void put_vector3(const Vector3 &p_value) {
+		put_real(p_value.x);
+		put_real(p_value.y);
+		put_real(p_value.z);
+	}
+
+	void put_transform(const Transform3D &p_value) {
+		for (int i = 0; i < 3; i++) {
+			put_vector3(p_value.basis.rows[i]);
+		}
+		put_vector3(p_value.origin);
+	}
+
+	// Blocks are prefixed with their size, so readers can skip the ones they don't need.
+	uint32_t begin_block() {
+		uint32_t position = data.size();
+		put_u32(0);
+		return position;
+	}
+
+	void end_block(uint32_t p_position) {
+		encode_uint32(data.size() - p_position - 4, data.ptr() + p_position);
+	}
+
+	Vector<uint8_t> get_data() const {
+		Vector<uint8_t> result;
+		result.resize(data.size());
+		if (data.size()) {
+			memcpy(result.ptrw(), data.ptr(), data.size());
+		}
+		return result;
+	}
+};
+
+// Reads what BradotStateWriter3D wrote. Reading past the end returns zeros and sets the error flag.
+class BradotStateReader3D {
+	const uint8_t *data = nullptr;
+	uint32_t size = 0;
+	uint32_t position = 0;
+	bool error = false;
+
+	_FORCE_INLINE_ const uint8_t *_advance(uint32_t p_size) {
+		static const uint8_t zero[8] = {};
+		if (error || p_size > size - position) {
+			error = true;
+			return zero;
+		}
+		const uint8_t *ptr = data + position;
+		position += p_size;
+		return ptr;
+	}
+
+public:
+	_FORCE_INLINE_ bool get_bool() { return *_advance(1) != 0; }
+	_FORCE_INLINE_ uint32_t get_u32() { return decode_uint32(_advance(4)); }
+	_FORCE_INLINE_ uint64_t get_u64() { return decode_uint64(_advance(8)); }
+
+	_FORCE_INLINE_ real_t get_real() {
+#ifdef REAL_T_IS_DOUBLE
+		return decode_double(_advance(8));
+#else
+		return decode_float(_advance(4));
+#endif
+	}
+
+	Vector3 get_vector3() {
+		Vector3 value;
+		value.x = get_real();
+		value.y = get_real();
+		value.z = get_real();
+		return value;
+	}
+
+	Transform3D get_transform() {
+		Transform3D value;
+		for (int i = 0; i < 3; i++) {
+			value.basis.rows[i] = get_vector3();
+		}
+		value.origin = get_vector3();
+		return value;
+	}
+
+	// Returns the position after the block, to pass to end_block() once done reading it.
+	uint32_t begin_block() {
+		uint32_t block_size = get_u32();
+		if (error || block_size > size - position) {
+			error = true;
+			return position;
+		}
+		return position + block_size;
+	}
+
+	void end_block(uint32_t p_end) {
+		if (!error) {
+			position = p_end;
+		}
+	}
+
+	bool has_error() const { return error; }
+	bool is_at_end() const { return position == size; }
+	uint32_t get_position() const { return position; }
+
+	BradotStateReader3D(const uint8_t *p_data, uint32_t p_size) {
+		data = p_data;
+		size = p_size;
+	}
+};
+
+#endif // BRADOT_STATE_3D_H
@@ -56,6 +56,12 @@ void BradotStep3D::_populate_island(BradotBody3D *p_body, LocalVector<BradotBody
 			continue; // Already processed.
 		}
 		constraint->set_island_step(_step);
+		if (deterministic && !constraint->is_overlapping()) {
+			// Pairs left over from past motion would join islands, and so change when bodies sleep. Leaving them out
+			// and resetting them like new pairs makes islands only depend on the current state.
+			constraint->clear_state();
+			continue;
+		}
 		p_constraint_island.push_back(constraint);
 
 		all_constraints.push_back(constraint);
@@ -113,11 +119,50 @@ void BradotStep3D::_populate_island_soft_body(BradotSoftBody3D *p_soft_body, Loc
 	}
 }
 
+void BradotStep3D::_predict_soft_body_motion(uint32_t p_soft_body_index, void *p_userdata) {
+	active_soft_bodies[p_soft_body_index]->predict_motion(delta);
+}
+
+void BradotStep3D::_solve_soft_body_constraints(uint32_t p_soft_body_index, void *p_userdata) {
+	active_soft_bodies[p_soft_body_index]->solve_constraints(delta);
+}
+
 void BradotStep3D::_setup_constraint(uint32_t p_constraint_index, void *p_userdata) {
 	BradotConstraint3D *constraint = all_constraints[p_constraint_index];
 	constraint->setup(delta);
 }
 
+struct _ConstraintKeySort {
+	_FORCE_INLINE_ bool operator()(const BradotConstraint3D *p_a, const BradotConstraint3D *p_b) const {
+		return p_a->get_key() < p_b->get_key();
+	}
+};
+
+struct _IslandKeySort {
+	const LocalVector<LocalVector<BradotConstraint3D *>> *islands = nullptr;
+
+	_FORCE_INLINE_ bool operator()(uint32_t p_a, uint32_t p_b) const {
+		return (*islands)[p_a][0]->get_key() < (*islands)[p_b][0]->get_key();
+	}
+};
+
+void BradotStep3D::_sort_islands(uint32_t p_island_count) {
+	// Islands are built by walking hash maps and active lists, whose order depends on the order
+	// objects and pairs were created in. Sorting by key makes solving only depend on the objects.
+	for (uint32_t island_index = 0; island_index < p_island_count; ++island_index) {
+		constraint_islands[island_index].sort_custom<_ConstraintKeySort>();
+	}
+
+	island_order.resize(p_island_count);
+	for (uint32_t island_index = 0; island_index < p_island_count; ++island_index) {
+		island_order[island_index] = island_index;
+	}
+
+	SortArray<uint32_t, _IslandKeySort> sorter;
+	sorter.compare.islands = &constraint_islands;
+	sorter.sort(island_order.ptr(), p_island_count);
+}
+
 void BradotStep3D::_pre_solve_island(LocalVector<BradotConstraint3D *> &p_constraint_island) const {
 	uint32_t constraint_count = p_constraint_island.size();
 	uint32_t valid_constraint_count = 0;
@@ -131,6 +176,15 @@ void BradotStep3D::_pre_solve_island(LocalVector<BradotConstraint3D *> &p_constr
 	p_constraint_island.resize(valid_constraint_count);
 }
 
+void BradotStep3D::_pre_solve_islands(uint32_t p_island_count) {
+	pre_solve_begtime = OS::get_singleton()->get_ticks_usec();
+
+	// Areas report overlaps while pre-solving, so this order is visible to scripts.
+	for (uint32_t island_index = 0; island_index < p_island_count; ++island_index) {
+		_pre_solve_island(constraint_islands[island_order.is_empty() ? island_index : island_order[island_index]]);
+	}
+}
+
 void BradotStep3D::_solve_island(uint32_t p_island_index, void *p_userdata) {
 	LocalVector<BradotConstraint3D *> &constraint_island = constraint_islands[p_island_index];
 
@@ -192,6 +246,7 @@ void BradotStep3D::step(BradotSpace3D *p_space, real_t p_delta) {
 
 	iterations = p_space->get_solver_iterations();
 	delta = p_delta;
+	deterministic = p_space->is_deterministic();
 
 	const SelfList<BradotBody3D>::List *body_list = &p_space->get_active_body_list();
 
@@ -215,11 +270,24 @@ void BradotStep3D::step(BradotSpace3D *p_space, real_t p_delta) {
 
 	const SelfList<BradotSoftBody3D> *sb = soft_body_list->first();
 	while (sb) {
-		sb->self()->predict_motion(p_delta);
+		active_soft_bodies.push_back(sb->self());
 		sb = sb->next();
 		active_count++;
 	}
 
+	// Soft bodies are independent from each other here, so they are updated in parallel.
+	WorkerThreadPool *wtp = WorkerThreadPool::get_singleton();
+	uint32_t soft_body_count = active_soft_bodies.size();
+	if (soft_body_count) {
+		WorkerThreadPool::GroupID predict_group_task = wtp->add_template_group_task(this, &BradotStep3D::_predict_soft_body_motion, nullptr, soft_body_count, -1, true, SNAME("Physics3DSoftBodyPredictMotion"));
+		wtp->wait_for_group_task_completion(predict_group_task);
+
+		// The broadphase isn't thread-safe, the new bounds are sent to it in list order afterwards.
+		for (BradotSoftBody3D *soft_body : active_soft_bodies) {
+			soft_body->update_shape();
+		}
+	}
+
 	p_space->set_active_objects(active_count);
 
 	// Update the broadphase to register collision pairs.
@@ -336,41 +404,40 @@ void BradotStep3D::step(BradotSpace3D *p_space, real_t p_delta) {
 
 	p_space->set_island_count((int)island_count);
 
-	{ //profile
-		profile_endtime = OS::get_singleton()->get_ticks_usec();
-		p_space->set_elapsed_time(BradotSpace3D::ELAPSED_TIME_GENERATE_ISLANDS, profile_endtime - profile_begtime);
-		profile_begtime = profile_endtime;
+	island_order.clear();
+	if (p_space->is_deterministic()) {
+		_sort_islands(island_count);
 	}
 
-	/* SETUP CONSTRAINTS / PROCESS COLLISIONS */
-
-	uint32_t total_constraint_count = all_constraints.size();
-	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &BradotStep3D::_setup_constraint, nullptr, total_constraint_count, -1, true, SNAME("Physics3DConstraintSetup"));
-	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
-
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
-		p_space->set_elapsed_time(BradotSpace3D::ELAPSED_TIME_SETUP_CONSTRAINTS, profile_endtime - profile_begtime);
+		p_space->set_elapsed_time(BradotSpace3D::ELAPSED_TIME_GENERATE_ISLANDS, profile_endtime - profile_begtime);
 		profile_begtime = profile_endtime;
 	}
 
-	/* PRE-SOLVE CONSTRAINT ISLANDS */
+	/* SETUP CONSTRAINTS / PROCESS COLLISIONS, PRE-SOLVE AND SOLVE CONSTRAINT ISLANDS */
 
-	// WARNING: This doesn't run on threads, because it involves thread-unsafe processing.
-	for (uint32_t island_index = 0; island_index < island_count; ++island_index) {
-		_pre_solve_island(constraint_islands[island_index]);
-	}
+	// These phases are submitted as a chain of dependent tasks, so there's a single wait at the end.
+	uint32_t total_constraint_count = all_constraints.size();
+	WorkerThreadPool::GroupID setup_group_task = wtp->add_template_group_task(this, &BradotStep3D::_setup_constraint, nullptr, total_constraint_count, -1, true, SNAME("Physics3DConstraintSetup"));
 
-	/* SOLVE CONSTRAINT ISLANDS */
+	// WARNING: This doesn't run in parallel, because it involves thread-unsafe processing.
+	// A single task pre-solves all the islands serially.
+	WorkerThreadPool::TaskID pre_solve_task = wtp->add_template_task_after({ setup_group_task }, this, &BradotStep3D::_pre_solve_islands, island_count, true, SNAME("Physics3DConstraintPreSolveIslands"));
 
 	// WARNING: `_solve_island` modifies the constraint islands for optimization purpose,
 	// their content is not reliable after these calls and shouldn't be used anymore.
-	group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &BradotStep3D::_solve_island, nullptr, island_count, -1, true, SNAME("Physics3DConstraintSolveIslands"));
-	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	WorkerThreadPool::GroupID solve_group_task = wtp->add_template_group_task_after({ pre_solve_task }, this, &BradotStep3D::_solve_island, nullptr, island_count, -1, true, SNAME("Physics3DConstraintSolveIslands"));
+
+	wtp->wait_for_group_task_completion(solve_group_task);
+	// These have normally completed already (unless there were no islands), so this just releases them.
+	wtp->wait_for_task_completion(pre_solve_task);
+	wtp->wait_for_group_task_completion(setup_group_task);
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
-		p_space->set_elapsed_time(BradotSpace3D::ELAPSED_TIME_SOLVE_CONSTRAINTS, profile_endtime - profile_begtime);
+		p_space->set_elapsed_time(BradotSpace3D::ELAPSED_TIME_SETUP_CONSTRAINTS, pre_solve_begtime - profile_begtime);
+		p_space->set_elapsed_time(BradotSpace3D::ELAPSED_TIME_SOLVE_CONSTRAINTS, profile_endtime - pre_solve_begtime);
 		profile_begtime = profile_endtime;
 	}
 
@@ -391,10 +458,9 @@ void BradotStep3D::step(BradotSpace3D *p_space, real_t p_delta) {
 
 	/* UPDATE SOFT BODY CONSTRAINTS */
 
-	sb = soft_body_list->first();
-	while (sb) {
-		sb->self()->solve_constraints(p_delta);
-		sb = sb->next();
+	if (soft_body_count) {
+		WorkerThreadPool::GroupID solve_soft_body_group_task = wtp->add_template_group_task(this, &BradotStep3D::_solve_soft_body_constraints, nullptr, soft_body_count, -1, true, SNAME("Physics3DSoftBodySolveConstraints"));
+		wtp->wait_for_group_task_completion(solve_soft_body_group_task);
 	}
 
 	{ //profile
@@ -404,6 +470,7 @@ void BradotStep3D::step(BradotSpace3D *p_space, real_t p_delta) {
 	}
 
 	all_constraints.clear();
+	active_soft_bodies.clear();
 
 	p_space->unlock();
 	_step++;
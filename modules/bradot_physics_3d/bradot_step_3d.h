@@ -41,15 +41,24 @@ class BradotStep3D {
 
 	int iterations = 0;
 	real_t delta = 0.0;
+	bool deterministic = false;
 
 	LocalVector<LocalVector<BradotBody3D *>> body_islands;
 	LocalVector<LocalVector<BradotConstraint3D *>> constraint_islands;
 	LocalVector<BradotConstraint3D *> all_constraints;
+	LocalVector<BradotSoftBody3D *> active_soft_bodies;
+	LocalVector<uint32_t> island_order; // Only used by deterministic spaces, otherwise islands are processed in index order.
+
+	uint64_t pre_solve_begtime = 0; // Set when constraint setup is done, for profiling.
 
 	void _populate_island(BradotBody3D *p_body, LocalVector<BradotBody3D *> &p_body_island, LocalVector<BradotConstraint3D *> &p_constraint_island);
 	void _populate_island_soft_body(BradotSoftBody3D *p_soft_body, LocalVector<BradotBody3D *> &p_body_island, LocalVector<BradotConstraint3D *> &p_constraint_island);
+	void _predict_soft_body_motion(uint32_t p_soft_body_index, void *p_userdata = nullptr);
+	void _solve_soft_body_constraints(uint32_t p_soft_body_index, void *p_userdata = nullptr);
 	void _setup_constraint(uint32_t p_constraint_index, void *p_userdata = nullptr);
+	void _sort_islands(uint32_t p_island_count);
 	void _pre_solve_island(LocalVector<BradotConstraint3D *> &p_constraint_island) const;
+	void _pre_solve_islands(uint32_t p_island_count);
 	void _solve_island(uint32_t p_island_index, void *p_userdata = nullptr);
 	void _check_suspend(const LocalVector<BradotBody3D *> &p_body_island) const;
 
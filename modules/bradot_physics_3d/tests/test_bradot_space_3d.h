@@ -0,0 +1,523 @@
+/**************************************************************************/
+/*  test_bradot_space_3d.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_BRADOT_SPACE_3D_H
+#define TEST_BRADOT_SPACE_3D_H
+
+#include "core/os/os.h"
+#include "servers/physics_server_3d.h"
+#include "servers/rendering_server.h"
+
+#include "tests/test_macros.h"
+
+namespace TestBradotSpace3D {
+
+// A space with a grid of static boxes, 4 units apart on the X and Z axes.
+struct BoxGrid {
+	RID space;
+	RID shape;
+	LocalVector<RID> bodies;
+
+	// Bodies get consecutive state IDs from p_first_state_id, unless it's 0.
+	BoxGrid(int p_size, uint64_t p_first_state_id = 0) {
+		PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+		space = ps->space_create();
+		ps->space_set_active(space, true);
+		shape = ps->box_shape_create();
+		ps->shape_set_data(shape, Vector3(1, 1, 1));
+
+		for (int x = 0; x < p_size; x++) {
+			for (int z = 0; z < p_size; z++) {
+				RID body = ps->body_create();
+				ps->body_set_mode(body, PhysicsServer3D::BODY_MODE_STATIC);
+				ps->body_add_shape(body, shape);
+				ps->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(x * 4, 0, z * 4)));
+				if (p_first_state_id) {
+					ps->body_set_state_id(body, p_first_state_id + bodies.size());
+				}
+				ps->body_set_space(body, space);
+				bodies.push_back(body);
+			}
+		}
+
+		// Registers the shapes in the broadphase.
+		ps->step(1.0 / 60.0);
+	}
+
+	~BoxGrid() {
+		PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+		for (const RID &body : bodies) {
+			ps->free(body);
+		}
+		ps->free(shape);
+		ps->free(space);
+	}
+};
+
+TEST_CASE("[SceneTree][BradotSpace3D] Batched queries") {
+	BoxGrid grid(8);
+	PhysicsDirectSpaceState3D *state = PhysicsServer3D::get_singleton()->space_get_direct_state(grid.space);
+	REQUIRE(state);
+
+	// Enough queries to be split across several tasks, half of them between the boxes.
+	const int count = 500;
+	LocalVector<Vector3> from;
+	LocalVector<Vector3> to;
+	for (int i = 0; i < count; i++) {
+		Vector3 position(i % 64 * 0.5, 0, i / 64 * 4.0);
+		from.push_back(position + Vector3(0, 10, 0));
+		to.push_back(position + Vector3(0, -10, 0));
+	}
+
+	SUBCASE("Rays") {
+		PhysicsDirectSpaceState3D::RayParameters parameters;
+		LocalVector<PhysicsDirectSpaceState3D::RayResult> results;
+		results.resize(count);
+		int hits = state->intersect_ray_batch(parameters, from.ptr(), to.ptr(), count, results.ptr());
+
+		int expected_hits = 0;
+		for (int i = 0; i < count; i++) {
+			parameters.from = from[i];
+			parameters.to = to[i];
+			PhysicsDirectSpaceState3D::RayResult expected;
+			bool hit = state->intersect_ray(parameters, expected);
+			expected_hits += hit;
+			CHECK(results[i].rid == expected.rid);
+			CHECK(results[i].position.is_equal_approx(expected.position));
+			CHECK(results[i].normal.is_equal_approx(expected.normal));
+		}
+		CHECK(expected_hits > 0);
+		CHECK(expected_hits < count);
+		CHECK(hits == expected_hits);
+	}
+
+	SUBCASE("Shapes") {
+		RID sphere = PhysicsServer3D::get_singleton()->sphere_shape_create();
+		PhysicsServer3D::get_singleton()->shape_set_data(sphere, 0.5);
+
+		PhysicsDirectSpaceState3D::ShapeParameters parameters;
+		parameters.shape_rid = sphere;
+
+		const int result_max = 4;
+		LocalVector<PhysicsDirectSpaceState3D::ShapeResult> results;
+		LocalVector<int> result_counts;
+		results.resize(count * result_max);
+		result_counts.resize(count);
+		LocalVector<Vector3> origins;
+		for (int i = 0; i < count; i++) {
+			origins.push_back(from[i] - Vector3(0, 10, 0));
+		}
+		state->intersect_shape_batch(parameters, origins.ptr(), count, results.ptr(), result_max, result_counts.ptr());
+
+		LocalVector<Vector3> motions;
+		LocalVector<real_t> closest_safe;
+		LocalVector<real_t> closest_unsafe;
+		for (int i = 0; i < count; i++) {
+			motions.push_back(to[i] - from[i]);
+		}
+		closest_safe.resize(count);
+		closest_unsafe.resize(count);
+		state->cast_motion_batch(parameters, from.ptr(), motions.ptr(), count, closest_safe.ptr(), closest_unsafe.ptr());
+
+		for (int i = 0; i < count; i++) {
+			parameters.transform.origin = origins[i];
+			PhysicsDirectSpaceState3D::ShapeResult expected[result_max];
+			int expected_count = state->intersect_shape(parameters, expected, result_max);
+			REQUIRE(result_counts[i] == expected_count);
+			for (int j = 0; j < expected_count; j++) {
+				CHECK(results[i * result_max + j].rid == expected[j].rid);
+			}
+
+			parameters.transform.origin = from[i];
+			parameters.motion = motions[i];
+			real_t expected_safe = 1.0;
+			real_t expected_unsafe = 1.0;
+			state->cast_motion(parameters, expected_safe, expected_unsafe);
+			CHECK(closest_safe[i] == doctest::Approx(expected_safe));
+			CHECK(closest_unsafe[i] == doctest::Approx(expected_unsafe));
+			parameters.motion = Vector3();
+		}
+
+		PhysicsServer3D::get_singleton()->free(sphere);
+	}
+}
+
+// Spheres falling onto the boxes and into each other, with state IDs from 1000.
+static void _add_falling_spheres(RID p_space, RID p_shape, LocalVector<RID> &r_spheres, bool p_reverse) {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	const int count = 12;
+	r_spheres.resize(count);
+	for (int j = 0; j < count; j++) {
+		int i = p_reverse ? count - 1 - j : j;
+		RID body = ps->body_create();
+		ps->body_add_shape(body, p_shape);
+		ps->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(i % 4 * 0.6, 2 + i * 1.1, i / 4 * 0.3)));
+		ps->body_set_state_id(body, 1000 + i);
+		ps->body_set_space(body, p_space);
+		r_spheres[i] = body;
+	}
+}
+
+TEST_CASE("[SceneTree][BradotSpace3D] Deterministic state snapshots") {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	BoxGrid grid(4, 1);
+	ps->space_set_param(grid.space, PhysicsServer3D::SPACE_PARAM_DETERMINISTIC, 1);
+	CHECK(ps->space_get_param(grid.space, PhysicsServer3D::SPACE_PARAM_DETERMINISTIC) == 1);
+
+	RID sphere = ps->sphere_shape_create();
+	ps->shape_set_data(sphere, 0.5);
+	LocalVector<RID> spheres;
+	_add_falling_spheres(grid.space, sphere, spheres, false);
+	CHECK(ps->body_get_state_id(spheres[3]) == 1003);
+
+	const int steps = 40;
+	for (int i = 0; i < steps; i++) {
+		ps->step(1.0 / 60.0);
+	}
+
+	Vector<uint8_t> state = ps->space_get_state(grid.space);
+	REQUIRE(!state.is_empty());
+
+	// Long enough for bodies to come to rest, so sleeping is covered too.
+	const int replay_steps = 150;
+	LocalVector<Transform3D> first_run;
+	LocalVector<bool> first_run_sleeping;
+	for (int i = 0; i < replay_steps; i++) {
+		ps->step(1.0 / 60.0);
+	}
+	for (const RID &body : spheres) {
+		first_run.push_back(ps->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM));
+		first_run_sleeping.push_back(ps->body_get_state(body, PhysicsServer3D::BODY_STATE_SLEEPING));
+	}
+
+	SUBCASE("Replaying in the same space") {
+		// Replaying from the snapshot must give the same results, bit for bit.
+		ps->space_set_state(grid.space, state);
+		for (int i = 0; i < replay_steps; i++) {
+			ps->step(1.0 / 60.0);
+		}
+		for (uint32_t i = 0; i < spheres.size(); i++) {
+			Transform3D transform = ps->body_get_state(spheres[i], PhysicsServer3D::BODY_STATE_TRANSFORM);
+			CHECK(transform == first_run[i]);
+			CHECK(bool(ps->body_get_state(spheres[i], PhysicsServer3D::BODY_STATE_SLEEPING)) == first_run_sleeping[i]);
+		}
+	}
+
+	SUBCASE("Replaying in another space") {
+		// Like another peer would: the RIDs differ and the bodies are created in another order, but the state IDs match.
+		RID unrelated = ps->box_shape_create();
+		BoxGrid other_grid(4, 1);
+		ps->space_set_param(other_grid.space, PhysicsServer3D::SPACE_PARAM_DETERMINISTIC, 1);
+		LocalVector<RID> other_spheres;
+		_add_falling_spheres(other_grid.space, sphere, other_spheres, true);
+		ps->step(1.0 / 60.0);
+
+		ps->space_set_state(other_grid.space, state);
+		for (int i = 0; i < replay_steps; i++) {
+			ps->step(1.0 / 60.0);
+		}
+		for (uint32_t i = 0; i < other_spheres.size(); i++) {
+			Transform3D transform = ps->body_get_state(other_spheres[i], PhysicsServer3D::BODY_STATE_TRANSFORM);
+			CHECK(transform == first_run[i]);
+			CHECK(bool(ps->body_get_state(other_spheres[i], PhysicsServer3D::BODY_STATE_SLEEPING)) == first_run_sleeping[i]);
+		}
+
+		for (const RID &body : other_spheres) {
+			ps->free(body);
+		}
+		ps->free(unrelated);
+	}
+
+	SUBCASE("Damaged states are rejected") {
+		// Nothing may be loaded from them, not even the bodies that come before the damage.
+		const Vector<uint8_t> current = ps->space_get_state(grid.space);
+		REQUIRE(current != state);
+
+		ERR_PRINT_OFF;
+		Vector<uint8_t> invalid;
+		invalid.push_back(1);
+		ps->space_set_state(grid.space, invalid);
+		CHECK(ps->space_get_state(grid.space) == current);
+
+		Vector<uint8_t> truncated = state;
+		truncated.resize(state.size() - 1);
+		ps->space_set_state(grid.space, truncated);
+		CHECK(ps->space_get_state(grid.space) == current);
+
+		truncated.resize(state.size() / 2);
+		ps->space_set_state(grid.space, truncated);
+		CHECK(ps->space_get_state(grid.space) == current);
+
+		Vector<uint8_t> trailing = state;
+		trailing.push_back(0);
+		ps->space_set_state(grid.space, trailing);
+		CHECK(ps->space_get_state(grid.space) == current);
+		ERR_PRINT_ON;
+	}
+
+	for (const RID &body : spheres) {
+		ps->free(body);
+	}
+	ps->free(sphere);
+}
+
+TEST_CASE("[SceneTree][BradotSpace3D] State IDs of areas and soft bodies") {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	RID area = ps->area_create();
+	RID soft_body = ps->soft_body_create();
+	CHECK(ps->area_get_state_id(area) == 0);
+	CHECK(ps->soft_body_get_state_id(soft_body) == 0);
+
+	ps->area_set_state_id(area, 2000);
+	ps->soft_body_set_state_id(soft_body, 3000);
+	CHECK(ps->area_get_state_id(area) == 2000);
+	CHECK(ps->soft_body_get_state_id(soft_body) == 3000);
+
+	ps->free(soft_body);
+	ps->free(area);
+}
+
+// A square cloth of 2 by 2 units, lying on the XZ plane.
+static RID _create_cloth_mesh(int p_subdivisions, int &r_point_count) {
+	PackedVector3Array vertices;
+	PackedInt32Array indices;
+	const int row = p_subdivisions + 1;
+	for (int z = 0; z < row; z++) {
+		for (int x = 0; x < row; x++) {
+			vertices.push_back(Vector3(x * 2.0 / p_subdivisions - 1.0, 0, z * 2.0 / p_subdivisions - 1.0));
+		}
+	}
+	for (int z = 0; z < p_subdivisions; z++) {
+		for (int x = 0; x < p_subdivisions; x++) {
+			int corner = z * row + x;
+			indices.push_back(corner);
+			indices.push_back(corner + 1);
+			indices.push_back(corner + row);
+			indices.push_back(corner + 1);
+			indices.push_back(corner + row + 1);
+			indices.push_back(corner + row);
+		}
+	}
+
+	Array arrays;
+	arrays.resize(RS::ARRAY_MAX);
+	arrays[RS::ARRAY_VERTEX] = vertices;
+	arrays[RS::ARRAY_INDEX] = indices;
+	RID mesh = RS::get_singleton()->mesh_create();
+	RS::get_singleton()->mesh_add_surface_from_arrays(mesh, RS::PRIMITIVE_TRIANGLES, arrays);
+	r_point_count = vertices.size();
+	return mesh;
+}
+
+// Drops the cloths whose index is in p_cloths onto the boxes, and stores where their points end up.
+static void _drop_cloths(RID p_space, RID p_mesh, int p_point_count, const LocalVector<int> &p_cloths, LocalVector<LocalVector<Vector3>> &r_points) {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	LocalVector<RID> soft_bodies;
+	for (int cloth : p_cloths) {
+		RID soft_body = ps->soft_body_create();
+		ps->soft_body_set_mesh(soft_body, p_mesh);
+		ps->soft_body_set_simulation_precision(soft_body, 5);
+		ps->soft_body_set_transform(soft_body, Transform3D(Basis(Vector3(0, 1, 0), cloth * 0.3), Vector3(cloth % 3 * 4 + 0.5, 2 + cloth * 0.25, cloth / 3 * 4 + 0.5)));
+		ps->soft_body_set_space(soft_body, p_space);
+		soft_bodies.push_back(soft_body);
+	}
+
+	for (int i = 0; i < 60; i++) {
+		ps->step(1.0 / 60.0);
+	}
+
+	for (uint32_t i = 0; i < soft_bodies.size(); i++) {
+		LocalVector<Vector3> &points = r_points[p_cloths[i]];
+		points.clear();
+		for (int j = 0; j < p_point_count; j++) {
+			points.push_back(ps->soft_body_get_point_global_position(soft_bodies[i], j));
+		}
+		ps->free(soft_bodies[i]);
+	}
+}
+
+TEST_CASE("[SceneTree][BradotSpace3D] Soft bodies stepped in parallel") {
+	BoxGrid grid(3);
+	int point_count = 0;
+	RID mesh = _create_cloth_mesh(8, point_count);
+
+	// Soft bodies don't collide with each other, so each one must end up the same whether it's
+	// stepped alongside others or alone, bit for bit.
+	const int cloth_count = 6;
+	LocalVector<int> all_cloths;
+	for (int i = 0; i < cloth_count; i++) {
+		all_cloths.push_back(i);
+	}
+	LocalVector<LocalVector<Vector3>> together;
+	together.resize(cloth_count);
+	_drop_cloths(grid.space, mesh, point_count, all_cloths, together);
+
+	LocalVector<LocalVector<Vector3>> again;
+	again.resize(cloth_count);
+	_drop_cloths(grid.space, mesh, point_count, all_cloths, again);
+
+	LocalVector<LocalVector<Vector3>> alone;
+	alone.resize(cloth_count);
+	for (int i = 0; i < cloth_count; i++) {
+		LocalVector<int> cloth;
+		cloth.push_back(i);
+		_drop_cloths(grid.space, mesh, point_count, cloth, alone);
+	}
+
+	for (int i = 0; i < cloth_count; i++) {
+		REQUIRE(together[i].size() == (uint32_t)point_count);
+		// The cloths must have moved, or this would compare starting positions.
+		CHECK(together[i][0].y < 2 + i * 0.25);
+		for (int j = 0; j < point_count; j++) {
+			CHECK(together[i][j] == again[i][j]);
+			CHECK(together[i][j] == alone[i][j]);
+		}
+	}
+
+	RS::get_singleton()->free(mesh);
+}
+
+TEST_CASE_BENCHMARK("[SceneTree][BradotSpace3D][Benchmark] Batched raycasts") {
+	BoxGrid grid(32);
+	PhysicsDirectSpaceState3D *state = PhysicsServer3D::get_singleton()->space_get_direct_state(grid.space);
+	REQUIRE(state);
+
+	const int count = 20000;
+	LocalVector<Vector3> from;
+	LocalVector<Vector3> to;
+	for (int i = 0; i < count; i++) {
+		Vector3 position(Math::random(0.0, 128.0), 0, Math::random(0.0, 128.0));
+		from.push_back(position + Vector3(Math::random(-8.0, 8.0), 10, Math::random(-8.0, 8.0)));
+		to.push_back(position + Vector3(0, -10, 0));
+	}
+
+	PhysicsDirectSpaceState3D::RayParameters parameters;
+	LocalVector<PhysicsDirectSpaceState3D::RayResult> results;
+	results.resize(count);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	int single_hits = 0;
+	for (int i = 0; i < count; i++) {
+		parameters.from = from[i];
+		parameters.to = to[i];
+		single_hits += state->intersect_ray(parameters, results[i]);
+	}
+	uint64_t single_time = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	int batch_hits = state->intersect_ray_batch(parameters, from.ptr(), to.ptr(), count, results.ptr());
+	uint64_t batch_time = OS::get_singleton()->get_ticks_usec() - begin;
+
+	MESSAGE("Single queries: ", single_time, " usec");
+	MESSAGE("Batched queries: ", batch_time, " usec");
+	CHECK(batch_hits == single_hits);
+}
+
+TEST_CASE_BENCHMARK("[SceneTree][BradotSpace3D][Benchmark] Steps with sleeping bodies") {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	RID box = ps->box_shape_create();
+	ps->shape_set_data(box, Vector3(0.5, 0.5, 0.5));
+	const int awake_count = 16;
+
+	// The cost of a step should depend on the bodies that move, not on the ones at rest.
+	for (int count : { 1000, 8000 }) {
+		RID space = ps->space_create();
+		ps->space_set_active(space, true);
+
+		const int side = Math::ceil(Math::sqrt(count / 2.0));
+		RID floor_shape = ps->box_shape_create();
+		ps->shape_set_data(floor_shape, Vector3(side, 1, side));
+		RID floor = ps->body_create();
+		ps->body_set_mode(floor, PhysicsServer3D::BODY_MODE_STATIC);
+		ps->body_add_shape(floor, floor_shape);
+		ps->body_set_state(floor, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(side * 0.75, -1, side * 0.75)));
+		ps->body_set_space(floor, space);
+
+		// Stacks of two boxes, so there are pairs between bodies as well as with the floor.
+		LocalVector<RID> bodies;
+		for (int i = 0; i < count; i++) {
+			int cell = i / 2;
+			RID body = ps->body_create();
+			ps->body_add_shape(body, box);
+			ps->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(cell % side * 1.5, 0.5 + i % 2, cell / side * 1.5)));
+			ps->body_set_space(body, space);
+			bodies.push_back(body);
+		}
+		// A few bodies never sleep, like the moving parts of a mostly static scene.
+		for (int i = 0; i < awake_count; i++) {
+			RID body = ps->body_create();
+			ps->body_add_shape(body, box);
+			ps->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(i * 1.5, 3, -3)));
+			ps->body_set_state(body, PhysicsServer3D::BODY_STATE_CAN_SLEEP, false);
+			ps->body_set_space(body, space);
+			bodies.push_back(body);
+		}
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		ps->step(1.0 / 60.0);
+		uint64_t pair_time = OS::get_singleton()->get_ticks_usec() - begin;
+		int pair_count = ps->get_process_info(PhysicsServer3D::INFO_COLLISION_PAIRS);
+
+		for (int i = 0; i < 600 && ps->get_process_info(PhysicsServer3D::INFO_ACTIVE_OBJECTS) > awake_count; i++) {
+			ps->step(1.0 / 60.0);
+		}
+		int active_count = ps->get_process_info(PhysicsServer3D::INFO_ACTIVE_OBJECTS);
+
+		const int steps = 120;
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < steps; i++) {
+			ps->step(1.0 / 60.0);
+		}
+		uint64_t resting_time = OS::get_singleton()->get_ticks_usec() - begin;
+
+		// Unpairing returns the pairs to their pools.
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (const RID &body : bodies) {
+			ps->free(body);
+		}
+		uint64_t free_time = OS::get_singleton()->get_ticks_usec() - begin;
+
+		MESSAGE(count, " resting bodies, ", active_count, " awake:");
+		MESSAGE("  First step, creating ", pair_count, " pairs: ", pair_time, " usec");
+		MESSAGE("  Steps at rest: ", resting_time / steps, " usec per step");
+		MESSAGE("  Freeing the bodies: ", free_time, " usec");
+
+		ps->free(floor);
+		ps->free(floor_shape);
+		ps->free(space);
+	}
+
+	ps->free(box);
+}
+
+} // namespace TestBradotSpace3D
+
+#endif // TEST_BRADOT_SPACE_3D_H
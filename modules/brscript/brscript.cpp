@@ -32,10 +32,12 @@
 #include "brscript.h"
 
 #include "brscript_analyzer.h"
+#include "brscript_byte_optimizer.h"
 #include "brscript_cache.h"
 #include "brscript_compiler.h"
 #include "brscript_parser.h"
 #include "brscript_rpc_callable.h"
+#include "brscript_sampling_profiler.h"
 #include "brscript_tokenizer_buffer.h"
 #include "brscript_warning.h"
 
@@ -820,7 +822,7 @@ Error BRScript::reload(bool p_keep_state) {
 	if (!binary_tokens.is_empty()) {
 		err = parser.parse_binary(binary_tokens, path);
 	} else {
-		err = parser.parse(source, path, false);
+		err = BRScriptCache::parse_source(&parser, source, path);
 	}
 	if (err) {
 		if (EngineDebugger::is_active()) {
@@ -1441,6 +1443,7 @@ BRScript::BRScript() :
 	}
 
 	path = vformat("brscript://%d.br", get_instance_id());
+	inline_cache_epoch.set(BRScriptFunction::new_inline_cache_epoch());
 }
 
 void BRScript::_save_orphaned_subclasses(ClearData *p_clear_data) {
@@ -1561,6 +1564,8 @@ void BRScript::clear(ClearData *p_clear_data) {
 	}
 	clearing = true;
 
+	BRScriptFunction::invalidate_inline_caches(this);
+
 	ClearData data;
 	ClearData *clear_data = p_clear_data;
 	bool is_root = false;
@@ -2295,6 +2300,31 @@ void BRScriptLanguage::init() {
 		_add_global(E.name, E.ptr);
 	}
 
+	// Read in the editor too, so exported native code is generated for the same bytecode.
+	BRScriptByteCodeOptimizer::set_enabled(GLOBAL_GET("brscript/compilation/optimize_bytecode"));
+
+	// Outside of the editor, sources only change between runs, so tokens can be reused.
+	// The editor needs comments for documentation, which tokens don't keep.
+	if (!Engine::get_singleton()->is_editor_hint() && ProjectSettings::get_singleton()->is_project_loaded()) {
+		if (GLOBAL_GET("brscript/compilation/token_cache")) {
+			// Exported projects can't write to their own resources.
+			String cache_dir = OS::get_singleton()->has_feature("template") ? String("user://") : ProjectSettings::get_singleton()->get_project_data_path();
+			BRScriptCache::set_token_cache_path(cache_dir.path_join("brscript_cache"));
+		}
+
+		if (GLOBAL_GET("brscript/compilation/parse_global_classes_at_startup")) {
+			Vector<String> paths;
+			List<StringName> global_classes;
+			ScriptServer::get_global_class_list(&global_classes);
+			for (const StringName &class_name : global_classes) {
+				if (ScriptServer::get_global_class_language(class_name) == get_name()) {
+					paths.push_back(ScriptServer::get_global_class_path(class_name));
+				}
+			}
+			BRScriptCache::preparse_scripts(paths);
+		}
+	}
+
 #ifdef TOOLS_ENABLED
 	if (Engine::get_singleton()->is_editor_hint()) {
 		BRExtensionManager::get_singleton()->connect("extension_loaded", callable_mp(this, &BRScriptLanguage::_extension_loaded));
@@ -2302,6 +2332,10 @@ void BRScriptLanguage::init() {
 	}
 #endif
 
+	if (!Engine::get_singleton()->is_editor_hint() && GLOBAL_GET("debug/settings/brscript/sampling_profiler/enabled")) {
+		BRScriptSamplingProfiler::start(GLOBAL_GET("debug/settings/brscript/sampling_profiler/interval_usec"), GLOBAL_GET("debug/settings/brscript/sampling_profiler/output_path"), uint64_t(GLOBAL_GET("debug/settings/brscript/sampling_profiler/save_interval")) * 1000000);
+	}
+
 #ifdef TESTS_ENABLED
 	BRScriptTests::BRScriptTestRunner::handle_cmdline();
 #endif
@@ -2343,6 +2377,8 @@ void BRScriptLanguage::finish() {
 	}
 	finishing = true;
 
+	BRScriptSamplingProfiler::stop();
+
 	_call_stack.free();
 
 	// Clear the cache before parsing the script_list
@@ -2965,6 +3001,15 @@ BRScriptLanguage::BRScriptLanguage() {
 
 	int dmcs = GLOBAL_DEF(PropertyInfo(Variant::INT, "debug/settings/brscript/max_call_stack", PROPERTY_HINT_RANGE, "512," + itos(BRScriptFunction::MAX_CALL_DEPTH - 1) + ",1"), 1024);
 
+	GLOBAL_DEF("debug/settings/brscript/sampling_profiler/enabled", false);
+	GLOBAL_DEF(PropertyInfo(Variant::INT, "debug/settings/brscript/sampling_profiler/interval_usec", PROPERTY_HINT_RANGE, "100,100000,1,suffix:usec"), 1000);
+	GLOBAL_DEF(PropertyInfo(Variant::STRING, "debug/settings/brscript/sampling_profiler/output_path", PROPERTY_HINT_SAVE_FILE, "*.folded"), "user://brscript_profile.folded");
+	GLOBAL_DEF(PropertyInfo(Variant::INT, "debug/settings/brscript/sampling_profiler/save_interval", PROPERTY_HINT_RANGE, "0,3600,1,suffix:s"), 10);
+
+	GLOBAL_DEF("brscript/compilation/optimize_bytecode", true);
+	GLOBAL_DEF("brscript/compilation/token_cache", true);
+	GLOBAL_DEF("brscript/compilation/parse_global_classes_at_startup", true);
+
 	if (EngineDebugger::is_active()) {
 		//debugging enabled!
 
@@ -2986,6 +3031,7 @@ BRScriptLanguage::BRScriptLanguage() {
 }
 
 BRScriptLanguage::~BRScriptLanguage() {
+	BRScriptFunctionState::clear_stack_pool();
 	singleton = nullptr;
 }
 
@@ -97,6 +97,10 @@ class BRScript : public Script {
 	BRScript *_base = nullptr; //fast pointer access
 	BRScript *_owner = nullptr; //for subclasses
 
+	// Inline cache entries keyed on this script are only valid while the epochs of the script and its bases
+	// don't change (see `BRScriptFunction::invalidate_inline_caches()`).
+	SafeNumeric<uint32_t> inline_cache_epoch;
+
 	// Members are just indices to the instantiated script.
 	HashMap<StringName, MemberInfo> member_indices; // Includes member info of all base BRScript classes.
 	HashSet<StringName> members; // Only members of the current class.
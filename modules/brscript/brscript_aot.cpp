@@ -0,0 +1,514 @@
+/**************************************************************************/
+/*  brscript_aot.cpp                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "brscript_aot.h"
+
+#include "brscript.h"
+
+#include "core/object/method_bind.h"
+
+#ifdef TOOLS_ENABLED
+#include "brscript_analyzer.h"
+#include "brscript_cache.h"
+#include "brscript_compiler.h"
+#include "brscript_parser.h"
+
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/templates/hash_set.h"
+#include "core/templates/local_vector.h"
+#endif
+
+HashMap<String, BRScriptAOT::Registration> BRScriptAOT::registry;
+
+String BRScriptAOT::_get_function_key(const BRScriptFunction *p_function) {
+	return p_function->_script->get_fully_qualified_name() + "::" + String(p_function->name);
+}
+
+uint32_t BRScriptAOT::hash_function(const BRScriptFunction *p_function) {
+	uint32_t hash = hash_murmur3_buffer(p_function->_code_ptr, p_function->_code_size * sizeof(int));
+	hash = hash_murmur3_one_32(p_function->_stack_size, hash);
+	hash = hash_murmur3_one_32(p_function->_constant_count, hash);
+	hash = hash_murmur3_one_32(p_function->_operator_funcs_count, hash);
+	for (int i = 0; i < p_function->_methods_count; i++) {
+		hash = hash_murmur3_one_32(p_function->_methods_ptr[i]->get_name().hash(), hash);
+	}
+	return hash_fmix32(hash);
+}
+
+void BRScriptAOT::register_function(const String &p_key, uint32_t p_hash, NativeFunction p_function) {
+	ERR_FAIL_NULL(p_function);
+	Registration registration;
+	registration.hash = p_hash;
+	registration.function = p_function;
+	registry[p_key] = registration;
+}
+
+void BRScriptAOT::unregister_function(const String &p_key) {
+	registry.erase(p_key);
+}
+
+BRScriptAOT::NativeFunction BRScriptAOT::get_function(const BRScriptFunction *p_function) {
+	if (registry.is_empty() || !p_function->_script || !p_function->_code_ptr) {
+		return nullptr;
+	}
+
+	const Registration *registration = registry.getptr(_get_function_key(p_function));
+	if (!registration || registration->hash != hash_function(p_function)) {
+		// Not exported, or the script changed since: stay on the bytecode.
+		return nullptr;
+	}
+	return registration->function;
+}
+
+#ifdef TOOLS_ENABLED
+
+struct BRScriptAOTTypedOperator {
+	BRScriptFunction::Opcode opcode;
+	const char *op;
+	const char *get_func;
+	const char *ret_get_func;
+};
+
+static const BRScriptAOTTypedOperator typed_operators[] = {
+	{ BRScriptFunction::OPCODE_OPERATOR_ADD_INT, "+", "get_int", "get_int" },
+	{ BRScriptFunction::OPCODE_OPERATOR_SUBTRACT_INT, "-", "get_int", "get_int" },
+	{ BRScriptFunction::OPCODE_OPERATOR_MULTIPLY_INT, "*", "get_int", "get_int" },
+	{ BRScriptFunction::OPCODE_OPERATOR_EQUAL_INT, "==", "get_int", "get_bool" },
+	{ BRScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_INT, "!=", "get_int", "get_bool" },
+	{ BRScriptFunction::OPCODE_OPERATOR_LESS_INT, "<", "get_int", "get_bool" },
+	{ BRScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_INT, "<=", "get_int", "get_bool" },
+	{ BRScriptFunction::OPCODE_OPERATOR_GREATER_INT, ">", "get_int", "get_bool" },
+	{ BRScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_INT, ">=", "get_int", "get_bool" },
+	{ BRScriptFunction::OPCODE_OPERATOR_ADD_FLOAT, "+", "get_float", "get_float" },
+	{ BRScriptFunction::OPCODE_OPERATOR_SUBTRACT_FLOAT, "-", "get_float", "get_float" },
+	{ BRScriptFunction::OPCODE_OPERATOR_MULTIPLY_FLOAT, "*", "get_float", "get_float" },
+	{ BRScriptFunction::OPCODE_OPERATOR_DIVIDE_FLOAT, "/", "get_float", "get_float" },
+	{ BRScriptFunction::OPCODE_OPERATOR_EQUAL_FLOAT, "==", "get_float", "get_bool" },
+	{ BRScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_FLOAT, "!=", "get_float", "get_bool" },
+	{ BRScriptFunction::OPCODE_OPERATOR_LESS_FLOAT, "<", "get_float", "get_bool" },
+	{ BRScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_FLOAT, "<=", "get_float", "get_bool" },
+	{ BRScriptFunction::OPCODE_OPERATOR_GREATER_FLOAT, ">", "get_float", "get_bool" },
+	{ BRScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_FLOAT, ">=", "get_float", "get_bool" },
+};
+
+static const BRScriptAOTTypedOperator *_get_typed_operator(int p_opcode) {
+	for (const BRScriptAOTTypedOperator &typed_operator : typed_operators) {
+		if (typed_operator.opcode == p_opcode) {
+			return &typed_operator;
+		}
+	}
+	return nullptr;
+}
+
+static const char *address_type_names[BRScriptFunction::ADDR_TYPE_MAX] = { "stack", "constants", "members" };
+
+bool BRScriptAOT::_decode_instruction(const BRScriptFunction *p_function, int p_ip, Instruction &r_instruction) {
+	const int *code = p_function->_code_ptr;
+	const int code_size = p_function->_code_size;
+	if (p_ip < 0 || p_ip >= code_size) {
+		return false;
+	}
+
+	r_instruction = Instruction();
+
+	switch (code[p_ip]) {
+		case BRScriptFunction::OPCODE_OPERATOR_VALIDATED: {
+			r_instruction.length = 5;
+			if (p_ip + 4 < code_size && (code[p_ip + 4] < 0 || code[p_ip + 4] >= p_function->_operator_funcs_count)) {
+				return false;
+			}
+		} break;
+		case BRScriptFunction::OPCODE_ASSIGN: {
+			r_instruction.length = 3;
+		} break;
+		case BRScriptFunction::OPCODE_ASSIGN_NULL:
+		case BRScriptFunction::OPCODE_ASSIGN_TRUE:
+		case BRScriptFunction::OPCODE_ASSIGN_FALSE:
+		case BRScriptFunction::OPCODE_LINE: {
+			r_instruction.length = 2;
+		} break;
+		case BRScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN: {
+			r_instruction.length = 4;
+			if (p_ip + 3 < code_size && (code[p_ip + 3] < 0 || code[p_ip + 3] >= Variant::VARIANT_MAX)) {
+				return false;
+			}
+		} break;
+		case BRScriptFunction::OPCODE_JUMP: {
+			r_instruction.length = 2;
+			r_instruction.falls_through = false;
+			r_instruction.jump = p_ip + 1 < code_size ? code[p_ip + 1] : -1;
+		} break;
+		case BRScriptFunction::OPCODE_JUMP_IF:
+		case BRScriptFunction::OPCODE_JUMP_IF_NOT: {
+			r_instruction.length = 3;
+			r_instruction.jump = p_ip + 2 < code_size ? code[p_ip + 2] : -1;
+		} break;
+		case BRScriptFunction::OPCODE_ITERATE_BEGIN_INT:
+		case BRScriptFunction::OPCODE_ITERATE_INT: {
+			r_instruction.length = 5;
+			r_instruction.jump = p_ip + 4 < code_size ? code[p_ip + 4] : -1;
+		} break;
+		case BRScriptFunction::OPCODE_CALL_METHOD_BIND_VALIDATED_RETURN:
+		case BRScriptFunction::OPCODE_CALL_METHOD_BIND_VALIDATED_NO_RETURN: {
+			if (p_ip + 1 >= code_size) {
+				return false;
+			}
+			// Arguments, base and return value, then the argument count and the method.
+			const int instr_arg_count = code[p_ip + 1];
+			r_instruction.length = 4 + instr_arg_count;
+			if (p_ip + r_instruction.length > code_size) {
+				return false;
+			}
+			const int argc = code[p_ip + 2 + instr_arg_count];
+			const int method = code[p_ip + 3 + instr_arg_count];
+			if (argc < 0 || argc + 2 != instr_arg_count || method < 0 || method >= p_function->_methods_count) {
+				return false;
+			}
+		} break;
+		default: {
+			if (!_get_typed_operator(code[p_ip])) {
+				return false;
+			}
+			r_instruction.length = 4;
+		} break;
+	}
+
+	if (p_ip + r_instruction.length > code_size) {
+		return false;
+	}
+	if (r_instruction.jump != -1 && (r_instruction.jump < 0 || r_instruction.jump > code_size)) {
+		return false;
+	}
+	return true;
+}
+
+String BRScriptAOT::_get_address(int p_address, uint32_t &r_used_address_types) {
+	const uint32_t address_type = (uint32_t(p_address) & uint32_t(BRScriptFunction::ADDR_TYPE_MASK)) >> BRScriptFunction::ADDR_BITS;
+	ERR_FAIL_COND_V(address_type >= BRScriptFunction::ADDR_TYPE_MAX, String());
+	r_used_address_types |= 1 << address_type;
+	return vformat("%s[%d]", address_type_names[address_type], p_address & BRScriptFunction::ADDR_MASK);
+}
+
+String BRScriptAOT::_get_branch(const RBMap<int, Instruction> &p_instructions, int p_target) {
+	if (p_instructions.has(p_target)) {
+		return vformat("goto L_%d;", p_target);
+	}
+	// Not translated, let the VM take it from here.
+	return vformat("return %d;", p_target);
+}
+
+String BRScriptAOT::_write_instruction(const BRScriptFunction *p_function, int p_ip, const RBMap<int, Instruction> &p_instructions, uint32_t &r_used_address_types) {
+	const int *code = p_function->_code_ptr;
+
+#define ADDR(m_ofs) _get_address(code[p_ip + 1 + (m_ofs)], r_used_address_types)
+
+	String text;
+	switch (code[p_ip]) {
+		case BRScriptFunction::OPCODE_OPERATOR_VALIDATED: {
+			text += vformat("\tp_context.operator_funcs[%d](&%s, &%s, &%s);\n", code[p_ip + 4], ADDR(0), ADDR(1), ADDR(2));
+		} break;
+		case BRScriptFunction::OPCODE_ASSIGN: {
+			text += vformat("\t%s = %s;\n", ADDR(0), ADDR(1));
+		} break;
+		case BRScriptFunction::OPCODE_ASSIGN_NULL: {
+			text += vformat("\t%s = Variant();\n", ADDR(0));
+		} break;
+		case BRScriptFunction::OPCODE_ASSIGN_TRUE: {
+			text += vformat("\t%s = true;\n", ADDR(0));
+		} break;
+		case BRScriptFunction::OPCODE_ASSIGN_FALSE: {
+			text += vformat("\t%s = false;\n", ADDR(0));
+		} break;
+		case BRScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN: {
+			// Conversions are left to the VM.
+			text += vformat("\tif (%s.get_type() != Variant::Type(%d)) {\n", ADDR(1), code[p_ip + 3]);
+			text += vformat("\t\treturn %d;\n", p_ip);
+			text += "\t}\n";
+			text += vformat("\t%s = %s;\n", ADDR(0), ADDR(1));
+		} break;
+		case BRScriptFunction::OPCODE_JUMP: {
+			text += "\t" + _get_branch(p_instructions, code[p_ip + 1]) + "\n";
+		} break;
+		case BRScriptFunction::OPCODE_JUMP_IF:
+		case BRScriptFunction::OPCODE_JUMP_IF_NOT: {
+			text += vformat("\tif (%s%s.booleanize()) {\n", code[p_ip] == BRScriptFunction::OPCODE_JUMP_IF_NOT ? "!" : "", ADDR(0));
+			text += "\t\t" + _get_branch(p_instructions, code[p_ip + 2]) + "\n";
+			text += "\t}\n";
+		} break;
+		case BRScriptFunction::OPCODE_ITERATE_BEGIN_INT: {
+			text += vformat("\tif (%s.get_type() != Variant::INT) {\n", ADDR(1));
+			text += vformat("\t\treturn %d;\n", p_ip);
+			text += "\t}\n";
+			text += vformat("\tVariantInternal::initialize(&%s, Variant::INT);\n", ADDR(0));
+			text += vformat("\t*VariantInternal::get_int(&%s) = 0;\n", ADDR(0));
+			text += vformat("\tif (*VariantInternal::get_int(&%s) <= 0) {\n", ADDR(1));
+			text += "\t\t" + _get_branch(p_instructions, code[p_ip + 4]) + "\n";
+			text += "\t}\n";
+			text += vformat("\tVariantInternal::initialize(&%s, Variant::INT);\n", ADDR(2));
+			text += vformat("\t*VariantInternal::get_int(&%s) = 0;\n", ADDR(2));
+		} break;
+		case BRScriptFunction::OPCODE_ITERATE_INT: {
+			text += vformat("\tif (++*VariantInternal::get_int(&%s) >= *VariantInternal::get_int(&%s)) {\n", ADDR(0), ADDR(1));
+			text += "\t\t" + _get_branch(p_instructions, code[p_ip + 4]) + "\n";
+			text += "\t}\n";
+			text += vformat("\t*VariantInternal::get_int(&%s) = *VariantInternal::get_int(&%s);\n", ADDR(2), ADDR(0));
+		} break;
+		case BRScriptFunction::OPCODE_LINE: {
+			// Only meaningful to the debugger.
+			text += "\t;\n";
+		} break;
+		case BRScriptFunction::OPCODE_CALL_METHOD_BIND_VALIDATED_RETURN:
+		case BRScriptFunction::OPCODE_CALL_METHOD_BIND_VALIDATED_NO_RETURN: {
+			const int instr_arg_count = code[p_ip + 1];
+			const int argc = code[p_ip + 2 + instr_arg_count];
+			const int method = code[p_ip + 3 + instr_arg_count];
+			const bool has_return = code[p_ip] == BRScriptFunction::OPCODE_CALL_METHOD_BIND_VALIDATED_RETURN;
+			// Instruction arguments start one word later, after their count.
+			const String base = ADDR(1 + argc);
+			const String ret = ADDR(2 + argc);
+
+			text += "\t{\n";
+			text += vformat("\t\tif (%s.get_type() != Variant::OBJECT || !*VariantInternal::get_object(&%s)) {\n", base, base);
+			text += vformat("\t\t\treturn %d;\n", p_ip);
+			text += "\t\t}\n";
+			String args = "nullptr";
+			if (argc > 0) {
+				text += "\t\tconst Variant *args[] = { ";
+				for (int i = 0; i < argc; i++) {
+					text += (i > 0 ? ", &" : "&") + ADDR(1 + i);
+				}
+				text += " };\n";
+				args = "args";
+			}
+			if (!has_return) {
+				text += vformat("\t\tVariantInternal::initialize(&%s, Variant::NIL);\n", ret);
+			}
+			text += vformat("\t\tp_context.methods[%d]->validated_call(*VariantInternal::get_object(&%s), %s, %s);\n", method, base, args, has_return ? "&" + ret : String("nullptr"));
+			text += "\t}\n";
+		} break;
+		default: {
+			const BRScriptAOTTypedOperator *typed_operator = _get_typed_operator(code[p_ip]);
+			ERR_FAIL_NULL_V(typed_operator, String());
+			text += vformat("\t*VariantInternal::%s(&%s) = *VariantInternal::%s(&%s) %s *VariantInternal::%s(&%s);\n",
+					typed_operator->ret_get_func, ADDR(2), typed_operator->get_func, ADDR(0), typed_operator->op, typed_operator->get_func, ADDR(1));
+		} break;
+	}
+
+#undef ADDR
+
+	return text;
+}
+
+String BRScriptAOT::_lower_function(const BRScriptFunction *p_function, const String &p_symbol) {
+	// Find everything reachable from the entry point without going through an instruction we can't translate.
+	RBMap<int, Instruction> instructions;
+	LocalVector<int> pending;
+	pending.push_back(0);
+	while (!pending.is_empty()) {
+		const int ip = pending[pending.size() - 1];
+		pending.remove_at(pending.size() - 1);
+
+		Instruction instruction;
+		if (instructions.has(ip) || !_decode_instruction(p_function, ip, instruction)) {
+			continue;
+		}
+		instructions.insert(ip, instruction);
+
+		if (instruction.jump != -1) {
+			pending.push_back(instruction.jump);
+		}
+		if (instruction.falls_through) {
+			pending.push_back(ip + instruction.length);
+		}
+	}
+
+	if (instructions.is_empty()) {
+		return String();
+	}
+
+	// Only label instructions something jumps to, so the generated code builds without warnings.
+	HashSet<int> labels;
+	for (const KeyValue<int, Instruction> &E : instructions) {
+		if (E.value.jump != -1 && instructions.has(E.value.jump)) {
+			labels.insert(E.value.jump);
+		}
+		const RBMap<int, Instruction>::Element *next = instructions.find(E.key)->next();
+		if (E.value.falls_through && (!next || next->key() != E.key + E.value.length) && instructions.has(E.key + E.value.length)) {
+			labels.insert(E.key + E.value.length);
+		}
+	}
+
+	String body;
+	uint32_t used_address_types = 0;
+	for (const RBMap<int, Instruction>::Element *E = instructions.front(); E; E = E->next()) {
+		if (labels.has(E->key())) {
+			body += vformat("L_%d:\n", E->key());
+		}
+		body += _write_instruction(p_function, E->key(), instructions, used_address_types);
+
+		const int next_ip = E->key() + E->get().length;
+		if (E->get().falls_through && (!E->next() || E->next()->key() != next_ip)) {
+			body += "\t" + _get_branch(instructions, next_ip) + "\n";
+		}
+	}
+
+	String code = vformat("// %s\n", _get_function_key(p_function));
+	code += vformat("static int %s(const BRScriptFunction::NativeContext &p_context) {\n", p_symbol);
+	for (int i = 0; i < BRScriptFunction::ADDR_TYPE_MAX; i++) {
+		if (used_address_types & (1 << i)) {
+			code += vformat("\tVariant *%s = p_context.addresses[%d];\n", address_type_names[i], i);
+		}
+	}
+	code += body;
+	code += "}\n";
+	return code;
+}
+
+void BRScriptAOT::_add_functions(const BRScript *p_script) {
+	for (const KeyValue<StringName, BRScriptFunction *> &E : p_script->get_member_functions()) {
+		const BRScriptFunction *function = E.value;
+		if (!function || !function->_code_ptr) {
+			continue;
+		}
+
+		const String code = _lower_function(function, vformat("_brscript_aot_%d", functions.size()));
+		if (code.is_empty()) {
+			continue;
+		}
+
+		LoweredFunction lowered;
+		lowered.key = _get_function_key(function);
+		lowered.hash = hash_function(function);
+		lowered.code = code;
+		functions.push_back(lowered);
+	}
+
+	for (const KeyValue<StringName, Ref<BRScript>> &E : p_script->get_subclasses()) {
+		_add_functions(E.value.ptr());
+	}
+}
+
+Error BRScriptAOT::add_script(const String &p_path, const String &p_source) {
+	BRScriptParser parser;
+	Error err = parser.parse(p_source, p_path, false);
+	if (err != OK) {
+		return err;
+	}
+
+	BRScriptAnalyzer analyzer(&parser);
+	err = analyzer.analyze();
+	if (err != OK) {
+		return err;
+	}
+
+	// Compile a detached copy, so the script loaded in the editor keeps its debug bytecode.
+	Ref<BRScript> script;
+	script.instantiate();
+
+	BRScriptCompiler compiler;
+	compiler.set_release_bytecode(true);
+	err = compiler.compile(&parser, script.ptr(), false);
+
+	// The copy has no path, drop what the compiler cached for it.
+	BRScriptCache::remove_script(String());
+
+	if (err != OK) {
+		return err;
+	}
+
+	_add_functions(script.ptr());
+	return OK;
+}
+
+Error BRScriptAOT::save_module(const String &p_dir) const {
+	const String module_name = p_dir.simplify_path().get_file();
+	ERR_FAIL_COND_V_MSG(!module_name.is_valid_ascii_identifier(), ERR_INVALID_PARAMETER, vformat("The BRScript native module directory name must be a valid identifier: \"%s\".", module_name));
+
+	Error err = DirAccess::make_dir_recursive_absolute(p_dir);
+	ERR_FAIL_COND_V_MSG(err != OK, err, vformat("Cannot create the BRScript native module directory: \"%s\".", p_dir));
+
+	const String header = "# THIS FILE IS GENERATED. DO NOT EDIT.\n";
+	const String cpp_header = "/* THIS FILE IS GENERATED. DO NOT EDIT. */\n";
+
+	String config = header;
+	config += "\n\ndef can_build(env, platform):\n";
+	config += vformat("    env.module_add_dependencies(\"%s\", [\"brscript\"])\n", module_name);
+	config += "    return True\n";
+	config += "\n\ndef configure(env):\n";
+	config += "    pass\n";
+
+	String scsub = "#!/usr/bin/env python\n" + header;
+	scsub += "\nImport(\"env\")\n";
+	scsub += "Import(\"env_modules\")\n";
+	scsub += vformat("\nenv_%s = env_modules.Clone()\n", module_name);
+	scsub += vformat("env_%s.add_source_files(env.modules_sources, \"*.cpp\")\n", module_name);
+
+	const String guard = module_name.to_upper() + "_REGISTER_TYPES_H";
+	String register_h = cpp_header;
+	register_h += vformat("\n#ifndef %s\n#define %s\n", guard, guard);
+	register_h += "\n#include \"modules/register_module_types.h\"\n\n";
+	register_h += vformat("void initialize_%s_module(ModuleInitializationLevel p_level);\n", module_name);
+	register_h += vformat("void uninitialize_%s_module(ModuleInitializationLevel p_level);\n", module_name);
+	register_h += vformat("\n#endif // %s\n", guard);
+
+	String register_cpp = cpp_header;
+	register_cpp += "\n#include \"register_types.h\"\n\n";
+	register_cpp += "#include \"modules/brscript/brscript_aot.h\"\n\n";
+	register_cpp += "#include \"core/object/method_bind.h\"\n";
+	register_cpp += "#include \"core/variant/variant_internal.h\"\n";
+	for (const LoweredFunction &function : functions) {
+		register_cpp += "\n" + function.code;
+	}
+	register_cpp += vformat("\nvoid initialize_%s_module(ModuleInitializationLevel p_level) {\n", module_name);
+	register_cpp += "\tif (p_level != MODULE_INITIALIZATION_LEVEL_CORE) {\n\t\treturn;\n\t}\n\n";
+	for (int i = 0; i < functions.size(); i++) {
+		register_cpp += vformat("\tBRScriptAOT::register_function(\"%s\", %du, _brscript_aot_%d);\n", functions[i].key.c_escape(), functions[i].hash, i);
+	}
+	register_cpp += "}\n";
+	register_cpp += vformat("\nvoid uninitialize_%s_module(ModuleInitializationLevel p_level) {\n}\n", module_name);
+
+	const String files[][2] = {
+		{ "config.py", config },
+		{ "SCsub", scsub },
+		{ "register_types.h", register_h },
+		{ "register_types.cpp", register_cpp },
+	};
+	for (const String *file : files) {
+		Ref<FileAccess> f = FileAccess::open(p_dir.path_join(file[0]), FileAccess::WRITE, &err);
+		ERR_FAIL_COND_V_MSG(f.is_null(), err, vformat("Cannot write the BRScript native module file: \"%s\".", p_dir.path_join(file[0])));
+		f->store_string(file[1]);
+	}
+
+	return OK;
+}
+
+#endif // TOOLS_ENABLED
@@ -0,0 +1,110 @@
+/**************************************************************************/
+/*  brscript_aot.h                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef BRSCRIPT_AOT_H
+#define BRSCRIPT_AOT_H
+
+#include "brscript_function.h"
+
+#include "core/templates/hash_map.h"
+#include "core/templates/rb_map.h"
+
+class BRScript;
+
+// Ahead-of-time translation of BRScript bytecode to C++.
+//
+// On export, every function is compiled as a release build would compile it, and the longest
+// run of instructions reachable from its entry that has a direct C++ equivalent is written out
+// as a native function. The generated sources form an engine module which registers those
+// functions here. When a release build compiles a script, functions whose bytecode hashes the
+// same as at export time run the native code first, then the VM resumes at the address it
+// returns. Anything that changed or isn't supported keeps running in the VM.
+//
+// Translated are typed int/float arithmetic and comparisons, validated operators, assignments,
+// jumps, `for` loops over integer ranges and validated calls to engine methods, on locals,
+// constants and script members. Statically typed numeric loops and kernels benefit the most.
+// Returns, named access on untyped values, utility function calls and native property access
+// end the native prefix, so duck-typed code and functions that start with them gain nothing.
+class BRScriptAOT {
+public:
+	typedef BRScriptFunction::NativeFunction NativeFunction;
+
+private:
+	struct Registration {
+		uint32_t hash = 0;
+		NativeFunction function = nullptr;
+	};
+
+	static HashMap<String, Registration> registry;
+
+	static String _get_function_key(const BRScriptFunction *p_function);
+
+#ifdef TOOLS_ENABLED
+	struct Instruction {
+		int length = 0;
+		int jump = -1;
+		bool falls_through = true;
+	};
+
+	struct LoweredFunction {
+		String key;
+		uint32_t hash = 0;
+		String code;
+	};
+
+	Vector<LoweredFunction> functions;
+
+	static bool _decode_instruction(const BRScriptFunction *p_function, int p_ip, Instruction &r_instruction);
+	static String _get_address(int p_address, uint32_t &r_used_address_types);
+	static String _get_branch(const RBMap<int, Instruction> &p_instructions, int p_target);
+	static String _write_instruction(const BRScriptFunction *p_function, int p_ip, const RBMap<int, Instruction> &p_instructions, uint32_t &r_used_address_types);
+	static String _lower_function(const BRScriptFunction *p_function, const String &p_symbol);
+
+	void _add_functions(const BRScript *p_script);
+#endif
+
+public:
+	static uint32_t hash_function(const BRScriptFunction *p_function);
+
+	static void register_function(const String &p_key, uint32_t p_hash, NativeFunction p_function);
+	static void unregister_function(const String &p_key);
+	static NativeFunction get_function(const BRScriptFunction *p_function);
+
+#ifdef TOOLS_ENABLED
+	Error add_script(const String &p_path, const String &p_source);
+	Error save_module(const String &p_dir) const;
+
+	bool is_empty() const { return functions.is_empty(); }
+	void clear() { functions.clear(); }
+#endif
+};
+
+#endif // BRSCRIPT_AOT_H
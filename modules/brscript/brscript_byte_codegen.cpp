@@ -32,9 +32,13 @@
 #include "brscript_byte_codegen.h"
 
 #include "brscript.h"
+#include "brscript_aot.h"
+#include "brscript_byte_optimizer.h"
 
 #include "core/debugger/engine_debugger.h"
 
+bool BRScriptByteCodeGenerator::typed_operators_enabled = true;
+
 uint32_t BRScriptByteCodeGenerator::add_parameter(const StringName &p_name, bool p_is_optional, const BRScriptDataType &p_type) {
 	function->_argument_count++;
 	function->argument_types.push_back(p_type);
@@ -396,12 +400,23 @@ BRScriptFunction *BRScriptByteCodeGenerator::write_end() {
 		function->_lambdas_count = 0;
 	}
 
+	if (inline_cache_count) {
+		function->inline_caches.resize(inline_cache_count);
+		function->_inline_caches_ptr = function->inline_caches.ptr();
+		function->_inline_caches_count = inline_cache_count;
+	} else {
+		function->_inline_caches_ptr = nullptr;
+		function->_inline_caches_count = 0;
+	}
+
 	if (debug_stack) {
 		function->stack_debug = stack_debug;
 	}
 	function->_stack_size = BRScriptFunction::FIXED_ADDRESSES_MAX + max_locals + temporaries.size();
 	function->_instruction_args_size = instr_args_max;
 
+	BRScriptByteCodeOptimizer::optimize(function, BRScriptFunction::FIXED_ADDRESSES_MAX + max_locals);
+
 #ifdef DEBUG_ENABLED
 	function->operator_names = operator_names;
 	function->setter_names = setter_names;
@@ -412,6 +427,10 @@ BRScriptFunction *BRScriptByteCodeGenerator::write_end() {
 	function->gds_utilities_names = gds_utilities_names;
 #endif
 
+	// Exported builds may ship native code for this exact bytecode. Debug builds only compile the same bytecode
+	// when asked for release bytecode, as exporting does.
+	function->native_function = BRScriptAOT::get_function(function);
+
 	ended = true;
 	return function;
 }
@@ -585,6 +604,60 @@ void BRScriptByteCodeGenerator::write_unary_operator(const Address &p_target, Va
 	}
 }
 
+// Returns the dedicated opcode for int/float arithmetic and comparisons, or `OPCODE_END` if there is none.
+static BRScriptFunction::Opcode _get_typed_operator_opcode(Variant::Operator p_operator, Variant::Type p_left_type, Variant::Type p_right_type) {
+	if (p_left_type == Variant::INT && p_right_type == Variant::INT) {
+		switch (p_operator) {
+			case Variant::OP_ADD:
+				return BRScriptFunction::OPCODE_OPERATOR_ADD_INT;
+			case Variant::OP_SUBTRACT:
+				return BRScriptFunction::OPCODE_OPERATOR_SUBTRACT_INT;
+			case Variant::OP_MULTIPLY:
+				return BRScriptFunction::OPCODE_OPERATOR_MULTIPLY_INT;
+			case Variant::OP_EQUAL:
+				return BRScriptFunction::OPCODE_OPERATOR_EQUAL_INT;
+			case Variant::OP_NOT_EQUAL:
+				return BRScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_INT;
+			case Variant::OP_LESS:
+				return BRScriptFunction::OPCODE_OPERATOR_LESS_INT;
+			case Variant::OP_LESS_EQUAL:
+				return BRScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_INT;
+			case Variant::OP_GREATER:
+				return BRScriptFunction::OPCODE_OPERATOR_GREATER_INT;
+			case Variant::OP_GREATER_EQUAL:
+				return BRScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_INT;
+			default:
+				break;
+		}
+	} else if (p_left_type == Variant::FLOAT && p_right_type == Variant::FLOAT) {
+		switch (p_operator) {
+			case Variant::OP_ADD:
+				return BRScriptFunction::OPCODE_OPERATOR_ADD_FLOAT;
+			case Variant::OP_SUBTRACT:
+				return BRScriptFunction::OPCODE_OPERATOR_SUBTRACT_FLOAT;
+			case Variant::OP_MULTIPLY:
+				return BRScriptFunction::OPCODE_OPERATOR_MULTIPLY_FLOAT;
+			case Variant::OP_DIVIDE:
+				return BRScriptFunction::OPCODE_OPERATOR_DIVIDE_FLOAT;
+			case Variant::OP_EQUAL:
+				return BRScriptFunction::OPCODE_OPERATOR_EQUAL_FLOAT;
+			case Variant::OP_NOT_EQUAL:
+				return BRScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_FLOAT;
+			case Variant::OP_LESS:
+				return BRScriptFunction::OPCODE_OPERATOR_LESS_FLOAT;
+			case Variant::OP_LESS_EQUAL:
+				return BRScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_FLOAT;
+			case Variant::OP_GREATER:
+				return BRScriptFunction::OPCODE_OPERATOR_GREATER_FLOAT;
+			case Variant::OP_GREATER_EQUAL:
+				return BRScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_FLOAT;
+			default:
+				break;
+		}
+	}
+	return BRScriptFunction::OPCODE_END;
+}
+
 void BRScriptByteCodeGenerator::write_binary_operator(const Address &p_target, Variant::Operator p_operator, const Address &p_left_operand, const Address &p_right_operand) {
 	// Avoid validated evaluator for modulo and division when operands are int, since there's no check for division by zero.
 	if (HAS_BUILTIN_TYPE(p_left_operand) && HAS_BUILTIN_TYPE(p_right_operand) && ((p_operator != Variant::OP_DIVIDE && p_operator != Variant::OP_MODULE) || p_left_operand.type.builtin_type != Variant::INT || p_right_operand.type.builtin_type != Variant::INT)) {
@@ -596,6 +669,16 @@ void BRScriptByteCodeGenerator::write_binary_operator(const Address &p_target, V
 			}
 		}
 
+		// Numeric kernels use dedicated opcodes that work on the raw payloads without going through an evaluator.
+		BRScriptFunction::Opcode typed_opcode = typed_operators_enabled ? _get_typed_operator_opcode(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type) : BRScriptFunction::OPCODE_END;
+		if (typed_opcode != BRScriptFunction::OPCODE_END) {
+			append_opcode(typed_opcode);
+			append(p_left_operand);
+			append(p_right_operand);
+			append(p_target);
+			return;
+		}
+
 		// Gather specific operator.
 		Variant::ValidatedOperatorEvaluator op_func = Variant::get_validated_operator_evaluator(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type);
 
@@ -845,6 +928,7 @@ void BRScriptByteCodeGenerator::write_set_named(const Address &p_target, const S
 	append(p_target);
 	append(p_source);
 	append(p_name);
+	append_inline_cache();
 }
 
 void BRScriptByteCodeGenerator::write_get_named(const Address &p_target, const StringName &p_name, const Address &p_source) {
@@ -863,6 +947,7 @@ void BRScriptByteCodeGenerator::write_get_named(const Address &p_target, const S
 	append(p_source);
 	append(p_target);
 	append(p_name);
+	append_inline_cache();
 }
 
 void BRScriptByteCodeGenerator::write_set_member(const Address &p_value, const StringName &p_name) {
@@ -1077,6 +1162,7 @@ void BRScriptByteCodeGenerator::write_call(const Address &p_target, const Addres
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append_inline_cache();
 	ct.cleanup();
 }
 
@@ -1102,6 +1188,7 @@ void BRScriptByteCodeGenerator::write_call_async(const Address &p_target, const
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append_inline_cache();
 	ct.cleanup();
 }
 
@@ -1169,24 +1256,16 @@ void BRScriptByteCodeGenerator::write_call_utility(const Address &p_target, cons
 }
 
 void BRScriptByteCodeGenerator::write_call_builtin_type(const Address &p_target, const Address &p_base, Variant::Type p_type, const StringName &p_method, bool p_is_static, const Vector<Address> &p_arguments) {
-	bool is_validated = false;
-
-	// Check if all types are correct.
-	if (Variant::is_builtin_method_vararg(p_type, p_method)) {
-		is_validated = false; // Vararg needs runtime checks, can't use validated call.
-	} else if (p_arguments.size() == Variant::get_builtin_method_argument_count(p_type, p_method)) {
-		bool all_types_exact = true;
-		for (int i = 0; i < p_arguments.size(); i++) {
-			if (!IS_BUILTIN_TYPE(p_arguments[i], Variant::get_builtin_method_argument_type(p_type, p_method, i))) {
-				all_types_exact = false;
-				break;
-			}
-		}
-
-		is_validated = all_types_exact;
+	// Validated calls need all argument types to be known and exact.
+	LocalVector<Variant::Type> argument_types;
+	argument_types.resize(p_arguments.size());
+	for (int i = 0; i < p_arguments.size(); i++) {
+		const BRScriptDataType &type = p_arguments[i].type;
+		argument_types[i] = (type.has_type && type.kind == BRScriptDataType::BUILTIN) ? type.builtin_type : Variant::NIL;
 	}
+	Variant::ValidatedBuiltInMethod validated = Variant::get_validated_builtin_method_for_arguments(p_type, p_method, argument_types.ptr(), argument_types.size());
 
-	if (!is_validated) {
+	if (!validated) {
 		// Perform regular call.
 		if (p_is_static) {
 			append_opcode_and_argcount(BRScriptFunction::OPCODE_CALL_BUILTIN_STATIC, p_arguments.size() + 1);
@@ -1220,11 +1299,11 @@ void BRScriptByteCodeGenerator::write_call_builtin_type(const Address &p_target,
 	append(p_base);
 	append(ct.target);
 	append(p_arguments.size());
-	append(Variant::get_validated_builtin_method(p_type, p_method));
+	append(validated);
 	ct.cleanup();
 
 #ifdef DEBUG_ENABLED
-	add_debug_name(builtin_methods_names, get_builtin_method_pos(Variant::get_validated_builtin_method(p_type, p_method)), p_method);
+	add_debug_name(builtin_methods_names, get_builtin_method_pos(validated), p_method);
 #endif
 }
 
@@ -1336,6 +1415,7 @@ void BRScriptByteCodeGenerator::write_call_self(const Address &p_target, const S
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append_inline_cache();
 	ct.cleanup();
 }
 
@@ -1349,6 +1429,7 @@ void BRScriptByteCodeGenerator::write_call_self_async(const Address &p_target, c
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append_inline_cache();
 	ct.cleanup();
 }
 
@@ -1362,6 +1443,7 @@ void BRScriptByteCodeGenerator::write_call_script_function(const Address &p_targ
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append_inline_cache();
 	ct.cleanup();
 }
 
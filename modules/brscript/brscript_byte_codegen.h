@@ -74,6 +74,9 @@ class BRScriptByteCodeGenerator : public BRScriptCodeGenerator {
 		CallTarget &operator=(CallTarget &) = delete;
 	};
 
+	// Only turned off to measure the typed operator opcodes against the validated evaluators.
+	static bool typed_operators_enabled;
+
 	bool ended = false;
 	BRScriptFunction *function = nullptr;
 	bool debug_stack = false;
@@ -122,6 +125,7 @@ class BRScriptByteCodeGenerator : public BRScriptCodeGenerator {
 	RBMap<BRScriptUtilityFunctions::FunctionPtr, int> gds_utilities_map;
 	RBMap<MethodBind *, int> method_bind_map;
 	RBMap<BRScriptFunction *, int> lambdas_map;
+	int inline_cache_count = 0;
 
 #ifdef DEBUG_ENABLED
 	// Keep method and property names for pointer and validated operations.
@@ -396,6 +400,10 @@ class BRScriptByteCodeGenerator : public BRScriptCodeGenerator {
 		opcodes.push_back(get_name_map_pos(p_name));
 	}
 
+	void append_inline_cache() {
+		opcodes.push_back(inline_cache_count++);
+	}
+
 	void append(const Variant::ValidatedOperatorEvaluator p_operation) {
 		opcodes.push_back(get_operation_pos(p_operation));
 	}
@@ -453,6 +461,9 @@ class BRScriptByteCodeGenerator : public BRScriptCodeGenerator {
 	}
 
 public:
+	static void set_typed_operators_enabled(bool p_enabled) { typed_operators_enabled = p_enabled; }
+	static bool is_typed_operators_enabled() { return typed_operators_enabled; }
+
 	virtual uint32_t add_parameter(const StringName &p_name, bool p_is_optional, const BRScriptDataType &p_type) override;
 	virtual uint32_t add_local(const StringName &p_name, const BRScriptDataType &p_type) override;
 	virtual uint32_t add_local_constant(const StringName &p_name, const Variant &p_constant) override;
@@ -0,0 +1,1022 @@
+/**************************************************************************/
+/*  brscript_byte_optimizer.cpp                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "brscript_byte_optimizer.h"
+
+#include "core/variant/variant_internal.h"
+
+bool BRScriptByteCodeOptimizer::enabled = true;
+
+int BRScriptByteCodeOptimizer::_get_instruction_length(const int *p_code, int p_ip, int p_code_size) {
+	const int opcode = p_code[p_ip];
+	if (opcode >= BRScriptFunction::OPCODE_OPERATOR_ADD_INT && opcode <= BRScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_FLOAT) {
+		return 4;
+	}
+	if (opcode >= BRScriptFunction::OPCODE_ITERATE_BEGIN && opcode <= BRScriptFunction::OPCODE_ITERATE_OBJECT) {
+		return 5;
+	}
+	if (opcode >= BRScriptFunction::OPCODE_TYPE_ADJUST_BOOL && opcode <= BRScriptFunction::OPCODE_TYPE_ADJUST_PACKED_VECTOR4_ARRAY) {
+		return 2;
+	}
+
+	// Instructions taking a variable amount of addresses store it right after the opcode.
+	const int instr_arg_count = p_ip + 1 < p_code_size ? p_code[p_ip + 1] : -1;
+
+	switch (opcode) {
+		case BRScriptFunction::OPCODE_OPERATOR:
+			return 7 + sizeof(Variant::ValidatedOperatorEvaluator) / sizeof(*p_code);
+		case BRScriptFunction::OPCODE_OPERATOR_VALIDATED:
+			return 5;
+		case BRScriptFunction::OPCODE_TYPE_TEST_BUILTIN:
+		case BRScriptFunction::OPCODE_TYPE_TEST_NATIVE:
+		case BRScriptFunction::OPCODE_TYPE_TEST_SCRIPT:
+			return 4;
+		case BRScriptFunction::OPCODE_TYPE_TEST_ARRAY:
+			return 6;
+		case BRScriptFunction::OPCODE_TYPE_TEST_DICTIONARY:
+			return 9;
+		case BRScriptFunction::OPCODE_SET_KEYED:
+		case BRScriptFunction::OPCODE_GET_KEYED:
+		case BRScriptFunction::OPCODE_SET_NAMED_VALIDATED:
+		case BRScriptFunction::OPCODE_GET_NAMED_VALIDATED:
+		case BRScriptFunction::OPCODE_SET_STATIC_VARIABLE:
+		case BRScriptFunction::OPCODE_GET_STATIC_VARIABLE:
+			return 4;
+		case BRScriptFunction::OPCODE_SET_KEYED_VALIDATED:
+		case BRScriptFunction::OPCODE_SET_INDEXED_VALIDATED:
+		case BRScriptFunction::OPCODE_GET_KEYED_VALIDATED:
+		case BRScriptFunction::OPCODE_GET_INDEXED_VALIDATED:
+		case BRScriptFunction::OPCODE_SET_NAMED:
+		case BRScriptFunction::OPCODE_GET_NAMED:
+			return 5;
+		case BRScriptFunction::OPCODE_SET_MEMBER:
+		case BRScriptFunction::OPCODE_GET_MEMBER:
+		case BRScriptFunction::OPCODE_ASSIGN:
+			return 3;
+		case BRScriptFunction::OPCODE_ASSIGN_NULL:
+		case BRScriptFunction::OPCODE_ASSIGN_TRUE:
+		case BRScriptFunction::OPCODE_ASSIGN_FALSE:
+			return 2;
+		case BRScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN:
+		case BRScriptFunction::OPCODE_ASSIGN_TYPED_NATIVE:
+		case BRScriptFunction::OPCODE_ASSIGN_TYPED_SCRIPT:
+		case BRScriptFunction::OPCODE_CAST_TO_BUILTIN:
+		case BRScriptFunction::OPCODE_CAST_TO_NATIVE:
+		case BRScriptFunction::OPCODE_CAST_TO_SCRIPT:
+			return 4;
+		case BRScriptFunction::OPCODE_ASSIGN_TYPED_ARRAY:
+			return 6;
+		case BRScriptFunction::OPCODE_ASSIGN_TYPED_DICTIONARY:
+			return 9;
+		case BRScriptFunction::OPCODE_CONSTRUCT_ARRAY:
+		case BRScriptFunction::OPCODE_CONSTRUCT_DICTIONARY:
+			return instr_arg_count < 0 ? -1 : 3 + instr_arg_count;
+		case BRScriptFunction::OPCODE_CONSTRUCT:
+		case BRScriptFunction::OPCODE_CONSTRUCT_VALIDATED:
+		case BRScriptFunction::OPCODE_CALL_METHOD_BIND:
+		case BRScriptFunction::OPCODE_CALL_METHOD_BIND_RET:
+		case BRScriptFunction::OPCODE_CALL_NATIVE_STATIC:
+		case BRScriptFunction::OPCODE_CALL_NATIVE_STATIC_VALIDATED_RETURN:
+		case BRScriptFunction::OPCODE_CALL_NATIVE_STATIC_VALIDATED_NO_RETURN:
+		case BRScriptFunction::OPCODE_CALL_METHOD_BIND_VALIDATED_RETURN:
+		case BRScriptFunction::OPCODE_CALL_METHOD_BIND_VALIDATED_NO_RETURN:
+		case BRScriptFunction::OPCODE_CALL_BUILTIN_TYPE_VALIDATED:
+		case BRScriptFunction::OPCODE_CALL_UTILITY:
+		case BRScriptFunction::OPCODE_CALL_UTILITY_VALIDATED:
+		case BRScriptFunction::OPCODE_CALL_BRSCRIPT_UTILITY:
+		case BRScriptFunction::OPCODE_CALL_SELF_BASE:
+		case BRScriptFunction::OPCODE_CREATE_LAMBDA:
+		case BRScriptFunction::OPCODE_CREATE_SELF_LAMBDA:
+			return instr_arg_count < 0 ? -1 : 4 + instr_arg_count;
+		case BRScriptFunction::OPCODE_CONSTRUCT_TYPED_ARRAY:
+			return instr_arg_count < 0 ? -1 : 5 + instr_arg_count;
+		case BRScriptFunction::OPCODE_CALL:
+		case BRScriptFunction::OPCODE_CALL_RETURN:
+		case BRScriptFunction::OPCODE_CALL_ASYNC:
+		case BRScriptFunction::OPCODE_CALL_BUILTIN_STATIC:
+			return instr_arg_count < 0 ? -1 : 5 + instr_arg_count;
+		case BRScriptFunction::OPCODE_CONSTRUCT_TYPED_DICTIONARY:
+			return instr_arg_count < 0 ? -1 : 7 + instr_arg_count;
+		case BRScriptFunction::OPCODE_AWAIT:
+		case BRScriptFunction::OPCODE_AWAIT_RESUME:
+		case BRScriptFunction::OPCODE_JUMP:
+		case BRScriptFunction::OPCODE_RETURN:
+		case BRScriptFunction::OPCODE_LINE:
+			return 2;
+		case BRScriptFunction::OPCODE_JUMP_IF:
+		case BRScriptFunction::OPCODE_JUMP_IF_NOT:
+		case BRScriptFunction::OPCODE_JUMP_IF_SHARED:
+		case BRScriptFunction::OPCODE_RETURN_TYPED_BUILTIN:
+		case BRScriptFunction::OPCODE_RETURN_TYPED_NATIVE:
+		case BRScriptFunction::OPCODE_RETURN_TYPED_SCRIPT:
+		case BRScriptFunction::OPCODE_STORE_GLOBAL:
+		case BRScriptFunction::OPCODE_STORE_NAMED_GLOBAL:
+		case BRScriptFunction::OPCODE_ASSERT:
+			return 3;
+		case BRScriptFunction::OPCODE_RETURN_TYPED_ARRAY:
+			return 5;
+		case BRScriptFunction::OPCODE_RETURN_TYPED_DICTIONARY:
+			return 8;
+		case BRScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT:
+		case BRScriptFunction::OPCODE_BREAKPOINT:
+		case BRScriptFunction::OPCODE_END:
+			return 1;
+		default:
+			return -1;
+	}
+}
+
+int BRScriptByteCodeOptimizer::_get_jump_operand(int p_opcode) {
+	switch (p_opcode) {
+		case BRScriptFunction::OPCODE_JUMP:
+			return 1;
+		case BRScriptFunction::OPCODE_JUMP_IF:
+		case BRScriptFunction::OPCODE_JUMP_IF_NOT:
+		case BRScriptFunction::OPCODE_JUMP_IF_SHARED:
+			return 2;
+		default:
+			if (p_opcode >= BRScriptFunction::OPCODE_ITERATE_BEGIN && p_opcode <= BRScriptFunction::OPCODE_ITERATE_OBJECT) {
+				return 4;
+			}
+			return -1;
+	}
+}
+
+bool BRScriptByteCodeOptimizer::_is_terminator(int p_opcode) {
+	switch (p_opcode) {
+		case BRScriptFunction::OPCODE_JUMP:
+		case BRScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT:
+		case BRScriptFunction::OPCODE_RETURN:
+		case BRScriptFunction::OPCODE_RETURN_TYPED_BUILTIN:
+		case BRScriptFunction::OPCODE_RETURN_TYPED_ARRAY:
+		case BRScriptFunction::OPCODE_RETURN_TYPED_DICTIONARY:
+		case BRScriptFunction::OPCODE_RETURN_TYPED_NATIVE:
+		case BRScriptFunction::OPCODE_RETURN_TYPED_SCRIPT:
+		case BRScriptFunction::OPCODE_END:
+			return true;
+		default:
+			return false;
+	}
+}
+
+bool BRScriptByteCodeOptimizer::_is_typed_operator(int p_opcode) {
+	return p_opcode >= BRScriptFunction::OPCODE_OPERATOR_ADD_INT && p_opcode <= BRScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_FLOAT;
+}
+
+bool BRScriptByteCodeOptimizer::_is_same_value(const Variant &p_a, const Variant &p_b) {
+	if (p_a.get_type() != p_b.get_type()) {
+		return false;
+	}
+	if (p_a.get_type() == Variant::FLOAT) {
+		// Tells zero from negative zero, and matches NaN with itself.
+		const double a = p_a;
+		const double b = p_b;
+		return memcmp(&a, &b, sizeof(double)) == 0;
+	}
+	return p_a.hash_compare(p_b);
+}
+
+bool BRScriptByteCodeOptimizer::_is_foldable_value(const Variant &p_value) {
+	// Only values copied on assignment, so a constant and a slot holding the same value can't be told apart.
+	return p_value.get_type() < Variant::RID;
+}
+
+// Reports the operands of the instructions the optimizer knows. Anything else may read or write every address it holds.
+bool BRScriptByteCodeOptimizer::_get_operands(const Instruction &p_instruction, LocalVector<int> &r_reads, int &r_write) {
+	r_reads.clear();
+	r_write = -1;
+
+	const int opcode = p_instruction.code[0];
+	if (_is_typed_operator(opcode)) {
+		r_reads.push_back(1);
+		r_reads.push_back(2);
+		r_write = 3;
+		return true;
+	}
+
+	switch (opcode) {
+		case BRScriptFunction::OPCODE_OPERATOR_VALIDATED: {
+			r_reads.push_back(1);
+			r_reads.push_back(2);
+			r_write = 3;
+		} break;
+		case BRScriptFunction::OPCODE_ASSIGN:
+		case BRScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN: {
+			r_reads.push_back(2);
+			r_write = 1;
+		} break;
+		case BRScriptFunction::OPCODE_ASSIGN_NULL:
+		case BRScriptFunction::OPCODE_ASSIGN_TRUE:
+		case BRScriptFunction::OPCODE_ASSIGN_FALSE: {
+			r_write = 1;
+		} break;
+		case BRScriptFunction::OPCODE_GET_NAMED:
+		case BRScriptFunction::OPCODE_GET_NAMED_VALIDATED: {
+			r_reads.push_back(1);
+			r_write = 2;
+		} break;
+		case BRScriptFunction::OPCODE_JUMP_IF:
+		case BRScriptFunction::OPCODE_JUMP_IF_NOT:
+		case BRScriptFunction::OPCODE_JUMP_IF_SHARED:
+		case BRScriptFunction::OPCODE_RETURN: {
+			r_reads.push_back(1);
+		} break;
+		case BRScriptFunction::OPCODE_JUMP:
+		case BRScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT:
+		case BRScriptFunction::OPCODE_LINE:
+		case BRScriptFunction::OPCODE_END:
+			break;
+		default:
+			return false;
+	}
+	return true;
+}
+
+int BRScriptByteCodeOptimizer::_resolve(int p_index) const {
+	// Removed instructions do nothing, so whatever jumped to them continues with the next one left.
+	while (p_index < (int)instructions.size() && instructions[p_index].removed) {
+		p_index++;
+	}
+	return p_index;
+}
+
+int BRScriptByteCodeOptimizer::_add_constant(const Variant &p_value) {
+	for (int i = 0; i < function->constants.size(); i++) {
+		if (_is_same_value(function->constants[i], p_value)) {
+			return i;
+		}
+	}
+	function->constants.push_back(p_value);
+	function->_constant_count = function->constants.size();
+	function->_constants_ptr = function->constants.ptrw();
+	return function->constants.size() - 1;
+}
+
+bool BRScriptByteCodeOptimizer::_get_value(int p_address, const ConstantState &p_state, Variant &r_value) const {
+	const int address_type = (p_address & BRScriptFunction::ADDR_TYPE_MASK) >> BRScriptFunction::ADDR_BITS;
+	const int index = p_address & BRScriptFunction::ADDR_MASK;
+
+	if (address_type == BRScriptFunction::ADDR_TYPE_CONSTANT) {
+		if (index >= function->constants.size() || !_is_foldable_value(function->constants[index])) {
+			return false;
+		}
+		r_value = function->constants[index];
+		return true;
+	}
+	if (address_type == BRScriptFunction::ADDR_TYPE_STACK) {
+		const Variant *value = p_state.getptr(index);
+		if (value) {
+			r_value = *value;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool BRScriptByteCodeOptimizer::_fold(const Instruction &p_instruction, const ConstantState &p_state, Variant &r_result) const {
+	const int opcode = p_instruction.code[0];
+
+	if (_is_typed_operator(opcode)) {
+		Variant a;
+		Variant b;
+		if (!_get_value(p_instruction.code[1], p_state, a) || !_get_value(p_instruction.code[2], p_state, b)) {
+			return false;
+		}
+
+		if (opcode <= BRScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_INT) {
+			if (a.get_type() != Variant::INT || b.get_type() != Variant::INT) {
+				return false;
+			}
+			const int64_t x = VariantInternal::get_int(&a)[0];
+			const int64_t y = VariantInternal::get_int(&b)[0];
+			// Wraps around on overflow, like the VM does.
+			switch (opcode) {
+				case BRScriptFunction::OPCODE_OPERATOR_ADD_INT:
+					r_result = int64_t(uint64_t(x) + uint64_t(y));
+					break;
+				case BRScriptFunction::OPCODE_OPERATOR_SUBTRACT_INT:
+					r_result = int64_t(uint64_t(x) - uint64_t(y));
+					break;
+				case BRScriptFunction::OPCODE_OPERATOR_MULTIPLY_INT:
+					r_result = int64_t(uint64_t(x) * uint64_t(y));
+					break;
+				case BRScriptFunction::OPCODE_OPERATOR_EQUAL_INT:
+					r_result = x == y;
+					break;
+				case BRScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_INT:
+					r_result = x != y;
+					break;
+				case BRScriptFunction::OPCODE_OPERATOR_LESS_INT:
+					r_result = x < y;
+					break;
+				case BRScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_INT:
+					r_result = x <= y;
+					break;
+				case BRScriptFunction::OPCODE_OPERATOR_GREATER_INT:
+					r_result = x > y;
+					break;
+				default:
+					r_result = x >= y;
+					break;
+			}
+			return true;
+		}
+
+		if (a.get_type() != Variant::FLOAT || b.get_type() != Variant::FLOAT) {
+			return false;
+		}
+		const double x = VariantInternal::get_float(&a)[0];
+		const double y = VariantInternal::get_float(&b)[0];
+		switch (opcode) {
+			case BRScriptFunction::OPCODE_OPERATOR_ADD_FLOAT:
+				r_result = x + y;
+				break;
+			case BRScriptFunction::OPCODE_OPERATOR_SUBTRACT_FLOAT:
+				r_result = x - y;
+				break;
+			case BRScriptFunction::OPCODE_OPERATOR_MULTIPLY_FLOAT:
+				r_result = x * y;
+				break;
+			case BRScriptFunction::OPCODE_OPERATOR_DIVIDE_FLOAT:
+				r_result = x / y;
+				break;
+			case BRScriptFunction::OPCODE_OPERATOR_EQUAL_FLOAT:
+				r_result = x == y;
+				break;
+			case BRScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_FLOAT:
+				r_result = x != y;
+				break;
+			case BRScriptFunction::OPCODE_OPERATOR_LESS_FLOAT:
+				r_result = x < y;
+				break;
+			case BRScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_FLOAT:
+				r_result = x <= y;
+				break;
+			case BRScriptFunction::OPCODE_OPERATOR_GREATER_FLOAT:
+				r_result = x > y;
+				break;
+			default:
+				r_result = x >= y;
+				break;
+		}
+		return true;
+	}
+
+	// Members of a value known at compile time, such as `Vector2(1, 2).x`, never change, so reading
+	// them is done once here instead of on every run, loops included.
+	if (opcode == BRScriptFunction::OPCODE_GET_NAMED || opcode == BRScriptFunction::OPCODE_GET_NAMED_VALIDATED) {
+		Variant base;
+		if (!_get_value(p_instruction.code[1], p_state, base)) {
+			return false;
+		}
+
+		StringName name;
+		if (opcode == BRScriptFunction::OPCODE_GET_NAMED) {
+			const int name_index = p_instruction.code[3];
+			if (name_index < 0 || name_index >= function->global_names.size()) {
+				return false;
+			}
+			name = function->global_names[name_index];
+		} else {
+			// Only the getter is stored, so find the member it belongs to.
+			const int getter_index = p_instruction.code[3];
+			if (getter_index < 0 || getter_index >= function->getters.size()) {
+				return false;
+			}
+			List<StringName> members;
+			Variant::get_member_list(base.get_type(), &members);
+			for (const StringName &member : members) {
+				if (Variant::get_member_validated_getter(base.get_type(), member) == function->getters[getter_index]) {
+					name = member;
+					break;
+				}
+			}
+			if (name == StringName()) {
+				return false;
+			}
+		}
+
+		bool valid = false;
+		r_result = base.get_named(name, valid);
+		return valid && _is_foldable_value(r_result);
+	}
+
+	return false;
+}
+
+bool BRScriptByteCodeOptimizer::_process(Instruction &p_instruction, ConstantState &p_state, bool p_rewrite) {
+	bool changed = false;
+
+	LocalVector<int> reads;
+	int write = -1;
+	if (!_get_operands(p_instruction, reads, write)) {
+		// Unknown instructions may write to any slot they mention.
+		const int jump_operand = _get_jump_operand(p_instruction.code[0]);
+		for (uint32_t i = 1; i < p_instruction.code.size(); i++) {
+			if ((int)i != jump_operand) {
+				p_state.erase(p_instruction.code[i]);
+			}
+		}
+		return false;
+	}
+
+	const int opcode = p_instruction.code[0];
+
+	if (p_rewrite) {
+		// Read constants directly instead of the slots holding them.
+		for (int operand : reads) {
+			const int address = p_instruction.code[operand];
+			if ((address & BRScriptFunction::ADDR_TYPE_MASK) != (BRScriptFunction::ADDR_TYPE_STACK << BRScriptFunction::ADDR_BITS)) {
+				continue;
+			}
+			const Variant *value = p_state.getptr(address);
+			if (value && opcode != BRScriptFunction::OPCODE_JUMP_IF_SHARED) {
+				p_instruction.code[operand] = _add_constant(*value) | (BRScriptFunction::ADDR_TYPE_CONSTANT << BRScriptFunction::ADDR_BITS);
+				changed = true;
+			}
+		}
+	}
+
+	Variant value;
+	bool known = false;
+
+	switch (opcode) {
+		case BRScriptFunction::OPCODE_ASSIGN: {
+			known = _get_value(p_instruction.code[2], p_state, value);
+		} break;
+		case BRScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN: {
+			// Only without a conversion, which the VM may reject.
+			known = _get_value(p_instruction.code[2], p_state, value) && value.get_type() == p_instruction.code[3];
+		} break;
+		case BRScriptFunction::OPCODE_ASSIGN_TRUE:
+		case BRScriptFunction::OPCODE_ASSIGN_FALSE: {
+			value = opcode == BRScriptFunction::OPCODE_ASSIGN_TRUE;
+			known = true;
+		} break;
+		case BRScriptFunction::OPCODE_JUMP_IF:
+		case BRScriptFunction::OPCODE_JUMP_IF_NOT: {
+			Variant test;
+			if (p_rewrite && _get_value(p_instruction.code[1], p_state, test)) {
+				if (test.booleanize() == (opcode == BRScriptFunction::OPCODE_JUMP_IF)) {
+					const int to = p_instruction.code[2];
+					p_instruction.code.clear();
+					p_instruction.code.push_back(BRScriptFunction::OPCODE_JUMP);
+					p_instruction.code.push_back(to);
+				} else {
+					p_instruction.removed = true;
+				}
+				changed = true;
+			}
+		} break;
+		default: {
+			known = _fold(p_instruction, p_state, value);
+			if (known && p_rewrite) {
+				const int target = p_instruction.code[write];
+				p_instruction.code.clear();
+				p_instruction.code.push_back(BRScriptFunction::OPCODE_ASSIGN);
+				p_instruction.code.push_back(target);
+				p_instruction.code.push_back(_add_constant(value) | (BRScriptFunction::ADDR_TYPE_CONSTANT << BRScriptFunction::ADDR_BITS));
+				write = 1;
+				changed = true;
+			}
+		} break;
+	}
+
+	if (write != -1) {
+		const int target = p_instruction.code[write];
+		if ((target & BRScriptFunction::ADDR_TYPE_MASK) == (BRScriptFunction::ADDR_TYPE_STACK << BRScriptFunction::ADDR_BITS) && target >= BRScriptFunction::FIXED_ADDRESSES_MAX) {
+			if (known && _is_foldable_value(value)) {
+				p_state[target] = value;
+			} else {
+				p_state.erase(target);
+			}
+		}
+	}
+
+	return changed;
+}
+
+void BRScriptByteCodeOptimizer::_intersect(ConstantState &p_state, const ConstantState &p_other) {
+	LocalVector<int> lost;
+	for (const KeyValue<int, Variant> &E : p_state) {
+		const Variant *other = p_other.getptr(E.key);
+		if (!other || !_is_same_value(*other, E.value)) {
+			lost.push_back(E.key);
+		}
+	}
+	for (int slot : lost) {
+		p_state.erase(slot);
+	}
+}
+
+bool BRScriptByteCodeOptimizer::_decode() {
+	const int *code = function->_code_ptr;
+
+	HashMap<int, int> indices;
+	for (int ip = 0; ip < code_size;) {
+		const int length = _get_instruction_length(code, ip, code_size);
+		if (length <= 0 || ip + length > code_size) {
+			return false;
+		}
+
+		Instruction instruction;
+		instruction.position = ip;
+		instruction.code.resize(length);
+		memcpy(instruction.code.ptr(), code + ip, length * sizeof(int));
+
+		indices[ip] = instructions.size();
+		instructions.push_back(instruction);
+		ip += length;
+	}
+	indices[code_size] = instructions.size();
+
+	// Refer to instructions rather than positions, so they can be moved around.
+	for (Instruction &instruction : instructions) {
+		const int operand = _get_jump_operand(instruction.code[0]);
+		if (operand == -1) {
+			continue;
+		}
+		const int *index = indices.getptr(instruction.code[operand]);
+		if (!index) {
+			return false;
+		}
+		instruction.code[operand] = *index;
+	}
+
+	for (int i = 0; i < function->default_arguments.size(); i++) {
+		const int *index = indices.getptr(function->default_arguments[i]);
+		if (!index) {
+			return false;
+		}
+		default_arguments.push_back(*index);
+	}
+
+	return true;
+}
+
+void BRScriptByteCodeOptimizer::_build_blocks() {
+	order.clear();
+	blocks.clear();
+	block_of.clear();
+	block_of.resize(instructions.size() + 1);
+
+	LocalVector<bool> leaders;
+	leaders.resize(instructions.size() + 1);
+	for (uint32_t i = 0; i < leaders.size(); i++) {
+		leaders[i] = false;
+	}
+
+	bool next_is_leader = true;
+	for (uint32_t i = 0; i < instructions.size(); i++) {
+		const Instruction &instruction = instructions[i];
+		if (instruction.removed) {
+			continue;
+		}
+		order.push_back(i);
+
+		if (next_is_leader) {
+			leaders[i] = true;
+		}
+		const int opcode = instruction.code[0];
+		const int operand = _get_jump_operand(opcode);
+		if (operand != -1) {
+			leaders[_resolve(instruction.code[operand])] = true;
+		}
+		next_is_leader = operand != -1 || _is_terminator(opcode);
+	}
+	for (int target : default_arguments) {
+		leaders[_resolve(target)] = true;
+	}
+
+	for (uint32_t i = 0; i < order.size(); i++) {
+		if (leaders[order[i]]) {
+			if (!blocks.is_empty()) {
+				blocks[blocks.size() - 1].end = i;
+			}
+			Block block;
+			block.begin = i;
+			blocks.push_back(block);
+		}
+		block_of[order[i]] = blocks.size() - 1;
+	}
+	if (!blocks.is_empty()) {
+		blocks[blocks.size() - 1].end = order.size();
+	}
+	// Jumping past the last instruction ends the function.
+	block_of[instructions.size()] = -1;
+
+	for (uint32_t i = 0; i < blocks.size(); i++) {
+		Block &block = blocks[i];
+		const Instruction &last = instructions[order[block.end - 1]];
+		const int opcode = last.code[0];
+		const int operand = _get_jump_operand(opcode);
+
+		if (operand != -1) {
+			const int target = block_of[_resolve(last.code[operand])];
+			if (target != -1) {
+				block.successors.push_back(target);
+			}
+		}
+		if (opcode == BRScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT) {
+			for (int target : default_arguments) {
+				const int target_block = block_of[_resolve(target)];
+				if (target_block != -1) {
+					block.successors.push_back(target_block);
+				}
+			}
+		}
+		if (!_is_terminator(opcode) && i + 1 < blocks.size()) {
+			block.successors.push_back(i + 1);
+		}
+	}
+}
+
+bool BRScriptByteCodeOptimizer::_propagate_constants() {
+	// Forward data flow: a slot is known at the start of a block if every way into it leaves the same value there.
+	LocalVector<ConstantState> states;
+	LocalVector<bool> visited;
+	states.resize(blocks.size());
+	visited.resize(blocks.size());
+	for (uint32_t i = 0; i < blocks.size(); i++) {
+		visited[i] = false;
+	}
+
+	LocalVector<int> pending;
+	LocalVector<bool> is_pending;
+	is_pending.resize(blocks.size());
+	for (uint32_t i = 0; i < blocks.size(); i++) {
+		is_pending[i] = false;
+	}
+
+	// Nothing is known where the function may start.
+	visited[0] = true;
+	pending.push_back(0);
+	is_pending[0] = true;
+	for (int target : default_arguments) {
+		const int block = block_of[_resolve(target)];
+		if (block != -1 && !is_pending[block]) {
+			visited[block] = true;
+			pending.push_back(block);
+			is_pending[block] = true;
+		}
+	}
+
+	// Function entry points never learn anything from their predecessors.
+	LocalVector<bool> is_entry;
+	is_entry.resize(blocks.size());
+	for (uint32_t i = 0; i < blocks.size(); i++) {
+		is_entry[i] = is_pending[i];
+	}
+
+	while (!pending.is_empty()) {
+		const int index = pending[pending.size() - 1];
+		pending.remove_at(pending.size() - 1);
+		is_pending[index] = false;
+
+		ConstantState state = states[index];
+		const Block &block = blocks[index];
+		for (int i = block.begin; i < block.end; i++) {
+			_process(instructions[order[i]], state, false);
+		}
+
+		for (int successor : block.successors) {
+			if (is_entry[successor]) {
+				continue;
+			}
+			bool changed = false;
+			if (!visited[successor]) {
+				visited[successor] = true;
+				states[successor] = state;
+				changed = true;
+			} else {
+				const uint32_t size = states[successor].size();
+				_intersect(states[successor], state);
+				changed = states[successor].size() != size;
+			}
+			if (changed && !is_pending[successor]) {
+				pending.push_back(successor);
+				is_pending[successor] = true;
+			}
+		}
+	}
+
+	bool changed = false;
+	for (uint32_t i = 0; i < blocks.size(); i++) {
+		if (!visited[i]) {
+			// Unreachable, removed later.
+			continue;
+		}
+		ConstantState state = states[i];
+		for (int j = blocks[i].begin; j < blocks[i].end; j++) {
+			Instruction &instruction = instructions[order[j]];
+			if (!instruction.removed) {
+				changed |= _process(instruction, state, true);
+			}
+		}
+	}
+	return changed;
+}
+
+bool BRScriptByteCodeOptimizer::_thread_jumps() {
+	bool changed = false;
+	for (uint32_t i = 0; i < instructions.size(); i++) {
+		Instruction &instruction = instructions[i];
+		if (instruction.removed) {
+			continue;
+		}
+		const int opcode = instruction.code[0];
+		const int operand = _get_jump_operand(opcode);
+		if (operand == -1) {
+			continue;
+		}
+
+		// Follow chains of unconditional jumps, giving up on loops that never leave.
+		int target = _resolve(instruction.code[operand]);
+		for (uint32_t hops = 0; hops < instructions.size(); hops++) {
+			if (target >= (int)instructions.size() || instructions[target].code[0] != BRScriptFunction::OPCODE_JUMP) {
+				break;
+			}
+			const int next = _resolve(instructions[target].code[1]);
+			if (next == target) {
+				break;
+			}
+			target = next;
+		}
+		if (target != instruction.code[operand]) {
+			instruction.code[operand] = target;
+			changed = true;
+		}
+
+		// A jump to the next instruction only costs a dispatch. Testing a condition has no side effects.
+		const bool can_remove = opcode == BRScriptFunction::OPCODE_JUMP || opcode == BRScriptFunction::OPCODE_JUMP_IF || opcode == BRScriptFunction::OPCODE_JUMP_IF_NOT;
+		if (can_remove && target == _resolve(i + 1)) {
+			instruction.removed = true;
+			changed = true;
+		}
+	}
+	return changed;
+}
+
+bool BRScriptByteCodeOptimizer::_remove_unreachable() {
+	LocalVector<bool> reachable;
+	reachable.resize(blocks.size());
+	for (uint32_t i = 0; i < blocks.size(); i++) {
+		reachable[i] = false;
+	}
+
+	LocalVector<int> pending;
+	pending.push_back(0);
+	for (int target : default_arguments) {
+		const int block = block_of[_resolve(target)];
+		if (block != -1) {
+			pending.push_back(block);
+		}
+	}
+	while (!pending.is_empty()) {
+		const int index = pending[pending.size() - 1];
+		pending.remove_at(pending.size() - 1);
+		if (reachable[index]) {
+			continue;
+		}
+		reachable[index] = true;
+		for (int successor : blocks[index].successors) {
+			pending.push_back(successor);
+		}
+	}
+
+	bool changed = false;
+	// The final END stays, so the code never runs off its end.
+	const int last = order[order.size() - 1];
+	for (uint32_t i = 0; i < blocks.size(); i++) {
+		if (reachable[i]) {
+			continue;
+		}
+		for (int j = blocks[i].begin; j < blocks[i].end; j++) {
+			if (order[j] != last) {
+				instructions[order[j]].removed = true;
+				changed = true;
+			}
+		}
+	}
+	return changed;
+}
+
+bool BRScriptByteCodeOptimizer::_remove_dead_temporaries() {
+	// Backward data flow over temporaries. Stores to a temporary are only dropped for typed value temporaries,
+	// whose old value needs no releasing, and only if the value is overwritten before anything reads it.
+	const int temporary_count = function->_stack_size - temporaries_begin;
+	if (temporary_count <= 0) {
+		return false;
+	}
+
+	LocalVector<LocalVector<bool>> live_in;
+	live_in.resize(blocks.size());
+	for (LocalVector<bool> &live : live_in) {
+		live.resize(temporary_count);
+		for (uint32_t i = 0; i < live.size(); i++) {
+			live[i] = false;
+		}
+	}
+
+	LocalVector<int> reads;
+	int write = -1;
+
+	// Applies one instruction to the set of live temporaries, going backward.
+	auto step = [&](const Instruction &p_instruction, LocalVector<bool> &r_live) {
+		const bool is_known = _get_operands(p_instruction, reads, write);
+		if (is_known && write != -1) {
+			const int target = p_instruction.code[write] - temporaries_begin;
+			if (target >= 0 && target < temporary_count) {
+				r_live[target] = false;
+			}
+		}
+		if (is_known) {
+			for (int operand : reads) {
+				const int slot = p_instruction.code[operand] - temporaries_begin;
+				if (slot >= 0 && slot < temporary_count) {
+					r_live[slot] = true;
+				}
+			}
+		} else {
+			const int jump_operand = _get_jump_operand(p_instruction.code[0]);
+			for (uint32_t i = 1; i < p_instruction.code.size(); i++) {
+				const int slot = p_instruction.code[i] - temporaries_begin;
+				if ((int)i != jump_operand && slot >= 0 && slot < temporary_count) {
+					r_live[slot] = true;
+				}
+			}
+		}
+	};
+
+	auto get_live_out = [&](int p_block, LocalVector<bool> &r_live) {
+		r_live.resize(temporary_count);
+		for (uint32_t i = 0; i < r_live.size(); i++) {
+			r_live[i] = false;
+		}
+		for (int successor : blocks[p_block].successors) {
+			for (int i = 0; i < temporary_count; i++) {
+				r_live[i] = r_live[i] || live_in[successor][i];
+			}
+		}
+	};
+
+	LocalVector<bool> live;
+	bool stable = false;
+	while (!stable) {
+		stable = true;
+		for (int i = blocks.size() - 1; i >= 0; i--) {
+			get_live_out(i, live);
+			for (int j = blocks[i].end - 1; j >= blocks[i].begin; j--) {
+				step(instructions[order[j]], live);
+			}
+			for (int k = 0; k < temporary_count; k++) {
+				if (live[k] != live_in[i][k]) {
+					live_in[i] = live;
+					stable = false;
+					break;
+				}
+			}
+		}
+	}
+
+	bool changed = false;
+	for (uint32_t i = 0; i < blocks.size(); i++) {
+		get_live_out(i, live);
+		for (int j = blocks[i].end - 1; j >= blocks[i].begin; j--) {
+			Instruction &instruction = instructions[order[j]];
+			const int opcode = instruction.code[0];
+			const bool is_pure = _is_typed_operator(opcode) || opcode == BRScriptFunction::OPCODE_ASSIGN || opcode == BRScriptFunction::OPCODE_ASSIGN_TRUE || opcode == BRScriptFunction::OPCODE_ASSIGN_FALSE || opcode == BRScriptFunction::OPCODE_GET_NAMED_VALIDATED;
+			if (is_pure) {
+				_get_operands(instruction, reads, write);
+				const int target = instruction.code[write];
+				const Variant::Type *type = function->temporary_slots.getptr(target);
+				if (target >= temporaries_begin && target < function->_stack_size && !live[target - temporaries_begin] && type && *type < Variant::RID) {
+					instruction.removed = true;
+					changed = true;
+					continue;
+				}
+			}
+			step(instruction, live);
+		}
+	}
+	return changed;
+}
+
+void BRScriptByteCodeOptimizer::_encode() {
+	LocalVector<int> positions;
+	positions.resize(instructions.size() + 1);
+
+	int size = 0;
+	for (uint32_t i = 0; i < instructions.size(); i++) {
+		positions[i] = size;
+		if (!instructions[i].removed) {
+			size += instructions[i].code.size();
+		}
+	}
+	positions[instructions.size()] = size;
+
+	Vector<int> code;
+	code.resize(size);
+	int *ptr = code.ptrw();
+	for (const Instruction &instruction : instructions) {
+		if (instruction.removed) {
+			continue;
+		}
+		memcpy(ptr, instruction.code.ptr(), instruction.code.size() * sizeof(int));
+		const int operand = _get_jump_operand(instruction.code[0]);
+		if (operand != -1) {
+			ptr[operand] = positions[instruction.code[operand]];
+		}
+		ptr += instruction.code.size();
+	}
+
+	function->code = code;
+	function->_code_ptr = function->code.ptrw();
+	function->_code_size = size;
+
+	for (uint32_t i = 0; i < default_arguments.size(); i++) {
+		function->default_arguments.write[i] = positions[default_arguments[i]];
+	}
+	if (function->default_arguments.size()) {
+		function->_default_arg_ptr = function->default_arguments.ptr();
+	}
+
+	// Scope changes recorded for the debugger move along with the instruction they happened before.
+	for (BRScriptFunction::StackDebug &E : function->stack_debug) {
+		int low = 0;
+		int high = instructions.size();
+		while (low < high) {
+			const int middle = (low + high) / 2;
+			if (instructions[middle].position < E.pos) {
+				low = middle + 1;
+			} else {
+				high = middle;
+			}
+		}
+		E.pos = positions[low];
+	}
+}
+
+void BRScriptByteCodeOptimizer::optimize(BRScriptFunction *p_function, int p_temporaries_begin) {
+	if (!enabled || p_function->_code_size == 0) {
+		return;
+	}
+
+	BRScriptByteCodeOptimizer optimizer;
+	optimizer.function = p_function;
+	optimizer.temporaries_begin = p_temporaries_begin;
+	optimizer.code_size = p_function->_code_size;
+	if (!optimizer._decode()) {
+		return;
+	}
+
+	// Each pass can open up more work for the others.
+	static const int MAX_ROUNDS = 4;
+	for (int round = 0; round < MAX_ROUNDS; round++) {
+		bool changed = false;
+
+		optimizer._build_blocks();
+		changed |= optimizer._propagate_constants();
+		changed |= optimizer._thread_jumps();
+
+		optimizer._build_blocks();
+		changed |= optimizer._remove_unreachable();
+
+		optimizer._build_blocks();
+		changed |= optimizer._remove_dead_temporaries();
+
+		if (!changed) {
+			break;
+		}
+	}
+
+	optimizer._encode();
+}
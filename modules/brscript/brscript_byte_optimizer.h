@@ -0,0 +1,109 @@
+/**************************************************************************/
+/*  brscript_byte_optimizer.h                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef BRSCRIPT_BYTE_OPTIMIZER_H
+#define BRSCRIPT_BYTE_OPTIMIZER_H
+
+#include "brscript_function.h"
+
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+// Rewrites the bytecode of a function once the generator is done with it.
+//
+// Constants are propagated through stack slots across the whole function, so arithmetic
+// and member reads on values known at compile time are folded, and branches on them become
+// unconditional. Jumps to jumps are threaded, then unreachable instructions and stores to
+// temporaries nothing reads are dropped. Anything the optimizer doesn't understand is assumed
+// to read and write every address it mentions, so it is left alone and stays correct.
+//
+// The result is the same in debug and release builds, as ahead-of-time code is matched to it.
+class BRScriptByteCodeOptimizer {
+	struct Instruction {
+		LocalVector<int> code; // Jump operands hold instruction indices while optimizing.
+		int position = 0;
+		bool removed = false;
+	};
+
+	struct Block {
+		int begin = 0; // Index into `order`.
+		int end = 0;
+		LocalVector<int> successors;
+	};
+
+	typedef HashMap<int, Variant> ConstantState;
+
+	static bool enabled;
+
+	BRScriptFunction *function = nullptr;
+	int temporaries_begin = 0;
+	int code_size = 0;
+
+	LocalVector<Instruction> instructions;
+	LocalVector<int> default_arguments;
+
+	// Live instructions in code order, and the blocks they form.
+	LocalVector<int> order;
+	LocalVector<Block> blocks;
+	LocalVector<int> block_of;
+
+	static int _get_instruction_length(const int *p_code, int p_ip, int p_code_size);
+	static int _get_jump_operand(int p_opcode);
+	static bool _is_terminator(int p_opcode);
+	static bool _is_typed_operator(int p_opcode);
+	static bool _is_same_value(const Variant &p_a, const Variant &p_b);
+	static bool _is_foldable_value(const Variant &p_value);
+	static bool _get_operands(const Instruction &p_instruction, LocalVector<int> &r_reads, int &r_write);
+
+	int _resolve(int p_index) const;
+	int _add_constant(const Variant &p_value);
+	bool _get_value(int p_address, const ConstantState &p_state, Variant &r_value) const;
+	bool _fold(const Instruction &p_instruction, const ConstantState &p_state, Variant &r_result) const;
+	bool _process(Instruction &p_instruction, ConstantState &p_state, bool p_rewrite);
+	static void _intersect(ConstantState &p_state, const ConstantState &p_other);
+
+	bool _decode();
+	void _build_blocks();
+	bool _propagate_constants();
+	bool _thread_jumps();
+	bool _remove_unreachable();
+	bool _remove_dead_temporaries();
+	void _encode();
+
+public:
+	static void set_enabled(bool p_enabled) { enabled = p_enabled; }
+	static bool is_enabled() { return enabled; }
+
+	// Temporaries are the slots from `p_temporaries_begin` up to the stack size.
+	static void optimize(BRScriptFunction *p_function, int p_temporaries_begin);
+};
+
+#endif // BRSCRIPT_BYTE_OPTIMIZER_H
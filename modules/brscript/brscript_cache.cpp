@@ -35,9 +35,28 @@
 #include "brscript_analyzer.h"
 #include "brscript_compiler.h"
 #include "brscript_parser.h"
+#include "brscript_tokenizer_buffer.h"
 
+#include "core/config/project_settings.h"
+#include "core/io/dir_access.h"
 #include "core/io/file_access.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
 #include "core/templates/vector.h"
+#include "core/version.h"
+
+// "BRTC" in little-endian: cached tokens of a text script.
+#define TOKEN_CACHE_MAGIC 0x43545242
+#define TOKEN_CACHE_VERSION 3
+// Magic, version, engine hash, source hash, source length, token count and script path length. The path and the
+// tokens follow.
+#define TOKEN_CACHE_HEADER_SIZE 36
+// Temporary files older than this, in seconds, were left behind by a run that stopped while writing them.
+#define TOKEN_CACHE_TEMPORARY_MAX_AGE (24 * 60 * 60)
+
+// Source bytes of the scripts `preparse_scripts()` keeps parsed ahead of time. Parse trees take several times the
+// size of their source, scripts past this are parsed when first loaded instead.
+#define PREPARSE_SOURCE_BUDGET (4 * 1024 * 1024)
 
 BRScriptParserRef::Status BRScriptParserRef::get_status() const {
 	return status;
@@ -84,7 +103,7 @@ Error BRScriptParserRef::raise_status(Status p_new_status) {
 				} else {
 					String source = BRScriptCache::get_source_code(remapped_path);
 					source_hash = source.hash();
-					result = get_parser()->parse(source, path, false);
+					result = BRScriptCache::parse_source(get_parser(), source, path);
 				}
 			} break;
 			case PARSED: {
@@ -223,6 +242,8 @@ Ref<BRScriptParserRef> BRScriptCache::get_parser(const String &p_path, BRScriptP
 			r_error = ERR_INVALID_DATA;
 			return ref;
 		}
+		// From now on the requester owns it, like any other parser.
+		singleton->preparsed_parsers.erase(p_path);
 	} else {
 		String remapped_path = ResourceLoader::path_remap(p_path);
 		if (!FileAccess::exists(remapped_path)) {
@@ -254,6 +275,7 @@ void BRScriptCache::remove_parser(const String &p_path) {
 
 	// Can't clear the parser because some other parser might be currently using it in the chain of calls.
 	singleton->parser_map.erase(p_path);
+	singleton->preparsed_parsers.erase(p_path);
 
 	// Have to copy while iterating, because parser_inverse_dependencies is modified.
 	HashSet<String> ideps = singleton->parser_inverse_dependencies[p_path];
@@ -296,6 +318,247 @@ Vector<uint8_t> BRScriptCache::get_binary_tokens(const String &p_path) {
 	return buffer;
 }
 
+// Tokens depend on the tokenizer as much as on the source, so any other engine build invalidates them.
+static uint64_t _get_token_cache_engine_hash() {
+	return hash_djb2_one_64(String(VERSION_HASH).hash64(), String(VERSION_NUMBER).hash64());
+}
+
+// Reads the header of a cached entry, leaving the file at the start of its tokens. Fails for entries saved by another
+// engine build, or damaged ones.
+static bool _read_token_cache_header(const Ref<FileAccess> &p_file, uint64_t &r_source_hash, uint32_t &r_source_length, String &r_path, uint32_t &r_token_count) {
+	if (p_file->get_length() < TOKEN_CACHE_HEADER_SIZE || p_file->get_32() != TOKEN_CACHE_MAGIC || p_file->get_32() != TOKEN_CACHE_VERSION || p_file->get_64() != _get_token_cache_engine_hash()) {
+		return false;
+	}
+	r_source_hash = p_file->get_64();
+	r_source_length = p_file->get_32();
+	r_token_count = p_file->get_32();
+
+	const uint32_t path_length = p_file->get_32();
+	if (path_length > p_file->get_length() - p_file->get_position()) {
+		return false;
+	}
+	Vector<uint8_t> path;
+	path.resize(path_length);
+	if (p_file->get_buffer(path.ptrw(), path_length) != path_length) {
+		return false;
+	}
+	r_path = String::utf8((const char *)path.ptr(), path_length);
+	return r_token_count == p_file->get_length() - p_file->get_position();
+}
+
+Vector<uint8_t> BRScriptCache::_get_cached_tokens(const String &p_path, const String &p_source) {
+	String cache_path = singleton->token_cache_path.path_join(p_path.md5_text() + ".brtc");
+
+	// The full 64-bit hash and the length together make a collision with an edited source very unlikely.
+	const uint64_t source_hash = p_source.hash64();
+	const uint32_t source_length = p_source.length();
+
+	Ref<FileAccess> f = FileAccess::open(cache_path, FileAccess::READ);
+	if (f.is_valid()) {
+		uint64_t cached_source_hash = 0;
+		uint32_t cached_source_length = 0;
+		String cached_path;
+		uint32_t size = 0;
+		if (_read_token_cache_header(f, cached_source_hash, cached_source_length, cached_path, size) && cached_source_hash == source_hash && cached_source_length == source_length && cached_path == p_path) {
+			Vector<uint8_t> tokens;
+			tokens.resize(size);
+			if (f->get_buffer(tokens.ptrw(), size) == size) {
+				return tokens;
+			}
+		}
+	}
+	f.unref();
+
+	Vector<uint8_t> tokens = BRScriptTokenizerBuffer::parse_code_string(p_source, BRScriptTokenizerBuffer::COMPRESS_NONE);
+	if (tokens.is_empty()) {
+		return tokens;
+	}
+
+	// Write to a temporary file first so that a concurrent run never reads a partial entry.
+	String tmp_path = cache_path + ".tmp";
+	f = FileAccess::open(tmp_path, FileAccess::WRITE);
+	if (f.is_valid()) {
+		const CharString path = p_path.utf8();
+		f->store_32(TOKEN_CACHE_MAGIC);
+		f->store_32(TOKEN_CACHE_VERSION);
+		f->store_64(_get_token_cache_engine_hash());
+		f->store_64(source_hash);
+		f->store_32(source_length);
+		f->store_32(tokens.size());
+		f->store_32(path.length());
+		f->store_buffer((const uint8_t *)path.get_data(), path.length());
+		f->store_buffer(tokens.ptr(), tokens.size());
+		f.unref();
+		Ref<DirAccess> da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+		if (da->rename(tmp_path, cache_path) != OK) {
+			da->remove(tmp_path);
+		}
+	}
+
+	return tokens;
+}
+
+void BRScriptCache::_prune_token_cache(String p_dir) {
+	Ref<DirAccess> da = DirAccess::open(p_dir);
+	if (da.is_null()) {
+		return;
+	}
+
+	// Entries of edited scripts are overwritten, only the ones of scripts that are gone or of other engine builds
+	// would stay forever.
+	const uint64_t now = OS::get_singleton()->get_unix_time();
+	for (const String &file : da->get_files()) {
+		const String file_path = p_dir.path_join(file);
+		if (file.ends_with(".brtc.tmp")) {
+			// Another run may be writing it right now.
+			if (now > FileAccess::get_modified_time(file_path) + TOKEN_CACHE_TEMPORARY_MAX_AGE) {
+				da->remove(file);
+			}
+			continue;
+		}
+		if (file.get_extension() != "brtc") {
+			continue;
+		}
+
+		bool stale = true;
+		Ref<FileAccess> f = FileAccess::open(file_path, FileAccess::READ);
+		if (f.is_valid()) {
+			uint64_t source_hash = 0;
+			uint32_t source_length = 0;
+			String path;
+			uint32_t size = 0;
+			stale = !_read_token_cache_header(f, source_hash, source_length, path, size) || file != path.md5_text() + ".brtc" || !FileAccess::exists(ResourceLoader::path_remap(path));
+			f.unref();
+		}
+		if (stale) {
+			da->remove(file);
+		}
+	}
+}
+
+void BRScriptCache::_wait_for_token_cache_pruning() {
+	WorkerThreadPool::TaskID task;
+	{
+		MutexLock lock(singleton->mutex);
+		task = singleton->prune_task;
+		singleton->prune_task = WorkerThreadPool::INVALID_TASK_ID;
+	}
+	if (task != WorkerThreadPool::INVALID_TASK_ID) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(task);
+	}
+}
+
+Error BRScriptCache::parse_source(BRScriptParser *p_parser, const String &p_source, const String &p_path) {
+	if (singleton == nullptr || singleton->token_cache_path.is_empty() || p_path.is_empty()) {
+		return p_parser->parse(p_source, p_path, false);
+	}
+
+	Vector<uint8_t> tokens = _get_cached_tokens(p_path, p_source);
+	if (!tokens.is_empty() && p_parser->parse_binary(tokens, p_path) == OK) {
+		return OK;
+	}
+
+	// Parse the text again so errors are reported with their exact location.
+	return p_parser->parse(p_source, p_path, false);
+}
+
+void BRScriptCache::set_token_cache_path(const String &p_dir) {
+	ERR_FAIL_NULL(singleton);
+
+	_wait_for_token_cache_pruning();
+
+	String dir = p_dir;
+	if (!dir.is_empty()) {
+		dir = ProjectSettings::get_singleton()->globalize_path(dir);
+		if (!DirAccess::exists(dir)) {
+			Error err = DirAccess::make_dir_recursive_absolute(dir);
+			ERR_FAIL_COND_MSG(err != OK, vformat("Couldn't create BRScript token cache directory \"%s\".", dir));
+		}
+	}
+
+	MutexLock lock(singleton->mutex);
+	singleton->token_cache_path = dir;
+	if (!dir.is_empty()) {
+		// Stale entries are only dropped, the ones in use are never touched, so this can run alongside loading.
+		singleton->prune_task = WorkerThreadPool::get_singleton()->add_template_task(singleton, &BRScriptCache::_prune_token_cache, dir, false, SNAME("BRScriptPruneTokenCache"));
+	}
+}
+
+void BRScriptCache::_preparse_script(uint32_t p_index, Ref<BRScriptParserRef> *p_parser_refs) {
+	Ref<BRScriptParserRef> &ref = p_parser_refs[p_index];
+	ref->raise_status(BRScriptParserRef::PARSED);
+
+	MutexLock lock(mutex);
+	// Parsers with errors are dropped, so that errors are reported when the script is actually loaded.
+	// The same goes for scripts which were requested while parsing.
+	if (cleared || ref->result != OK || parser_map.has(ref->path)) {
+		return;
+	}
+	ref->abandoned = false;
+	parser_map[ref->path] = ref.ptr();
+	preparsed_parsers[ref->path] = ref;
+}
+
+void BRScriptCache::preparse_scripts(const Vector<String> &p_paths) {
+	ERR_FAIL_NULL(singleton);
+
+	wait_for_preparse();
+
+	// Parsing only looks at the script itself, so scripts can be parsed independently of each other.
+	// Dependencies are resolved later, when each script is analyzed on demand.
+	MutexLock lock(singleton->mutex);
+	uint64_t source_size = 0;
+	for (const String &path : p_paths) {
+		if (singleton->parser_map.has(path)) {
+			continue;
+		}
+		Ref<FileAccess> f = FileAccess::open(ResourceLoader::path_remap(path), FileAccess::READ);
+		if (f.is_null()) {
+			continue;
+		}
+		source_size += f->get_length();
+		if (source_size > PREPARSE_SOURCE_BUDGET) {
+			break;
+		}
+		Ref<BRScriptParserRef> ref;
+		ref.instantiate();
+		ref->path = path;
+		// Not in the cache until parsed, so that freeing it doesn't remove a parser created meanwhile.
+		ref->abandoned = true;
+		// Create parsers here, as the first one to be created also sets up shared state.
+		ref->get_parser();
+		singleton->preparsing_parsers.push_back(ref);
+	}
+
+	if (singleton->preparsing_parsers.is_empty()) {
+		return;
+	}
+
+	// Scripts loaded before their turn are parsed when requested, as usual, so loading never waits for this.
+	singleton->preparse_group = WorkerThreadPool::get_singleton()->add_template_group_task(singleton, &BRScriptCache::_preparse_script, singleton->preparsing_parsers.ptr(), singleton->preparsing_parsers.size(), -1, false, SNAME("BRScriptPreparse"));
+}
+
+void BRScriptCache::wait_for_preparse() {
+	ERR_FAIL_NULL(singleton);
+
+	WorkerThreadPool::GroupID group;
+	LocalVector<Ref<BRScriptParserRef>> parser_refs;
+	{
+		MutexLock lock(singleton->mutex);
+		group = singleton->preparse_group;
+		singleton->preparse_group = -1;
+	}
+	if (group == -1) {
+		return;
+	}
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+
+	// The ones that were added to the cache are kept alive by it.
+	MutexLock lock(singleton->mutex);
+	parser_refs = singleton->preparsing_parsers;
+	singleton->preparsing_parsers.clear();
+}
+
 Ref<BRScript> BRScriptCache::get_shallow_script(const String &p_path, Error &r_error, const String &p_owner) {
 	MutexLock lock(singleton->mutex);
 
@@ -451,6 +714,9 @@ void BRScriptCache::clear() {
 		return;
 	}
 
+	wait_for_preparse();
+	_wait_for_token_cache_pruning();
+
 	MutexLock lock(singleton->mutex);
 
 	if (singleton->cleared) {
@@ -470,6 +736,7 @@ void BRScriptCache::clear() {
 	}
 
 	singleton->abandoned_parser_map.clear();
+	singleton->preparsed_parsers.clear();
 
 	RBSet<Ref<BRScriptParserRef>> parser_map_refs;
 	for (KeyValue<String, BRScriptParserRef *> &E : singleton->parser_map) {
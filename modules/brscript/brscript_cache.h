@@ -35,9 +35,11 @@
 #include "brscript.h"
 
 #include "core/object/ref_counted.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/safe_binary_mutex.h"
 #include "core/templates/hash_map.h"
 #include "core/templates/hash_set.h"
+#include "core/templates/local_vector.h"
 
 class BRScriptAnalyzer;
 class BRScriptParser;
@@ -87,6 +89,15 @@ class BRScriptCache {
 	HashMap<String, Ref<BRScript>> static_brscript_cache;
 	HashMap<String, HashSet<String>> dependencies;
 	HashMap<String, HashSet<String>> parser_inverse_dependencies;
+	// Parsers created ahead of time by `preparse_scripts()`. Dropped as soon as they are requested, the ones that
+	// never are stay until the cache is cleared, which is why their total size is bounded.
+	HashMap<String, Ref<BRScriptParserRef>> preparsed_parsers;
+	// Parsers being parsed in the background, each one is added to the cache as soon as it's done.
+	LocalVector<Ref<BRScriptParserRef>> preparsing_parsers;
+	WorkerThreadPool::GroupID preparse_group = -1;
+	// Directory where tokenized sources are cached between runs. Empty if disabled.
+	String token_cache_path;
+	WorkerThreadPool::TaskID prune_task = WorkerThreadPool::INVALID_TASK_ID;
 
 	friend class BRScript;
 	friend class BRScriptParserRef;
@@ -103,6 +114,11 @@ private:
 	static SafeBinaryMutex<BINARY_MUTEX_TAG> mutex;
 	friend SafeBinaryMutex<BINARY_MUTEX_TAG> &_get_brscript_cache_mutex();
 
+	static Vector<uint8_t> _get_cached_tokens(const String &p_path, const String &p_source);
+	void _preparse_script(uint32_t p_index, Ref<BRScriptParserRef> *p_parser_refs);
+	void _prune_token_cache(String p_dir);
+	static void _wait_for_token_cache_pruning();
+
 public:
 	static void move_script(const String &p_from, const String &p_to);
 	static void remove_script(const String &p_path);
@@ -111,6 +127,10 @@ public:
 	static void remove_parser(const String &p_path);
 	static String get_source_code(const String &p_path);
 	static Vector<uint8_t> get_binary_tokens(const String &p_path);
+	static Error parse_source(BRScriptParser *p_parser, const String &p_source, const String &p_path);
+	static void set_token_cache_path(const String &p_dir);
+	static void preparse_scripts(const Vector<String> &p_paths);
+	static void wait_for_preparse();
 	static Ref<BRScript> get_shallow_script(const String &p_path, Error &r_error, const String &p_owner = String());
 	static Ref<BRScript> get_full_script(const String &p_path, Error &r_error, const String &p_owner = String(), bool p_update_from_disk = false);
 	static Ref<BRScript> get_cached_script(const String &p_path);
@@ -1896,7 +1896,9 @@ Error BRScriptCompiler::_parse_block(CodeGen &codegen, const BRScriptParser::Sui
 
 #ifdef DEBUG_ENABLED
 		// Add a newline before each statement, since the debugger needs those.
-		gen->write_newline(s->start_line);
+		if (!release_bytecode) {
+			gen->write_newline(s->start_line);
+		}
 #endif
 
 		switch (s->type) {
@@ -1948,7 +1950,9 @@ Error BRScriptCompiler::_parse_block(CodeGen &codegen, const BRScriptParser::Sui
 
 #ifdef DEBUG_ENABLED
 					// Add a newline before each branch, since the debugger needs those.
-					gen->write_newline(branch->start_line);
+					if (!release_bytecode) {
+						gen->write_newline(branch->start_line);
+					}
 #endif
 					// For each pattern in branch.
 					BRScriptCodeGenerator::Address pattern_result = codegen.add_temporary();
@@ -2136,6 +2140,10 @@ Error BRScriptCompiler::_parse_block(CodeGen &codegen, const BRScriptParser::Sui
 			} break;
 			case BRScriptParser::Node::ASSERT: {
 #ifdef DEBUG_ENABLED
+				if (release_bytecode) {
+					break;
+				}
+
 				const BRScriptParser::AssertNode *as = static_cast<const BRScriptParser::AssertNode *>(s);
 
 				BRScriptCodeGenerator::Address condition = _parse_expression(codegen, err, as->condition);
@@ -2163,7 +2171,9 @@ Error BRScriptCompiler::_parse_block(CodeGen &codegen, const BRScriptParser::Sui
 			} break;
 			case BRScriptParser::Node::BREAKPOINT: {
 #ifdef DEBUG_ENABLED
-				gen->write_breakpoint();
+				if (!release_bytecode) {
+					gen->write_breakpoint();
+				}
 #endif
 			} break;
 			case BRScriptParser::Node::VARIABLE: {
@@ -2649,6 +2659,9 @@ Error BRScriptCompiler::_prepare_compilation(BRScript *p_script, const BRScriptP
 
 	p_script->clearing = true;
 
+	// Members and functions are about to be rebuilt.
+	BRScriptFunction::invalidate_inline_caches(p_script);
+
 	p_script->native = Ref<BRScriptNativeClass>();
 	p_script->base = Ref<BRScript>();
 	p_script->_base = nullptr;
@@ -3267,7 +3280,7 @@ Error BRScriptCompiler::compile(const BRScriptParser *p_parser, BRScript *p_scri
 	_get_function_ptr_replacements(func_ptr_replacements, old_lambda_info, &new_lambda_info);
 	main_script->_recurse_replace_function_ptrs(func_ptr_replacements);
 
-	if (has_static_data && !root->annotated_static_unload) {
+	if (has_static_data && !root->annotated_static_unload && !release_bytecode) {
 		BRScriptCache::add_static_script(p_script);
 	}
 
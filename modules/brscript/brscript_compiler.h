@@ -175,6 +175,7 @@ class BRScriptCompiler {
 	String error;
 	BRScriptParser::ExpressionNode *awaited_node = nullptr;
 	bool has_static_data = false;
+	bool release_bytecode = false;
 
 public:
 	static void convert_to_initializer_type(Variant &p_variant, const BRScriptParser::VariableNode *p_node);
@@ -185,6 +186,10 @@ public:
 	int get_error_line() const;
 	int get_error_column() const;
 
+	// Emit the bytecode of a release build (no line, assert or breakpoint opcodes), e.g. to translate it ahead of time.
+	// Such scripts are throwaway copies, so they are not kept in the static script cache either.
+	void set_release_bytecode(bool p_enabled) { release_bytecode = p_enabled; }
+
 	BRScriptCompiler();
 };
 
@@ -71,6 +71,51 @@ static String _get_variant_string(const Variant &p_variant) {
 	return txt;
 }
 
+static String _get_typed_operator_name(int p_opcode) {
+	switch (p_opcode) {
+		case BRScriptFunction::OPCODE_OPERATOR_ADD_INT:
+			return "+ (int)";
+		case BRScriptFunction::OPCODE_OPERATOR_SUBTRACT_INT:
+			return "- (int)";
+		case BRScriptFunction::OPCODE_OPERATOR_MULTIPLY_INT:
+			return "* (int)";
+		case BRScriptFunction::OPCODE_OPERATOR_EQUAL_INT:
+			return "== (int)";
+		case BRScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_INT:
+			return "!= (int)";
+		case BRScriptFunction::OPCODE_OPERATOR_LESS_INT:
+			return "< (int)";
+		case BRScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_INT:
+			return "<= (int)";
+		case BRScriptFunction::OPCODE_OPERATOR_GREATER_INT:
+			return "> (int)";
+		case BRScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_INT:
+			return ">= (int)";
+		case BRScriptFunction::OPCODE_OPERATOR_ADD_FLOAT:
+			return "+ (float)";
+		case BRScriptFunction::OPCODE_OPERATOR_SUBTRACT_FLOAT:
+			return "- (float)";
+		case BRScriptFunction::OPCODE_OPERATOR_MULTIPLY_FLOAT:
+			return "* (float)";
+		case BRScriptFunction::OPCODE_OPERATOR_DIVIDE_FLOAT:
+			return "/ (float)";
+		case BRScriptFunction::OPCODE_OPERATOR_EQUAL_FLOAT:
+			return "== (float)";
+		case BRScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_FLOAT:
+			return "!= (float)";
+		case BRScriptFunction::OPCODE_OPERATOR_LESS_FLOAT:
+			return "< (float)";
+		case BRScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_FLOAT:
+			return "<= (float)";
+		case BRScriptFunction::OPCODE_OPERATOR_GREATER_FLOAT:
+			return "> (float)";
+		case BRScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_FLOAT:
+			return ">= (float)";
+		default:
+			return "<err>";
+	}
+}
+
 static String _disassemble_address(const BRScript *p_script, const BRScriptFunction &p_function, int p_address) {
 	int addr = p_address & BRScriptFunction::ADDR_MASK;
 
@@ -142,6 +187,37 @@ void BRScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 5;
 			} break;
+			case OPCODE_OPERATOR_ADD_INT:
+			case OPCODE_OPERATOR_SUBTRACT_INT:
+			case OPCODE_OPERATOR_MULTIPLY_INT:
+			case OPCODE_OPERATOR_EQUAL_INT:
+			case OPCODE_OPERATOR_NOT_EQUAL_INT:
+			case OPCODE_OPERATOR_LESS_INT:
+			case OPCODE_OPERATOR_LESS_EQUAL_INT:
+			case OPCODE_OPERATOR_GREATER_INT:
+			case OPCODE_OPERATOR_GREATER_EQUAL_INT:
+			case OPCODE_OPERATOR_ADD_FLOAT:
+			case OPCODE_OPERATOR_SUBTRACT_FLOAT:
+			case OPCODE_OPERATOR_MULTIPLY_FLOAT:
+			case OPCODE_OPERATOR_DIVIDE_FLOAT:
+			case OPCODE_OPERATOR_EQUAL_FLOAT:
+			case OPCODE_OPERATOR_NOT_EQUAL_FLOAT:
+			case OPCODE_OPERATOR_LESS_FLOAT:
+			case OPCODE_OPERATOR_LESS_EQUAL_FLOAT:
+			case OPCODE_OPERATOR_GREATER_FLOAT:
+			case OPCODE_OPERATOR_GREATER_EQUAL_FLOAT: {
+				text += "typed operator ";
+
+				text += DADDR(3);
+				text += " = ";
+				text += DADDR(1);
+				text += " ";
+				text += _get_typed_operator_name(opcode);
+				text += " ";
+				text += DADDR(2);
+
+				incr += 4;
+			} break;
 			case OPCODE_TYPE_TEST_BUILTIN: {
 				text += "type test ";
 				text += DADDR(1);
@@ -309,7 +385,7 @@ void BRScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += "\"] = ";
 				text += DADDR(2);
 
-				incr += 4;
+				incr += 5;
 			} break;
 			case OPCODE_SET_NAMED_VALIDATED: {
 				text += "set_named validated ";
@@ -330,7 +406,7 @@ void BRScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += _global_names_ptr[_code_ptr[ip + 3]];
 				text += "\"]";
 
-				incr += 4;
+				incr += 5;
 			} break;
 			case OPCODE_GET_NAMED_VALIDATED: {
 				text += "get_named validated ";
@@ -699,7 +775,7 @@ void BRScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				}
 				text += ")";
 
-				incr = 5 + argc;
+				incr = 6 + argc;
 			} break;
 			case OPCODE_CALL_METHOD_BIND:
 			case OPCODE_CALL_METHOD_BIND_RET: {
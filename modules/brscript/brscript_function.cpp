@@ -33,6 +33,9 @@
 
 #include "brscript.h"
 
+SpinLock BRScriptFunctionState::stack_pool_lock;
+LocalVector<uint8_t *> BRScriptFunctionState::stack_pool[STACK_POOL_MAX_SHIFT - STACK_POOL_MIN_SHIFT + 1];
+
 Variant BRScriptFunction::get_constant(int p_idx) const {
 	ERR_FAIL_INDEX_V(p_idx, constants.size(), "<errconst>");
 	return constants[p_idx];
@@ -117,6 +120,7 @@ BRScriptFunction::BRScriptFunction() {
 
 BRScriptFunction::~BRScriptFunction() {
 	get_script()->member_functions.erase(name);
+	invalidate_inline_caches(get_script());
 
 	for (int i = 0; i < lambdas.size(); i++) {
 		memdelete(lambdas[i]);
@@ -215,6 +219,12 @@ Variant BRScriptFunctionState::resume(const Variant &p_arg) {
 	state.result = p_arg;
 	Callable::CallError err;
 	Variant ret = function->call(nullptr, nullptr, 0, err, &state);
+	state.result = Variant();
+
+	// Awaiting again suspends into this same state, which stays pending.
+	if (ret.get_type() == Variant::OBJECT && ret.get_validated_object() == this) {
+		return ret;
+	}
 
 	bool completed = true;
 
@@ -229,7 +239,6 @@ Variant BRScriptFunctionState::resume(const Variant &p_arg) {
 	}
 
 	function = nullptr; //cleaned up;
-	state.result = Variant();
 
 	if (completed) {
 		if (first_state.is_valid()) {
@@ -242,23 +251,74 @@ Variant BRScriptFunctionState::resume(const Variant &p_arg) {
 		if (EngineDebugger::is_active()) {
 			BRScriptLanguage::get_singleton()->exit_function();
 		}
-
-		_clear_stack();
 #endif
 	}
 
+	_clear_stack();
+
 	return ret;
 }
 
+uint8_t *BRScriptFunctionState::_alloc_stack(uint32_t p_size) {
+	uint32_t shift = MAX(nearest_shift(p_size - 1), (uint32_t)STACK_POOL_MIN_SHIFT);
+	if (shift > STACK_POOL_MAX_SHIFT) {
+		return (uint8_t *)memalloc(p_size);
+	}
+
+	uint8_t *stack = nullptr;
+	stack_pool_lock.lock();
+	LocalVector<uint8_t *> &pool = stack_pool[shift - STACK_POOL_MIN_SHIFT];
+	if (!pool.is_empty()) {
+		stack = pool[pool.size() - 1];
+		pool.resize(pool.size() - 1);
+	}
+	stack_pool_lock.unlock();
+
+	return stack ? stack : (uint8_t *)memalloc(1 << shift);
+}
+
+void BRScriptFunctionState::_free_stack(uint8_t *p_stack, uint32_t p_size) {
+	uint32_t shift = MAX(nearest_shift(p_size - 1), (uint32_t)STACK_POOL_MIN_SHIFT);
+	if (shift <= STACK_POOL_MAX_SHIFT) {
+		stack_pool_lock.lock();
+		LocalVector<uint8_t *> &pool = stack_pool[shift - STACK_POOL_MIN_SHIFT];
+		bool pooled = ((pool.size() + 1) << shift) <= STACK_POOL_MAX_BYTES;
+		if (pooled) {
+			pool.push_back(p_stack);
+		}
+		stack_pool_lock.unlock();
+		if (pooled) {
+			return;
+		}
+	}
+
+	memfree(p_stack);
+}
+
+void BRScriptFunctionState::clear_stack_pool() {
+	stack_pool_lock.lock();
+	for (LocalVector<uint8_t *> &pool : stack_pool) {
+		for (uint8_t *stack : pool) {
+			memfree(stack);
+		}
+		pool.reset();
+	}
+	stack_pool_lock.unlock();
+}
+
 void BRScriptFunctionState::_clear_stack() {
 	if (state.stack_size) {
-		Variant *stack = (Variant *)state.stack.ptr();
+		Variant *stack = (Variant *)state.stack;
 		// The first 3 are special addresses and not copied to the state, so we skip them here.
 		for (int i = 3; i < state.stack_size; i++) {
 			stack[i].~Variant();
 		}
 		state.stack_size = 0;
 	}
+	if (state.stack) {
+		_free_stack(state.stack, state.alloca_size);
+		state.stack = nullptr;
+	}
 }
 
 void BRScriptFunctionState::_clear_connections() {
@@ -281,6 +341,7 @@ void BRScriptFunctionState::_bind_methods() {
 BRScriptFunctionState::BRScriptFunctionState() :
 		scripts_list(this),
 		instances_list(this) {
+	state.function_state = this;
 }
 
 BRScriptFunctionState::~BRScriptFunctionState() {
@@ -289,4 +350,50 @@ BRScriptFunctionState::~BRScriptFunctionState() {
 		scripts_list.remove_from_list();
 		instances_list.remove_from_list();
 	}
+	_clear_stack();
+}
+
+bool BRScriptFunctionStateCallable::compare_equal(const CallableCustom *p_a, const CallableCustom *p_b) {
+	return static_cast<const BRScriptFunctionStateCallable *>(p_a)->state == static_cast<const BRScriptFunctionStateCallable *>(p_b)->state;
+}
+
+bool BRScriptFunctionStateCallable::compare_less(const CallableCustom *p_a, const CallableCustom *p_b) {
+	return static_cast<const BRScriptFunctionStateCallable *>(p_a)->state.ptr() < static_cast<const BRScriptFunctionStateCallable *>(p_b)->state.ptr();
+}
+
+uint32_t BRScriptFunctionStateCallable::hash() const {
+	return hash_murmur3_one_64(state->get_instance_id());
+}
+
+String BRScriptFunctionStateCallable::get_as_text() const {
+	return "BRScriptFunctionState::resume";
+}
+
+CallableCustom::CompareEqualFunc BRScriptFunctionStateCallable::get_compare_equal_func() const {
+	return compare_equal;
+}
+
+CallableCustom::CompareLessFunc BRScriptFunctionStateCallable::get_compare_less_func() const {
+	return compare_less;
+}
+
+ObjectID BRScriptFunctionStateCallable::get_object() const {
+	return state->get_instance_id();
+}
+
+void BRScriptFunctionStateCallable::call(const Variant **p_arguments, int p_argcount, Variant &r_return_value, Callable::CallError &r_call_error) const {
+	r_call_error.error = Callable::CallError::CALL_OK;
+
+	if (p_argcount == 0) {
+		r_return_value = state->resume();
+	} else if (p_argcount == 1) {
+		r_return_value = state->resume(*p_arguments[0]);
+	} else {
+		Array args;
+		args.resize(p_argcount);
+		for (int i = 0; i < p_argcount; i++) {
+			args[i] = *p_arguments[i];
+		}
+		r_return_value = state->resume(args);
+	}
 }
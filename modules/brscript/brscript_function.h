@@ -36,14 +36,17 @@
 
 #include "core/object/ref_counted.h"
 #include "core/object/script_language.h"
+#include "core/os/spin_lock.h"
 #include "core/os/thread.h"
 #include "core/string/string_name.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/pair.h"
 #include "core/templates/self_list.h"
 #include "core/variant/variant.h"
 
 class BRScriptInstance;
 class BRScript;
+class BRScriptFunctionState;
 
 class BRScriptDataType {
 public:
@@ -258,6 +261,25 @@ public:
 	enum Opcode {
 		OPCODE_OPERATOR,
 		OPCODE_OPERATOR_VALIDATED,
+		OPCODE_OPERATOR_ADD_INT,
+		OPCODE_OPERATOR_SUBTRACT_INT,
+		OPCODE_OPERATOR_MULTIPLY_INT,
+		OPCODE_OPERATOR_EQUAL_INT,
+		OPCODE_OPERATOR_NOT_EQUAL_INT,
+		OPCODE_OPERATOR_LESS_INT,
+		OPCODE_OPERATOR_LESS_EQUAL_INT,
+		OPCODE_OPERATOR_GREATER_INT,
+		OPCODE_OPERATOR_GREATER_EQUAL_INT,
+		OPCODE_OPERATOR_ADD_FLOAT,
+		OPCODE_OPERATOR_SUBTRACT_FLOAT,
+		OPCODE_OPERATOR_MULTIPLY_FLOAT,
+		OPCODE_OPERATOR_DIVIDE_FLOAT,
+		OPCODE_OPERATOR_EQUAL_FLOAT,
+		OPCODE_OPERATOR_NOT_EQUAL_FLOAT,
+		OPCODE_OPERATOR_LESS_FLOAT,
+		OPCODE_OPERATOR_LESS_EQUAL_FLOAT,
+		OPCODE_OPERATOR_GREATER_FLOAT,
+		OPCODE_OPERATOR_GREATER_EQUAL_FLOAT,
 		OPCODE_TYPE_TEST_BUILTIN,
 		OPCODE_TYPE_TEST_ARRAY,
 		OPCODE_TYPE_TEST_DICTIONARY,
@@ -441,11 +463,61 @@ public:
 		StringName identifier;
 	};
 
+	// Per-site cache for untyped named access and method calls. Entries are keyed on the native class and the
+	// script of the base object, and resolve straight to a member index, a property accessor or a function.
+	struct InlineCache {
+		enum Kind {
+			KIND_MEMBER,
+			KIND_NATIVE_GETTER,
+			KIND_NATIVE_SETTER,
+			KIND_METHOD_BIND,
+			KIND_SCRIPT_FUNCTION,
+		};
+
+		struct Entry {
+			StringName class_name;
+			const BRScript *script = nullptr;
+			ObjectID script_id; // Tells whether the script is still alive before looking at it.
+			uint32_t epoch = 0;
+			Kind kind = KIND_MEMBER;
+			int member_index = -1;
+			const BRScriptDataType *member_type = nullptr;
+			MethodBind *method = nullptr;
+			BRScriptFunction *function = nullptr;
+		};
+
+		// Sites that see more shapes than this are megamorphic and keep using the generic path.
+		static constexpr uint32_t MAX_ENTRIES = 4;
+
+		Entry entries[MAX_ENTRIES];
+		// Each entry is guarded by a sequence lock on its epoch, so readers don't lock. Writers, serialized by a
+		// mutex, set the epoch to 0, which no reader accepts, write the entry and then publish its epoch. Readers
+		// copy the entry and check that its epoch didn't change meanwhile. Once the cache is full, stale entries
+		// are overwritten.
+		SafeNumeric<uint32_t> entry_epochs[MAX_ENTRIES];
+		SafeNumeric<uint32_t> entry_count;
+		// Value of the epoch counter when the full cache last had no stale entry, so megamorphic sites don't lock.
+		SafeNumeric<uint32_t> full_at_epoch;
+	};
+
+	// Frame handed to functions compiled ahead of time (see BRScriptAOT), indexed like the VM tables.
+	struct NativeContext {
+		Variant *const *addresses = nullptr;
+		const Variant::ValidatedOperatorEvaluator *operator_funcs = nullptr;
+		MethodBind *const *methods = nullptr;
+	};
+
+	// Runs the function from its first instruction and returns the address at which the VM takes over.
+	typedef int (*NativeFunction)(const NativeContext &p_context);
+
 private:
 	friend class BRScript;
 	friend class BRScriptCompiler;
 	friend class BRScriptByteCodeGenerator;
+	friend class BRScriptByteCodeOptimizer;
 	friend class BRScriptLanguage;
+	friend class BRScriptAOT;
+	friend class BRScriptSamplingProfiler;
 
 	StringName name;
 	StringName source;
@@ -483,6 +555,7 @@ private:
 	Vector<BRScriptUtilityFunctions::FunctionPtr> gds_utilities;
 	Vector<MethodBind *> methods;
 	Vector<BRScriptFunction *> lambdas;
+	LocalVector<InlineCache> inline_caches;
 
 	int _code_size = 0;
 	int _default_arg_count = 0;
@@ -501,6 +574,7 @@ private:
 	int _gds_utilities_count = 0;
 	int _methods_count = 0;
 	int _lambdas_count = 0;
+	int _inline_caches_count = 0;
 
 	int *_code_ptr = nullptr;
 	const int *_default_arg_ptr = nullptr;
@@ -519,6 +593,16 @@ private:
 	const BRScriptUtilityFunctions::FunctionPtr *_gds_utilities_ptr = nullptr;
 	MethodBind **_methods_ptr = nullptr;
 	BRScriptFunction **_lambdas_ptr = nullptr;
+	InlineCache *_inline_caches_ptr = nullptr;
+
+	NativeFunction native_function = nullptr;
+
+	// Identifies the function in sampled stacks, assigned the first time it's sampled.
+	SafeNumeric<uint32_t> sampling_id;
+
+	// Hands out the epochs of scripts. Every epoch is larger than the ones before it, so a script whose address
+	// was reused, or any script in the inheritance chain getting a new one, changes the epoch of its entries.
+	static SafeNumeric<uint32_t> inline_cache_epochs;
 
 #ifdef DEBUG_ENABLED
 	CharString func_cname;
@@ -556,17 +640,31 @@ private:
 	_FORCE_INLINE_ String _get_call_error(const String &p_where, const Variant **p_argptrs, const Variant &p_ret, const Callable::CallError &p_err) const;
 	Variant _get_default_variant_for_data_type(const BRScriptDataType &p_data_type);
 
+	static Object *_get_inline_cache_object(const Variant *p_base, bool p_validate, BRScriptInstance *&r_instance);
+	static uint32_t _get_inline_cache_epoch(const BRScript *p_script);
+	static bool _is_inline_cache_entry_stale(const InlineCache::Entry &p_entry, uint32_t p_epoch);
+	static bool _find_inline_cache_entry(const InlineCache &p_cache, const Object *p_object, const BRScriptInstance *p_instance, InlineCache::Entry &r_entry);
+	static void _add_inline_cache_entry(InlineCache &p_cache, const InlineCache::Entry &p_entry);
+	static bool _resolve_inline_cache_get(const Object *p_object, const BRScriptInstance *p_instance, const StringName &p_name, InlineCache::Entry &r_entry);
+	static bool _resolve_inline_cache_set(const Object *p_object, const BRScriptInstance *p_instance, const StringName &p_name, InlineCache::Entry &r_entry);
+	static bool _resolve_inline_cache_call(const Object *p_object, const BRScriptInstance *p_instance, const StringName &p_name, InlineCache::Entry &r_entry);
+	static bool _inline_cache_get(InlineCache &p_cache, const Variant *p_base, const StringName &p_name, Variant &r_ret);
+	static bool _inline_cache_set(InlineCache &p_cache, const Variant *p_base, const StringName &p_name, const Variant &p_value, bool &r_valid);
+	static bool _inline_cache_call(InlineCache &p_cache, const Variant *p_base, const StringName &p_name, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_err);
+
 public:
 	static constexpr int MAX_CALL_DEPTH = 2048; // Limit to try to avoid crash because of a stack overflow.
 
 	struct CallState {
+		BRScriptFunctionState *function_state = nullptr;
 		BRScript *script = nullptr;
 		BRScriptInstance *instance = nullptr;
 #ifdef DEBUG_ENABLED
 		StringName function_name;
 		String script_path;
 #endif
-		Vector<uint8_t> stack;
+		// Pooled, holds `alloca_size` bytes. Variants from index 3 up to `stack_size` are owned by the state.
+		uint8_t *stack = nullptr;
 		int stack_size = 0;
 		uint32_t alloca_size = 0;
 		int ip = 0;
@@ -583,10 +681,19 @@ public:
 	_FORCE_INLINE_ int get_argument_count() const { return _argument_count; }
 	_FORCE_INLINE_ Variant get_rpc_config() const { return rpc_config; }
 	_FORCE_INLINE_ int get_max_stack_size() const { return _stack_size; }
+	_FORCE_INLINE_ int get_code_size() const { return _code_size; }
+	_FORCE_INLINE_ NativeFunction get_native_function() const { return native_function; }
 
 	Variant get_constant(int p_idx) const;
 	StringName get_global_name(int p_idx) const;
 
+	static uint32_t new_inline_cache_epoch() { return inline_cache_epochs.increment(); }
+	// Called when the members or functions of a script change, only the entries keyed on it and its inheritors miss.
+	static void invalidate_inline_caches(BRScript *p_script);
+	int get_inline_cache_count() const { return _inline_caches_count; }
+	// Whether an inline cache has a valid entry for the class and script of the object, so its site hits for it.
+	bool has_inline_cache_entry(int p_cache, const Variant &p_base) const;
+
 	Variant call(BRScriptInstance *p_instance, const Variant **p_args, int p_argcount, Callable::CallError &r_err, CallState *p_state = nullptr);
 	void debug_get_stack_member_state(int p_line, List<Pair<StringName, int>> *r_stackvars) const;
 
@@ -610,6 +717,19 @@ class BRScriptFunctionState : public RefCounted {
 	SelfList<BRScriptFunctionState> scripts_list;
 	SelfList<BRScriptFunctionState> instances_list;
 
+	// Stacks are recycled by power-of-two size, so suspending a function doesn't allocate once the pool is warm.
+	enum {
+		STACK_POOL_MIN_SHIFT = 7,
+		STACK_POOL_MAX_SHIFT = 16,
+		STACK_POOL_MAX_BYTES = 1 << 20, // Per size.
+	};
+
+	static SpinLock stack_pool_lock;
+	static LocalVector<uint8_t *> stack_pool[STACK_POOL_MAX_SHIFT - STACK_POOL_MIN_SHIFT + 1];
+
+	static uint8_t *_alloc_stack(uint32_t p_size);
+	static void _free_stack(uint8_t *p_stack, uint32_t p_size);
+
 protected:
 	static void _bind_methods();
 
@@ -620,8 +740,29 @@ public:
 	void _clear_stack();
 	void _clear_connections();
 
+	static void clear_stack_pool();
+
 	BRScriptFunctionState();
 	~BRScriptFunctionState();
 };
 
+// Resumes a function state when the awaited signal is emitted, passing the signal arguments as the await result.
+class BRScriptFunctionStateCallable : public CallableCustom {
+	Ref<BRScriptFunctionState> state;
+
+	static bool compare_equal(const CallableCustom *p_a, const CallableCustom *p_b);
+	static bool compare_less(const CallableCustom *p_a, const CallableCustom *p_b);
+
+public:
+	uint32_t hash() const override;
+	String get_as_text() const override;
+	CompareEqualFunc get_compare_equal_func() const override;
+	CompareLessFunc get_compare_less_func() const override;
+	ObjectID get_object() const override;
+	void call(const Variant **p_arguments, int p_argcount, Variant &r_return_value, Callable::CallError &r_call_error) const override;
+
+	BRScriptFunctionStateCallable(const Ref<BRScriptFunctionState> &p_state) :
+			state(p_state) {}
+};
+
 #endif // BRSCRIPT_FUNCTION_H
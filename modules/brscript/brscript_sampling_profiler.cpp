@@ -0,0 +1,223 @@
+/**************************************************************************/
+/*  brscript_sampling_profiler.cpp                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "brscript_sampling_profiler.h"
+
+#include "brscript_function.h"
+
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/object/method_bind.h"
+#include "core/os/os.h"
+
+SafeFlag BRScriptSamplingProfiler::active;
+Mutex BRScriptSamplingProfiler::mutex;
+Thread BRScriptSamplingProfiler::thread;
+uint64_t BRScriptSamplingProfiler::interval_usec = 1000;
+uint64_t BRScriptSamplingProfiler::save_interval_usec = 0;
+String BRScriptSamplingProfiler::output_path;
+LocalVector<BRScriptSamplingProfiler::ThreadStack *> BRScriptSamplingProfiler::thread_stacks;
+LocalVector<String> BRScriptSamplingProfiler::function_names;
+HashMap<String, uint64_t> BRScriptSamplingProfiler::samples;
+
+thread_local BRScriptSamplingProfiler::ThreadStack BRScriptSamplingProfiler::thread_stack;
+
+BRScriptSamplingProfiler::ThreadStack::ThreadStack() {
+	is_main_thread = Thread::is_main_thread();
+	MutexLock lock(mutex);
+	thread_stacks.push_back(this);
+}
+
+BRScriptSamplingProfiler::ThreadStack::~ThreadStack() {
+	MutexLock lock(mutex);
+	thread_stacks.erase(this);
+}
+
+uint32_t BRScriptSamplingProfiler::_register_function(BRScriptFunction *p_function) {
+	MutexLock lock(mutex);
+	uint32_t id = p_function->sampling_id.get();
+	if (id == 0) {
+		String source = p_function->source;
+		function_names.push_back(vformat("%s (%s:%d)", p_function->name, source.is_empty() ? String("<built-in>") : source, p_function->_initial_line));
+		id = function_names.size();
+		p_function->sampling_id.set(id);
+	}
+	return id;
+}
+
+void BRScriptSamplingProfiler::push_frame(BRScriptFunction *p_function) {
+	uint32_t id = p_function->sampling_id.get();
+	if (unlikely(id == 0)) {
+		id = _register_function(p_function);
+	}
+
+	ThreadStack &stack = thread_stack;
+	uint32_t generation = stack.generation.load(std::memory_order_relaxed);
+	uint32_t depth = stack.depth.load(std::memory_order_relaxed);
+
+	stack.generation.store(generation + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	if (depth < MAX_DEPTH) {
+		stack.frames[depth].function.store(id, std::memory_order_relaxed);
+		stack.frames[depth].native_call.store(nullptr, std::memory_order_relaxed);
+	}
+	stack.depth.store(depth + 1, std::memory_order_relaxed);
+	stack.generation.store(generation + 2, std::memory_order_release);
+}
+
+void BRScriptSamplingProfiler::pop_frame() {
+	ThreadStack &stack = thread_stack;
+	uint32_t generation = stack.generation.load(std::memory_order_relaxed);
+
+	stack.generation.store(generation + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	stack.depth.store(stack.depth.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+	stack.generation.store(generation + 2, std::memory_order_release);
+}
+
+void BRScriptSamplingProfiler::_sample() {
+	uint32_t functions[MAX_DEPTH];
+	const MethodBind *native_calls[MAX_DEPTH];
+
+	MutexLock lock(mutex);
+	for (ThreadStack *stack : thread_stacks) {
+		uint32_t generation = stack->generation.load(std::memory_order_acquire);
+		if (generation & 1) {
+			continue; // Busy pushing or popping.
+		}
+		uint32_t depth = MIN(stack->depth.load(std::memory_order_relaxed), (uint32_t)MAX_DEPTH);
+		if (depth == 0) {
+			continue; // Not running scripts.
+		}
+		for (uint32_t i = 0; i < depth; i++) {
+			functions[i] = stack->frames[i].function.load(std::memory_order_relaxed);
+			native_calls[i] = stack->frames[i].native_call.load(std::memory_order_relaxed);
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (stack->generation.load(std::memory_order_relaxed) != generation) {
+			continue; // Changed while copying, the copy may be torn.
+		}
+
+		String folded = stack->is_main_thread ? "Main Thread" : "Other Threads";
+		for (uint32_t i = 0; i < depth; i++) {
+			if (functions[i] == 0 || functions[i] > function_names.size()) {
+				continue;
+			}
+			folded += ";" + function_names[functions[i] - 1];
+			if (native_calls[i]) {
+				folded += ";" + String(native_calls[i]->get_instance_class()) + "." + String(native_calls[i]->get_name());
+			}
+		}
+		samples[folded]++;
+	}
+}
+
+void BRScriptSamplingProfiler::_thread_func(void *p_userdata) {
+	Thread::set_name("BRScript Sampling Profiler");
+
+	uint64_t last_save = OS::get_singleton()->get_ticks_usec();
+	while (active.is_set()) {
+		OS::get_singleton()->delay_usec(interval_usec);
+		_sample();
+
+		if (save_interval_usec > 0 && !output_path.is_empty() && OS::get_singleton()->get_ticks_usec() - last_save >= save_interval_usec) {
+			save_folded_stacks(output_path);
+			last_save = OS::get_singleton()->get_ticks_usec();
+		}
+	}
+}
+
+void BRScriptSamplingProfiler::start(uint64_t p_interval_usec, const String &p_output_path, uint64_t p_save_interval_usec) {
+	ERR_FAIL_COND_MSG(active.is_set(), "The BRScript sampling profiler is already running.");
+#ifdef THREADS_ENABLED
+	interval_usec = MAX(p_interval_usec, (uint64_t)10);
+	output_path = p_output_path;
+	save_interval_usec = p_save_interval_usec;
+
+	active.set();
+	thread.start(_thread_func, nullptr);
+#else
+	ERR_FAIL_MSG("The BRScript sampling profiler requires threads support.");
+#endif
+}
+
+void BRScriptSamplingProfiler::stop() {
+	if (!active.is_set()) {
+		return;
+	}
+	active.clear();
+	thread.wait_to_finish();
+
+	if (!output_path.is_empty()) {
+		save_folded_stacks(output_path);
+	}
+}
+
+String BRScriptSamplingProfiler::get_folded_stacks() {
+	LocalVector<String> lines;
+	{
+		MutexLock lock(mutex);
+		lines.reserve(samples.size());
+		for (const KeyValue<String, uint64_t> &E : samples) {
+			lines.push_back(E.key + " " + itos(E.value));
+		}
+	}
+	lines.sort();
+
+	String folded;
+	for (const String &line : lines) {
+		folded += line + "\n";
+	}
+	return folded;
+}
+
+Error BRScriptSamplingProfiler::save_folded_stacks(const String &p_path) {
+	String folded = get_folded_stacks();
+
+	// Write to a temporary file first, so that tools reading the file while running never see it partially written.
+	String tmp_path = p_path + ".tmp";
+	Error err = OK;
+	Ref<FileAccess> f = FileAccess::open(tmp_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, vformat("Couldn't save sampled BRScript stacks to \"%s\".", p_path));
+	f->store_string(folded);
+	f.unref();
+
+	Ref<DirAccess> da = DirAccess::create_for_path(p_path);
+	if (da->exists(p_path)) {
+		da->remove(p_path);
+	}
+	return da->rename(tmp_path, p_path);
+}
+
+void BRScriptSamplingProfiler::clear() {
+	MutexLock lock(mutex);
+	samples.clear();
+}
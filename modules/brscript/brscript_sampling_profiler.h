@@ -0,0 +1,118 @@
+/**************************************************************************/
+/*  brscript_sampling_profiler.h                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef BRSCRIPT_SAMPLING_PROFILER_H
+#define BRSCRIPT_SAMPLING_PROFILER_H
+
+#include "core/os/mutex.h"
+#include "core/os/thread.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+
+#include <atomic>
+
+class BRScriptFunction;
+class MethodBind;
+
+// Low-overhead alternative to the instrumenting profiler.
+//
+// While active, every thread running scripts keeps a lightweight copy of its script call stack, where
+// each frame also records the native method it's currently calling, if any. A separate thread
+// periodically snapshots those stacks and counts how often each one is seen. The result is written
+// in the folded format used by flame graph tools: one line per stack, frames separated by
+// semicolons, followed by the number of samples.
+class BRScriptSamplingProfiler {
+public:
+	enum {
+		MAX_DEPTH = 256,
+	};
+
+private:
+	struct Frame {
+		std::atomic<uint32_t> function = 0;
+		std::atomic<const MethodBind *> native_call = nullptr;
+	};
+
+	// Written only by its own thread. Readers copy it and check the generation didn't change meanwhile.
+	struct ThreadStack {
+		std::atomic<uint32_t> generation = 0;
+		std::atomic<uint32_t> depth = 0;
+		Frame frames[MAX_DEPTH];
+		bool is_main_thread = false;
+
+		ThreadStack();
+		~ThreadStack();
+	};
+
+	static thread_local ThreadStack thread_stack;
+
+	static SafeFlag active;
+	static Mutex mutex;
+	static Thread thread;
+	static uint64_t interval_usec;
+	static uint64_t save_interval_usec;
+	static String output_path;
+
+	// Guarded by the mutex.
+	static LocalVector<ThreadStack *> thread_stacks;
+	static LocalVector<String> function_names;
+	static HashMap<String, uint64_t> samples;
+
+	static uint32_t _register_function(BRScriptFunction *p_function);
+	static void _sample();
+	static void _thread_func(void *p_userdata);
+
+public:
+	_FORCE_INLINE_ static bool is_active() { return active.is_set(); }
+
+	// Called by the VM around each function call started while active.
+	static void push_frame(BRScriptFunction *p_function);
+	static void pop_frame();
+	// Marks the native method called by the innermost frame, null once the call returns.
+	_FORCE_INLINE_ static void set_native_call(const MethodBind *p_method) {
+		uint32_t depth = thread_stack.depth.load(std::memory_order_relaxed);
+		if (likely(depth > 0 && depth <= MAX_DEPTH)) {
+			thread_stack.frames[depth - 1].native_call.store(p_method, std::memory_order_relaxed);
+		}
+	}
+
+	// Starts sampling every `p_interval_usec`. If `p_output_path` isn't empty, folded stacks are saved there every
+	// `p_save_interval_usec` (if not zero) and when stopping.
+	static void start(uint64_t p_interval_usec, const String &p_output_path = String(), uint64_t p_save_interval_usec = 0);
+	static void stop();
+
+	static String get_folded_stacks();
+	static Error save_folded_stacks(const String &p_path);
+	static void clear();
+};
+
+#endif // BRSCRIPT_SAMPLING_PROFILER_H
@@ -32,8 +32,10 @@
 #include "brscript.h"
 #include "brscript_function.h"
 #include "brscript_lambda_callable.h"
+#include "brscript_sampling_profiler.h"
 
 #include "core/os/os.h"
+#include "scene/scene_string_names.h"
 
 #ifdef DEBUG_ENABLED
 
@@ -186,6 +188,362 @@ String BRScriptFunction::_get_call_error(const String &p_where, const Variant **
 	return "Bug: Invalid call error code " + itos(p_err.error) + ".";
 }
 
+// Epoch 0 marks entries being written, entries keyed on native classes alone never go stale.
+static constexpr uint32_t INLINE_CACHE_NATIVE_EPOCH = 1;
+
+SafeNumeric<uint32_t> BRScriptFunction::inline_cache_epochs(INLINE_CACHE_NATIVE_EPOCH);
+
+void BRScriptFunction::invalidate_inline_caches(BRScript *p_script) {
+	p_script->inline_cache_epoch.set(new_inline_cache_epoch());
+}
+
+uint32_t BRScriptFunction::_get_inline_cache_epoch(const BRScript *p_script) {
+	if (!p_script) {
+		return INLINE_CACHE_NATIVE_EPOCH;
+	}
+	// Entries also refer to what the script inherits, so they go stale when any of its bases changes.
+	uint32_t epoch = 0;
+	for (const BRScript *sptr = p_script; sptr; sptr = sptr->_base) {
+		epoch = MAX(epoch, sptr->inline_cache_epoch.get());
+	}
+	return epoch;
+}
+
+// Returns the object the inline caches can be keyed on, or `nullptr` if the base has to go through the generic path.
+Object *BRScriptFunction::_get_inline_cache_object(const Variant *p_base, bool p_validate, BRScriptInstance *&r_instance) {
+	if (p_base->get_type() != Variant::OBJECT) {
+		return nullptr;
+	}
+
+	Object *object = p_validate ? p_base->get_validated_object() : p_base->operator Object *();
+	if (!object) {
+		return nullptr;
+	}
+
+	ScriptInstance *script_instance = object->get_script_instance();
+	if (script_instance) {
+		if (script_instance->is_placeholder() || script_instance->get_language() != BRScriptLanguage::get_singleton()) {
+			return nullptr;
+		}
+		r_instance = static_cast<BRScriptInstance *>(script_instance);
+	} else {
+		r_instance = nullptr;
+	}
+	return object;
+}
+
+bool BRScriptFunction::_is_inline_cache_entry_stale(const InlineCache::Entry &p_entry, uint32_t p_epoch) {
+	if (!p_entry.script) {
+		return p_epoch != INLINE_CACHE_NATIVE_EPOCH;
+	}
+	if (!ObjectDB::get_instance(p_entry.script_id)) {
+		return true; // Freed, another script may be using its address.
+	}
+	return p_epoch != _get_inline_cache_epoch(p_entry.script);
+}
+
+bool BRScriptFunction::_find_inline_cache_entry(const InlineCache &p_cache, const Object *p_object, const BRScriptInstance *p_instance, InlineCache::Entry &r_entry) {
+	const BRScript *script = p_instance ? p_instance->script.ptr() : nullptr;
+	const uint32_t epoch = _get_inline_cache_epoch(script);
+	const StringName &class_name = p_object->get_class_name();
+	const uint32_t count = p_cache.entry_count.get();
+	for (uint32_t i = 0; i < count; i++) {
+		const uint32_t entry_epoch = p_cache.entry_epochs[i].get();
+		if (entry_epoch != epoch) {
+			continue;
+		}
+		// Only compares pointers, the entry may be overwritten meanwhile.
+		const InlineCache::Entry &entry = p_cache.entries[i];
+		if (entry.script != script || entry.class_name != class_name) {
+			continue;
+		}
+		r_entry.kind = entry.kind;
+		r_entry.member_index = entry.member_index;
+		r_entry.member_type = entry.member_type;
+		r_entry.method = entry.method;
+		r_entry.function = entry.function;
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (p_cache.entry_epochs[i].get() != entry_epoch) {
+			continue; // Overwritten while copying it.
+		}
+		return true;
+	}
+	return false;
+}
+
+void BRScriptFunction::_add_inline_cache_entry(InlineCache &p_cache, const InlineCache::Entry &p_entry) {
+	if (p_entry.epoch != _get_inline_cache_epoch(p_entry.script)) {
+		return; // Invalidated while resolving.
+	}
+
+	// Megamorphic sites miss on every access, don't make them take the lock until some script changes.
+	if (p_cache.entry_count.get() == InlineCache::MAX_ENTRIES && p_cache.full_at_epoch.get() == inline_cache_epochs.get()) {
+		return;
+	}
+
+	static Mutex inline_cache_mutex;
+	MutexLock lock(inline_cache_mutex);
+
+	const uint32_t epochs = inline_cache_epochs.get();
+	const uint32_t count = p_cache.entry_count.get();
+	uint32_t slot = count;
+	for (uint32_t i = 0; i < count; i++) {
+		const InlineCache::Entry &entry = p_cache.entries[i];
+		if (entry.script == p_entry.script && entry.class_name == p_entry.class_name) {
+			if (p_cache.entry_epochs[i].get() == p_entry.epoch) {
+				return; // Another thread got here first.
+			}
+			slot = i; // The previous version of the same shape.
+			break;
+		}
+		if (slot == count && _is_inline_cache_entry_stale(entry, p_cache.entry_epochs[i].get())) {
+			slot = i;
+		}
+	}
+	if (slot >= InlineCache::MAX_ENTRIES) {
+		p_cache.full_at_epoch.set(epochs);
+		return;
+	}
+
+	p_cache.entry_epochs[slot].set(0);
+	std::atomic_thread_fence(std::memory_order_release);
+	p_cache.entries[slot] = p_entry;
+	p_cache.entry_epochs[slot].set(p_entry.epoch);
+	if (slot == count) {
+		p_cache.entry_count.set(count + 1);
+	}
+}
+
+bool BRScriptFunction::has_inline_cache_entry(int p_cache, const Variant &p_base) const {
+	ERR_FAIL_INDEX_V(p_cache, _inline_caches_count, false);
+	BRScriptInstance *instance = nullptr;
+	Object *object = _get_inline_cache_object(&p_base, true, instance);
+	if (!object) {
+		return false;
+	}
+	InlineCache::Entry entry;
+	return _find_inline_cache_entry(_inline_caches_ptr[p_cache], object, instance, entry);
+}
+
+// The resolvers mirror the lookup order of `Object::get()`, `Object::set()` and `Object::callp()`, and give up whenever
+// the result could depend on something other than the class and script of the object (`_get()`, `_set()`, extensions...).
+
+bool BRScriptFunction::_resolve_inline_cache_get(const Object *p_object, const BRScriptInstance *p_instance, const StringName &p_name, InlineCache::Entry &r_entry) {
+	if (p_instance) {
+		const BRScript *script = p_instance->script.ptr();
+		if (!script->valid) {
+			return false;
+		}
+
+		HashMap<StringName, BRScript::MemberInfo>::ConstIterator E = script->member_indices.find(p_name);
+		if (E) {
+			if (E->value.getter) {
+				return false;
+			}
+			r_entry.kind = InlineCache::KIND_MEMBER;
+			r_entry.member_index = E->value.index;
+			return true;
+		}
+
+		const StringName &get_name = BRScriptLanguage::get_singleton()->strings._get;
+		for (const BRScript *sptr = script; sptr; sptr = sptr->_base) {
+			if (sptr->constants.has(p_name) || sptr->static_variables_indices.has(p_name) || sptr->_signals.has(p_name) || sptr->subclasses.has(p_name)) {
+				return false;
+			}
+			if (sptr->member_functions.has(p_name) || sptr->member_functions.has(get_name)) {
+				return false;
+			}
+		}
+	}
+
+	const ClassDB::APIType api = ClassDB::get_api_type(p_object->get_class_name());
+	if (api == ClassDB::API_EXTENSION || api == ClassDB::API_EDITOR_EXTENSION) {
+		return false; // Extension instances get a chance to handle the property first.
+	}
+
+	MethodBind *getter = ClassDB::get_property_getter_method(p_object->get_class_name(), p_name);
+	if (!getter) {
+		return false;
+	}
+	r_entry.kind = InlineCache::KIND_NATIVE_GETTER;
+	r_entry.method = getter;
+	return true;
+}
+
+bool BRScriptFunction::_resolve_inline_cache_set(const Object *p_object, const BRScriptInstance *p_instance, const StringName &p_name, InlineCache::Entry &r_entry) {
+	if (p_instance) {
+		const BRScript *script = p_instance->script.ptr();
+		if (!script->valid) {
+			return false;
+		}
+
+		HashMap<StringName, BRScript::MemberInfo>::ConstIterator E = script->member_indices.find(p_name);
+		if (E) {
+			if (E->value.setter) {
+				return false;
+			}
+			r_entry.kind = InlineCache::KIND_MEMBER;
+			r_entry.member_index = E->value.index;
+			r_entry.member_type = &E->value.data_type;
+			return true;
+		}
+
+		const StringName &set_name = BRScriptLanguage::get_singleton()->strings._set;
+		for (const BRScript *sptr = script; sptr; sptr = sptr->_base) {
+			if (sptr->static_variables_indices.has(p_name) || sptr->member_functions.has(set_name)) {
+				return false;
+			}
+		}
+	}
+
+	const ClassDB::APIType api = ClassDB::get_api_type(p_object->get_class_name());
+	if (api == ClassDB::API_EXTENSION || api == ClassDB::API_EDITOR_EXTENSION) {
+		return false; // Extension instances get a chance to handle the property first.
+	}
+
+	MethodBind *setter = ClassDB::get_property_setter_method(p_object->get_class_name(), p_name);
+	if (!setter) {
+		return false;
+	}
+	r_entry.kind = InlineCache::KIND_NATIVE_SETTER;
+	r_entry.method = setter;
+	return true;
+}
+
+bool BRScriptFunction::_resolve_inline_cache_call(const Object *p_object, const BRScriptInstance *p_instance, const StringName &p_name, InlineCache::Entry &r_entry) {
+	// Both are special-cased by `Object::callp()` and `BRScriptInstance::callp()`.
+	if (p_name == CoreStringName(free_) || p_name == SceneStringName(_ready)) {
+		return false;
+	}
+
+	if (p_instance) {
+		for (const BRScript *sptr = p_instance->script.ptr(); sptr; sptr = sptr->_base) {
+			if (likely(sptr->valid)) {
+				HashMap<StringName, BRScriptFunction *>::ConstIterator E = sptr->member_functions.find(p_name);
+				if (E) {
+					r_entry.kind = InlineCache::KIND_SCRIPT_FUNCTION;
+					r_entry.function = E->value;
+					return true;
+				}
+			}
+		}
+	}
+
+	MethodBind *method = ClassDB::get_method(p_object->get_class_name(), p_name);
+	if (!method) {
+		return false;
+	}
+	r_entry.kind = InlineCache::KIND_METHOD_BIND;
+	r_entry.method = method;
+	return true;
+}
+
+bool BRScriptFunction::_inline_cache_get(InlineCache &p_cache, const Variant *p_base, const StringName &p_name, Variant &r_ret) {
+	BRScriptInstance *instance = nullptr;
+	Object *object = _get_inline_cache_object(p_base, true, instance);
+	if (!object) {
+		return false;
+	}
+
+	InlineCache::Entry entry;
+	if (!_find_inline_cache_entry(p_cache, object, instance, entry)) {
+		entry.script = instance ? instance->script.ptr() : nullptr;
+		entry.script_id = instance ? instance->script->get_instance_id() : ObjectID();
+		entry.epoch = _get_inline_cache_epoch(entry.script);
+		if (!_resolve_inline_cache_get(object, instance, p_name, entry)) {
+			return false;
+		}
+		entry.class_name = object->get_class_name();
+		_add_inline_cache_entry(p_cache, entry);
+	}
+
+	if (entry.kind == InlineCache::KIND_MEMBER) {
+		r_ret = instance->members[entry.member_index];
+	} else {
+		Callable::CallError ce;
+		const Variant value = entry.method->call(object, nullptr, 0, ce);
+		r_ret = (ce.error == Callable::CallError::CALL_OK) ? value : Variant();
+	}
+	return true;
+}
+
+bool BRScriptFunction::_inline_cache_set(InlineCache &p_cache, const Variant *p_base, const StringName &p_name, const Variant &p_value, bool &r_valid) {
+	BRScriptInstance *instance = nullptr;
+	Object *object = _get_inline_cache_object(p_base, true, instance);
+	if (!object) {
+		return false;
+	}
+
+	InlineCache::Entry entry;
+	if (!_find_inline_cache_entry(p_cache, object, instance, entry)) {
+		entry.script = instance ? instance->script.ptr() : nullptr;
+		entry.script_id = instance ? instance->script->get_instance_id() : ObjectID();
+		entry.epoch = _get_inline_cache_epoch(entry.script);
+		if (!_resolve_inline_cache_set(object, instance, p_name, entry)) {
+			return false;
+		}
+		entry.class_name = object->get_class_name();
+		_add_inline_cache_entry(p_cache, entry);
+	}
+
+	if (entry.kind == InlineCache::KIND_MEMBER) {
+		if (entry.member_type->has_type && !entry.member_type->is_type(p_value)) {
+			return false; // Let the generic path try the conversion.
+		}
+#ifdef TOOLS_ENABLED
+		object->mark_edited();
+#endif
+		instance->members.write[entry.member_index] = p_value;
+		r_valid = true;
+	} else {
+#ifdef TOOLS_ENABLED
+		object->mark_edited();
+#endif
+		Callable::CallError ce;
+		const Variant *args[1] = { &p_value };
+		entry.method->call(object, args, 1, ce);
+		r_valid = ce.error == Callable::CallError::CALL_OK;
+	}
+	return true;
+}
+
+bool BRScriptFunction::_inline_cache_call(InlineCache &p_cache, const Variant *p_base, const StringName &p_name, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_err) {
+	BRScriptInstance *instance = nullptr;
+	// Like `Variant::callp()`, only debug builds check that the object is still alive.
+#ifdef DEBUG_ENABLED
+	Object *object = _get_inline_cache_object(p_base, true, instance);
+#else
+	Object *object = _get_inline_cache_object(p_base, false, instance);
+#endif
+	if (!object) {
+		return false;
+	}
+
+	InlineCache::Entry entry;
+	if (!_find_inline_cache_entry(p_cache, object, instance, entry)) {
+		entry.script = instance ? instance->script.ptr() : nullptr;
+		entry.script_id = instance ? instance->script->get_instance_id() : ObjectID();
+		entry.epoch = _get_inline_cache_epoch(entry.script);
+		if (!_resolve_inline_cache_call(object, instance, p_name, entry)) {
+			return false;
+		}
+		entry.class_name = object->get_class_name();
+		_add_inline_cache_entry(p_cache, entry);
+	}
+
+	r_err.error = Callable::CallError::CALL_OK;
+#ifdef DEBUG_ENABLED
+	// Like `Object::callp()`, don't let the method free the object it runs on.
+	_ObjectDebugLock debug_lock(object);
+#endif
+	if (entry.kind == InlineCache::KIND_SCRIPT_FUNCTION) {
+		r_ret = entry.function->call(instance, p_args, p_argcount, r_err);
+	} else {
+		r_ret = entry.method->call(object, p_args, p_argcount, r_err);
+	}
+	return true;
+}
+
 void (*type_init_function_table[])(Variant *) = {
 	nullptr, // NIL (shouldn't be called).
 	&VariantInitializer<bool>::init, // BOOL.
@@ -233,6 +591,25 @@ void (*type_init_function_table[])(Variant *) = {
 	static const void *switch_table_ops[] = {            \
 		&&OPCODE_OPERATOR,                               \
 		&&OPCODE_OPERATOR_VALIDATED,                     \
+		&&OPCODE_OPERATOR_ADD_INT,                       \
+		&&OPCODE_OPERATOR_SUBTRACT_INT,                  \
+		&&OPCODE_OPERATOR_MULTIPLY_INT,                  \
+		&&OPCODE_OPERATOR_EQUAL_INT,                     \
+		&&OPCODE_OPERATOR_NOT_EQUAL_INT,                 \
+		&&OPCODE_OPERATOR_LESS_INT,                      \
+		&&OPCODE_OPERATOR_LESS_EQUAL_INT,                \
+		&&OPCODE_OPERATOR_GREATER_INT,                   \
+		&&OPCODE_OPERATOR_GREATER_EQUAL_INT,             \
+		&&OPCODE_OPERATOR_ADD_FLOAT,                     \
+		&&OPCODE_OPERATOR_SUBTRACT_FLOAT,                \
+		&&OPCODE_OPERATOR_MULTIPLY_FLOAT,                \
+		&&OPCODE_OPERATOR_DIVIDE_FLOAT,                  \
+		&&OPCODE_OPERATOR_EQUAL_FLOAT,                   \
+		&&OPCODE_OPERATOR_NOT_EQUAL_FLOAT,               \
+		&&OPCODE_OPERATOR_LESS_FLOAT,                    \
+		&&OPCODE_OPERATOR_LESS_EQUAL_FLOAT,              \
+		&&OPCODE_OPERATOR_GREATER_FLOAT,                 \
+		&&OPCODE_OPERATOR_GREATER_EQUAL_FLOAT,           \
 		&&OPCODE_TYPE_TEST_BUILTIN,                      \
 		&&OPCODE_TYPE_TEST_ARRAY,                        \
 		&&OPCODE_TYPE_TEST_DICTIONARY,                   \
@@ -473,6 +850,7 @@ void (*type_init_function_table[])(Variant *) = {
 
 Variant BRScriptFunction::call(BRScriptInstance *p_instance, const Variant **p_args, int p_argcount, Callable::CallError &r_err, CallState *p_state) {
 	OPCODES_TABLE;
+	MemoryTagScope memory_tag_scope(Memory::TAG_SCRIPTING);
 
 	if (!_code_ptr) {
 		return _get_default_variant_for_data_type(return_type);
@@ -522,14 +900,16 @@ Variant BRScriptFunction::call(BRScriptInstance *p_instance, const Variant **p_a
 	BRScript *script;
 	int ip = 0;
 	int line = _initial_line;
+	// Set when the stack is handed over to a function state on `await`.
+	bool suspended = false;
 
 	if (p_state) {
 		//use existing (supplied) state (awaited)
-		stack = (Variant *)p_state->stack.ptr();
-		instruction_args = (Variant **)&p_state->stack.ptr()[sizeof(Variant) * p_state->stack_size]; //ptr() to avoid bounds check
+		stack = (Variant *)p_state->stack;
+		instruction_args = (Variant **)&p_state->stack[sizeof(Variant) * p_state->stack_size];
 		line = p_state->line;
 		ip = p_state->ip;
-		alloca_size = p_state->stack.size();
+		alloca_size = p_state->alloca_size;
 		script = p_state->script;
 		p_instance = p_state->instance;
 		defarg = p_state->defarg;
@@ -626,6 +1006,16 @@ Variant BRScriptFunction::call(BRScriptInstance *p_instance, const Variant **p_a
 	memnew_placement(&stack[ADDR_STACK_CLASS], Variant(script));
 	memnew_placement(&stack[ADDR_STACK_NIL], Variant);
 
+	const bool sampled = BRScriptSamplingProfiler::is_active();
+	if (unlikely(sampled)) {
+		BRScriptSamplingProfiler::push_frame(this);
+	}
+
+#define SAMPLE_NATIVE_CALL(m_method)                         \
+	if (unlikely(sampled)) {                                 \
+		BRScriptSamplingProfiler::set_native_call(m_method); \
+	}
+
 	String err_text;
 
 #ifdef DEBUG_ENABLED
@@ -711,6 +1101,12 @@ Variant BRScriptFunction::call(BRScriptInstance *p_instance, const Variant **p_a
 
 	Variant *variant_addresses[ADDR_TYPE_MAX] = { stack, _constants_ptr, p_instance ? p_instance->members.ptrw() : nullptr };
 
+	if (native_function && !p_state) {
+		// The native code leaves the frame as the bytecode would, so the VM continues from wherever it stopped.
+		const NativeContext native_context = { variant_addresses, _operator_funcs_ptr, _methods_ptr };
+		ip = native_function(native_context);
+	}
+
 #ifdef DEBUG_ENABLED
 	OPCODE_WHILE(ip < _code_size) {
 		int last_opcode = _code_ptr[ip];
@@ -823,6 +1219,38 @@ Variant BRScriptFunction::call(BRScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+#define OPCODE_OPERATOR_TYPED(m_name, m_op, m_get_func, m_ret_get_func)                                                \
+	OPCODE(OPCODE_OPERATOR_##m_name) {                                                                                 \
+		CHECK_SPACE(4);                                                                                                \
+		GET_VARIANT_PTR(a, 0);                                                                                         \
+		GET_VARIANT_PTR(b, 1);                                                                                         \
+		GET_VARIANT_PTR(dst, 2);                                                                                       \
+		*VariantInternal::m_ret_get_func(dst) = *VariantInternal::m_get_func(a) m_op * VariantInternal::m_get_func(b); \
+		ip += 4;                                                                                                       \
+	}                                                                                                                  \
+	DISPATCH_OPCODE
+
+			// Operands and target are known to hold the exact type, so the payloads are used directly.
+			OPCODE_OPERATOR_TYPED(ADD_INT, +, get_int, get_int);
+			OPCODE_OPERATOR_TYPED(SUBTRACT_INT, -, get_int, get_int);
+			OPCODE_OPERATOR_TYPED(MULTIPLY_INT, *, get_int, get_int);
+			OPCODE_OPERATOR_TYPED(EQUAL_INT, ==, get_int, get_bool);
+			OPCODE_OPERATOR_TYPED(NOT_EQUAL_INT, !=, get_int, get_bool);
+			OPCODE_OPERATOR_TYPED(LESS_INT, <, get_int, get_bool);
+			OPCODE_OPERATOR_TYPED(LESS_EQUAL_INT, <=, get_int, get_bool);
+			OPCODE_OPERATOR_TYPED(GREATER_INT, >, get_int, get_bool);
+			OPCODE_OPERATOR_TYPED(GREATER_EQUAL_INT, >=, get_int, get_bool);
+			OPCODE_OPERATOR_TYPED(ADD_FLOAT, +, get_float, get_float);
+			OPCODE_OPERATOR_TYPED(SUBTRACT_FLOAT, -, get_float, get_float);
+			OPCODE_OPERATOR_TYPED(MULTIPLY_FLOAT, *, get_float, get_float);
+			OPCODE_OPERATOR_TYPED(DIVIDE_FLOAT, /, get_float, get_float);
+			OPCODE_OPERATOR_TYPED(EQUAL_FLOAT, ==, get_float, get_bool);
+			OPCODE_OPERATOR_TYPED(NOT_EQUAL_FLOAT, !=, get_float, get_bool);
+			OPCODE_OPERATOR_TYPED(LESS_FLOAT, <, get_float, get_bool);
+			OPCODE_OPERATOR_TYPED(LESS_EQUAL_FLOAT, <=, get_float, get_bool);
+			OPCODE_OPERATOR_TYPED(GREATER_FLOAT, >, get_float, get_bool);
+			OPCODE_OPERATOR_TYPED(GREATER_EQUAL_FLOAT, >=, get_float, get_bool);
+
 			OPCODE(OPCODE_TYPE_TEST_BUILTIN) {
 				CHECK_SPACE(4);
 
@@ -1167,7 +1595,7 @@ Variant BRScriptFunction::call(BRScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_SET_NAMED) {
-				CHECK_SPACE(3);
+				CHECK_SPACE(5);
 
 				GET_VARIANT_PTR(dst, 0);
 				GET_VARIANT_PTR(value, 1);
@@ -1177,8 +1605,13 @@ Variant BRScriptFunction::call(BRScriptInstance *p_instance, const Variant **p_a
 				BR_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
+				int cache_idx = _code_ptr[ip + 4];
+				BR_ERR_BREAK(cache_idx < 0 || cache_idx >= _inline_caches_count);
+
 				bool valid;
-				dst->set_named(*index, *value, valid);
+				if (!_inline_cache_set(_inline_caches_ptr[cache_idx], dst, *index, *value, valid)) {
+					dst->set_named(*index, *value, valid);
+				}
 
 #ifdef DEBUG_ENABLED
 				if (!valid) {
@@ -1199,7 +1632,7 @@ Variant BRScriptFunction::call(BRScriptInstance *p_instance, const Variant **p_a
 					OPCODE_BREAK;
 				}
 #endif
-				ip += 4;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -1219,7 +1652,7 @@ Variant BRScriptFunction::call(BRScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_GET_NAMED) {
-				CHECK_SPACE(4);
+				CHECK_SPACE(5);
 
 				GET_VARIANT_PTR(src, 0);
 				GET_VARIANT_PTR(dst, 1);
@@ -1229,22 +1662,23 @@ Variant BRScriptFunction::call(BRScriptInstance *p_instance, const Variant **p_a
 				BR_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
-				bool valid;
-#ifdef DEBUG_ENABLED
-				//allow better error message in cases where src and dst are the same stack position
-				Variant ret = src->get_named(*index, valid);
+				int cache_idx = _code_ptr[ip + 4];
+				BR_ERR_BREAK(cache_idx < 0 || cache_idx >= _inline_caches_count);
 
-#else
-				*dst = src->get_named(*index, valid);
-#endif
+				bool valid = true;
+				// Also keeps the value alive in cases where src and dst are the same stack position.
+				Variant ret;
+				if (!_inline_cache_get(_inline_caches_ptr[cache_idx], src, *index, ret)) {
+					ret = src->get_named(*index, valid);
+				}
 #ifdef DEBUG_ENABLED
 				if (!valid) {
 					err_text = "Invalid access to property or key '" + index->operator String() + "' on a base object of type '" + _get_var_type(src) + "'.";
 					OPCODE_BREAK;
 				}
-				*dst = ret;
 #endif
-				ip += 4;
+				*dst = ret;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -1863,7 +2297,7 @@ Variant BRScriptFunction::call(BRScriptInstance *p_instance, const Variant **p_a
 				bool call_async = (_code_ptr[ip]) == OPCODE_CALL_ASYNC;
 #endif
 				LOAD_INSTRUCTION_ARGS
-				CHECK_SPACE(3 + instr_arg_count);
+				CHECK_SPACE(4 + instr_arg_count);
 
 				ip += instr_arg_count;
 
@@ -1874,6 +2308,9 @@ Variant BRScriptFunction::call(BRScriptInstance *p_instance, const Variant **p_a
 				BR_ERR_BREAK(methodname_idx < 0 || methodname_idx >= _global_names_count);
 				const StringName *methodname = &_global_names_ptr[methodname_idx];
 
+				int cache_idx = _code_ptr[ip + 3];
+				BR_ERR_BREAK(cache_idx < 0 || cache_idx >= _inline_caches_count);
+
 				GET_INSTRUCTION_ARG(base, argc);
 				Variant **argptrs = instruction_args;
 
@@ -1892,7 +2329,9 @@ Variant BRScriptFunction::call(BRScriptInstance *p_instance, const Variant **p_a
 				Callable::CallError err;
 				if (call_ret) {
 					GET_INSTRUCTION_ARG(ret, argc + 1);
-					base->callp(*methodname, (const Variant **)argptrs, argc, temp_ret, err);
+					if (!_inline_cache_call(_inline_caches_ptr[cache_idx], base, *methodname, (const Variant **)argptrs, argc, temp_ret, err)) {
+						base->callp(*methodname, (const Variant **)argptrs, argc, temp_ret, err);
+					}
 					*ret = temp_ret;
 #ifdef DEBUG_ENABLED
 					if (ret->get_type() == Variant::NIL) {
@@ -1922,7 +2361,9 @@ Variant BRScriptFunction::call(BRScriptInstance *p_instance, const Variant **p_a
 					}
 #endif
 				} else {
-					base->callp(*methodname, (const Variant **)argptrs, argc, temp_ret, err);
+					if (!_inline_cache_call(_inline_caches_ptr[cache_idx], base, *methodname, (const Variant **)argptrs, argc, temp_ret, err)) {
+						base->callp(*methodname, (const Variant **)argptrs, argc, temp_ret, err);
+					}
 				}
 #ifdef DEBUG_ENABLED
 
@@ -1972,7 +2413,7 @@ Variant BRScriptFunction::call(BRScriptInstance *p_instance, const Variant **p_a
 				}
 #endif // DEBUG_ENABLED
 
-				ip += 3;
+				ip += 4;
 			}
 			DISPATCH_OPCODE;
 
@@ -2015,6 +2456,7 @@ Variant BRScriptFunction::call(BRScriptInstance *p_instance, const Variant **p_a
 
 				Variant temp_ret;
 				Callable::CallError err;
+				SAMPLE_NATIVE_CALL(method);
 				if (call_ret) {
 					GET_INSTRUCTION_ARG(ret, argc + 1);
 					temp_ret = method->call(base_obj, (const Variant **)argptrs, argc, err);
@@ -2022,6 +2464,7 @@ Variant BRScriptFunction::call(BRScriptInstance *p_instance, const Variant **p_a
 				} else {
 					temp_ret = method->call(base_obj, (const Variant **)argptrs, argc, err);
 				}
+				SAMPLE_NATIVE_CALL(nullptr);
 
 #ifdef DEBUG_ENABLED
 
@@ -2119,7 +2562,9 @@ Variant BRScriptFunction::call(BRScriptInstance *p_instance, const Variant **p_a
 #endif
 
 				Callable::CallError err;
+				SAMPLE_NATIVE_CALL(method);
 				*ret = method->call(nullptr, argptrs, argc, err);
+				SAMPLE_NATIVE_CALL(nullptr);
 
 #ifdef DEBUG_ENABLED
 				if (BRScriptLanguage::get_singleton()->profiling && BRScriptLanguage::get_singleton()->profile_native_calls) {
@@ -2160,7 +2605,9 @@ Variant BRScriptFunction::call(BRScriptInstance *p_instance, const Variant **p_a
 #endif
 
 				GET_INSTRUCTION_ARG(ret, argc);
+				SAMPLE_NATIVE_CALL(method);
 				method->validated_call(nullptr, (const Variant **)argptrs, ret);
+				SAMPLE_NATIVE_CALL(nullptr);
 
 #ifdef DEBUG_ENABLED
 				if (BRScriptLanguage::get_singleton()->profiling && BRScriptLanguage::get_singleton()->profile_native_calls) {
@@ -2196,7 +2643,9 @@ Variant BRScriptFunction::call(BRScriptInstance *p_instance, const Variant **p_a
 
 				GET_INSTRUCTION_ARG(ret, argc);
 				VariantInternal::initialize(ret, Variant::NIL);
+				SAMPLE_NATIVE_CALL(method);
 				method->validated_call(nullptr, (const Variant **)argptrs, nullptr);
+				SAMPLE_NATIVE_CALL(nullptr);
 
 #ifdef DEBUG_ENABLED
 				if (BRScriptLanguage::get_singleton()->profiling && BRScriptLanguage::get_singleton()->profile_native_calls) {
@@ -2248,7 +2697,9 @@ Variant BRScriptFunction::call(BRScriptInstance *p_instance, const Variant **p_a
 #endif
 
 				GET_INSTRUCTION_ARG(ret, argc + 1);
+				SAMPLE_NATIVE_CALL(method);
 				method->validated_call(base_obj, (const Variant **)argptrs, ret);
+				SAMPLE_NATIVE_CALL(nullptr);
 
 #ifdef DEBUG_ENABLED
 				if (BRScriptLanguage::get_singleton()->profiling && BRScriptLanguage::get_singleton()->profile_native_calls) {
@@ -2298,7 +2749,9 @@ Variant BRScriptFunction::call(BRScriptInstance *p_instance, const Variant **p_a
 
 				GET_INSTRUCTION_ARG(ret, argc + 1);
 				VariantInternal::initialize(ret, Variant::NIL);
+				SAMPLE_NATIVE_CALL(method);
 				method->validated_call(base_obj, (const Variant **)argptrs, nullptr);
+				SAMPLE_NATIVE_CALL(nullptr);
 
 #ifdef DEBUG_ENABLED
 				if (BRScriptLanguage::get_singleton()->profiling && BRScriptLanguage::get_singleton()->profile_native_calls) {
@@ -2535,40 +2988,43 @@ Variant BRScriptFunction::call(BRScriptInstance *p_instance, const Variant **p_a
 				}
 
 				if (is_signal) {
-					Ref<BRScriptFunctionState> gdfs = memnew(BRScriptFunctionState);
-					gdfs->function = this;
-
-					gdfs->state.stack.resize(alloca_size);
-
-					// First 3 stack addresses are special, so we just skip them here.
-					for (int i = 3; i < _stack_size; i++) {
-						memnew_placement(&gdfs->state.stack.write[sizeof(Variant) * i], Variant(stack[i]));
+					Ref<BRScriptFunctionState> gdfs;
+					if (p_state) {
+						// Awaiting again after resuming, the stack already lives in the state.
+						gdfs = Ref<BRScriptFunctionState>(p_state->function_state);
+					} else {
+						gdfs = memnew(BRScriptFunctionState);
+						gdfs->function = this;
+
+						// Move the locals instead of copying them, this frame won't touch them anymore.
+						// First 3 stack addresses are special, so we just skip them here.
+						gdfs->state.stack = BRScriptFunctionState::_alloc_stack(alloca_size);
+						memcpy((void *)&gdfs->state.stack[sizeof(Variant) * 3], (const void *)&stack[3], sizeof(Variant) * (_stack_size - 3));
+						gdfs->state.stack_size = _stack_size;
+						gdfs->state.alloca_size = alloca_size;
+						gdfs->state.script = _script;
+						gdfs->state.instance = p_instance;
+#ifdef DEBUG_ENABLED
+						gdfs->state.function_name = name;
+						gdfs->state.script_path = _script->get_script_path();
+#endif
+						gdfs->state.defarg = defarg;
 					}
-					gdfs->state.stack_size = _stack_size;
-					gdfs->state.alloca_size = alloca_size;
+					suspended = true;
+
 					gdfs->state.ip = ip + 2;
 					gdfs->state.line = line;
-					gdfs->state.script = _script;
 					{
 						MutexLock lock(BRScriptLanguage::get_singleton()->mutex);
 						_script->pending_func_states.add(&gdfs->scripts_list);
 						if (p_instance) {
-							gdfs->state.instance = p_instance;
 							p_instance->pending_func_states.add(&gdfs->instances_list);
-						} else {
-							gdfs->state.instance = nullptr;
 						}
 					}
-#ifdef DEBUG_ENABLED
-					gdfs->state.function_name = name;
-					gdfs->state.script_path = _script->get_script_path();
-#endif
-					gdfs->state.defarg = defarg;
-					gdfs->function = this;
 
 					retvalue = gdfs;
 
-					Error err = sig.connect(Callable(gdfs.ptr(), "_signal_callback").bind(retvalue), Object::CONNECT_ONE_SHOT);
+					Error err = sig.connect(Callable(memnew(BRScriptFunctionStateCallable(gdfs))), Object::CONNECT_ONE_SHOT);
 					if (err != OK) {
 						err_text = "Error connecting to signal: " + sig.get_name() + " during await.";
 						OPCODE_BREAK;
@@ -3883,21 +4339,25 @@ Variant BRScriptFunction::call(BRScriptInstance *p_instance, const Variant **p_a
 		if (EngineDebugger::is_active()) {
 			BRScriptLanguage::get_singleton()->exit_function();
 		}
+	}
 #endif
 
-		// Free stack, except reserved addresses.
+	// Free stack, except reserved addresses. A resumed stack belongs to its function state, which frees it.
+	if (!p_state && !suspended) {
 		for (int i = FIXED_ADDRESSES_MAX; i < _stack_size; i++) {
 			stack[i].~Variant();
 		}
-#ifdef DEBUG_ENABLED
 	}
-#endif
 
 	// Always free reserved addresses, since they are never copied.
 	for (int i = 0; i < FIXED_ADDRESSES_MAX; i++) {
 		stack[i].~Variant();
 	}
 
+	if (unlikely(sampled)) {
+		BRScriptSamplingProfiler::pop_frame();
+	}
+
 	call_depth--;
 
 	return retvalue;
@@ -39,6 +39,7 @@
 #include "brscript_utility_functions.h"
 
 #ifdef TOOLS_ENABLED
+#include "brscript_aot.h"
 #include "editor/brscript_highlighter.h"
 #include "editor/brscript_translation_parser_plugin.h"
 
@@ -57,6 +58,7 @@
 #include "core/io/resource_loader.h"
 
 #ifdef TOOLS_ENABLED
+#include "core/config/project_settings.h"
 #include "editor/editor_node.h"
 #include "editor/editor_settings.h"
 #include "editor/editor_translation_parser.h"
@@ -86,18 +88,29 @@ class EditorExportBRScript : public EditorExportPlugin {
 	static constexpr int DEFAULT_SCRIPT_MODE = EditorExportPreset::MODE_SCRIPT_BINARY_TOKENS_COMPRESSED;
 	int script_mode = DEFAULT_SCRIPT_MODE;
 
+	// Where to write the engine module with the scripts translated to C++, if anywhere.
+	String native_module_path;
+	BRScriptAOT aot;
+
 protected:
+	virtual void _get_export_options(const Ref<EditorExportPlatform> &p_export_platform, List<EditorExportPlatform::ExportOption> *r_options) const override {
+		r_options->push_back(EditorExportPlatform::ExportOption(PropertyInfo(Variant::STRING, "brscript/native_module_path", PROPERTY_HINT_GLOBAL_DIR), ""));
+	}
+
 	virtual void _export_begin(const HashSet<String> &p_features, bool p_debug, const String &p_path, int p_flags) override {
 		script_mode = DEFAULT_SCRIPT_MODE;
+		native_module_path = String();
+		aot.clear();
 
 		const Ref<EditorExportPreset> &preset = get_export_preset();
 		if (preset.is_valid()) {
 			script_mode = preset->get_script_export_mode();
+			native_module_path = String(get_option("brscript/native_module_path")).strip_edges();
 		}
 	}
 
 	virtual void _export_file(const String &p_path, const String &p_type, const HashSet<String> &p_features) override {
-		if (p_path.get_extension() != "br" || script_mode == EditorExportPreset::MODE_SCRIPT_TEXT) {
+		if (p_path.get_extension() != "br" || (script_mode == EditorExportPreset::MODE_SCRIPT_TEXT && native_module_path.is_empty())) {
 			return;
 		}
 
@@ -108,6 +121,16 @@ protected:
 
 		String source;
 		source.parse_utf8(reinterpret_cast<const char *>(file.ptr()), file.size());
+
+		if (!native_module_path.is_empty()) {
+			// Scripts that don't compile are left to the VM, which reports the errors at runtime.
+			aot.add_script(p_path, source);
+		}
+
+		if (script_mode == EditorExportPreset::MODE_SCRIPT_TEXT) {
+			return;
+		}
+
 		BRScriptTokenizerBuffer::CompressMode compress_mode = script_mode == EditorExportPreset::MODE_SCRIPT_BINARY_TOKENS_COMPRESSED ? BRScriptTokenizerBuffer::COMPRESS_ZSTD : BRScriptTokenizerBuffer::COMPRESS_NONE;
 		file = BRScriptTokenizerBuffer::parse_code_string(source, compress_mode);
 		if (file.is_empty()) {
@@ -117,6 +140,14 @@ protected:
 		add_file(p_path.get_basename() + ".brc", file, true);
 	}
 
+	virtual void _export_end() override {
+		if (!native_module_path.is_empty() && !aot.is_empty()) {
+			// Built into the export template with `scons custom_modules=<parent directory>`.
+			aot.save_module(ProjectSettings::get_singleton()->globalize_path(native_module_path));
+		}
+		aot.clear();
+	}
+
 public:
 	virtual String get_name() const override { return "BRScript"; }
 };
@@ -0,0 +1,156 @@
+/**************************************************************************/
+/*  test_brscript_aot.h                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_BRSCRIPT_AOT_H
+#define TEST_BRSCRIPT_AOT_H
+
+#ifdef TOOLS_ENABLED
+
+#include "../brscript.h"
+#include "../brscript_aot.h"
+#include "../brscript_analyzer.h"
+#include "../brscript_cache.h"
+#include "../brscript_compiler.h"
+#include "../brscript_parser.h"
+
+#include "core/io/file_access.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_utils.h"
+
+namespace BRScriptTests {
+
+// Compiles the script the way exporting and release builds do.
+static Ref<BRScript> _compile_release_bytecode(const String &p_path, const String &p_source) {
+	BRScriptParser parser;
+	if (parser.parse(p_source, p_path, false) != OK) {
+		return Ref<BRScript>();
+	}
+	BRScriptAnalyzer analyzer(&parser);
+	if (analyzer.analyze() != OK) {
+		return Ref<BRScript>();
+	}
+
+	Ref<BRScript> script;
+	script.instantiate();
+	BRScriptCompiler compiler;
+	compiler.set_release_bytecode(true);
+	const Error error = compiler.compile(&parser, script.ptr(), false);
+	BRScriptCache::remove_script(String());
+	return error == OK ? script : Ref<BRScript>();
+}
+
+static int aot_native_calls = 0;
+
+// Stands in for exported code whose whole prefix is already done, the VM resumes at the entry point.
+static int _aot_native_at_entry(const BRScriptFunction::NativeContext &p_context) {
+	aot_native_calls++;
+	return 0;
+}
+
+TEST_CASE("[Modules][BRScript] Ahead-of-time native module") {
+	const String source = R"(
+extends RefCounted
+
+func sum_to(n: int) -> int:
+	var sum := 0
+	for i in n:
+		sum = sum + i
+	return sum
+
+func untyped(value):
+	return value.length()
+)";
+
+	BRScriptAOT aot;
+	ERR_PRINT_OFF;
+	const Error error = aot.add_script("res://aot_test.br", source);
+	ERR_PRINT_ON;
+	REQUIRE(error == OK);
+	// At least the typed loop has a native prefix.
+	CHECK_FALSE(aot.is_empty());
+
+	const String module_path = TestUtils::get_temp_path("brscript_aot_module");
+	REQUIRE(aot.save_module(module_path) == OK);
+
+	const String register_types = FileAccess::get_file_as_string(module_path.path_join("register_types.cpp"));
+	CHECK(register_types.contains("void initialize_brscript_aot_module_module(ModuleInitializationLevel p_level)"));
+	CHECK(register_types.contains("BRScriptAOT::register_function(\"res://aot_test.br::sum_to\""));
+	CHECK(FileAccess::exists(module_path.path_join("config.py")));
+	CHECK(FileAccess::exists(module_path.path_join("SCsub")));
+
+	SUBCASE("The bytecode compiled at runtime hashes as at export time") {
+		const String registration = "BRScriptAOT::register_function(\"res://aot_test.br::sum_to\", ";
+		const int hash_begin = register_types.find(registration) + registration.length();
+		const int hash_end = register_types.find("u,", hash_begin);
+		REQUIRE(hash_end > hash_begin);
+		const uint32_t exported_hash = register_types.substr(hash_begin, hash_end - hash_begin).to_int();
+
+		Ref<BRScript> script = _compile_release_bytecode("res://aot_test.br", source);
+		REQUIRE(script.is_valid());
+		BRScriptFunction *const *sum_to = script->get_member_functions().getptr("sum_to");
+		REQUIRE(sum_to);
+		CHECK(BRScriptAOT::hash_function(*sum_to) == exported_hash);
+	}
+
+	SUBCASE("Functions with native code run it and give the same results") {
+		Ref<BRScript> bytecode = _compile_release_bytecode("res://aot_test.br", source);
+		REQUIRE(bytecode.is_valid());
+		BRScriptFunction *const *bytecode_sum_to = bytecode->get_member_functions().getptr("sum_to");
+		REQUIRE(bytecode_sum_to);
+		CHECK((*bytecode_sum_to)->get_native_function() == nullptr);
+
+		BRScriptAOT::register_function("res://aot_test.br::sum_to", BRScriptAOT::hash_function(*bytecode_sum_to), _aot_native_at_entry);
+		Ref<BRScript> native = _compile_release_bytecode("res://aot_test.br", source);
+		BRScriptAOT::unregister_function("res://aot_test.br::sum_to");
+		REQUIRE(native.is_valid());
+		BRScriptFunction *const *native_sum_to = native->get_member_functions().getptr("sum_to");
+		REQUIRE(native_sum_to);
+		CHECK((*native_sum_to)->get_native_function() == _aot_native_at_entry);
+
+		Ref<RefCounted> bytecode_instance = memnew(RefCounted);
+		bytecode_instance->set_script(bytecode);
+		Ref<RefCounted> native_instance = memnew(RefCounted);
+		native_instance->set_script(native);
+
+		aot_native_calls = 0;
+		for (int n : { 0, 1, 10, 1000 }) {
+			CHECK(native_instance->call("sum_to", n) == bytecode_instance->call("sum_to", n));
+		}
+		CHECK(aot_native_calls == 4);
+	}
+}
+
+} // namespace BRScriptTests
+
+#endif // TOOLS_ENABLED
+
+#endif // TEST_BRSCRIPT_AOT_H
@@ -0,0 +1,177 @@
+/**************************************************************************/
+/*  test_brscript_benchmarks.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_BRSCRIPT_BENCHMARKS_H
+#define TEST_BRSCRIPT_BENCHMARKS_H
+
+#ifdef TOOLS_ENABLED
+
+#include "../brscript.h"
+#include "../brscript_byte_codegen.h"
+#include "test_brscript_vm.h"
+
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace BRScriptTests {
+
+// Untyped access goes through the per-site inline caches, typed access is resolved when compiling.
+static const char *named_access_source = R"(
+extends RefCounted
+
+class Mover:
+	var speed = 2
+	func step(delta):
+		return speed * delta
+
+func untyped_access(n):
+	var node = Node2D.new()
+	var mover = Mover.new()
+	var i = 0
+	while i < n:
+		node.position = node.position + Vector2(mover.step(1), 0)
+		mover.speed = mover.speed + 1
+		i += 1
+	node.free()
+
+func typed_access(n: int) -> void:
+	var node := Node2D.new()
+	var mover := Mover.new()
+	var i := 0
+	while i < n:
+		node.position = node.position + Vector2(mover.step(1), 0)
+		mover.speed = mover.speed + 1
+		i += 1
+	node.free()
+)";
+
+// Every worker awaits the same signal, so each emission resumes and suspends all of them once.
+static const char *coroutines_source = R"(
+extends RefCounted
+
+signal tick
+
+var finished := 0
+
+func worker(frames: int) -> void:
+	for i in frames:
+		await tick
+	finished += 1
+
+func start(count: int, frames: int) -> void:
+	for i in count:
+		worker(frames)
+)";
+
+TEST_CASE_BENCHMARK("[Modules][BRScript][Benchmark] Numeric kernels") {
+	Ref<RefCounted> instance = _instantiate_source(numeric_kernels_source);
+	// The same source compiled without the typed operator opcodes is the baseline they have to beat: typed
+	// operands then go through the validated operator evaluators.
+	const bool was_enabled = BRScriptByteCodeGenerator::is_typed_operators_enabled();
+	BRScriptByteCodeGenerator::set_typed_operators_enabled(false);
+	Ref<RefCounted> validated_instance = _instantiate_source(numeric_kernels_source);
+	BRScriptByteCodeGenerator::set_typed_operators_enabled(was_enabled);
+
+	struct Kernel {
+		const char *name;
+		int argument;
+	};
+	// Arguments are picked so every kernel runs for about the same time.
+	const Kernel kernels[] = {
+		{ "int_kernel", 2000000 },
+		{ "float_kernel", 2000000 },
+		{ "nbody", 20000 },
+		{ "mandelbrot", 200 },
+		{ "matmul", 60 },
+	};
+	const double target_speedup = 3.0;
+
+	for (const Kernel &kernel : kernels) {
+		const StringName untyped_method = String(kernel.name) + "_untyped";
+		const StringName typed_method = String(kernel.name) + "_typed";
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		instance->call(untyped_method, kernel.argument);
+		const uint64_t untyped = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		validated_instance->call(typed_method, kernel.argument);
+		const uint64_t validated = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		instance->call(typed_method, kernel.argument);
+		const uint64_t typed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+
+		const double speedup = double(validated) / typed;
+		MESSAGE(kernel.name, ": untyped ", untyped, " usec, validated operators ", validated, " usec, typed opcodes ", typed, " usec, speedup over validated ", speedup, "x (target ", target_speedup, "x, ", speedup >= target_speedup ? "met" : "missed", "), over untyped ", double(untyped) / typed, "x");
+	}
+}
+
+TEST_CASE_BENCHMARK("[Modules][BRScript][Benchmark] Duck-typed property and method access") {
+	Ref<RefCounted> instance = _instantiate_source(named_access_source);
+	const int iterations = 500000;
+
+	uint64_t elapsed[2];
+	for (int typed = 0; typed < 2; typed++) {
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		instance->call(typed ? "typed_access" : "untyped_access", iterations);
+		elapsed[typed] = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+	}
+	MESSAGE("untyped ", elapsed[0], " usec (", (uint64_t)iterations * 1000000 / elapsed[0], " iterations/s), typed ", elapsed[1], " usec (", (uint64_t)iterations * 1000000 / elapsed[1], " iterations/s)");
+}
+
+TEST_CASE_BENCHMARK("[Modules][BRScript][Benchmark] Awaiting coroutines") {
+	Ref<RefCounted> instance = _instantiate_source(coroutines_source);
+	const int coroutines = 50000;
+	const int frames = 20;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	instance->call("start", coroutines, frames);
+	const uint64_t start_elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+
+	uint64_t slowest_frame = 0;
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < frames; i++) {
+		uint64_t frame_begin = OS::get_singleton()->get_ticks_usec();
+		instance->emit_signal(SNAME("tick"));
+		slowest_frame = MAX(slowest_frame, OS::get_singleton()->get_ticks_usec() - frame_begin);
+	}
+	const uint64_t resume_elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+
+	CHECK(int(instance->get("finished")) == coroutines);
+	MESSAGE(coroutines, " coroutines: started in ", start_elapsed, " usec, ", frames, " frames in ", resume_elapsed, " usec (", (uint64_t)coroutines * frames * 1000000 / resume_elapsed, " resumes/s, slowest frame ", slowest_frame, " usec)");
+}
+
+} // namespace BRScriptTests
+
+#endif // TOOLS_ENABLED
+
+#endif // TEST_BRSCRIPT_BENCHMARKS_H
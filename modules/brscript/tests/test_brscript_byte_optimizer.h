@@ -0,0 +1,113 @@
+/**************************************************************************/
+/*  test_brscript_byte_optimizer.h                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_BRSCRIPT_BYTE_OPTIMIZER_H
+#define TEST_BRSCRIPT_BYTE_OPTIMIZER_H
+
+#include "../brscript.h"
+#include "../brscript_byte_optimizer.h"
+
+#include "tests/test_macros.h"
+
+namespace BRScriptTests {
+
+static Ref<BRScript> compile_for_optimizer_test(const String &p_source, bool p_optimize) {
+	const bool was_enabled = BRScriptByteCodeOptimizer::is_enabled();
+	BRScriptByteCodeOptimizer::set_enabled(p_optimize);
+	Ref<BRScript> brscript = memnew(BRScript);
+	brscript->set_source_code(p_source);
+	const Error error = brscript->reload();
+	BRScriptByteCodeOptimizer::set_enabled(was_enabled);
+	return error == OK ? brscript : Ref<BRScript>();
+}
+
+TEST_CASE("[Modules][BRScript] Bytecode optimizer") {
+	const String source = R"(
+extends RefCounted
+
+func folded() -> int:
+	var a := 6
+	var b := 7
+	return a * b + 1
+
+func branch(value: int) -> String:
+	var limit := 10
+	if limit > 5:
+		return "big %d" % value
+	return "small"
+
+func loop(count: int) -> float:
+	var origin := Vector2(3, 4)
+	var sum := 0.0
+	for i in count:
+		sum += origin.x * origin.y
+	return sum
+
+func unknown(a: int, b: int) -> int:
+	var total := 0
+	while a > 0:
+		total += b
+		a -= 1
+	return total
+)";
+
+	Ref<BRScript> plain = compile_for_optimizer_test(source, false);
+	Ref<BRScript> optimized = compile_for_optimizer_test(source, true);
+	REQUIRE(plain.is_valid());
+	REQUIRE(optimized.is_valid());
+
+	Ref<RefCounted> plain_instance = memnew(RefCounted);
+	plain_instance->set_script(plain);
+	Ref<RefCounted> optimized_instance = memnew(RefCounted);
+	optimized_instance->set_script(optimized);
+
+	SUBCASE("Results don't change") {
+		CHECK(optimized_instance->call("folded") == Variant(43));
+		CHECK(optimized_instance->call("folded") == plain_instance->call("folded"));
+		CHECK(optimized_instance->call("branch", 3) == Variant("big 3"));
+		CHECK(optimized_instance->call("loop", 4) == Variant(48.0));
+		CHECK(optimized_instance->call("loop", 4) == plain_instance->call("loop", 4));
+		CHECK(optimized_instance->call("unknown", 5, 3) == Variant(15));
+		CHECK(optimized_instance->call("unknown", 0, 3) == Variant(0));
+	}
+
+	SUBCASE("Bytecode gets shorter") {
+		for (const StringName name : { "folded", "branch", "loop" }) {
+			const BRScriptFunction *before = plain->get_member_functions()[name];
+			const BRScriptFunction *after = optimized->get_member_functions()[name];
+			CHECK_MESSAGE(after->get_code_size() < before->get_code_size(), name);
+		}
+	}
+}
+
+} // namespace BRScriptTests
+
+#endif // TEST_BRSCRIPT_BYTE_OPTIMIZER_H
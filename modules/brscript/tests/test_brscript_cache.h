@@ -0,0 +1,168 @@
+/**************************************************************************/
+/*  test_brscript_cache.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_BRSCRIPT_CACHE_H
+#define TEST_BRSCRIPT_CACHE_H
+
+#include "../brscript_cache.h"
+#include "../brscript_parser.h"
+
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_utils.h"
+
+namespace BRScriptTests {
+
+TEST_CASE("[Modules][BRScript] Token cache") {
+	const String source = R"(
+extends RefCounted
+
+# Comments are not part of the tokens.
+func double(value: int) -> int:
+	return value * 2
+)";
+
+	const String cache_path = TestUtils::get_temp_path("brscript_token_cache");
+	BRScriptCache::set_token_cache_path(cache_path);
+
+	// First parse tokenizes and saves, second parse reads the saved tokens.
+	for (int i = 0; i < 2; i++) {
+		BRScriptParser parser;
+		CHECK(BRScriptCache::parse_source(&parser, source, "res://token_cache_test.br") == OK);
+		CHECK(parser.get_errors().is_empty());
+		REQUIRE(parser.get_tree() != nullptr);
+		CHECK(parser.get_tree()->has_member("double"));
+	}
+
+	Ref<DirAccess> dir = DirAccess::open(cache_path);
+	REQUIRE(dir.is_valid());
+	CHECK(dir->file_exists(String("res://token_cache_test.br").md5_text() + ".brtc"));
+
+	SUBCASE("Errors are reported from the source") {
+		BRScriptParser parser;
+		ERR_PRINT_OFF;
+		CHECK(BRScriptCache::parse_source(&parser, "func broken(:\n\tpass\n", "res://token_cache_error.br") != OK);
+		ERR_PRINT_ON;
+		REQUIRE_FALSE(parser.get_errors().is_empty());
+		CHECK(parser.get_errors().front()->get().line == 1);
+	}
+
+	BRScriptCache::set_token_cache_path(String());
+}
+
+TEST_CASE("[Modules][BRScript] Token cache pruning") {
+	const String source = "extends RefCounted\nfunc half(value: float) -> float:\n\treturn value / 2.0\n";
+	const String scripts_dir = TestUtils::get_temp_path("brscript_token_cache_scripts");
+	REQUIRE(DirAccess::make_dir_recursive_absolute(scripts_dir) == OK);
+	const String kept_path = scripts_dir.path_join("kept.br");
+	const String removed_path = scripts_dir.path_join("removed.br");
+	Ref<FileAccess> f = FileAccess::open(kept_path, FileAccess::WRITE);
+	REQUIRE(f.is_valid());
+	f->store_string(source);
+	f.unref();
+
+	const String cache_path = TestUtils::get_temp_path("brscript_token_cache_pruning");
+	BRScriptCache::set_token_cache_path(cache_path);
+	for (const String &path : { kept_path, removed_path }) {
+		BRScriptParser parser;
+		CHECK(BRScriptCache::parse_source(&parser, source, path) == OK);
+	}
+	f = FileAccess::open(cache_path.path_join("damaged.brtc"), FileAccess::WRITE);
+	REQUIRE(f.is_valid());
+	f->store_string("Not cached tokens.");
+	f.unref();
+
+	// Setting the path again prunes the cache, clearing it waits for that to finish.
+	BRScriptCache::set_token_cache_path(cache_path);
+	BRScriptCache::set_token_cache_path(String());
+
+	Ref<DirAccess> da = DirAccess::open(cache_path);
+	REQUIRE(da.is_valid());
+	CHECK(da->file_exists(kept_path.md5_text() + ".brtc"));
+	CHECK_FALSE(da->file_exists(removed_path.md5_text() + ".brtc"));
+	CHECK_FALSE(da->file_exists("damaged.brtc"));
+
+	da->remove(kept_path.md5_text() + ".brtc");
+	da = DirAccess::open(scripts_dir);
+	REQUIRE(da.is_valid());
+	da->remove("kept.br");
+}
+
+TEST_CASE("[Modules][BRScript] Parsing scripts ahead of time") {
+	const String dir = TestUtils::get_temp_path("brscript_preparse");
+	REQUIRE(DirAccess::make_dir_recursive_absolute(dir) == OK);
+
+	const String valid_path = dir.path_join("preparse_valid.br");
+	const String broken_path = dir.path_join("preparse_broken.br");
+	Ref<FileAccess> f = FileAccess::open(valid_path, FileAccess::WRITE);
+	REQUIRE(f.is_valid());
+	f->store_string("extends RefCounted\nfunc triple(value: int) -> int:\n\treturn value * 3\n");
+	f = FileAccess::open(broken_path, FileAccess::WRITE);
+	REQUIRE(f.is_valid());
+	f->store_string("func broken(:\n\tpass\n");
+	f.unref();
+
+	Vector<String> paths;
+	paths.push_back(valid_path);
+	paths.push_back(broken_path);
+	paths.push_back(dir.path_join("preparse_missing.br"));
+	BRScriptCache::preparse_scripts(paths);
+	BRScriptCache::wait_for_preparse();
+
+	// Scripts with errors are left to be parsed, and report their errors, when loaded.
+	CHECK(BRScriptCache::has_parser(valid_path));
+	CHECK_FALSE(BRScriptCache::has_parser(broken_path));
+	CHECK_FALSE(BRScriptCache::has_parser(dir.path_join("preparse_missing.br")));
+
+	{
+		Error err = OK;
+		Ref<BRScriptParserRef> ref = BRScriptCache::get_parser(valid_path, BRScriptParserRef::PARSED, err);
+		CHECK(err == OK);
+		REQUIRE(ref.is_valid());
+		CHECK(ref->get_status() == BRScriptParserRef::PARSED);
+		REQUIRE(ref->get_parser()->get_tree() != nullptr);
+		CHECK(ref->get_parser()->get_tree()->has_member("triple"));
+	}
+
+	// The cache let go of the parser when it was requested, so it's freed with the last reference.
+	CHECK_FALSE(BRScriptCache::has_parser(valid_path));
+
+	Ref<DirAccess> da = DirAccess::open(dir);
+	REQUIRE(da.is_valid());
+	da->remove("preparse_valid.br");
+	da->remove("preparse_broken.br");
+}
+
+} // namespace BRScriptTests
+
+#endif // TEST_BRSCRIPT_CACHE_H
@@ -0,0 +1,78 @@
+/**************************************************************************/
+/*  test_brscript_sampling_profiler.h                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_BRSCRIPT_SAMPLING_PROFILER_H
+#define TEST_BRSCRIPT_SAMPLING_PROFILER_H
+
+#ifdef THREADS_ENABLED
+
+#include "../brscript.h"
+#include "../brscript_sampling_profiler.h"
+
+#include "tests/test_macros.h"
+
+namespace BRScriptTests {
+
+TEST_CASE("[Modules][BRScript] Sampling profiler") {
+	Ref<BRScript> brscript = memnew(BRScript);
+	brscript->set_source_code(R"(
+extends RefCounted
+
+func busy(msec: int) -> void:
+	var start := Time.get_ticks_msec()
+	while Time.get_ticks_msec() - start < msec:
+		pass
+)");
+	REQUIRE(brscript->reload() == OK);
+
+	Ref<RefCounted> instance = memnew(RefCounted);
+	instance->set_script(brscript);
+
+	BRScriptSamplingProfiler::clear();
+	BRScriptSamplingProfiler::start(200);
+	instance->call("busy", 100);
+	BRScriptSamplingProfiler::stop();
+
+	const String folded = BRScriptSamplingProfiler::get_folded_stacks();
+	CHECK(folded.contains("Main Thread;busy (<built-in>:4)"));
+	// Each line ends with its sample count.
+	const Vector<String> lines = folded.strip_edges().split("\n");
+	REQUIRE_FALSE(lines.is_empty());
+	CHECK(lines[0].get_slice(" ", lines[0].get_slice_count(" ") - 1).to_int() > 0);
+
+	BRScriptSamplingProfiler::clear();
+}
+
+} // namespace BRScriptTests
+
+#endif // THREADS_ENABLED
+
+#endif // TEST_BRSCRIPT_SAMPLING_PROFILER_H
@@ -0,0 +1,339 @@
+/**************************************************************************/
+/*  test_brscript_vm.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+
+#ifndef TEST_BRSCRIPT_VM_H
+#define TEST_BRSCRIPT_VM_H
+
+#include "../brscript.h"
+
+#include "tests/test_macros.h"
+
+namespace BRScriptTests {
+
+// The same kernels are written with and without static types, so the untyped variants measure the generic
+// operator path while the typed ones go through the dedicated int/float opcodes.
+static const char *numeric_kernels_source = R"(
+extends RefCounted
+
+func float_kernel_typed(n: int) -> float:
+	var acc := 0.0
+	var x := 0.0
+	var i := 0
+	while i < n:
+		acc = acc + x * x - x / 3.0
+		if acc > 1000000.0:
+			acc = acc - 1000000.0
+		x = x + 0.5
+		i = i + 1
+	return acc
+
+func float_kernel_untyped(n):
+	var acc = 0.0
+	var x = 0.0
+	var i = 0
+	while i < n:
+		acc = acc + x * x - x / 3.0
+		if acc > 1000000.0:
+			acc = acc - 1000000.0
+		x = x + 0.5
+		i = i + 1
+	return acc
+
+func int_kernel_typed(n: int) -> int:
+	var sum := 0
+	var i := 0
+	while i < n:
+		sum = sum + i * 3 - (i - 1)
+		if sum >= 1000000:
+			sum = sum - 1000000
+		i = i + 1
+	return sum
+
+func int_kernel_untyped(n):
+	var sum = 0
+	var i = 0
+	while i < n:
+		sum = sum + i * 3 - (i - 1)
+		if sum >= 1000000:
+			sum = sum - 1000000
+		i = i + 1
+	return sum
+
+func nbody_typed(n: int) -> float:
+	var count := 5
+	var px := PackedFloat64Array()
+	var py := PackedFloat64Array()
+	var vx := PackedFloat64Array()
+	var vy := PackedFloat64Array()
+	var mass := PackedFloat64Array()
+	for b in count:
+		px.push_back(float(b) - 2.0)
+		py.push_back(float(b * b) * 0.25)
+		vx.push_back(0.0)
+		vy.push_back(float(b) * 0.1)
+		mass.push_back(1.0 + float(b) * 0.5)
+	var dt := 0.01
+	var step := 0
+	while step < n:
+		var i := 0
+		while i < count:
+			var j := i + 1
+			while j < count:
+				var dx := px[i] - px[j]
+				var dy := py[i] - py[j]
+				var dist2 := dx * dx + dy * dy + 0.01
+				var mag := dt / (dist2 * sqrt(dist2))
+				vx[i] = vx[i] - dx * mass[j] * mag
+				vy[i] = vy[i] - dy * mass[j] * mag
+				vx[j] = vx[j] + dx * mass[i] * mag
+				vy[j] = vy[j] + dy * mass[i] * mag
+				j = j + 1
+			i = i + 1
+		i = 0
+		while i < count:
+			px[i] = px[i] + dt * vx[i]
+			py[i] = py[i] + dt * vy[i]
+			i = i + 1
+		step = step + 1
+	var energy := 0.0
+	for b in count:
+		energy = energy + 0.5 * mass[b] * (vx[b] * vx[b] + vy[b] * vy[b])
+	return energy
+
+func nbody_untyped(n):
+	var count = 5
+	var px = PackedFloat64Array()
+	var py = PackedFloat64Array()
+	var vx = PackedFloat64Array()
+	var vy = PackedFloat64Array()
+	var mass = PackedFloat64Array()
+	for b in count:
+		px.push_back(float(b) - 2.0)
+		py.push_back(float(b * b) * 0.25)
+		vx.push_back(0.0)
+		vy.push_back(float(b) * 0.1)
+		mass.push_back(1.0 + float(b) * 0.5)
+	var dt = 0.01
+	var step = 0
+	while step < n:
+		var i = 0
+		while i < count:
+			var j = i + 1
+			while j < count:
+				var dx = px[i] - px[j]
+				var dy = py[i] - py[j]
+				var dist2 = dx * dx + dy * dy + 0.01
+				var mag = dt / (dist2 * sqrt(dist2))
+				vx[i] = vx[i] - dx * mass[j] * mag
+				vy[i] = vy[i] - dy * mass[j] * mag
+				vx[j] = vx[j] + dx * mass[i] * mag
+				vy[j] = vy[j] + dy * mass[i] * mag
+				j = j + 1
+			i = i + 1
+		i = 0
+		while i < count:
+			px[i] = px[i] + dt * vx[i]
+			py[i] = py[i] + dt * vy[i]
+			i = i + 1
+		step = step + 1
+	var energy = 0.0
+	for b in count:
+		energy = energy + 0.5 * mass[b] * (vx[b] * vx[b] + vy[b] * vy[b])
+	return energy
+
+func mandelbrot_typed(size: int) -> int:
+	var inside := 0
+	var y := 0
+	while y < size:
+		var ci := 2.0 * float(y) / float(size) - 1.0
+		var x := 0
+		while x < size:
+			var cr := 2.5 * float(x) / float(size) - 2.0
+			var zr := 0.0
+			var zi := 0.0
+			var k := 0
+			while k < 50 and zr * zr + zi * zi <= 4.0:
+				var t := zr * zr - zi * zi + cr
+				zi = 2.0 * zr * zi + ci
+				zr = t
+				k = k + 1
+			if k == 50:
+				inside = inside + 1
+			x = x + 1
+		y = y + 1
+	return inside
+
+func mandelbrot_untyped(size):
+	var inside = 0
+	var y = 0
+	while y < size:
+		var ci = 2.0 * float(y) / float(size) - 1.0
+		var x = 0
+		while x < size:
+			var cr = 2.5 * float(x) / float(size) - 2.0
+			var zr = 0.0
+			var zi = 0.0
+			var k = 0
+			while k < 50 and zr * zr + zi * zi <= 4.0:
+				var t = zr * zr - zi * zi + cr
+				zi = 2.0 * zr * zi + ci
+				zr = t
+				k = k + 1
+			if k == 50:
+				inside = inside + 1
+			x = x + 1
+		y = y + 1
+	return inside
+
+func matmul_typed(size: int) -> float:
+	var a := PackedFloat64Array()
+	var b := PackedFloat64Array()
+	var c := PackedFloat64Array()
+	a.resize(size * size)
+	b.resize(size * size)
+	c.resize(size * size)
+	var i := 0
+	while i < size * size:
+		a[i] = float(i % 7) * 0.5
+		b[i] = float(i % 5) - 1.0
+		i = i + 1
+	var row := 0
+	while row < size:
+		var col := 0
+		while col < size:
+			var sum := 0.0
+			var k := 0
+			while k < size:
+				sum = sum + a[row * size + k] * b[k * size + col]
+				k = k + 1
+			c[row * size + col] = sum
+			col = col + 1
+		row = row + 1
+	var trace := 0.0
+	i = 0
+	while i < size:
+		trace = trace + c[i * size + i]
+		i = i + 1
+	return trace
+
+func matmul_untyped(size):
+	var a = PackedFloat64Array()
+	var b = PackedFloat64Array()
+	var c = PackedFloat64Array()
+	a.resize(size * size)
+	b.resize(size * size)
+	c.resize(size * size)
+	var i = 0
+	while i < size * size:
+		a[i] = float(i % 7) * 0.5
+		b[i] = float(i % 5) - 1.0
+		i = i + 1
+	var row = 0
+	while row < size:
+		var col = 0
+		while col < size:
+			var sum = 0.0
+			var k = 0
+			while k < size:
+				sum = sum + a[row * size + k] * b[k * size + col]
+				k = k + 1
+			c[row * size + col] = sum
+			col = col + 1
+		row = row + 1
+	var trace = 0.0
+	i = 0
+	while i < size:
+		trace = trace + c[i * size + i]
+		i = i + 1
+	return trace
+)";
+
+static Ref<RefCounted> _instantiate_source(const String &p_source) {
+	Ref<BRScript> brscript = memnew(BRScript);
+	brscript->set_source_code(p_source);
+	ERR_PRINT_OFF;
+	const Error error = brscript->reload();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(error == OK, "The benchmark script should parse successfully.");
+
+	Ref<RefCounted> instance = memnew(RefCounted);
+	instance->set_script(brscript);
+	return instance;
+}
+
+TEST_CASE("[Modules][BRScript] Typed arithmetic matches untyped arithmetic") {
+	Ref<RefCounted> instance = _instantiate_source(numeric_kernels_source);
+
+	CHECK(int64_t(instance->call("int_kernel_typed", 1000)) == int64_t(instance->call("int_kernel_untyped", 1000)));
+	CHECK(double(instance->call("float_kernel_typed", 1000)) == doctest::Approx(double(instance->call("float_kernel_untyped", 1000))));
+	CHECK(double(instance->call("nbody_typed", 100)) == doctest::Approx(double(instance->call("nbody_untyped", 100))));
+	CHECK(int64_t(instance->call("mandelbrot_typed", 20)) == int64_t(instance->call("mandelbrot_untyped", 20)));
+	CHECK(double(instance->call("matmul_typed", 8)) == doctest::Approx(double(instance->call("matmul_untyped", 8))));
+}
+
+TEST_CASE("[Modules][BRScript] Inline caches keep hitting after scripts are reloaded") {
+	Ref<BRScript> accessor = memnew(BRScript);
+	accessor->set_source_code("extends RefCounted\nfunc access(target):\n\treturn target.value\n");
+	REQUIRE(accessor->reload() == OK);
+	Ref<RefCounted> accessor_instance = memnew(RefCounted);
+	accessor_instance->set_script(accessor);
+
+	BRScriptFunction *const *access = accessor->get_member_functions().getptr("access");
+	REQUIRE(access);
+	REQUIRE((*access)->get_inline_cache_count() == 1);
+
+	Ref<BRScript> other = memnew(BRScript);
+	other->set_source_code("extends RefCounted\nvar value = -1\n");
+	REQUIRE(other->reload() == OK);
+	Ref<RefCounted> other_instance = memnew(RefCounted);
+	other_instance->set_script(other);
+	CHECK(int(accessor_instance->call("access", other_instance)) == -1);
+
+	Ref<BRScript> target = memnew(BRScript);
+	// Every reload starts a new epoch for the script, more of them than the cache has entries.
+	for (uint32_t i = 0; i < BRScriptFunction::InlineCache::MAX_ENTRIES * 2; i++) {
+		target->set_source_code(vformat("extends RefCounted\nvar value = %d\n", i));
+		REQUIRE(target->reload() == OK);
+		Ref<RefCounted> target_instance = memnew(RefCounted);
+		target_instance->set_script(target);
+
+		CHECK_FALSE((*access)->has_inline_cache_entry(0, target_instance));
+		CHECK(int(accessor_instance->call("access", target_instance)) == int(i));
+		CHECK((*access)->has_inline_cache_entry(0, target_instance));
+		CHECK(int(accessor_instance->call("access", target_instance)) == int(i));
+
+		// Only the entries of the reloaded script are invalidated.
+		CHECK((*access)->has_inline_cache_entry(0, other_instance));
+	}
+}
+
+} // namespace BRScriptTests
+
+#endif // TEST_BRSCRIPT_VM_H
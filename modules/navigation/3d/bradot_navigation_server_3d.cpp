@@ -1315,6 +1315,8 @@ void BradotNavigationServer3D::sync() {
 }
 
 void BradotNavigationServer3D::process(real_t p_delta_time) {
+	MemoryTagScope memory_tag_scope(Memory::TAG_NAVIGATION);
+
 	flush_queries();
 
 	if (!active) {
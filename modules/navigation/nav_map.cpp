@@ -433,7 +433,9 @@ void NavMap::sync() {
 		};
 
 		// Group all edges per key.
-		HashMap<gd::EdgeKey, ConnectionPair, gd::EdgeKey> connection_pairs_map;
+		// This and the free edges are only needed during the sync, so they come from the frame allocator.
+		typedef HashMap<gd::EdgeKey, ConnectionPair, gd::EdgeKey, HashMapComparatorDefault<gd::EdgeKey>, FrameTypedAllocator<HashMapElement<gd::EdgeKey, ConnectionPair>>> ConnectionPairsMap;
+		ConnectionPairsMap connection_pairs_map;
 		connection_pairs_map.reserve(polygons.size());
 		int free_edges_count = 0; // How many ConnectionPairs have only one Connection.
 
@@ -442,7 +444,7 @@ void NavMap::sync() {
 				const int next_point = (p + 1) % poly.points.size();
 				const gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
 
-				HashMap<gd::EdgeKey, ConnectionPair, gd::EdgeKey>::Iterator pair_it = connection_pairs_map.find(ek);
+				ConnectionPairsMap::Iterator pair_it = connection_pairs_map.find(ek);
 				if (!pair_it) {
 					pair_it = connection_pairs_map.insert(ek, ConnectionPair());
 					_new_pm_edge_count += 1;
@@ -470,7 +472,7 @@ void NavMap::sync() {
 			}
 		}
 
-		LocalVector<gd::Edge::Connection> free_edges;
+		LocalVector<gd::Edge::Connection, uint32_t, false, false, FrameAllocator> free_edges;
 		free_edges.reserve(free_edges_count);
 
 		for (const KeyValue<gd::EdgeKey, ConnectionPair> &pair_it : connection_pairs_map) {
@@ -623,7 +625,6 @@ void NavMap::sync() {
 				new_polygon.edges.clear();
 				new_polygon.edges.resize(4);
 				new_polygon.points.clear();
-				new_polygon.points.reserve(4);
 
 				// Build a set of vertices that create a thin polygon going from the start to the end point.
 				new_polygon.points.push_back({ closest_start_point, get_point_key(closest_start_point) });
@@ -36,6 +36,7 @@
 #include "core/templates/hash_map.h"
 #include "core/templates/hashfuncs.h"
 #include "core/templates/local_vector.h"
+#include "core/templates/small_vector.h"
 
 class NavBase;
 
@@ -105,11 +106,15 @@ struct Polygon {
 	/// Navigation region or link that contains this polygon.
 	const NavBase *owner = nullptr;
 
+	/// Baked polygons have up to 6 vertices by default, those are kept inline so building and
+	/// copying polygons when the map syncs doesn't allocate.
+	static constexpr uint32_t INLINE_POINTS = 6;
+
 	/// The points of this `Polygon`
-	LocalVector<Point> points;
+	SmallVector<Point, INLINE_POINTS> points;
 
 	/// The edges of this `Polygon`
-	LocalVector<Edge> edges;
+	SmallVector<Edge, INLINE_POINTS> edges;
 
 	real_t surface_area = 0.0;
 };
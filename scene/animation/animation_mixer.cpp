@@ -1870,11 +1870,11 @@ void AnimationMixer::_blend_apply() {
 				TrackCacheAudio *t = static_cast<TrackCacheAudio *>(track);
 
 				// Audio ending process.
-				LocalVector<ObjectID> erase_maps;
+				LocalVector<ObjectID, uint32_t, false, false, FrameAllocator> erase_maps;
 				for (KeyValue<ObjectID, PlayingAudioTrackInfo> &L : t->playing_streams) {
 					PlayingAudioTrackInfo &track_info = L.value;
 					float db = Math::linear_to_db(track_info.use_blend ? track_info.volume : 1.0);
-					LocalVector<int> erase_streams;
+					LocalVector<int, uint32_t, false, false, FrameAllocator> erase_streams;
 					AHashMap<int, PlayingAudioStreamInfo> &map = track_info.stream_info;
 					for (const KeyValue<int, PlayingAudioStreamInfo> &M : map) {
 						PlayingAudioStreamInfo pasi = M.value;
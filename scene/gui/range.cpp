@@ -46,7 +46,7 @@ void Range::_value_changed(double p_value) {
 }
 void Range::_value_changed_notify() {
 	_value_changed(shared->val);
-	emit_signal(SceneStringName(value_changed), shared->val);
+	emit_signal_handle(value_changed_signal, shared->val);
 	queue_redraw();
 }
 
@@ -375,6 +375,7 @@ bool Range::is_lesser_allowed() const {
 }
 
 Range::Range() {
+	value_changed_signal = SignalHandle(SceneStringName(value_changed));
 	shared = memnew(Shared);
 	shared->owners.insert(this);
 }
@@ -53,6 +53,7 @@ class Range : public Control {
 	};
 
 	Shared *shared = nullptr;
+	SignalHandle value_changed_signal;
 
 	void _ref_shared(Shared *p_shared);
 	void _unref_shared();
@@ -796,6 +796,7 @@ public:
 	virtual void get_meta_list(List<StringName> *p_list) const override;
 
 	virtual Error emit_signalp(const StringName &p_name, const Variant **p_args, int p_argcount) override;
+	virtual Error emit_signal_handlep(SignalHandle &p_handle, const Variant **p_args, int p_argcount) override;
 	virtual bool has_signal(const StringName &p_name) const override;
 	virtual void get_signal_list(List<MethodInfo> *p_signals) const override;
 	virtual void get_signal_connection_list(const StringName &p_signal, List<Connection> *p_connections) const override;
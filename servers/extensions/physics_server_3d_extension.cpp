@@ -168,6 +168,9 @@ void PhysicsServer3DExtension::_bind_methods() {
 	BRVIRTUAL_BIND(_space_get_contacts, "space");
 	BRVIRTUAL_BIND(_space_get_contact_count, "space");
 
+	BRVIRTUAL_BIND(_space_get_state, "space");
+	BRVIRTUAL_BIND(_space_set_state, "space", "state");
+
 	/* AREA API */
 
 	BRVIRTUAL_BIND(_area_create);
@@ -202,6 +205,9 @@ void PhysicsServer3DExtension::_bind_methods() {
 	BRVIRTUAL_BIND(_area_set_collision_mask, "area", "mask");
 	BRVIRTUAL_BIND(_area_get_collision_mask, "area");
 
+	BRVIRTUAL_BIND(_area_set_state_id, "area", "id");
+	BRVIRTUAL_BIND(_area_get_state_id, "area");
+
 	BRVIRTUAL_BIND(_area_set_monitorable, "area", "monitorable");
 	BRVIRTUAL_BIND(_area_set_ray_pickable, "area", "enable");
 
@@ -248,6 +254,9 @@ void PhysicsServer3DExtension::_bind_methods() {
 	BRVIRTUAL_BIND(_body_set_collision_priority, "body", "priority");
 	BRVIRTUAL_BIND(_body_get_collision_priority, "body");
 
+	BRVIRTUAL_BIND(_body_set_state_id, "body", "id");
+	BRVIRTUAL_BIND(_body_get_state_id, "body");
+
 	BRVIRTUAL_BIND(_body_set_user_flags, "body", "flags");
 	BRVIRTUAL_BIND(_body_get_user_flags, "body");
 
@@ -321,6 +330,9 @@ void PhysicsServer3DExtension::_bind_methods() {
 	BRVIRTUAL_BIND(_soft_body_set_collision_mask, "body", "mask");
 	BRVIRTUAL_BIND(_soft_body_get_collision_mask, "body");
 
+	BRVIRTUAL_BIND(_soft_body_set_state_id, "body", "id");
+	BRVIRTUAL_BIND(_soft_body_get_state_id, "body");
+
 	BRVIRTUAL_BIND(_soft_body_add_collision_exception, "body", "body_b");
 	BRVIRTUAL_BIND(_soft_body_remove_collision_exception, "body", "body_b");
 	BRVIRTUAL_BIND(_soft_body_get_collision_exceptions, "body");
@@ -244,6 +244,9 @@ public:
 	EXBIND1RC(Vector<Vector3>, space_get_contacts, RID)
 	EXBIND1RC(int, space_get_contact_count, RID)
 
+	EXBIND1RC(Vector<uint8_t>, space_get_state, RID)
+	EXBIND2(space_set_state, RID, const Vector<uint8_t> &)
+
 	/* AREA API */
 
 	//EXBIND0RID(area);
@@ -279,6 +282,9 @@ public:
 	EXBIND2(area_set_collision_mask, RID, uint32_t)
 	EXBIND1RC(uint32_t, area_get_collision_mask, RID)
 
+	EXBIND2(area_set_state_id, RID, uint64_t)
+	EXBIND1RC(uint64_t, area_get_state_id, RID)
+
 	EXBIND2(area_set_monitorable, RID, bool)
 	EXBIND2(area_set_ray_pickable, RID, bool)
 
@@ -323,6 +329,9 @@ public:
 	EXBIND2(body_set_collision_priority, RID, real_t)
 	EXBIND1RC(real_t, body_get_collision_priority, RID)
 
+	EXBIND2(body_set_state_id, RID, uint64_t)
+	EXBIND1RC(uint64_t, body_get_state_id, RID)
+
 	EXBIND2(body_set_user_flags, RID, uint32_t)
 	EXBIND1RC(uint32_t, body_get_user_flags, RID)
 
@@ -421,6 +430,9 @@ public:
 	EXBIND2(soft_body_set_collision_mask, RID, uint32_t)
 	EXBIND1RC(uint32_t, soft_body_get_collision_mask, RID)
 
+	EXBIND2(soft_body_set_state_id, RID, uint64_t)
+	EXBIND1RC(uint64_t, soft_body_get_state_id, RID)
+
 	EXBIND2(soft_body_add_collision_exception, RID, RID)
 	EXBIND2(soft_body_remove_collision_exception, RID, RID)
 
@@ -450,6 +450,140 @@ Dictionary PhysicsDirectSpaceState2D::_get_rest_info(const Ref<PhysicsShapeQuery
 	return r;
 }
 
+Dictionary PhysicsDirectSpaceState2D::_intersect_ray_batch(const Ref<PhysicsRayQueryParameters2D> &p_ray_query, const PackedVector2Array &p_from, const PackedVector2Array &p_to) {
+	ERR_FAIL_COND_V(!p_ray_query.is_valid(), Dictionary());
+	ERR_FAIL_COND_V_MSG(p_from.size() != p_to.size(), Dictionary(), "The arrays of ray origins and ends must have the same size.");
+
+	const int count = p_from.size();
+	Vector<RayResult> results;
+	results.resize(count);
+	intersect_ray_batch(p_ray_query->get_parameters(), p_from.ptr(), p_to.ptr(), count, results.ptrw());
+
+	PackedVector2Array positions;
+	PackedVector2Array normals;
+	PackedInt64Array collider_ids;
+	PackedInt32Array shapes;
+	TypedArray<RID> rids;
+	positions.resize(count);
+	normals.resize(count);
+	collider_ids.resize(count);
+	shapes.resize(count);
+	rids.resize(count);
+
+	Vector2 *positions_ptrw = positions.ptrw();
+	Vector2 *normals_ptrw = normals.ptrw();
+	int64_t *collider_ids_ptrw = collider_ids.ptrw();
+	int32_t *shapes_ptrw = shapes.ptrw();
+	for (int i = 0; i < count; i++) {
+		const RayResult &result = results[i];
+		positions_ptrw[i] = result.position;
+		normals_ptrw[i] = result.normal;
+		collider_ids_ptrw[i] = int64_t(result.collider_id);
+		shapes_ptrw[i] = result.shape;
+		rids[i] = result.rid;
+	}
+
+	Dictionary d;
+	d["position"] = positions;
+	d["normal"] = normals;
+	d["collider_id"] = collider_ids;
+	d["shape"] = shapes;
+	d["rid"] = rids;
+
+	return d;
+}
+
+Dictionary PhysicsDirectSpaceState2D::_intersect_shape_batch(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query, const PackedVector2Array &p_origins, int p_max_results) {
+	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Dictionary());
+	ERR_FAIL_COND_V(p_max_results <= 0, Dictionary());
+
+	const int count = p_origins.size();
+	Vector<ShapeResult> results;
+	results.resize(count * p_max_results);
+	PackedInt32Array counts;
+	counts.resize(count);
+	intersect_shape_batch(p_shape_query->get_parameters(), p_origins.ptr(), count, results.ptrw(), p_max_results, counts.ptrw());
+
+	PackedInt64Array collider_ids;
+	PackedInt32Array shapes;
+	TypedArray<RID> rids;
+	collider_ids.resize(results.size());
+	shapes.resize(results.size());
+	rids.resize(results.size());
+
+	int64_t *collider_ids_ptrw = collider_ids.ptrw();
+	int32_t *shapes_ptrw = shapes.ptrw();
+	for (int i = 0; i < results.size(); i++) {
+		const ShapeResult &result = results[i];
+		collider_ids_ptrw[i] = int64_t(result.collider_id);
+		shapes_ptrw[i] = result.shape;
+		rids[i] = result.rid;
+	}
+
+	Dictionary d;
+	d["count"] = counts;
+	d["collider_id"] = collider_ids;
+	d["shape"] = shapes;
+	d["rid"] = rids;
+
+	return d;
+}
+
+Vector<real_t> PhysicsDirectSpaceState2D::_cast_motion_batch(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query, const PackedVector2Array &p_origins, const PackedVector2Array &p_motions) {
+	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Vector<real_t>());
+	ERR_FAIL_COND_V_MSG(p_origins.size() != p_motions.size(), Vector<real_t>(), "The arrays of shape origins and motions must have the same size.");
+
+	const int count = p_origins.size();
+	Vector<real_t> closest_safe;
+	Vector<real_t> closest_unsafe;
+	closest_safe.resize(count);
+	closest_unsafe.resize(count);
+	cast_motion_batch(p_shape_query->get_parameters(), p_origins.ptr(), p_motions.ptr(), count, closest_safe.ptrw(), closest_unsafe.ptrw());
+
+	Vector<real_t> ret;
+	ret.resize(count * 2);
+	real_t *ret_ptrw = ret.ptrw();
+	for (int i = 0; i < count; i++) {
+		ret_ptrw[i * 2 + 0] = closest_safe[i];
+		ret_ptrw[i * 2 + 1] = closest_unsafe[i];
+	}
+	return ret;
+}
+
+int PhysicsDirectSpaceState2D::intersect_ray_batch(const RayParameters &p_parameters, const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results) {
+	RayParameters parameters = p_parameters;
+	int hits = 0;
+	for (int i = 0; i < p_count; i++) {
+		parameters.from = p_from[i];
+		parameters.to = p_to[i];
+		if (intersect_ray(parameters, r_results[i])) {
+			hits++;
+		} else {
+			r_results[i] = RayResult();
+		}
+	}
+	return hits;
+}
+
+void PhysicsDirectSpaceState2D::intersect_shape_batch(const ShapeParameters &p_parameters, const Vector2 *p_origins, int p_count, ShapeResult *r_results, int p_result_max, int *r_result_counts) {
+	ShapeParameters parameters = p_parameters;
+	for (int i = 0; i < p_count; i++) {
+		parameters.transform.set_origin(p_origins[i]);
+		r_result_counts[i] = intersect_shape(parameters, r_results + i * p_result_max, p_result_max);
+	}
+}
+
+void PhysicsDirectSpaceState2D::cast_motion_batch(const ShapeParameters &p_parameters, const Vector2 *p_origins, const Vector2 *p_motions, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) {
+	ShapeParameters parameters = p_parameters;
+	for (int i = 0; i < p_count; i++) {
+		parameters.transform.set_origin(p_origins[i]);
+		parameters.motion = p_motions[i];
+		r_closest_safe[i] = 1.0;
+		r_closest_unsafe[i] = 1.0;
+		cast_motion(parameters, r_closest_safe[i], r_closest_unsafe[i]);
+	}
+}
+
 PhysicsDirectSpaceState2D::PhysicsDirectSpaceState2D() {
 }
 
@@ -460,6 +594,9 @@ void PhysicsDirectSpaceState2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("cast_motion", "parameters"), &PhysicsDirectSpaceState2D::_cast_motion);
 	ClassDB::bind_method(D_METHOD("collide_shape", "parameters", "max_results"), &PhysicsDirectSpaceState2D::_collide_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("get_rest_info", "parameters"), &PhysicsDirectSpaceState2D::_get_rest_info);
+	ClassDB::bind_method(D_METHOD("intersect_ray_batch", "parameters", "from", "to"), &PhysicsDirectSpaceState2D::_intersect_ray_batch);
+	ClassDB::bind_method(D_METHOD("intersect_shape_batch", "parameters", "origins", "max_results"), &PhysicsDirectSpaceState2D::_intersect_shape_batch, DEFVAL(32));
+	ClassDB::bind_method(D_METHOD("cast_motion_batch", "parameters", "origins", "motions"), &PhysicsDirectSpaceState2D::_cast_motion_batch);
 }
 
 ///////////////////////////////
@@ -124,6 +124,9 @@ class PhysicsDirectSpaceState2D : public Object {
 	Vector<real_t> _cast_motion(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query);
 	TypedArray<Vector2> _collide_shape(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query, int p_max_results = 32);
 	Dictionary _get_rest_info(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query);
+	Dictionary _intersect_ray_batch(const Ref<PhysicsRayQueryParameters2D> &p_ray_query, const PackedVector2Array &p_from, const PackedVector2Array &p_to);
+	Dictionary _intersect_shape_batch(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query, const PackedVector2Array &p_origins, int p_max_results = 32);
+	Vector<real_t> _cast_motion_batch(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query, const PackedVector2Array &p_origins, const PackedVector2Array &p_motions);
 
 protected:
 	static void _bind_methods();
@@ -199,6 +202,13 @@ public:
 	virtual bool collide_shape(const ShapeParameters &p_parameters, Vector2 *r_results, int p_result_max, int &r_result_count) = 0;
 	virtual bool rest_info(const ShapeParameters &p_parameters, ShapeRestInfo *r_info) = 0;
 
+	// Run many queries sharing the same parameters at once, with the ray or shape placed differently for each.
+	// Results are written at the query index, with `p_result_max` entries per query for shape intersections.
+	// By default they run one after the other, servers can override them to spread the work across threads.
+	virtual int intersect_ray_batch(const RayParameters &p_parameters, const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results);
+	virtual void intersect_shape_batch(const ShapeParameters &p_parameters, const Vector2 *p_origins, int p_count, ShapeResult *r_results, int p_result_max, int *r_result_counts);
+	virtual void cast_motion_batch(const ShapeParameters &p_parameters, const Vector2 *p_origins, const Vector2 *p_motions, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe);
+
 	PhysicsDirectSpaceState2D();
 };
 
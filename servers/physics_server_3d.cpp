@@ -477,6 +477,145 @@ Dictionary PhysicsDirectSpaceState3D::_get_rest_info(const Ref<PhysicsShapeQuery
 	return r;
 }
 
+Dictionary PhysicsDirectSpaceState3D::_intersect_ray_batch(const Ref<PhysicsRayQueryParameters3D> &p_ray_query, const PackedVector3Array &p_from, const PackedVector3Array &p_to) {
+	ERR_FAIL_COND_V(!p_ray_query.is_valid(), Dictionary());
+	ERR_FAIL_COND_V_MSG(p_from.size() != p_to.size(), Dictionary(), "The arrays of ray origins and ends must have the same size.");
+
+	const int count = p_from.size();
+	Vector<RayResult> results;
+	results.resize(count);
+	intersect_ray_batch(p_ray_query->get_parameters(), p_from.ptr(), p_to.ptr(), count, results.ptrw());
+
+	PackedVector3Array positions;
+	PackedVector3Array normals;
+	PackedInt32Array face_indices;
+	PackedInt64Array collider_ids;
+	PackedInt32Array shapes;
+	TypedArray<RID> rids;
+	positions.resize(count);
+	normals.resize(count);
+	face_indices.resize(count);
+	collider_ids.resize(count);
+	shapes.resize(count);
+	rids.resize(count);
+
+	Vector3 *positions_ptrw = positions.ptrw();
+	Vector3 *normals_ptrw = normals.ptrw();
+	int32_t *face_indices_ptrw = face_indices.ptrw();
+	int64_t *collider_ids_ptrw = collider_ids.ptrw();
+	int32_t *shapes_ptrw = shapes.ptrw();
+	for (int i = 0; i < count; i++) {
+		const RayResult &result = results[i];
+		positions_ptrw[i] = result.position;
+		normals_ptrw[i] = result.normal;
+		face_indices_ptrw[i] = result.face_index;
+		collider_ids_ptrw[i] = int64_t(result.collider_id);
+		shapes_ptrw[i] = result.shape;
+		rids[i] = result.rid;
+	}
+
+	Dictionary d;
+	d["position"] = positions;
+	d["normal"] = normals;
+	d["face_index"] = face_indices;
+	d["collider_id"] = collider_ids;
+	d["shape"] = shapes;
+	d["rid"] = rids;
+
+	return d;
+}
+
+Dictionary PhysicsDirectSpaceState3D::_intersect_shape_batch(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, const PackedVector3Array &p_origins, int p_max_results) {
+	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Dictionary());
+	ERR_FAIL_COND_V(p_max_results <= 0, Dictionary());
+
+	const int count = p_origins.size();
+	Vector<ShapeResult> results;
+	results.resize(count * p_max_results);
+	PackedInt32Array counts;
+	counts.resize(count);
+	intersect_shape_batch(p_shape_query->get_parameters(), p_origins.ptr(), count, results.ptrw(), p_max_results, counts.ptrw());
+
+	PackedInt64Array collider_ids;
+	PackedInt32Array shapes;
+	TypedArray<RID> rids;
+	collider_ids.resize(results.size());
+	shapes.resize(results.size());
+	rids.resize(results.size());
+
+	int64_t *collider_ids_ptrw = collider_ids.ptrw();
+	int32_t *shapes_ptrw = shapes.ptrw();
+	for (int i = 0; i < results.size(); i++) {
+		const ShapeResult &result = results[i];
+		collider_ids_ptrw[i] = int64_t(result.collider_id);
+		shapes_ptrw[i] = result.shape;
+		rids[i] = result.rid;
+	}
+
+	Dictionary d;
+	d["count"] = counts;
+	d["collider_id"] = collider_ids;
+	d["shape"] = shapes;
+	d["rid"] = rids;
+
+	return d;
+}
+
+Vector<real_t> PhysicsDirectSpaceState3D::_cast_motion_batch(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, const PackedVector3Array &p_origins, const PackedVector3Array &p_motions) {
+	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Vector<real_t>());
+	ERR_FAIL_COND_V_MSG(p_origins.size() != p_motions.size(), Vector<real_t>(), "The arrays of shape origins and motions must have the same size.");
+
+	const int count = p_origins.size();
+	Vector<real_t> closest_safe;
+	Vector<real_t> closest_unsafe;
+	closest_safe.resize(count);
+	closest_unsafe.resize(count);
+	cast_motion_batch(p_shape_query->get_parameters(), p_origins.ptr(), p_motions.ptr(), count, closest_safe.ptrw(), closest_unsafe.ptrw());
+
+	Vector<real_t> ret;
+	ret.resize(count * 2);
+	real_t *ret_ptrw = ret.ptrw();
+	for (int i = 0; i < count; i++) {
+		ret_ptrw[i * 2 + 0] = closest_safe[i];
+		ret_ptrw[i * 2 + 1] = closest_unsafe[i];
+	}
+	return ret;
+}
+
+int PhysicsDirectSpaceState3D::intersect_ray_batch(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results) {
+	RayParameters parameters = p_parameters;
+	int hits = 0;
+	for (int i = 0; i < p_count; i++) {
+		parameters.from = p_from[i];
+		parameters.to = p_to[i];
+		if (intersect_ray(parameters, r_results[i])) {
+			hits++;
+		} else {
+			r_results[i] = RayResult();
+		}
+	}
+	return hits;
+}
+
+void PhysicsDirectSpaceState3D::intersect_shape_batch(const ShapeParameters &p_parameters, const Vector3 *p_origins, int p_count, ShapeResult *r_results, int p_result_max, int *r_result_counts) {
+	ShapeParameters parameters = p_parameters;
+	for (int i = 0; i < p_count; i++) {
+		parameters.transform.origin = p_origins[i];
+		r_result_counts[i] = intersect_shape(parameters, r_results + i * p_result_max, p_result_max);
+	}
+}
+
+void PhysicsDirectSpaceState3D::cast_motion_batch(const ShapeParameters &p_parameters, const Vector3 *p_origins, const Vector3 *p_motions, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) {
+	ShapeParameters parameters = p_parameters;
+	for (int i = 0; i < p_count; i++) {
+		parameters.transform.origin = p_origins[i];
+		parameters.motion = p_motions[i];
+		r_closest_safe[i] = 1.0;
+		r_closest_unsafe[i] = 1.0;
+		cast_motion(parameters, r_closest_safe[i], r_closest_unsafe[i]);
+	}
+}
+
 PhysicsDirectSpaceState3D::PhysicsDirectSpaceState3D() {
 }
 
@@ -487,6 +626,9 @@ void PhysicsDirectSpaceState3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("cast_motion", "parameters"), &PhysicsDirectSpaceState3D::_cast_motion);
 	ClassDB::bind_method(D_METHOD("collide_shape", "parameters", "max_results"), &PhysicsDirectSpaceState3D::_collide_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("get_rest_info", "parameters"), &PhysicsDirectSpaceState3D::_get_rest_info);
+	ClassDB::bind_method(D_METHOD("intersect_ray_batch", "parameters", "from", "to"), &PhysicsDirectSpaceState3D::_intersect_ray_batch);
+	ClassDB::bind_method(D_METHOD("intersect_shape_batch", "parameters", "origins", "max_results"), &PhysicsDirectSpaceState3D::_intersect_shape_batch, DEFVAL(32));
+	ClassDB::bind_method(D_METHOD("cast_motion_batch", "parameters", "origins", "motions"), &PhysicsDirectSpaceState3D::_cast_motion_batch);
 }
 
 ///////////////////////////////
@@ -717,6 +859,8 @@ void PhysicsServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("space_set_param", "space", "param", "value"), &PhysicsServer3D::space_set_param);
 	ClassDB::bind_method(D_METHOD("space_get_param", "space", "param"), &PhysicsServer3D::space_get_param);
 	ClassDB::bind_method(D_METHOD("space_get_direct_state", "space"), &PhysicsServer3D::space_get_direct_state);
+	ClassDB::bind_method(D_METHOD("space_get_state", "space"), &PhysicsServer3D::space_get_state);
+	ClassDB::bind_method(D_METHOD("space_set_state", "space", "state"), &PhysicsServer3D::space_set_state);
 
 	ClassDB::bind_method(D_METHOD("area_create"), &PhysicsServer3D::area_create);
 	ClassDB::bind_method(D_METHOD("area_set_space", "area", "space"), &PhysicsServer3D::area_set_space);
@@ -740,6 +884,9 @@ void PhysicsServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("area_set_collision_mask", "area", "mask"), &PhysicsServer3D::area_set_collision_mask);
 	ClassDB::bind_method(D_METHOD("area_get_collision_mask", "area"), &PhysicsServer3D::area_get_collision_mask);
 
+	ClassDB::bind_method(D_METHOD("area_set_state_id", "area", "id"), &PhysicsServer3D::area_set_state_id);
+	ClassDB::bind_method(D_METHOD("area_get_state_id", "area"), &PhysicsServer3D::area_get_state_id);
+
 	ClassDB::bind_method(D_METHOD("area_set_param", "area", "param", "value"), &PhysicsServer3D::area_set_param);
 	ClassDB::bind_method(D_METHOD("area_set_transform", "area", "transform"), &PhysicsServer3D::area_set_transform);
 
@@ -772,6 +919,9 @@ void PhysicsServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("body_set_collision_priority", "body", "priority"), &PhysicsServer3D::body_set_collision_priority);
 	ClassDB::bind_method(D_METHOD("body_get_collision_priority", "body"), &PhysicsServer3D::body_get_collision_priority);
 
+	ClassDB::bind_method(D_METHOD("body_set_state_id", "body", "id"), &PhysicsServer3D::body_set_state_id);
+	ClassDB::bind_method(D_METHOD("body_get_state_id", "body"), &PhysicsServer3D::body_get_state_id);
+
 	ClassDB::bind_method(D_METHOD("body_add_shape", "body", "shape", "transform", "disabled"), &PhysicsServer3D::body_add_shape, DEFVAL(Transform3D()), DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("body_set_shape", "body", "shape_idx", "shape"), &PhysicsServer3D::body_set_shape);
 	ClassDB::bind_method(D_METHOD("body_set_shape_transform", "body", "shape_idx", "transform"), &PhysicsServer3D::body_set_shape_transform);
@@ -859,6 +1009,9 @@ void PhysicsServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("soft_body_set_collision_mask", "body", "mask"), &PhysicsServer3D::soft_body_set_collision_mask);
 	ClassDB::bind_method(D_METHOD("soft_body_get_collision_mask", "body"), &PhysicsServer3D::soft_body_get_collision_mask);
 
+	ClassDB::bind_method(D_METHOD("soft_body_set_state_id", "body", "id"), &PhysicsServer3D::soft_body_set_state_id);
+	ClassDB::bind_method(D_METHOD("soft_body_get_state_id", "body"), &PhysicsServer3D::soft_body_get_state_id);
+
 	ClassDB::bind_method(D_METHOD("soft_body_add_collision_exception", "body", "body_b"), &PhysicsServer3D::soft_body_add_collision_exception);
 	ClassDB::bind_method(D_METHOD("soft_body_remove_collision_exception", "body", "body_b"), &PhysicsServer3D::soft_body_remove_collision_exception);
 
@@ -1111,6 +1264,7 @@ void PhysicsServer3D::_bind_methods() {
 	BIND_ENUM_CONSTANT(SPACE_PARAM_BODY_ANGULAR_VELOCITY_SLEEP_THRESHOLD);
 	BIND_ENUM_CONSTANT(SPACE_PARAM_BODY_TIME_TO_SLEEP);
 	BIND_ENUM_CONSTANT(SPACE_PARAM_SOLVER_ITERATIONS);
+	BIND_ENUM_CONSTANT(SPACE_PARAM_DETERMINISTIC);
 
 	BIND_ENUM_CONSTANT(BODY_AXIS_LINEAR_X);
 	BIND_ENUM_CONSTANT(BODY_AXIS_LINEAR_Y);
@@ -1140,6 +1294,7 @@ PhysicsServer3D::PhysicsServer3D() {
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/3d/solver/contact_max_separation", PROPERTY_HINT_RANGE, "0,0.1,0.001,or_greater"), 0.05);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/3d/solver/contact_max_allowed_penetration", PROPERTY_HINT_RANGE, "0.001,0.1,0.001,or_greater"), 0.01);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/3d/solver/default_contact_bias", PROPERTY_HINT_RANGE, "0,1,0.01"), 0.8);
+	GLOBAL_DEF("physics/3d/solver/deterministic", false);
 }
 
 PhysicsServer3D::~PhysicsServer3D() {
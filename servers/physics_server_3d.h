@@ -130,6 +130,9 @@ private:
 	Vector<real_t> _cast_motion(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query);
 	TypedArray<Vector3> _collide_shape(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, int p_max_results = 32);
 	Dictionary _get_rest_info(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query);
+	Dictionary _intersect_ray_batch(const Ref<PhysicsRayQueryParameters3D> &p_ray_query, const PackedVector3Array &p_from, const PackedVector3Array &p_to);
+	Dictionary _intersect_shape_batch(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, const PackedVector3Array &p_origins, int p_max_results = 32);
+	Vector<real_t> _cast_motion_batch(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, const PackedVector3Array &p_origins, const PackedVector3Array &p_motions);
 
 protected:
 	static void _bind_methods();
@@ -208,6 +211,13 @@ public:
 
 	virtual Vector3 get_closest_point_to_object_volume(RID p_object, const Vector3 p_point) const = 0;
 
+	// Run many queries sharing the same parameters at once, with the ray or shape placed differently for each.
+	// Results are written at the query index, with `p_result_max` entries per query for shape intersections.
+	// By default they run one after the other, servers can override them to spread the work across threads.
+	virtual int intersect_ray_batch(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results);
+	virtual void intersect_shape_batch(const ShapeParameters &p_parameters, const Vector3 *p_origins, int p_count, ShapeResult *r_results, int p_result_max, int *r_result_counts);
+	virtual void cast_motion_batch(const ShapeParameters &p_parameters, const Vector3 *p_origins, const Vector3 *p_motions, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe);
+
 	PhysicsDirectSpaceState3D();
 };
 
@@ -297,6 +307,7 @@ public:
 		SPACE_PARAM_BODY_ANGULAR_VELOCITY_SLEEP_THRESHOLD,
 		SPACE_PARAM_BODY_TIME_TO_SLEEP,
 		SPACE_PARAM_SOLVER_ITERATIONS,
+		SPACE_PARAM_DETERMINISTIC,
 	};
 
 	virtual void space_set_param(RID p_space, SpaceParameter p_param, real_t p_value) = 0;
@@ -309,6 +320,9 @@ public:
 	virtual Vector<Vector3> space_get_contacts(RID p_space) const = 0;
 	virtual int space_get_contact_count(RID p_space) const = 0;
 
+	virtual Vector<uint8_t> space_get_state(RID p_space) const = 0;
+	virtual void space_set_state(RID p_space, const Vector<uint8_t> &p_state) = 0;
+
 	//missing space parameters
 
 	/* AREA API */
@@ -373,6 +387,9 @@ public:
 	virtual void area_set_collision_mask(RID p_area, uint32_t p_mask) = 0;
 	virtual uint32_t area_get_collision_mask(RID p_area) const = 0;
 
+	virtual void area_set_state_id(RID p_area, uint64_t p_id) = 0;
+	virtual uint64_t area_get_state_id(RID p_area) const = 0;
+
 	virtual void area_set_monitorable(RID p_area, bool p_monitorable) = 0;
 
 	virtual void area_set_monitor_callback(RID p_area, const Callable &p_callback) = 0;
@@ -432,6 +449,9 @@ public:
 	virtual void body_set_collision_priority(RID p_body, real_t p_priority) = 0;
 	virtual real_t body_get_collision_priority(RID p_body) const = 0;
 
+	virtual void body_set_state_id(RID p_body, uint64_t p_id) = 0;
+	virtual uint64_t body_get_state_id(RID p_body) const = 0;
+
 	virtual void body_set_user_flags(RID p_body, uint32_t p_flags) = 0;
 	virtual uint32_t body_get_user_flags(RID p_body) const = 0;
 
@@ -589,6 +609,9 @@ public:
 	virtual void soft_body_set_collision_mask(RID p_body, uint32_t p_mask) = 0;
 	virtual uint32_t soft_body_get_collision_mask(RID p_body) const = 0;
 
+	virtual void soft_body_set_state_id(RID p_body, uint64_t p_id) = 0;
+	virtual uint64_t soft_body_get_state_id(RID p_body) const = 0;
+
 	virtual void soft_body_add_collision_exception(RID p_body, RID p_body_b) = 0;
 	virtual void soft_body_remove_collision_exception(RID p_body, RID p_body_b) = 0;
 	virtual void soft_body_get_collision_exceptions(RID p_body, List<RID> *p_exceptions) = 0;
@@ -168,6 +168,9 @@ public:
 	virtual Vector<Vector3> space_get_contacts(RID p_space) const override { return Vector<Vector3>(); }
 	virtual int space_get_contact_count(RID p_space) const override { return 0; }
 
+	virtual Vector<uint8_t> space_get_state(RID p_space) const override { return Vector<uint8_t>(); }
+	virtual void space_set_state(RID p_space, const Vector<uint8_t> &p_state) override {}
+
 	/* AREA API */
 
 	virtual RID area_create() override { return RID(); }
@@ -203,6 +206,9 @@ public:
 	virtual void area_set_collision_mask(RID p_area, uint32_t p_mask) override {}
 	virtual uint32_t area_get_collision_mask(RID p_area) const override { return 0; }
 
+	virtual void area_set_state_id(RID p_area, uint64_t p_id) override {}
+	virtual uint64_t area_get_state_id(RID p_area) const override { return 0; }
+
 	virtual void area_set_monitorable(RID p_area, bool p_monitorable) override {}
 
 	virtual void area_set_monitor_callback(RID p_area, const Callable &p_callback) override {}
@@ -248,6 +254,9 @@ public:
 	virtual void body_set_collision_priority(RID p_body, real_t p_priority) override {}
 	virtual real_t body_get_collision_priority(RID p_body) const override { return 0; }
 
+	virtual void body_set_state_id(RID p_body, uint64_t p_id) override {}
+	virtual uint64_t body_get_state_id(RID p_body) const override { return 0; }
+
 	virtual void body_set_user_flags(RID p_body, uint32_t p_flags) override {}
 	virtual uint32_t body_get_user_flags(RID p_body) const override { return 0; }
 
@@ -323,6 +332,9 @@ public:
 	virtual void soft_body_set_collision_mask(RID p_body, uint32_t p_mask) override {}
 	virtual uint32_t soft_body_get_collision_mask(RID p_body) const override { return 0; }
 
+	virtual void soft_body_set_state_id(RID p_body, uint64_t p_id) override {}
+	virtual uint64_t soft_body_get_state_id(RID p_body) const override { return 0; }
+
 	virtual void soft_body_add_collision_exception(RID p_body, RID p_body_b) override {}
 	virtual void soft_body_remove_collision_exception(RID p_body, RID p_body_b) override {}
 	virtual void soft_body_get_collision_exceptions(RID p_body, List<RID> *p_exceptions) override {}
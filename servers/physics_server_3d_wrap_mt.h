@@ -129,6 +129,9 @@ public:
 		return physics_server_3d->space_get_contact_count(p_space);
 	}
 
+	FUNC1RC(Vector<uint8_t>, space_get_state, RID);
+	FUNC2(space_set_state, RID, const Vector<uint8_t> &);
+
 	/* AREA API */
 
 	//FUNC0RID(area);
@@ -163,6 +166,9 @@ public:
 	FUNC2(area_set_collision_mask, RID, uint32_t);
 	FUNC1RC(uint32_t, area_get_collision_mask, RID);
 
+	FUNC2(area_set_state_id, RID, uint64_t);
+	FUNC1RC(uint64_t, area_get_state_id, RID);
+
 	FUNC2(area_set_monitorable, RID, bool);
 	FUNC2(area_set_ray_pickable, RID, bool);
 
@@ -208,6 +214,9 @@ public:
 	FUNC2(body_set_collision_priority, RID, real_t);
 	FUNC1RC(real_t, body_get_collision_priority, RID);
 
+	FUNC2(body_set_state_id, RID, uint64_t);
+	FUNC1RC(uint64_t, body_get_state_id, RID);
+
 	FUNC2(body_set_user_flags, RID, uint32_t);
 	FUNC1RC(uint32_t, body_get_user_flags, RID);
 
@@ -288,6 +297,9 @@ public:
 	FUNC2(soft_body_set_collision_mask, RID, uint32_t)
 	FUNC1RC(uint32_t, soft_body_get_collision_mask, RID)
 
+	FUNC2(soft_body_set_state_id, RID, uint64_t)
+	FUNC1RC(uint64_t, soft_body_get_state_id, RID)
+
 	FUNC2(soft_body_add_collision_exception, RID, RID)
 	FUNC2(soft_body_remove_collision_exception, RID, RID)
 	FUNC2S(soft_body_get_collision_exceptions, RID, List<RID> *)
@@ -0,0 +1,388 @@
+/**************************************************************************/
+/*  test_batch_math.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_BATCH_MATH_H
+#define TEST_BATCH_MATH_H
+
+#include "core/math/batch_math.h"
+#include "core/math/projection.h"
+#include "core/math/random_pcg.h"
+#include "core/math/transform_3d.h"
+#include "core/os/os.h"
+#include "core/templates/local_vector.h"
+
+#include "tests/test_macros.h"
+
+namespace TestBatchMath {
+
+static Transform3D random_transform(RandomPCG &p_rng) {
+	Basis basis = Basis::from_euler(Vector3(p_rng.random(-Math_PI, Math_PI), p_rng.random(-Math_PI, Math_PI), p_rng.random(-Math_PI, Math_PI)));
+	basis.scale(Vector3(p_rng.random(0.1, 4.0), p_rng.random(0.1, 4.0), p_rng.random(0.1, 4.0)));
+	return Transform3D(basis, Vector3(p_rng.random(-100, 100), p_rng.random(-100, 100), p_rng.random(-100, 100)));
+}
+
+static Vector3 random_vector(RandomPCG &p_rng, real_t p_range) {
+	return Vector3(p_rng.random(-p_range, p_range), p_rng.random(-p_range, p_range), p_rng.random(-p_range, p_range));
+}
+
+static AABB random_aabb(RandomPCG &p_rng) {
+	return AABB(random_vector(p_rng, 100), Vector3(p_rng.random(0, 10), p_rng.random(0, 10), p_rng.random(0, 10)));
+}
+
+static bool is_aabb_equal_approx(const AABB &p_a, const AABB &p_b) {
+	// Relative to the magnitude, as the values can be in the hundreds.
+	const real_t tolerance = 1e-4;
+	return (p_a.position - p_b.position).length() <= tolerance * MAX(1, p_a.position.length()) &&
+			(p_a.size - p_b.size).length() <= tolerance * MAX(1, p_a.size.length());
+}
+
+TEST_CASE("[BatchMath] Transforming points") {
+	RandomPCG rng(7);
+	// Not a multiple of 4, to exercise the tail.
+	const uint32_t count = 103;
+	LocalVector<Vector3> points;
+	for (uint32_t i = 0; i < count; i++) {
+		points.push_back(random_vector(rng, 1000));
+	}
+	const Transform3D transform = random_transform(rng);
+
+	LocalVector<Vector3> result;
+	result.resize(count);
+	BatchMath::xform(transform, points.ptr(), result.ptr(), count);
+
+	LocalVector<Vector3> result_scalar;
+	result_scalar.resize(count);
+	BatchMath::set_simd_enabled(false);
+	BatchMath::xform(transform, points.ptr(), result_scalar.ptr(), count);
+	BatchMath::set_simd_enabled(true);
+
+	int mismatches = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		Vector3 expected = transform.xform(points[i]);
+		if (!result[i].is_equal_approx(expected) || result_scalar[i] != expected) {
+			mismatches++;
+		}
+	}
+	CHECK(mismatches == 0);
+
+	// In place.
+	LocalVector<Vector3> in_place = points;
+	BatchMath::xform(transform, in_place.ptr(), in_place.ptr(), count);
+	mismatches = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		if (in_place[i] != result[i]) {
+			mismatches++;
+		}
+	}
+	CHECK(mismatches == 0);
+
+	// Through the Vector API.
+	Vector<Vector3> vector;
+	for (uint32_t i = 0; i < count; i++) {
+		vector.push_back(points[i]);
+	}
+	vector = transform.xform(vector);
+	CHECK(vector.size() == (int)count);
+	CHECK(vector[count - 1] == result[count - 1]);
+}
+
+TEST_CASE("[BatchMath] Float array operations") {
+	RandomPCG rng(19);
+	const uint32_t count = 103;
+	LocalVector<float> a;
+	LocalVector<float> b;
+	for (uint32_t i = 0; i < count; i++) {
+		a.push_back(rng.random(-100.0f, 100.0f));
+		b.push_back(rng.random(-10.0f, 10.0f));
+	}
+
+	LocalVector<float> results[2];
+	float reductions[2][4];
+	for (int simd = 1; simd >= 0; simd--) {
+		BatchMath::set_simd_enabled(simd);
+		LocalVector<float> &r = results[simd];
+		r.resize(count);
+		BatchMath::lerp(a.ptr(), b.ptr(), 0.25f, r.ptr(), count);
+		BatchMath::multiply_add(r.ptr(), b.ptr(), a.ptr(), r.ptr(), count);
+		BatchMath::multiply(r.ptr(), 0.5f, r.ptr(), count);
+		BatchMath::clamp(r.ptr(), -50.0f, 50.0f, r.ptr(), count);
+		BatchMath::add(r.ptr(), b.ptr(), r.ptr(), count);
+
+		reductions[simd][0] = BatchMath::dot(a.ptr(), b.ptr(), count);
+		reductions[simd][1] = BatchMath::sum(a.ptr(), count);
+		reductions[simd][2] = BatchMath::min(a.ptr(), count);
+		reductions[simd][3] = BatchMath::max(a.ptr(), count);
+	}
+	BatchMath::set_simd_enabled(true);
+
+	int mismatches = 0;
+	float expected_min = a[0];
+	float expected_max = a[0];
+	double expected_dot = 0.0;
+	double expected_sum = 0.0;
+	for (uint32_t i = 0; i < count; i++) {
+		float expected = Math::lerp(a[i], b[i], 0.25f);
+		expected = expected * b[i] + a[i];
+		expected *= 0.5f;
+		expected = CLAMP(expected, -50.0f, 50.0f);
+		expected += b[i];
+		if (results[0][i] != expected || results[1][i] != expected) {
+			mismatches++;
+		}
+		expected_min = MIN(expected_min, a[i]);
+		expected_max = MAX(expected_max, a[i]);
+		expected_dot += (double)a[i] * b[i];
+		expected_sum += a[i];
+	}
+	CHECK(mismatches == 0);
+
+	// Sums are accumulated the same way on both paths.
+	for (int i = 0; i < 4; i++) {
+		CHECK(reductions[0][i] == reductions[1][i]);
+	}
+	CHECK(reductions[0][0] == doctest::Approx(expected_dot).epsilon(1e-4));
+	CHECK(reductions[0][1] == doctest::Approx(expected_sum).epsilon(1e-4));
+	CHECK(reductions[0][2] == expected_min);
+	CHECK(reductions[0][3] == expected_max);
+	CHECK(BatchMath::sum(a.ptr(), 0) == 0.0f);
+	CHECK(BatchMath::max(a.ptr(), 0) == 0.0f);
+
+	const double values[] = { 1.0, 2.0, 3.0, 4.0 };
+	double running[4];
+	BatchMath::prefix_sum(values, running, 4);
+	CHECK(running[0] == 1.0);
+	CHECK(running[3] == 10.0);
+}
+
+TEST_CASE("[BatchMath] Vector3 lengths and normalization") {
+	RandomPCG rng(23);
+	const uint32_t count = 103;
+	LocalVector<Vector3> vectors;
+	for (uint32_t i = 0; i < count; i++) {
+		vectors.push_back(random_vector(rng, 100));
+	}
+	vectors[5] = Vector3();
+
+	int mismatches = 0;
+	for (int simd = 1; simd >= 0; simd--) {
+		BatchMath::set_simd_enabled(simd);
+		LocalVector<float> lengths;
+		lengths.resize(count);
+		BatchMath::length(vectors.ptr(), lengths.ptr(), count);
+		LocalVector<Vector3> normalized = vectors;
+		BatchMath::normalize(normalized.ptr(), normalized.ptr(), count);
+
+		for (uint32_t i = 0; i < count; i++) {
+			if (lengths[i] != (float)vectors[i].length() || normalized[i] != vectors[i].normalized()) {
+				mismatches++;
+			}
+		}
+	}
+	BatchMath::set_simd_enabled(true);
+	CHECK(mismatches == 0);
+}
+
+TEST_CASE("[BatchMath] Bulk operations on packed arrays") {
+	Variant floats = PackedFloat32Array({ 1.0, 2.0, 3.0, 4.0, 5.0 });
+	floats.call("multiply_add_scalar", 2.0, 1.0);
+	floats.call("add_array", PackedFloat32Array({ 1.0, 1.0, 1.0, 1.0, 1.0 }));
+	CHECK(floats == Variant(PackedFloat32Array({ 4.0, 6.0, 8.0, 10.0, 12.0 })));
+	CHECK(floats.call("sum") == Variant(40.0));
+	CHECK(floats.call("max") == Variant(12.0));
+	floats.call("clamp", 5.0, 9.0);
+	floats.call("prefix_sum");
+	CHECK(floats == Variant(PackedFloat32Array({ 5.0, 11.0, 19.0, 28.0, 37.0 })));
+
+	ERR_PRINT_OFF;
+	floats.call("add_array", PackedFloat32Array({ 1.0 }));
+	ERR_PRINT_ON;
+	CHECK_MESSAGE(floats == Variant(PackedFloat32Array({ 5.0, 11.0, 19.0, 28.0, 37.0 })), "Arrays of different sizes should be left untouched.");
+
+	Variant vectors = PackedVector3Array({ Vector3(3, 0, 4), Vector3(), Vector3(0, 2, 0) });
+	CHECK(vectors.call("get_lengths") == Variant(PackedFloat32Array({ 5.0, 0.0, 2.0 })));
+	vectors.call("normalize");
+	CHECK(vectors == Variant(PackedVector3Array({ Vector3(0.6, 0, 0.8), Vector3(), Vector3(0, 1, 0) })));
+}
+
+TEST_CASE("[BatchMath] Transforming and merging AABBs") {
+	RandomPCG rng(11);
+	const uint32_t count = 50;
+	LocalVector<Transform3D> transforms;
+	LocalVector<AABB> aabbs;
+	for (uint32_t i = 0; i < count; i++) {
+		transforms.push_back(random_transform(rng));
+		aabbs.push_back(random_aabb(rng));
+	}
+
+	LocalVector<AABB> result;
+	result.resize(count);
+	AABB merged = BatchMath::xform_merge(transforms.ptr(), aabbs.ptr(), result.ptr(), count);
+
+	AABB expected_merged;
+	int mismatches = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		AABB expected = transforms[i].xform(aabbs[i]);
+		if (!is_aabb_equal_approx(result[i], expected)) {
+			mismatches++;
+		}
+		if (i == 0) {
+			expected_merged = expected;
+		} else {
+			expected_merged.merge_with(expected);
+		}
+	}
+	CHECK(mismatches == 0);
+	CHECK(is_aabb_equal_approx(merged, expected_merged));
+
+	BatchMath::set_simd_enabled(false);
+	AABB merged_scalar = BatchMath::xform_merge(transforms.ptr(), aabbs.ptr(), nullptr, count);
+	BatchMath::set_simd_enabled(true);
+	CHECK(merged_scalar == expected_merged);
+
+	// The last element must not write past the end of the array.
+	LocalVector<AABB> guarded;
+	guarded.resize(2);
+	guarded[1] = AABB(Vector3(1, 2, 3), Vector3(4, 5, 6));
+	AABB merged_one = BatchMath::xform_merge(transforms.ptr(), aabbs.ptr(), guarded.ptr(), 1);
+	CHECK(merged_one == guarded[0]);
+	CHECK(is_aabb_equal_approx(guarded[0], transforms[0].xform(aabbs[0])));
+	CHECK(guarded[1] == AABB(Vector3(1, 2, 3), Vector3(4, 5, 6)));
+
+	CHECK(BatchMath::xform_merge(transforms.ptr(), aabbs.ptr(), nullptr, 0) == AABB());
+}
+
+TEST_CASE("[BatchMath] Culling AABBs") {
+	RandomPCG rng(13);
+	const uint32_t count = 1000;
+	LocalVector<AABB> aabbs;
+	for (uint32_t i = 0; i < count; i++) {
+		aabbs.push_back(random_aabb(rng));
+	}
+
+	Projection projection;
+	projection.set_perspective(75, 1.5, 0.1, 80);
+	Vector<Plane> frustum = projection.get_projection_planes(Transform3D(Basis(), Vector3(0, 0, 20)));
+
+	// Also with a number of planes that needs several groups, and one that takes the scalar path.
+	Vector<Plane> many_planes = frustum;
+	for (int i = 0; i < 3; i++) {
+		many_planes.push_back(Plane(random_vector(rng, 1).normalized(), rng.random(20, 60)));
+	}
+	Vector<Plane> too_many_planes;
+	for (int i = 0; i < 20; i++) {
+		too_many_planes.push_back(Plane(random_vector(rng, 1).normalized(), rng.random(50, 100)));
+	}
+
+	for (const Vector<Plane> &planes : { frustum, many_planes, too_many_planes }) {
+		LocalVector<uint32_t> expected;
+		for (uint32_t i = 0; i < count; i++) {
+			if (aabbs[i].intersects_convex_shape(planes.ptr(), planes.size(), nullptr, 0)) {
+				expected.push_back(i);
+			}
+		}
+
+		LocalVector<uint32_t> visible;
+		visible.resize(count);
+		uint32_t visible_count = BatchMath::cull(planes.ptr(), planes.size(), aabbs.ptr(), count, visible.ptr());
+
+		// Results could only differ for boxes touching a plane, which random data is unlikely to produce.
+		REQUIRE(visible_count == expected.size());
+		bool same = true;
+		for (uint32_t i = 0; i < visible_count; i++) {
+			same = same && visible[i] == expected[i];
+		}
+		CHECK(same);
+		CHECK(visible_count > 0);
+		CHECK(visible_count < count);
+	}
+}
+
+TEST_CASE_BENCHMARK("[BatchMath][Benchmark] Kernels against the scalar path") {
+	RandomPCG rng(17);
+	const uint32_t count = 1 << 16;
+	const int iterations = 100;
+
+	LocalVector<Vector3> points;
+	LocalVector<Transform3D> transforms;
+	LocalVector<AABB> aabbs;
+	for (uint32_t i = 0; i < count; i++) {
+		points.push_back(random_vector(rng, 1000));
+		transforms.push_back(random_transform(rng));
+		aabbs.push_back(random_aabb(rng));
+	}
+	LocalVector<Vector3> points_out;
+	points_out.resize(count);
+	LocalVector<AABB> aabbs_out;
+	aabbs_out.resize(count);
+	LocalVector<uint32_t> indices;
+	indices.resize(count);
+
+	Projection projection;
+	projection.set_perspective(75, 1.5, 0.1, 80);
+	Vector<Plane> frustum = projection.get_projection_planes(Transform3D(Basis(), Vector3(0, 0, 20)));
+	const Transform3D transform = random_transform(rng);
+
+	MESSAGE("SIMD available: ", BatchMath::has_simd());
+
+	for (int simd = 1; simd >= 0; simd--) {
+		BatchMath::set_simd_enabled(simd);
+		const char *path = simd ? "SIMD" : "Scalar";
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < iterations; i++) {
+			BatchMath::xform(transform, points.ptr(), points_out.ptr(), count);
+		}
+		uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+		MESSAGE(path, " xform: ", (uint64_t)count * iterations * 1000000 / elapsed, " points/s");
+
+		AABB bounds;
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < iterations; i++) {
+			bounds = BatchMath::xform_merge(transforms.ptr(), aabbs.ptr(), aabbs_out.ptr(), count);
+		}
+		elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+		MESSAGE(path, " xform_merge: ", (uint64_t)count * iterations * 1000000 / elapsed, " AABBs/s");
+		CHECK(bounds.has_volume());
+
+		uint32_t visible = 0;
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < iterations; i++) {
+			visible = BatchMath::cull(frustum.ptr(), frustum.size(), aabbs.ptr(), count, indices.ptr());
+		}
+		elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+		MESSAGE(path, " cull: ", (uint64_t)count * iterations * 1000000 / elapsed, " AABBs/s (", visible, " visible)");
+	}
+	BatchMath::set_simd_enabled(true);
+}
+
+} // namespace TestBatchMath
+
+#endif // TEST_BATCH_MATH_H
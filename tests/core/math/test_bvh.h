@@ -0,0 +1,245 @@
+/**************************************************************************/
+/*  test_bvh.h                                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_BVH_H
+#define TEST_BVH_H
+
+#include "core/math/bvh.h"
+#include "core/math/random_number_generator.h"
+
+#include "tests/test_macros.h"
+
+class TestBVHInternalsAccessor {
+public:
+	template <typename M>
+	static bool bounds_enclose_contents(const M &p_bvh) {
+		return p_bvh.tree._debug_bounds_enclose_contents();
+	}
+
+	template <typename M, typename B>
+	static bool get_root_bound(const M &p_bvh, B &r_bound) {
+		return p_bvh.tree._debug_get_root_bound(0, r_bound);
+	}
+};
+
+namespace TestBVH {
+
+template <typename T>
+class UserPairTestFunction {
+public:
+	static bool user_pair_check(const T *p_a, const T *p_b) {
+		return true;
+	}
+};
+
+template <typename T>
+class UserCullTestFunction {
+public:
+	static bool user_cull_check(const T *p_a, const T *p_b) {
+		return true;
+	}
+};
+
+template <typename M, typename B, typename P>
+void check_packet_culls(M &p_bvh, const B *p_aabbs, const P *p_from, const P *p_to) {
+	constexpr int PACKET_SIZE = BVH_Packet<B, P>::SIZE;
+	constexpr int MAX_RESULTS = 256;
+
+	int *packet_results[PACKET_SIZE * MAX_RESULTS];
+	int *single_results[MAX_RESULTS];
+	int packet_counts[PACKET_SIZE];
+
+	// Bounding boxes are tested the same way, so the results should match exactly.
+	p_bvh.cull_aabb_packet(p_aabbs, PACKET_SIZE, packet_results, MAX_RESULTS, packet_counts, nullptr);
+	for (int lane = 0; lane < PACKET_SIZE; lane++) {
+		int single_count = p_bvh.cull_aabb(p_aabbs[lane], single_results, MAX_RESULTS, nullptr);
+		CHECK(packet_counts[lane] == single_count);
+		for (int i = 0; i < MIN(single_count, packet_counts[lane]); i++) {
+			CHECK(packet_results[lane * MAX_RESULTS + i] == single_results[i]);
+		}
+	}
+
+	// Segment tests in packets are conservative, so they must find at least every single hit.
+	p_bvh.cull_segment_packet(p_from, p_to, PACKET_SIZE, packet_results, MAX_RESULTS, packet_counts, nullptr);
+	for (int lane = 0; lane < PACKET_SIZE; lane++) {
+		int single_count = p_bvh.cull_segment(p_from[lane], p_to[lane], single_results, MAX_RESULTS, nullptr);
+		CHECK(packet_counts[lane] >= single_count);
+		for (int i = 0; i < single_count; i++) {
+			bool found = false;
+			for (int j = 0; j < packet_counts[lane]; j++) {
+				found = found || packet_results[lane * MAX_RESULTS + j] == single_results[i];
+			}
+			CHECK(found);
+		}
+	}
+}
+
+TEST_CASE("[BVH] Packet culls find the same items as single culls") {
+	Ref<RandomNumberGenerator> rng;
+	rng.instantiate();
+	rng->set_seed(42);
+
+	int items[200];
+
+	SUBCASE("3D") {
+		BVH_Manager<int, 1, false, 32, UserPairTestFunction<int>, UserCullTestFunction<int>> bvh;
+		for (int i = 0; i < 200; i++) {
+			Vector3 position(rng->randf_range(-50, 50), rng->randf_range(-50, 50), rng->randf_range(-50, 50));
+			bvh.create(&items[i], true, 0, 1, AABB(position, Vector3(rng->randf_range(0, 5), rng->randf_range(0, 5), 0)));
+		}
+
+		for (int n = 0; n < 50; n++) {
+			AABB aabbs[4];
+			Vector3 from[4];
+			Vector3 to[4];
+			for (int lane = 0; lane < 4; lane++) {
+				aabbs[lane] = AABB(Vector3(rng->randf_range(-60, 60), rng->randf_range(-60, 60), rng->randf_range(-60, 60)), Vector3(10, 10, 10));
+				from[lane] = Vector3(rng->randf_range(-60, 60), rng->randf_range(-60, 60), rng->randf_range(-60, 60));
+				to[lane] = Vector3(rng->randf_range(-60, 60), rng->randf_range(-60, 60), rng->randf_range(-60, 60));
+			}
+			// Segments parallel to an axis take a separate path.
+			to[0].y = from[0].y;
+			check_packet_culls(bvh, aabbs, from, to);
+		}
+	}
+
+	SUBCASE("2D") {
+		BVH_Manager<int, 1, false, 32, UserPairTestFunction<int>, UserCullTestFunction<int>, Rect2, Vector2> bvh;
+		for (int i = 0; i < 200; i++) {
+			Vector2 position(rng->randf_range(-50, 50), rng->randf_range(-50, 50));
+			bvh.create(&items[i], true, 0, 1, Rect2(position, Vector2(rng->randf_range(0, 5), rng->randf_range(0, 5))));
+		}
+
+		for (int n = 0; n < 50; n++) {
+			Rect2 aabbs[4];
+			Vector2 from[4];
+			Vector2 to[4];
+			for (int lane = 0; lane < 4; lane++) {
+				aabbs[lane] = Rect2(Vector2(rng->randf_range(-60, 60), rng->randf_range(-60, 60)), Vector2(10, 10));
+				from[lane] = Vector2(rng->randf_range(-60, 60), rng->randf_range(-60, 60));
+				to[lane] = Vector2(rng->randf_range(-60, 60), rng->randf_range(-60, 60));
+			}
+			to[0].x = from[0].x;
+			check_packet_culls(bvh, aabbs, from, to);
+		}
+	}
+}
+
+TEST_CASE("[BVH] Culls stay correct as items move, shrink and are erased") {
+	Ref<RandomNumberGenerator> rng;
+	rng.instantiate();
+	rng->set_seed(7);
+
+	const int count = 300;
+	int items[count];
+	AABB aabbs[count];
+	BVHHandle handles[count];
+	bool alive[count];
+
+	BVH_Manager<int, 1, false, 32, UserPairTestFunction<int>, UserCullTestFunction<int>> bvh;
+	for (int i = 0; i < count; i++) {
+		aabbs[i] = AABB(Vector3(rng->randf_range(-50, 50), rng->randf_range(-50, 50), rng->randf_range(-50, 50)), Vector3(4, 4, 4));
+		handles[i] = bvh.create(&items[i], true, 0, 1, aabbs[i]);
+		alive[i] = true;
+	}
+
+	// Only leaves that items left are refitted on update, the others must keep bounding their items.
+	for (int frame = 0; frame < 60; frame++) {
+		for (int n = 0; n < 20; n++) {
+			int i = rng->randi_range(0, count - 1);
+			if (!alive[i]) {
+				continue;
+			}
+			if (frame % 10 == 9 && n < 4) {
+				bvh.erase(handles[i]);
+				alive[i] = false;
+				continue;
+			}
+			aabbs[i] = AABB(Vector3(rng->randf_range(-50, 50), rng->randf_range(-50, 50), rng->randf_range(-50, 50)), Vector3(1, 1, 1) * rng->randf_range(0.1, 4));
+			bvh.move(handles[i], aabbs[i]);
+		}
+		bvh.update();
+		CHECK(TestBVHInternalsAccessor::bounds_enclose_contents(bvh));
+
+		AABB query(Vector3(rng->randf_range(-50, 50), rng->randf_range(-50, 50), rng->randf_range(-50, 50)), Vector3(20, 20, 20));
+		int *results[count];
+		int result_count = bvh.cull_aabb(query, results, count, nullptr);
+
+		int expected_count = 0;
+		for (int i = 0; i < count; i++) {
+			if (!alive[i] || !aabbs[i].intersects_inclusive(query)) {
+				continue;
+			}
+			expected_count++;
+			bool found = false;
+			for (int j = 0; j < result_count; j++) {
+				found = found || results[j] == &items[i];
+			}
+			CHECK(found);
+		}
+		CHECK(result_count == expected_count);
+	}
+}
+
+TEST_CASE("[BVH] Node bounds shrink on update after items leave") {
+	Ref<RandomNumberGenerator> rng;
+	rng.instantiate();
+	rng->set_seed(11);
+
+	// Enough items for several levels of nodes, with one far away determining the bound of its branches.
+	const int count = 200;
+	int items[count + 1];
+	BVH_Manager<int, 1, false, 32, UserPairTestFunction<int>, UserCullTestFunction<int>> bvh;
+	for (int i = 0; i < count; i++) {
+		bvh.create(&items[i], true, 0, 1, AABB(Vector3(rng->randf_range(-10, 10), rng->randf_range(-10, 10), rng->randf_range(-10, 10)), Vector3(1, 1, 1)));
+	}
+	const AABB far(Vector3(1000, 1000, 1000), Vector3(1, 1, 1));
+	BVHHandle far_handle = bvh.create(&items[count], true, 0, 1, far);
+	bvh.update();
+
+	AABB bound;
+	REQUIRE(TestBVHInternalsAccessor::get_root_bound(bvh, bound));
+	CHECK(bound.encloses(far));
+
+	// Removing an item that determines a leaf bound only marks the leaf, the refit happens on update.
+	bvh.erase(far_handle);
+	REQUIRE(TestBVHInternalsAccessor::get_root_bound(bvh, bound));
+	CHECK(bound.encloses(far));
+
+	bvh.update();
+	REQUIRE(TestBVHInternalsAccessor::get_root_bound(bvh, bound));
+	CHECK_FALSE(bound.intersects(far));
+	CHECK(TestBVHInternalsAccessor::bounds_enclose_contents(bvh));
+}
+
+} // namespace TestBVH
+
+#endif // TEST_BVH_H
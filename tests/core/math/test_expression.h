@@ -241,6 +241,292 @@ TEST_CASE("[Expression] Built-in functions") {
 			"`pow(2.0, -2500)` should return the expected result (asymptotically zero).");
 }
 
+TEST_CASE("[Expression] Built-in methods") {
+	Expression expression;
+
+	PackedStringArray parameter_names;
+	parameter_names.push_back("value");
+	CHECK_MESSAGE(
+			expression.parse("value.abs()", parameter_names) == OK,
+			"The expression should parse successfully.");
+	// The call is resolved again whenever the types change.
+	Array values;
+	values.push_back(Vector2i(-3, 1));
+	CHECK_MESSAGE(
+			Vector2i(expression.execute(values)) == Vector2i(3, 1),
+			"`value.abs()` should return the expected result with a Vector2i.");
+	values[0] = Vector2i(-4, -5);
+	CHECK_MESSAGE(
+			Vector2i(expression.execute(values)) == Vector2i(4, 5),
+			"`value.abs()` should return the expected result when executed again.");
+	values[0] = Vector2(-1.5, 2);
+	CHECK_MESSAGE(
+			Vector2(expression.execute(values)) == Vector2(1.5, 2),
+			"`value.abs()` should return the expected result with a Vector2.");
+
+	parameter_names.push_back("start");
+	CHECK_MESSAGE(
+			expression.parse("value.substr(start, 3).length() + value.find(\"c\")", parameter_names) == OK,
+			"The expression should parse successfully.");
+	values[0] = "abcdef";
+	values.push_back(1);
+	CHECK_MESSAGE(
+			int(expression.execute(values)) == 5,
+			"Chained method calls should return the expected result.");
+	// A float where an int is expected goes through a regular call, which converts it.
+	values[1] = 4.0;
+	CHECK_MESSAGE(
+			int(expression.execute(values)) == 4,
+			"Chained method calls should convert arguments of other types.");
+
+	CHECK_MESSAGE(
+			expression.parse("value.push_back(1)", parameter_names) == OK,
+			"The expression should parse successfully.");
+	Array array;
+	values[0] = array;
+	expression.execute(values);
+	CHECK_MESSAGE(
+			array.size() == 1,
+			"Non-const methods should be called normally.");
+	ERR_PRINT_OFF;
+	expression.execute(values, nullptr, true, true);
+	ERR_PRINT_ON;
+	CHECK_MESSAGE(
+			expression.has_execute_failed(),
+			"Non-const methods should fail when only const calls are allowed.");
+	CHECK_MESSAGE(
+			array.size() == 1,
+			"Non-const methods should not be called when only const calls are allowed.");
+}
+
+TEST_CASE("[Expression] Executing again") {
+	Expression expression;
+
+	CHECK_MESSAGE(
+			expression.parse("2 * 3 + sin(0) + Vector2(1, 2).y") == OK,
+			"The expression should parse successfully.");
+	CHECK_MESSAGE(
+			double(expression.execute()) == doctest::Approx(8.0),
+			"Constant expressions should return the expected result.");
+	CHECK_MESSAGE(
+			double(expression.execute()) == doctest::Approx(8.0),
+			"Constant expressions should return the expected result when executed again.");
+
+	PackedStringArray parameter_names;
+	parameter_names.push_back("a");
+	parameter_names.push_back("b");
+	CHECK_MESSAGE(
+			expression.parse("a * b + a", parameter_names) == OK,
+			"The expression should parse successfully.");
+	Array values;
+	values.push_back(2);
+	values.push_back(3);
+	CHECK_MESSAGE(
+			int(expression.execute(values)) == 8,
+			"The expression should return the expected result with integers.");
+	values[1] = 0.5;
+	CHECK_MESSAGE(
+			double(expression.execute(values)) == doctest::Approx(3.0),
+			"The expression should return the expected result when the types change.");
+	values[0] = Vector2(1, 2);
+	values[1] = 2;
+	CHECK_MESSAGE(
+			Vector2(expression.execute(values)) == Vector2(3, 6),
+			"The expression should return the expected result when the types change again.");
+	values[0] = "text";
+	ERR_PRINT_OFF;
+	expression.execute(values);
+	ERR_PRINT_ON;
+	CHECK_MESSAGE(
+			expression.has_execute_failed(),
+			"The expression should fail with invalid operand types.");
+	values[0] = 1;
+	values[1] = 1;
+	CHECK_MESSAGE(
+			int(expression.execute(values)) == 2,
+			"The expression should succeed again after failing.");
+	values.resize(1);
+	ERR_PRINT_OFF;
+	expression.execute(values);
+	ERR_PRINT_ON;
+	CHECK_MESSAGE(
+			expression.has_execute_failed(),
+			"The expression should fail when an input is missing.");
+
+	CHECK_MESSAGE(
+			expression.parse("[a, 1]", parameter_names) == OK,
+			"The expression should parse successfully.");
+	values.push_back(0);
+	Array first = expression.execute(values);
+	Array second = expression.execute(values);
+	first.push_back(2);
+	CHECK_MESSAGE(
+			second.size() == 2,
+			"Each execution should return a new array.");
+
+	CHECK_MESSAGE(
+			expression.parse("Array()") == OK,
+			"The expression should parse successfully.");
+	Array constructed = expression.execute();
+	constructed.push_back(1);
+	CHECK_MESSAGE(
+			Array(expression.execute()).is_empty(),
+			"Constructing an array without arguments should return a new array on each execution.");
+
+	CHECK_MESSAGE(
+			expression.parse("Dictionary()") == OK,
+			"The expression should parse successfully.");
+	Dictionary constructed_dictionary = expression.execute();
+	constructed_dictionary["key"] = 1;
+	CHECK_MESSAGE(
+			Dictionary(expression.execute()).is_empty(),
+			"Constructing a dictionary without arguments should return a new dictionary on each execution.");
+
+	CHECK_MESSAGE(
+			expression.parse("PackedInt32Array()") == OK,
+			"The expression should parse successfully.");
+	// Variants share packed arrays, like scripts holding the result would.
+	Variant constructed_packed = expression.execute();
+	constructed_packed.call("push_back", 1);
+	CHECK_MESSAGE(
+			PackedInt32Array(expression.execute()).is_empty(),
+			"Constructing a packed array without arguments should return a new array on each execution.");
+}
+
+TEST_CASE("[Expression] Shifting by negative amounts") {
+	Expression expression;
+
+	CHECK_MESSAGE(
+			expression.parse("1 << 3") == OK,
+			"Integer left shift should parse successfully.");
+	CHECK_MESSAGE(
+			int(expression.execute()) == 8,
+			"Integer left shift should return the expected result.");
+
+	// Constant operands are folded when parsing, the error is left for execution to report.
+	for (const String &constant_shift : { "1 << -1", "1 >> -1" }) {
+		CHECK_MESSAGE(
+				expression.parse(constant_shift) == OK,
+				"Shifting constants by a negative amount should parse successfully.");
+		ERR_PRINT_OFF;
+		expression.execute();
+		ERR_PRINT_ON;
+		CHECK_MESSAGE(
+				expression.has_execute_failed(),
+				"Shifting constants by a negative amount should fail.");
+	}
+
+	PackedStringArray parameter_names;
+	parameter_names.push_back("a");
+	parameter_names.push_back("b");
+	const struct {
+		const char *expression;
+		int result;
+	} shifts[] = { { "a << b", 64 }, { "a >> b", 4 } };
+	for (const auto &shift : shifts) {
+		CHECK_MESSAGE(
+				expression.parse(shift.expression, parameter_names) == OK,
+				"Shifting inputs should parse successfully.");
+		Array values;
+		values.push_back(16);
+		values.push_back(2);
+		CHECK(int(expression.execute(values)) == shift.result);
+		CHECK_FALSE(expression.has_execute_failed());
+		// The operand types are the same as in the previous execution.
+		values[1] = -1;
+		ERR_PRINT_OFF;
+		expression.execute(values);
+		ERR_PRINT_ON;
+		CHECK_MESSAGE(
+				expression.has_execute_failed(),
+				"Shifting by a negative input should fail.");
+	}
+}
+
+TEST_CASE("[Expression] Executing again doesn't allocate") {
+	Expression expression;
+
+	PackedStringArray parameter_names;
+	parameter_names.push_back("a");
+	parameter_names.push_back("b");
+	CHECK_MESSAGE(
+			expression.parse("a * b + sin(a) + Vector2(a, b).x", parameter_names) == OK,
+			"The expression should parse successfully.");
+	Array values;
+	values.push_back(2.0);
+	values.push_back(3.0);
+	// The first execution settles the operand types.
+	const double expected = expression.execute(values);
+	CHECK(expected == doctest::Approx(8.0 + Math::sin(2.0)));
+
+	const uint64_t allocations = Memory::get_alloc_count();
+	double result = 0.0;
+	for (int i = 0; i < 10; i++) {
+		result = expression.execute(values);
+	}
+	CHECK(Memory::get_alloc_count() == allocations);
+	CHECK(result == doctest::Approx(expected));
+}
+
+// Executes the expression again from within its own execution, counting down to zero.
+class _ExpressionNestedCall : public CallableCustom {
+	Expression *expression = nullptr;
+
+	static bool _compare_equal(const CallableCustom *p_a, const CallableCustom *p_b) {
+		return p_a == p_b;
+	}
+
+	static bool _compare_less(const CallableCustom *p_a, const CallableCustom *p_b) {
+		return p_a < p_b;
+	}
+
+public:
+	uint32_t hash() const override { return hash_murmur3_one_64((uint64_t)this); }
+	String get_as_text() const override { return "_ExpressionNestedCall"; }
+	CompareEqualFunc get_compare_equal_func() const override { return _compare_equal; }
+	CompareLessFunc get_compare_less_func() const override { return _compare_less; }
+	ObjectID get_object() const override { return ObjectID(); }
+
+	void call(const Variant **p_arguments, int p_argcount, Variant &r_return_value, Callable::CallError &r_call_error) const override {
+		r_call_error.error = Callable::CallError::CALL_OK;
+		const int n = *p_arguments[0];
+		if (n <= 0) {
+			r_return_value = 0;
+			return;
+		}
+		Array values;
+		values.push_back(n - 1);
+		values.push_back(Callable(memnew(_ExpressionNestedCall(expression))));
+		r_return_value = expression->execute(values);
+	}
+
+	_ExpressionNestedCall(Expression *p_expression) :
+			expression(p_expression) {}
+};
+
+TEST_CASE("[Expression] Executing from within an execution") {
+	Expression expression;
+
+	PackedStringArray parameter_names;
+	parameter_names.push_back("n");
+	parameter_names.push_back("f");
+	CHECK_MESSAGE(
+			expression.parse("n * 10 + f.call(n)", parameter_names) == OK,
+			"The expression should parse successfully.");
+
+	Array values;
+	values.push_back(3);
+	values.push_back(Callable(memnew(_ExpressionNestedCall(&expression))));
+	// 30 + (20 + (10 + 0)), the nested executions must not overwrite the registers of the outer ones.
+	CHECK_MESSAGE(
+			int(expression.execute(values)) == 60,
+			"Nested executions should not change the result of the outer execution.");
+	CHECK_FALSE(expression.has_execute_failed());
+	CHECK_MESSAGE(
+			int(expression.execute(values)) == 60,
+			"The expression should return the same result when executed again.");
+}
+
 TEST_CASE("[Expression] Boolean expressions") {
 	Expression expression;
 
@@ -0,0 +1,277 @@
+/**************************************************************************/
+/*  test_message_queue.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_MESSAGE_QUEUE_H
+#define TEST_MESSAGE_QUEUE_H
+
+#include "core/object/message_queue.h"
+#include "core/os/os.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMessageQueue {
+
+static LocalVector<int64_t> received;
+static int64_t received_sum = 0;
+
+static void record(int64_t p_value) {
+	received.push_back(p_value);
+}
+
+static void record_sum(int64_t p_value) {
+	received_sum += p_value;
+}
+
+static void record_none() {
+	received.push_back(-1);
+}
+
+TEST_CASE("[MessageQueue] Calls are run in order") {
+	CallQueue queue;
+	received.clear();
+
+	CHECK_FALSE(queue.has_messages());
+	queue.push_callable(callable_mp_static(&record), 1);
+	queue.push_callable(callable_mp_static(&record_none));
+	Variant arg = 2;
+	const Variant *argptr = &arg;
+	queue.push_callablep(callable_mp_static(&record), &argptr, 1);
+	CHECK(queue.has_messages());
+
+	CHECK(queue.flush() == OK);
+	CHECK_FALSE(queue.has_messages());
+	REQUIRE(received.size() == 3);
+	CHECK(received[0] == 1);
+	CHECK(received[1] == -1);
+	CHECK(received[2] == 2);
+}
+
+struct ThreadData {
+	CallQueue *queue = nullptr;
+	int64_t first = 0;
+	int count = 0;
+};
+
+static void push_from_thread(void *p_userdata) {
+	ThreadData *data = (ThreadData *)p_userdata;
+	for (int i = 0; i < data->count; i++) {
+		data->queue->push_callable(callable_mp_static(&record), data->first + i);
+	}
+}
+
+TEST_CASE("[MessageQueue] Calls pushed from other threads") {
+	CallQueue queue;
+	received.clear();
+
+	const int thread_count = 4;
+	// Enough to need several pages per thread.
+	const int count = 2000;
+	Thread threads[thread_count];
+	ThreadData data[thread_count];
+	for (int i = 0; i < thread_count; i++) {
+		data[i].queue = &queue;
+		data[i].first = (int64_t)i * count;
+		data[i].count = count;
+		threads[i].start(push_from_thread, &data[i]);
+	}
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].wait_to_finish();
+	}
+
+	// Messages from the owner pushed after the threads finished must run after theirs.
+	queue.push_callable(callable_mp_static(&record), -2);
+
+	CHECK(queue.has_messages());
+	CHECK(queue.flush() == OK);
+	CHECK_FALSE(queue.has_messages());
+
+	REQUIRE(received.size() == thread_count * count + 1);
+	CHECK(received[received.size() - 1] == -2);
+
+	// Each thread's messages keep their relative order.
+	int64_t last[thread_count];
+	for (int i = 0; i < thread_count; i++) {
+		last[i] = -1;
+	}
+	bool ordered = true;
+	for (uint32_t i = 0; i < received.size() - 1; i++) {
+		int t = received[i] / count;
+		if (received[i] <= last[t]) {
+			ordered = false;
+		}
+		last[t] = received[i];
+	}
+	CHECK(ordered);
+
+	// Pages are reused by the next round.
+	received.clear();
+	threads[0].start(push_from_thread, &data[0]);
+	threads[0].wait_to_finish();
+	CHECK(queue.flush() == OK);
+	CHECK(received.size() == count);
+}
+
+TEST_CASE("[MessageQueue] Clearing drops the messages of other threads") {
+	CallQueue queue;
+	received.clear();
+
+	ThreadData data;
+	data.queue = &queue;
+	data.count = 100;
+	Thread thread;
+	thread.start(push_from_thread, &data);
+	thread.wait_to_finish();
+
+	CHECK(queue.has_messages());
+	queue.clear();
+	CHECK_FALSE(queue.has_messages());
+	CHECK(queue.flush() == OK);
+	CHECK(received.size() == 0);
+}
+
+TEST_CASE("[MessageQueue] Sub-queues of exited threads are released") {
+	CallQueue queue;
+	received.clear();
+
+	// More short-lived threads than there can be sub-queues at once.
+	const int thread_count = 100;
+	ThreadData data;
+	data.queue = &queue;
+	data.count = 10;
+	for (int i = 0; i < thread_count; i++) {
+		data.first = (int64_t)i * data.count;
+		Thread thread;
+		thread.start(push_from_thread, &data);
+		thread.wait_to_finish();
+		CHECK(queue.get_sub_queue_count() <= 1);
+		if (i % 10 == 9) {
+			CHECK(queue.flush() == OK);
+			CHECK(queue.get_sub_queue_count() == 0);
+		}
+	}
+
+	REQUIRE(received.size() == thread_count * data.count);
+	bool ordered = true;
+	for (uint32_t i = 0; i < received.size(); i++) {
+		ordered = ordered && received[i] == (int64_t)i;
+	}
+	CHECK(ordered);
+}
+
+struct QueueSequenceData {
+	CallQueue *queue = nullptr;
+	int count = 0;
+	int max_thread_sub_queues = 0;
+	Semaphore queue_ready;
+	Semaphore pushed;
+};
+
+static void push_to_each_queue(void *p_userdata) {
+	QueueSequenceData *data = (QueueSequenceData *)p_userdata;
+	for (int i = 0; i < data->count; i++) {
+		data->queue_ready.wait();
+		data->queue->push_callable(callable_mp_static(&record), i);
+		data->max_thread_sub_queues = MAX(data->max_thread_sub_queues, CallQueue::get_thread_sub_queue_count());
+		data->pushed.post();
+	}
+}
+
+TEST_CASE("[MessageQueue] Sub-queues of destroyed queues are released by their thread") {
+	received.clear();
+
+	// A long-lived thread pushing to many short-lived queues.
+	QueueSequenceData data;
+	data.count = 100;
+	Thread thread;
+	thread.start(push_to_each_queue, &data);
+	for (int i = 0; i < data.count; i++) {
+		data.queue = memnew(CallQueue);
+		data.queue_ready.post();
+		data.pushed.wait();
+		CHECK(data.queue->flush() == OK);
+		memdelete(data.queue);
+	}
+	thread.wait_to_finish();
+
+	CHECK(received.size() == (uint32_t)data.count);
+	CHECK(data.max_thread_sub_queues == 1);
+}
+
+struct BenchmarkData {
+	CallQueue *queue = nullptr;
+	int count = 0;
+	SafeNumeric<int> finished;
+};
+
+static void benchmark_push(void *p_userdata) {
+	BenchmarkData *data = (BenchmarkData *)p_userdata;
+	Callable callable = callable_mp_static(&record_sum);
+	for (int i = 0; i < data->count; i++) {
+		data->queue->push_callable(callable, 1);
+	}
+	data->finished.increment();
+}
+
+TEST_CASE_BENCHMARK("[MessageQueue][Benchmark] Pushing from several threads while flushing") {
+	CallQueue queue(nullptr, 65536);
+	const int count = 200000;
+
+	for (int thread_count = 1; thread_count <= 8; thread_count *= 2) {
+		received_sum = 0;
+		BenchmarkData data;
+		data.queue = &queue;
+		data.count = count;
+		Thread threads[8];
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < thread_count; i++) {
+			threads[i].start(benchmark_push, &data);
+		}
+		// Flush while the threads push, as the main thread does every frame.
+		while (data.finished.get() < thread_count) {
+			queue.flush();
+		}
+		for (int i = 0; i < thread_count; i++) {
+			threads[i].wait_to_finish();
+		}
+		queue.flush();
+		uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+
+		MESSAGE(thread_count, " threads: ", (uint64_t)thread_count * count * 1000000 / elapsed, " calls/s");
+		CHECK(received_sum == (int64_t)thread_count * count);
+	}
+}
+
+} // namespace TestMessageQueue
+
+#endif // TEST_MESSAGE_QUEUE_H
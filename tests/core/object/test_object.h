@@ -35,6 +35,9 @@
 #include "core/object/class_db.h"
 #include "core/object/object.h"
 #include "core/object/script_language.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/templates/safe_refcount.h"
 
 #include "tests/test_macros.h"
 
@@ -465,6 +468,175 @@ TEST_CASE("[Object] Signals") {
 		object.get_all_signal_connections(&signal_connections);
 		CHECK(signal_connections.size() == 0);
 	}
+
+	SUBCASE("Emitting through a signal handle should call the connected method") {
+		Array empty_signal_args;
+		empty_signal_args.push_back(Array());
+
+		Object::SignalHandle handle("my_custom_signal");
+		SIGNAL_WATCH(&object, "my_custom_signal");
+		SIGNAL_CHECK_FALSE("my_custom_signal");
+
+		CHECK(object.emit_signal_handle(handle) == OK);
+		SIGNAL_CHECK("my_custom_signal", empty_signal_args);
+		SIGNAL_UNWATCH(&object, "my_custom_signal");
+
+		// Still a user signal, but without connections.
+		CHECK(object.emit_signal_handle(handle) == OK);
+		SIGNAL_CHECK_FALSE("my_custom_signal");
+	}
+}
+
+class _SignalCounter : public Object {
+public:
+	int count = 0;
+	void increment() { count++; }
+	void increment_arg(int p_amount) { count += p_amount; }
+};
+
+class _SignalSafeCounter : public Object {
+public:
+	SafeNumeric<uint32_t> count;
+	void increment() { count.increment(); }
+};
+
+class _SignalDisconnector : public Object {
+public:
+	Object *emitter = nullptr;
+	Callable to_disconnect;
+	void disconnect_other() {
+		emitter->disconnect("script_changed", to_disconnect);
+	}
+};
+
+TEST_CASE("[Object] Signal handles") {
+	Object object;
+	_SignalCounter counter;
+	Object::SignalHandle handle("script_changed");
+
+	SUBCASE("A handle follows connections made after it was resolved") {
+		CHECK(object.emit_signal_handle(handle) == ERR_UNAVAILABLE);
+
+		object.connect("script_changed", callable_mp(&counter, &_SignalCounter::increment));
+		CHECK(object.emit_signal_handle(handle) == OK);
+		CHECK(counter.count == 1);
+
+		object.disconnect("script_changed", callable_mp(&counter, &_SignalCounter::increment));
+		CHECK(object.emit_signal_handle(handle) == ERR_UNAVAILABLE);
+		CHECK(counter.count == 1);
+	}
+
+	SUBCASE("A handle can be used with several objects") {
+		Object other;
+		_SignalCounter other_counter;
+		object.connect("script_changed", callable_mp(&counter, &_SignalCounter::increment));
+		other.connect("script_changed", callable_mp(&other_counter, &_SignalCounter::increment));
+
+		CHECK(object.emit_signal_handle(handle) == OK);
+		CHECK(other.emit_signal_handle(handle) == OK);
+		CHECK(other.emit_signal_handle(handle) == OK);
+		CHECK(counter.count == 1);
+		CHECK(other_counter.count == 2);
+	}
+
+	SUBCASE("Arguments are passed through a handle") {
+		Object::SignalHandle user_handle("my_signal");
+		object.add_user_signal(MethodInfo("my_signal", PropertyInfo(Variant::INT, "amount")));
+		object.connect("my_signal", callable_mp(&counter, &_SignalCounter::increment_arg));
+		CHECK(object.emit_signal_handle(user_handle, 5) == OK);
+		CHECK(object.emit_signal(user_handle.get_name(), 2) == OK);
+		CHECK(counter.count == 7);
+	}
+
+	SUBCASE("One-shot connections are only called once") {
+		object.connect("script_changed", callable_mp(&counter, &_SignalCounter::increment), Object::CONNECT_ONE_SHOT);
+		CHECK(object.emit_signal_handle(handle) == OK);
+		CHECK(object.emit_signal_handle(handle) == ERR_UNAVAILABLE);
+		CHECK(counter.count == 1);
+	}
+
+	SUBCASE("Disconnecting during an emission doesn't affect the slots being called") {
+		_SignalDisconnector disconnector;
+		disconnector.emitter = &object;
+		disconnector.to_disconnect = callable_mp(&counter, &_SignalCounter::increment);
+		object.connect("script_changed", callable_mp(&disconnector, &_SignalDisconnector::disconnect_other));
+		object.connect("script_changed", callable_mp(&counter, &_SignalCounter::increment));
+
+		CHECK(object.emit_signal_handle(handle) == OK);
+		CHECK(counter.count == 1);
+		CHECK_FALSE(object.is_connected("script_changed", callable_mp(&counter, &_SignalCounter::increment)));
+
+		CHECK(object.emit_signal_handle(handle) == OK);
+		CHECK(counter.count == 1);
+	}
+
+	SUBCASE("A handle doesn't reuse the state of a freed object") {
+		Object *first = memnew(Object);
+		_SignalCounter first_counter;
+		first->connect("script_changed", callable_mp(&first_counter, &_SignalCounter::increment));
+		CHECK(first->emit_signal_handle(handle) == OK);
+		memdelete(first);
+
+		// The allocator may hand out the same address again.
+		Object *second = memnew(Object);
+		CHECK(second->emit_signal_handle(handle) == ERR_UNAVAILABLE);
+		second->connect("script_changed", callable_mp(&counter, &_SignalCounter::increment));
+		CHECK(second->emit_signal_handle(handle) == OK);
+		memdelete(second);
+
+		CHECK(first_counter.count == 1);
+		CHECK(counter.count == 1);
+	}
+
+	SUBCASE("Several threads can emit the same signal") {
+		_SignalSafeCounter safe_counter;
+		object.connect("script_changed", callable_mp(&safe_counter, &_SignalSafeCounter::increment));
+
+		const int thread_count = 8;
+		const int emissions = 1000;
+		Thread threads[thread_count];
+		for (Thread &thread : threads) {
+			thread.start([](void *p_object) {
+				Object::SignalHandle thread_handle("script_changed");
+				for (int i = 0; i < emissions; i++) {
+					static_cast<Object *>(p_object)->emit_signal_handle(thread_handle);
+				}
+			},
+					&object);
+		}
+		for (Thread &thread : threads) {
+			thread.wait_to_finish();
+		}
+		CHECK(safe_counter.count.get() == thread_count * emissions);
+	}
+}
+
+TEST_CASE_BENCHMARK("[Object][Benchmark] Signal emission") {
+	Object object;
+	_SignalCounter counters[4];
+	for (_SignalCounter &counter : counters) {
+		object.connect("script_changed", callable_mp(&counter, &_SignalCounter::increment));
+	}
+
+	const int emissions = 1000000;
+	const StringName name = "script_changed";
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < emissions; i++) {
+		object.emit_signal(name);
+	}
+	uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+	MESSAGE("By name: ", (uint64_t)emissions * 1000000 / elapsed, " emissions/s");
+
+	Object::SignalHandle handle(name);
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < emissions; i++) {
+		object.emit_signal_handle(handle);
+	}
+	elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+	MESSAGE("Through a handle: ", (uint64_t)emissions * 1000000 / elapsed, " emissions/s");
+
+	CHECK(counters[0].count == emissions * 2);
 }
 
 class NotificationObject1 : public Object {
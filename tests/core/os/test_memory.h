@@ -0,0 +1,250 @@
+/**************************************************************************/
+/*  test_memory.h                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_MEMORY_H
+#define TEST_MEMORY_H
+
+#include "core/object/worker_thread_pool.h"
+#include "core/os/memory.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMemory {
+
+TEST_CASE("[Memory][FrameAllocator] Allocations are aligned and don't overlap") {
+	uint8_t *a = (uint8_t *)FrameAllocator::alloc(3);
+	uint8_t *b = (uint8_t *)FrameAllocator::alloc(100);
+	uint8_t *c = (uint8_t *)FrameAllocator::alloc(1);
+
+	CHECK((uintptr_t)a % alignof(max_align_t) == 0);
+	CHECK((uintptr_t)b % alignof(max_align_t) == 0);
+	CHECK((uintptr_t)c % alignof(max_align_t) == 0);
+	CHECK(b >= a + 3);
+	CHECK(c >= b + 100);
+
+	memset(a, 0xAA, 3);
+	memset(b, 0xBB, 100);
+	memset(c, 0xCC, 1);
+	CHECK(a[2] == 0xAA);
+	CHECK(b[0] == 0xBB);
+	CHECK(b[99] == 0xBB);
+
+	FrameAllocator::free(b);
+	FrameAllocator::free(c);
+	FrameAllocator::free(a);
+}
+
+TEST_CASE("[Memory][FrameAllocator] Latest allocation grows in place and memory is reused once everything is freed") {
+	uint8_t *a = (uint8_t *)FrameAllocator::alloc(16);
+	for (int i = 0; i < 16; i++) {
+		a[i] = i;
+	}
+
+	uint8_t *grown = (uint8_t *)FrameAllocator::realloc(a, 256);
+	CHECK(grown == a);
+
+	uint8_t *b = (uint8_t *)FrameAllocator::alloc(16);
+	uint8_t *moved = (uint8_t *)FrameAllocator::realloc(grown, 512); // Not the latest anymore.
+	CHECK(moved != grown);
+	bool preserved = true;
+	for (int i = 0; i < 16; i++) {
+		preserved &= moved[i] == i;
+	}
+	CHECK(preserved);
+
+	FrameAllocator::free(b);
+	FrameAllocator::free(moved);
+
+	uint8_t *again = (uint8_t *)FrameAllocator::alloc(16);
+	CHECK(again == a);
+	FrameAllocator::free(again);
+}
+
+TEST_CASE("[Memory][FrameAllocator] Allocations bigger than a chunk") {
+	const size_t size = 4 * 1024 * 1024;
+	uint8_t *small = (uint8_t *)FrameAllocator::alloc(8);
+	uint8_t *big = (uint8_t *)FrameAllocator::alloc(size);
+	REQUIRE(big != nullptr);
+	big[0] = 1;
+	big[size - 1] = 2;
+	CHECK(big[0] == 1);
+	CHECK(big[size - 1] == 2);
+	CHECK(FrameAllocator::get_peak_usage() >= size);
+	FrameAllocator::free(small);
+	FrameAllocator::free(big);
+}
+
+TEST_CASE("[Memory][FrameAllocator] Containers") {
+	LocalVector<int, uint32_t, false, false, FrameAllocator> vector;
+	for (int i = 0; i < 10000; i++) {
+		vector.push_back(i);
+	}
+	CHECK(vector.size() == 10000);
+	CHECK(vector[0] == 0);
+	CHECK(vector[9999] == 9999);
+
+	HashMap<int, int, HashMapHasherDefault, HashMapComparatorDefault<int>, FrameTypedAllocator<HashMapElement<int, int>>> map;
+	for (int i = 0; i < 1000; i++) {
+		map.insert(i, i * 2);
+	}
+	CHECK(map.size() == 1000);
+	CHECK(map[500] == 1000);
+	map.erase(500);
+	CHECK_FALSE(map.has(500));
+	map.clear();
+	CHECK(map.is_empty());
+
+	vector.reset();
+	CHECK(vector.is_empty());
+}
+
+TEST_CASE("[Memory] Tag scopes nest") {
+	CHECK(Memory::get_current_tag() == Memory::TAG_UNTAGGED);
+	{
+		MemoryTagScope physics(Memory::TAG_PHYSICS);
+		CHECK(Memory::get_current_tag() == (Memory::has_tags() ? Memory::TAG_PHYSICS : Memory::TAG_UNTAGGED));
+		{
+			MemoryTagScope scripting(Memory::TAG_SCRIPTING);
+			CHECK(Memory::get_current_tag() == (Memory::has_tags() ? Memory::TAG_SCRIPTING : Memory::TAG_UNTAGGED));
+		}
+		CHECK(Memory::get_current_tag() == (Memory::has_tags() ? Memory::TAG_PHYSICS : Memory::TAG_UNTAGGED));
+	}
+	CHECK(Memory::get_current_tag() == Memory::TAG_UNTAGGED);
+	CHECK(String(Memory::get_tag_name(Memory::TAG_NAVIGATION)) == "navigation");
+}
+
+TEST_CASE("[Memory] Tag counters") {
+	if (!Memory::has_tags()) {
+		return;
+	}
+
+	const size_t size = 1024 * 1024;
+	const uint64_t usage = Memory::get_tag_usage(Memory::TAG_NAVIGATION);
+	const uint64_t allocs = Memory::get_tag_alloc_count(Memory::TAG_NAVIGATION);
+
+	void *mem = nullptr;
+	{
+		MemoryTagScope scope(Memory::TAG_NAVIGATION);
+		mem = Memory::alloc_static(size);
+	}
+	CHECK(Memory::get_tag_usage(Memory::TAG_NAVIGATION) >= usage + size);
+	CHECK(Memory::get_tag_alloc_count(Memory::TAG_NAVIGATION) >= allocs + 1);
+
+	// Reallocations and frees are attributed to the tag the memory was allocated with, whatever the current one is.
+	{
+		MemoryTagScope scope(Memory::TAG_AUDIO);
+		mem = Memory::realloc_static(mem, size * 2);
+	}
+	CHECK(Memory::get_tag_usage(Memory::TAG_NAVIGATION) >= usage + size * 2);
+
+	Memory::free_static(mem);
+	CHECK(Memory::get_tag_usage(Memory::TAG_NAVIGATION) < usage + size);
+}
+
+static void _alloc_navigation_memory(void *p_userdata) {
+	MemoryTagScope scope(Memory::TAG_NAVIGATION);
+	*(void **)p_userdata = Memory::alloc_static(1024 * 1024);
+}
+
+TEST_CASE("[Memory] Tag counters are summed over threads") {
+	if (!Memory::has_tags()) {
+		return;
+	}
+
+	const size_t size = 1024 * 1024;
+	const uint64_t usage = Memory::get_tag_usage(Memory::TAG_NAVIGATION);
+	const uint64_t allocs = Memory::get_tag_alloc_count(Memory::TAG_NAVIGATION);
+
+	// The counters of a thread are kept after it exits.
+	void *mem = nullptr;
+	Thread thread;
+	thread.start(_alloc_navigation_memory, &mem);
+	thread.wait_to_finish();
+	CHECK(Memory::get_tag_usage(Memory::TAG_NAVIGATION) >= usage + size);
+	CHECK(Memory::get_tag_alloc_count(Memory::TAG_NAVIGATION) >= allocs + 1);
+
+	// Freeing it from another thread balances them.
+	Memory::free_static(mem);
+	CHECK(Memory::get_tag_usage(Memory::TAG_NAVIGATION) < usage + size);
+}
+
+TEST_CASE("[Memory] Reallocating to zero bytes frees") {
+	for (int pad = 0; pad < 2; pad++) {
+		const uint64_t allocs = Memory::get_alloc_count();
+		void *mem = Memory::alloc_static(64, pad);
+		CHECK(Memory::get_alloc_count() == allocs + 1);
+		mem = Memory::realloc_static(mem, 0, pad);
+		CHECK(mem == nullptr);
+		CHECK(Memory::get_alloc_count() == allocs);
+	}
+}
+
+static void _store_memory_tag(void *p_userdata) {
+	*(Memory::Tag *)p_userdata = Memory::get_current_tag();
+}
+
+TEST_CASE("[Memory] Worker tasks inherit the tag of the thread adding them") {
+	Memory::Tag task_tag = Memory::TAG_MAX;
+	WorkerThreadPool::TaskID id;
+	{
+		MemoryTagScope scope(Memory::TAG_RESOURCES);
+		id = WorkerThreadPool::get_singleton()->add_native_task(_store_memory_tag, &task_tag);
+	}
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(id);
+	CHECK(task_tag == (Memory::has_tags() ? Memory::TAG_RESOURCES : Memory::TAG_UNTAGGED));
+}
+
+TEST_CASE_BENCHMARK("[Memory][Benchmark] Tagged allocations") {
+	const int count = 1000000;
+	void *ptrs[16];
+	for (int pass = 0; pass < 2; pass++) {
+		MemoryTagScope scope(pass == 0 ? Memory::TAG_UNTAGGED : Memory::TAG_SCRIPTING);
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < count; i += 16) {
+			for (int j = 0; j < 16; j++) {
+				ptrs[j] = Memory::alloc_static(16 + j * 8);
+			}
+			for (int j = 0; j < 16; j++) {
+				Memory::free_static(ptrs[j]);
+			}
+		}
+		uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+		MESSAGE(Memory::get_tag_name(Memory::get_current_tag()), ": ", (uint64_t)count * 1000000 / elapsed, " allocations/s");
+	}
+}
+
+} // namespace TestMemory
+
+#endif // TEST_MEMORY_H
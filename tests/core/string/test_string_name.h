@@ -0,0 +1,197 @@
+/**************************************************************************/
+/*  test_string_name.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_STRING_NAME_H
+#define TEST_STRING_NAME_H
+
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/string/string_name.h"
+
+#include "tests/test_macros.h"
+
+namespace TestStringName {
+
+TEST_CASE("[StringName] Interning") {
+	const StringName a = "test_string_name_interning";
+	const StringName b = String("test_string_name_interning");
+	const StringName c = StringName::search("test_string_name_interning");
+
+	CHECK(a == b);
+	CHECK(a == c);
+	CHECK(a.data_unique_pointer() == b.data_unique_pointer());
+	CHECK(a.hash() == String("test_string_name_interning").hash());
+
+	CHECK_MESSAGE(
+			StringName::search("test_string_name_never_created") == StringName(),
+			"Searching a name that was never created should return an empty StringName.");
+}
+
+TEST_CASE("[StringName] Names are released when unreferenced") {
+	{
+		const StringName temp = String("test_string_name_released");
+		CHECK(StringName::search(String("test_string_name_released")) == temp);
+	}
+	CHECK(StringName::search(String("test_string_name_released")) == StringName());
+}
+
+TEST_CASE("[StringName] Growth") {
+	// Enough names to make every shard grow past its initial bucket array.
+	const int count = 100000;
+	Vector<StringName> names;
+	names.resize(count);
+	for (int i = 0; i < count; i++) {
+		names.write[i] = StringName("test_string_name_growth_" + itos(i));
+	}
+
+	int found = 0;
+	for (int i = 0; i < count; i++) {
+		StringName name = StringName::search("test_string_name_growth_" + itos(i));
+		if (name == names[i] && name.data_unique_pointer() == names[i].data_unique_pointer()) {
+			found++;
+		}
+	}
+	CHECK(found == count);
+
+	// Release half of them, the rest must still be found.
+	for (int i = 0; i < count; i += 2) {
+		names.write[i] = StringName();
+	}
+	found = 0;
+	for (int i = 1; i < count; i += 2) {
+		if (StringName::search("test_string_name_growth_" + itos(i)) == names[i]) {
+			found++;
+		}
+	}
+	CHECK(found == count / 2);
+}
+
+struct ConcurrentData {
+	int names = 0;
+	int iterations = 0;
+	Vector<String> strings;
+	Vector<StringName> results[8];
+	SafeNumeric<uint32_t> index;
+};
+
+static void concurrent_create(void *p_userdata) {
+	ConcurrentData *data = (ConcurrentData *)p_userdata;
+	Vector<StringName> &results = data->results[data->index.postincrement()];
+	results.resize(data->names);
+	for (int it = 0; it < data->iterations; it++) {
+		for (int i = 0; i < data->names; i++) {
+			// Alternate creation and release, so lookups race with insertions and removals.
+			results.write[i] = (it & 1) ? StringName() : StringName(data->strings[i]);
+		}
+	}
+	for (int i = 0; i < data->names; i++) {
+		results.write[i] = StringName(data->strings[i]);
+	}
+}
+
+TEST_CASE("[StringName] Concurrent creation") {
+	const int thread_count = 8;
+	ConcurrentData data;
+	data.names = 2000;
+	data.iterations = 8;
+	for (int i = 0; i < data.names; i++) {
+		data.strings.push_back("test_string_name_concurrent_" + itos(i));
+	}
+
+	Thread threads[thread_count];
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].start(concurrent_create, &data);
+	}
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].wait_to_finish();
+	}
+
+	// Every thread must have ended up with the same interned data for each name.
+	int mismatches = 0;
+	for (int i = 0; i < data.names; i++) {
+		const void *expected = data.results[0][i].data_unique_pointer();
+		for (int t = 1; t < thread_count; t++) {
+			if (data.results[t][i].data_unique_pointer() != expected) {
+				mismatches++;
+			}
+		}
+		if (StringName::search(data.strings[i]).data_unique_pointer() != expected) {
+			mismatches++;
+		}
+	}
+	CHECK(mismatches == 0);
+}
+
+static void benchmark_create(void *p_userdata) {
+	ConcurrentData *data = (ConcurrentData *)p_userdata;
+	data->index.increment();
+	for (int it = 0; it < data->iterations; it++) {
+		for (int i = 0; i < data->names; i++) {
+			StringName name(data->strings[i]);
+			StringName::search(data->strings[(i * 7) % data->names]);
+		}
+	}
+}
+
+TEST_CASE_BENCHMARK("[StringName][Benchmark] Concurrent creation and lookup") {
+	ConcurrentData data;
+	data.names = 10000;
+	data.iterations = 20;
+	for (int i = 0; i < data.names; i++) {
+		data.strings.push_back("test_string_name_benchmark_" + itos(i));
+	}
+
+	// Keep half of the names alive, so the benchmark mixes lookups of existing names with creations and releases.
+	Vector<StringName> kept;
+	for (int i = 0; i < data.names; i += 2) {
+		kept.push_back(data.strings[i]);
+	}
+
+	for (int thread_count = 1; thread_count <= 8; thread_count *= 2) {
+		data.index.set(0);
+		Thread threads[8];
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < thread_count; i++) {
+			threads[i].start(benchmark_create, &data);
+		}
+		for (int i = 0; i < thread_count; i++) {
+			threads[i].wait_to_finish();
+		}
+		uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+		uint64_t operations = (uint64_t)thread_count * data.iterations * data.names * 2;
+		MESSAGE(thread_count, " threads: ", operations * 1000000 / elapsed, " operations/s");
+		CHECK(data.index.get() == (uint32_t)thread_count);
+	}
+}
+
+} // namespace TestStringName
+
+#endif // TEST_STRING_NAME_H
@@ -0,0 +1,176 @@
+/**************************************************************************/
+/*  test_small_vector.h                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SMALL_VECTOR_H
+#define TEST_SMALL_VECTOR_H
+
+#include "core/math/vector3.h"
+#include "core/os/os.h"
+#include "core/templates/small_vector.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSmallVector {
+
+TEST_CASE("[SmallVector] Push back and access") {
+	SmallVector<int, 4> vector;
+	CHECK(vector.is_empty());
+
+	for (int i = 0; i < 10; i++) {
+		vector.push_back(i * 2);
+		CHECK(vector.is_inline() == (i < 4));
+	}
+
+	CHECK(vector.size() == 10);
+	for (int i = 0; i < 10; i++) {
+		CHECK(vector[i] == i * 2);
+	}
+	CHECK(vector.find(8) == 4);
+	CHECK(vector.has(18));
+	CHECK(!vector.has(19));
+}
+
+TEST_CASE("[SmallVector] Remove, erase and resize") {
+	SmallVector<String, 3> vector{ "a", "b", "c" };
+	CHECK(vector.is_inline());
+
+	CHECK(vector.erase("b"));
+	CHECK(!vector.erase("b"));
+	CHECK(vector.size() == 2);
+	CHECK(vector[0] == "a");
+	CHECK(vector[1] == "c");
+
+	vector.resize(5);
+	CHECK(!vector.is_inline());
+	CHECK(vector[0] == "a");
+	CHECK(vector[1] == "c");
+	CHECK(vector[4].is_empty());
+
+	vector.remove_at(0);
+	CHECK(vector[0] == "c");
+
+	// Clearing goes back to the inline storage.
+	vector.clear();
+	CHECK(vector.is_empty());
+	CHECK(vector.is_inline());
+	vector.push_back("d");
+	CHECK(vector.is_inline());
+	CHECK(vector[0] == "d");
+}
+
+TEST_CASE("[SmallVector] Conversion and iteration") {
+	SmallVector<Vector3, 4> vector;
+	vector.push_back(Vector3(1, 2, 3));
+	vector.push_back(Vector3(4, 5, 6));
+
+	Vector<Vector3> converted = vector;
+	CHECK(converted.size() == 2);
+	CHECK(converted[1] == Vector3(4, 5, 6));
+
+	SmallVector<Vector3, 4> back = converted;
+	CHECK(back.is_inline());
+
+	int count = 0;
+	for (const Vector3 &v : back) {
+		CHECK(v == converted[count]);
+		count++;
+	}
+	CHECK(count == 2);
+}
+
+TEST_CASE("[SmallVector] Allocation count") {
+	const uint64_t base = Memory::get_alloc_count();
+
+	SmallVector<Vector3, 4> vector;
+	for (int i = 0; i < 4; i++) {
+		vector.push_back(Vector3(i, i, i));
+	}
+	SmallVector<Vector3, 4> copy = vector;
+	copy.ptrw()[0] = Vector3();
+	CHECK_MESSAGE(Memory::get_alloc_count() == base, "Short arrays must not allocate.");
+
+	// Past the inline capacity, elements move to a single shared heap buffer.
+	vector.push_back(Vector3(4, 4, 4));
+	CHECK(Memory::get_alloc_count() == base + 1);
+
+	SmallVector<Vector3, 4> shared = vector;
+	Vector<Vector3> converted = vector;
+	CHECK_MESSAGE(Memory::get_alloc_count() == base + 1, "Copies of long arrays must share their buffer.");
+
+	// Writing to a copy makes it unique.
+	shared.set(0, Vector3(9, 9, 9));
+	CHECK(Memory::get_alloc_count() == base + 2);
+	CHECK(vector.get(0) == Vector3());
+	CHECK(converted[0] == Vector3());
+	CHECK(shared.get(0) == Vector3(9, 9, 9));
+
+	// For comparison, a Vector allocates for a single element.
+	Vector<Vector3> regular;
+	regular.push_back(Vector3());
+	CHECK(Memory::get_alloc_count() == base + 3);
+}
+
+TEST_CASE_BENCHMARK("[SmallVector][Benchmark] Short arrays against Vector") {
+	// Mimics the short arrays built while loading meshes and shapes: faces with 3 or 4 vertices, copied once.
+	const int faces = 200000;
+
+	for (int pass = 0; pass < 2; pass++) {
+		real_t sum = 0;
+		uint64_t allocations = Memory::get_alloc_count();
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < faces; i++) {
+			const int vertex_count = 3 + (i & 1);
+			if (pass == 0) {
+				Vector<Vector3> face;
+				for (int j = 0; j < vertex_count; j++) {
+					face.push_back(Vector3(i, j, 0));
+				}
+				Vector<Vector3> copy = face;
+				sum += copy[vertex_count - 1].y;
+			} else {
+				SmallVector<Vector3, 4> face;
+				for (int j = 0; j < vertex_count; j++) {
+					face.push_back(Vector3(i, j, 0));
+				}
+				SmallVector<Vector3, 4> copy = face;
+				sum += copy[vertex_count - 1].y;
+			}
+		}
+		uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+		const char *name = pass == 0 ? "Vector" : "SmallVector";
+		MESSAGE(name, ": ", elapsed, " usec, ", (uint64_t)faces * 1000000 / elapsed, " faces/s (", sum, ")");
+		CHECK(Memory::get_alloc_count() == allocations);
+	}
+}
+
+} // namespace TestSmallVector
+
+#endif // TEST_SMALL_VECTOR_H
@@ -0,0 +1,334 @@
+/**************************************************************************/
+/*  test_swiss_hash_map.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SWISS_HASH_MAP_H
+#define TEST_SWISS_HASH_MAP_H
+
+#include "core/os/os.h"
+#include "core/templates/a_hash_map.h"
+#include "core/templates/oa_hash_map.h"
+#include "core/templates/swiss_hash_map.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSwissHashMap {
+
+TEST_CASE("[SwissHashMap] Insert element") {
+	SwissHashMap<int, int> map;
+	SwissHashMap<int, int>::Iterator e = map.insert(42, 84);
+
+	CHECK(e);
+	CHECK(e->key == 42);
+	CHECK(e->value == 84);
+	CHECK(map[42] == 84);
+	CHECK(map.has(42));
+	CHECK(map.find(42));
+}
+
+TEST_CASE("[SwissHashMap] Overwrite element") {
+	SwissHashMap<int, int> map;
+	map.insert(42, 84);
+	map.insert(42, 1234);
+
+	CHECK(map[42] == 1234);
+	CHECK(map.size() == 1);
+}
+
+TEST_CASE("[SwissHashMap] Erase via element") {
+	SwissHashMap<int, int> map;
+	SwissHashMap<int, int>::Iterator e = map.insert(42, 84);
+	map.remove(e);
+	CHECK(!map.has(42));
+	CHECK(!map.find(42));
+}
+
+TEST_CASE("[SwissHashMap] Erase via key") {
+	SwissHashMap<int, int> map;
+	map.insert(42, 84);
+	CHECK(map.erase(42));
+	CHECK(!map.erase(42));
+	CHECK(!map.has(42));
+	CHECK(!map.find(42));
+	CHECK(map.is_empty());
+}
+
+TEST_CASE("[SwissHashMap] Size") {
+	SwissHashMap<int, int> map;
+	map.insert(42, 84);
+	map.insert(123, 84);
+	map.insert(123, 84);
+	map.insert(0, 84);
+	map.insert(123485, 84);
+
+	CHECK(map.size() == 4);
+}
+
+TEST_CASE("[SwissHashMap] Iteration keeps the insertion order") {
+	SwissHashMap<int, int> map;
+	map.insert(42, 84);
+	map.insert(123, 12385);
+	map.insert(0, 12934);
+	map.insert(123485, 1238888);
+	map.insert(123, 111111);
+	map.insert(7, 1);
+	map.erase(0);
+	map.insert(-1, 2, true);
+
+	Vector<Pair<int, int>> expected;
+	expected.push_back(Pair<int, int>(-1, 2));
+	expected.push_back(Pair<int, int>(42, 84));
+	expected.push_back(Pair<int, int>(123, 111111));
+	expected.push_back(Pair<int, int>(123485, 1238888));
+	expected.push_back(Pair<int, int>(7, 1));
+
+	int idx = 0;
+	for (const KeyValue<int, int> &E : map) {
+		CHECK(expected[idx] == Pair<int, int>(E.key, E.value));
+		++idx;
+	}
+	CHECK(idx == expected.size());
+
+	const SwissHashMap<int, int> const_map = map;
+	idx = 0;
+	for (const KeyValue<int, int> &E : const_map) {
+		CHECK(expected[idx] == Pair<int, int>(E.key, E.value));
+		++idx;
+	}
+	CHECK(idx == expected.size());
+}
+
+TEST_CASE("[SwissHashMap] Growth, erasure and reinsertion") {
+	SwissHashMap<int, int> map;
+	const int count = 10000;
+	for (int i = 0; i < count; i++) {
+		map.insert(i, i * 2);
+	}
+	CHECK(map.size() == (uint32_t)count);
+
+	// Pointers to values stay valid when the table grows.
+	int *value = map.getptr(5);
+	for (int i = count; i < count * 2; i++) {
+		map.insert(i, i * 2);
+	}
+	CHECK(value == map.getptr(5));
+
+	for (int i = 0; i < count * 2; i += 2) {
+		CHECK(map.erase(i));
+	}
+	CHECK(map.size() == (uint32_t)count);
+
+	bool all_found = true;
+	for (int i = 0; i < count * 2; i++) {
+		const int *v = map.getptr(i);
+		if (i % 2 == 0) {
+			all_found = all_found && v == nullptr;
+		} else {
+			all_found = all_found && v != nullptr && *v == i * 2;
+		}
+	}
+	CHECK(all_found);
+
+	// Churn through tombstones without growing the table.
+	const uint32_t capacity = map.get_capacity();
+	for (int round = 0; round < 8; round++) {
+		for (int i = 0; i < count * 2; i += 2) {
+			map.insert(i, round);
+		}
+		for (int i = 0; i < count * 2; i += 2) {
+			map.erase(i);
+		}
+	}
+	CHECK(map.get_capacity() == capacity);
+	CHECK(map.size() == (uint32_t)count);
+
+	int previous = -1;
+	bool ordered = true;
+	for (const KeyValue<int, int> &E : map) {
+		ordered = ordered && E.key > previous;
+		previous = E.key;
+	}
+	CHECK(ordered);
+
+	map.clear();
+	CHECK(map.is_empty());
+	CHECK(!map.has(1));
+}
+
+TEST_CASE("[SwissHashMap] String keys and replace_key") {
+	SwissHashMap<String, int> map;
+	for (int i = 0; i < 100; i++) {
+		map["key_" + itos(i)] = i;
+	}
+
+	CHECK(map.replace_key("key_10", "renamed"));
+	CHECK(!map.has("key_10"));
+	CHECK(map["renamed"] == 10);
+	CHECK(map.size() == 100);
+
+	// The renamed entry keeps its position.
+	int idx = 0;
+	for (const KeyValue<String, int> &E : map) {
+		if (idx == 10) {
+			CHECK(E.key == "renamed");
+		}
+		idx++;
+	}
+
+	SwissHashMap<String, int> copy;
+	copy = map;
+	CHECK(copy.size() == map.size());
+	CHECK(copy.get("key_99") == 99);
+}
+
+// Small maps are rebuilt several times so every size does about the same amount of work, the
+// results are given per key.
+template <typename TMap>
+static void benchmark_map(const char *p_name, const Vector<int> &p_keys, int p_repeats) {
+	const int count = p_keys.size();
+	uint64_t insert_usec = 0;
+	uint64_t lookup_usec = 0;
+	uint64_t iterate_usec = 0;
+	uint64_t erase_usec = 0;
+	int64_t sum = 0;
+
+	for (int repeat = 0; repeat < p_repeats; repeat++) {
+		TMap map;
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < count; i++) {
+			map.insert(p_keys[i], i);
+		}
+		insert_usec += OS::get_singleton()->get_ticks_usec() - begin;
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (int round = 0; round < 4; round++) {
+			for (int i = 0; i < count; i++) {
+				const int *value = map.getptr(p_keys[i]);
+				sum += value ? *value : 0;
+				// Misses.
+				sum += map.getptr(~p_keys[i]) ? 1 : 0;
+			}
+		}
+		lookup_usec += OS::get_singleton()->get_ticks_usec() - begin;
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (int round = 0; round < 4; round++) {
+			for (const KeyValue<int, int> &E : map) {
+				sum += E.value;
+			}
+		}
+		iterate_usec += OS::get_singleton()->get_ticks_usec() - begin;
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < count; i++) {
+			map.erase(p_keys[i]);
+		}
+		erase_usec += OS::get_singleton()->get_ticks_usec() - begin;
+
+		CHECK(map.is_empty());
+	}
+
+	const double keys = (double)count * p_repeats / 1000.0;
+	MESSAGE(p_name, ": insert ", insert_usec / keys, " ns, lookup ", lookup_usec / keys, " ns, iterate ", iterate_usec / keys, " ns, erase ", erase_usec / keys, " ns per key (", sum, ")");
+}
+
+static void benchmark_oa_map(const Vector<int> &p_keys, int p_repeats) {
+	const int count = p_keys.size();
+	uint64_t insert_usec = 0;
+	uint64_t lookup_usec = 0;
+	uint64_t iterate_usec = 0;
+	uint64_t erase_usec = 0;
+	int64_t sum = 0;
+
+	for (int repeat = 0; repeat < p_repeats; repeat++) {
+		OAHashMap<int, int> map;
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < count; i++) {
+			map.insert(p_keys[i], i);
+		}
+		insert_usec += OS::get_singleton()->get_ticks_usec() - begin;
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (int round = 0; round < 4; round++) {
+			for (int i = 0; i < count; i++) {
+				const int *value = map.lookup_ptr(p_keys[i]);
+				sum += value ? *value : 0;
+				// Misses.
+				sum += map.lookup_ptr(~p_keys[i]) ? 1 : 0;
+			}
+		}
+		lookup_usec += OS::get_singleton()->get_ticks_usec() - begin;
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (int round = 0; round < 4; round++) {
+			for (OAHashMap<int, int>::Iterator it = map.iter(); it.valid; it = map.next_iter(it)) {
+				sum += *it.value;
+			}
+		}
+		iterate_usec += OS::get_singleton()->get_ticks_usec() - begin;
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < count; i++) {
+			map.remove(p_keys[i]);
+		}
+		erase_usec += OS::get_singleton()->get_ticks_usec() - begin;
+
+		CHECK(map.is_empty());
+	}
+
+	const double keys = (double)count * p_repeats / 1000.0;
+	MESSAGE("OAHashMap: insert ", insert_usec / keys, " ns, lookup ", lookup_usec / keys, " ns, iterate ", iterate_usec / keys, " ns, erase ", erase_usec / keys, " ns per key (", sum, ")");
+}
+
+TEST_CASE_BENCHMARK("[SwissHashMap][Benchmark] Against the other hash maps") {
+	// From fitting in L1 to far larger than the last level cache.
+	const int sizes[] = { 8, 1000, 100000, 10000000 };
+	for (const int count : sizes) {
+		Vector<int> keys;
+		keys.resize(count);
+		for (int i = 0; i < count; i++) {
+			// Scattered keys, with the sign bit clear so the missed lookups never hit.
+			keys.write[i] = (int)(hash_murmur3_one_32(i) & 0x7FFFFFFF);
+		}
+		const int repeats = MAX(10000000 / count, 1);
+
+		MESSAGE(count, " keys:");
+		benchmark_map<HashMap<int, int>>("HashMap", keys, repeats);
+		benchmark_map<AHashMap<int, int>>("AHashMap", keys, repeats);
+		benchmark_map<SwissHashMap<int, int>>("SwissHashMap", keys, repeats);
+		benchmark_oa_map(keys, repeats);
+	}
+}
+
+} // namespace TestSwissHashMap
+
+#endif // TEST_SWISS_HASH_MAP_H
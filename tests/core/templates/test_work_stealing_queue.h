@@ -0,0 +1,159 @@
+/**************************************************************************/
+/*  test_work_stealing_queue.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             BRADOT ENGINE                              */
+/*                        https://bradotengine.org                        */
+/**************************************************************************/
+/* Copyright (c) 2024-present Bradot Engine contributors (see AUTHORS.md).*/
+/* Copyright (c) 2014-2024 Godot Engine contributors (see AUTHORS.md).    */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_WORK_STEALING_QUEUE_H
+#define TEST_WORK_STEALING_QUEUE_H
+
+#include "core/os/thread.h"
+#include "core/templates/work_stealing_queue.h"
+
+#include "tests/test_macros.h"
+
+namespace TestWorkStealingQueue {
+
+TEST_CASE("[WorkStealingQueue] Owner pops LIFO, thieves steal FIFO") {
+	WorkStealingQueue<int, 8> *queue = memnew((WorkStealingQueue<int, 8>));
+	int value = 0;
+
+	CHECK(queue->is_empty());
+	CHECK_FALSE(queue->pop(value));
+	CHECK(queue->steal(value) == WorkStealingQueue<int, 8>::STEAL_EMPTY);
+
+	for (int i = 1; i <= 4; i++) {
+		CHECK(queue->push(i));
+	}
+	CHECK_FALSE(queue->is_empty());
+
+	CHECK(queue->pop(value));
+	CHECK(value == 4);
+	CHECK(queue->steal(value) == WorkStealingQueue<int, 8>::STEAL_OK);
+	CHECK(value == 1);
+	CHECK(queue->pop(value));
+	CHECK(value == 3);
+	CHECK(queue->steal(value) == WorkStealingQueue<int, 8>::STEAL_OK);
+	CHECK(value == 2);
+
+	CHECK(queue->is_empty());
+	CHECK_FALSE(queue->pop(value));
+
+	memdelete(queue);
+}
+
+TEST_CASE("[WorkStealingQueue] Push fails when full") {
+	WorkStealingQueue<int, 4> *queue = memnew((WorkStealingQueue<int, 4>));
+
+	for (int i = 0; i < 4; i++) {
+		CHECK(queue->push(i));
+	}
+	CHECK_FALSE(queue->push(4));
+
+	int value = 0;
+	CHECK(queue->steal(value) == WorkStealingQueue<int, 4>::STEAL_OK);
+	CHECK(value == 0);
+	CHECK(queue->push(4)); // Wraps around.
+
+	for (int i = 4; i >= 1; i--) {
+		CHECK(queue->pop(value));
+		CHECK(value == i);
+	}
+
+	memdelete(queue);
+}
+
+struct StealState {
+	WorkStealingQueue<int64_t, 64> queue;
+	SafeNumeric<int64_t> sum;
+	SafeNumeric<int64_t> count;
+	SafeFlag done;
+};
+
+static void thief_function(void *p_userdata) {
+	StealState *state = (StealState *)p_userdata;
+	while (true) {
+		bool done = state->done.is_set();
+		int64_t value = 0;
+		WorkStealingQueue<int64_t, 64>::StealResult result = state->queue.steal(value);
+		if (result == WorkStealingQueue<int64_t, 64>::STEAL_OK) {
+			state->sum.add(value);
+			state->count.increment();
+		} else if (result == WorkStealingQueue<int64_t, 64>::STEAL_EMPTY && done) {
+			break;
+		}
+	}
+}
+
+TEST_CASE("[WorkStealingQueue] Every element is taken exactly once under concurrent stealing") {
+	StealState *state = memnew(StealState);
+	const int64_t element_count = 100000;
+
+	Thread thieves[3];
+	for (Thread &thief : thieves) {
+		thief.start(thief_function, state);
+	}
+
+	int64_t expected_sum = 0;
+	for (int64_t i = 1; i <= element_count; i++) {
+		expected_sum += i;
+		while (!state->queue.push(i)) {
+			int64_t value = 0;
+			if (state->queue.pop(value)) {
+				state->sum.add(value);
+				state->count.increment();
+			}
+		}
+		if (i % 3 == 0) {
+			int64_t value = 0;
+			if (state->queue.pop(value)) {
+				state->sum.add(value);
+				state->count.increment();
+			}
+		}
+	}
+	int64_t value = 0;
+	while (state->queue.pop(value)) {
+		state->sum.add(value);
+		state->count.increment();
+	}
+
+	state->done.set();
+	for (Thread &thief : thieves) {
+		thief.wait_to_finish();
+	}
+
+	CHECK(state->count.get() == element_count);
+	CHECK(state->sum.get() == expected_sum);
+
+	memdelete(state);
+}
+
+} // namespace TestWorkStealingQueue
+
+#endif // TEST_WORK_STEALING_QUEUE_H
@@ -174,6 +174,194 @@ TEST_CASE("[WorkerThreadPool] Run a yielding daemon as the only hope for other t
 	CHECK_MESSAGE(all_needed_yield, "All legit tasks should have needed the daemon yielding to run.");
 }
 
+struct NestedTaskData {
+	LocalVector<SafeNumeric<int>> *counters = nullptr;
+	uint32_t first = 0;
+	uint32_t count = 0;
+};
+
+static void static_nested_leaf_test(void *p_arg) {
+	NestedTaskData *data = (NestedTaskData *)p_arg;
+	for (uint32_t i = data->first; i < data->first + data->count; i++) {
+		(*data->counters)[i].increment();
+	}
+}
+
+static void static_nested_spawner_test(void *p_arg) {
+	// Tasks posted from a pool thread go to its local queue, where other threads can steal them.
+	NestedTaskData *data = (NestedTaskData *)p_arg;
+	const uint32_t leaves = 8;
+	NestedTaskData leaf_data[leaves];
+	WorkerThreadPool::TaskID leaf_tasks[leaves];
+	for (uint32_t i = 0; i < leaves; i++) {
+		leaf_data[i].counters = data->counters;
+		leaf_data[i].first = data->first + i * (data->count / leaves);
+		leaf_data[i].count = data->count / leaves;
+		leaf_tasks[i] = WorkerThreadPool::get_singleton()->add_native_task(static_nested_leaf_test, &leaf_data[i], true);
+	}
+	for (uint32_t i = 0; i < leaves; i++) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(leaf_tasks[i]);
+	}
+}
+
+TEST_CASE("[WorkerThreadPool] Process tasks posted from within pool threads") {
+	const uint32_t spawners = 16;
+	const uint32_t elements_per_spawner = 64;
+
+	LocalVector<SafeNumeric<int>> counters;
+	counters.resize(spawners * elements_per_spawner);
+	for (uint32_t i = 0; i < counters.size(); i++) {
+		counters[i].set(0);
+	}
+
+	for (int iterations = 0; iterations < 50; iterations++) {
+		NestedTaskData spawner_data[spawners];
+		WorkerThreadPool::TaskID spawner_tasks[spawners];
+		for (uint32_t i = 0; i < spawners; i++) {
+			spawner_data[i].counters = &counters;
+			spawner_data[i].first = i * elements_per_spawner;
+			spawner_data[i].count = elements_per_spawner;
+			spawner_tasks[i] = WorkerThreadPool::get_singleton()->add_native_task(static_nested_spawner_test, &spawner_data[i], true);
+		}
+		for (uint32_t i = 0; i < spawners; i++) {
+			WorkerThreadPool::get_singleton()->wait_for_task_completion(spawner_tasks[i]);
+		}
+	}
+
+	bool all_run = true;
+	for (uint32_t i = 0; i < counters.size(); i++) {
+		all_run &= counters[i].get() == 50;
+	}
+	CHECK(all_run);
+}
+
+struct DependencyChainData {
+	SafeNumeric<uint32_t> phase1_done;
+	SafeNumeric<uint32_t> phase2_done;
+	SafeFlag phase3_ran;
+	SafeFlag order_ok;
+	uint32_t elements = 0;
+};
+
+static void static_dependency_phase1(void *p_arg, uint32_t p_index) {
+	((DependencyChainData *)p_arg)->phase1_done.increment();
+}
+
+static void static_dependency_phase2(void *p_arg, uint32_t p_index) {
+	DependencyChainData *data = (DependencyChainData *)p_arg;
+	if (data->phase1_done.get() != data->elements) {
+		data->order_ok.clear();
+	}
+	data->phase2_done.increment();
+}
+
+static void static_dependency_phase3(void *p_arg) {
+	DependencyChainData *data = (DependencyChainData *)p_arg;
+	if (data->phase1_done.get() != data->elements || data->phase2_done.get() != data->elements) {
+		data->order_ok.clear();
+	}
+	data->phase3_ran.set();
+}
+
+TEST_CASE("[WorkerThreadPool] Dependent tasks and groups run after their dependencies") {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+
+	for (int iterations = 0; iterations < 200; iterations++) {
+		DependencyChainData data;
+		data.elements = 1 + Math::rand() % 64;
+		data.order_ok.set();
+
+		WorkerThreadPool::GroupID phase1 = pool->add_native_group_task(static_dependency_phase1, &data, data.elements);
+		WorkerThreadPool::GroupID phase2 = pool->add_native_group_task_after({ phase1 }, static_dependency_phase2, &data, data.elements);
+		WorkerThreadPool::TaskID phase3 = pool->add_native_task_after({ phase1, phase2 }, static_dependency_phase3, &data);
+
+		pool->wait_for_task_completion(phase3);
+		CHECK(pool->is_group_task_completed(phase1));
+		CHECK(pool->is_group_task_completed(phase2));
+		pool->wait_for_group_task_completion(phase2);
+		pool->wait_for_group_task_completion(phase1);
+
+		CHECK(data.phase3_ran.is_set());
+		CHECK(data.order_ok.is_set());
+	}
+}
+
+TEST_CASE("[WorkerThreadPool] Dependencies that have already completed don't delay the dependent") {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+
+	DependencyChainData data;
+	data.elements = 4;
+	data.order_ok.set();
+
+	WorkerThreadPool::GroupID phase1 = pool->add_native_group_task(static_dependency_phase1, &data, data.elements);
+	while (!pool->is_group_task_completed(phase1)) {
+		OS::get_singleton()->delay_usec(1);
+	}
+	WorkerThreadPool::GroupID phase2 = pool->add_native_group_task_after({ phase1 }, static_dependency_phase2, &data, data.elements);
+	pool->wait_for_group_task_completion(phase2);
+	pool->wait_for_group_task_completion(phase1);
+
+	CHECK(data.phase2_done.get() == data.elements);
+	CHECK(data.order_ok.is_set());
+}
+
+static void static_benchmark_group_element(void *p_arg, uint32_t p_index) {
+	((SafeNumeric<uint64_t> *)p_arg)->increment();
+}
+
+static void static_benchmark_leaf(void *p_arg) {
+	((SafeNumeric<uint64_t> *)p_arg)->increment();
+}
+
+static void static_benchmark_spawner(void *p_arg) {
+	const uint32_t leaves = 256;
+	WorkerThreadPool::TaskID leaf_tasks[leaves];
+	for (uint32_t i = 0; i < leaves; i++) {
+		leaf_tasks[i] = WorkerThreadPool::get_singleton()->add_native_task(static_benchmark_leaf, p_arg, true);
+	}
+	for (uint32_t i = 0; i < leaves; i++) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(leaf_tasks[i]);
+	}
+}
+
+TEST_CASE_BENCHMARK("[WorkerThreadPool][Benchmark] Contention scaling with the number of threads") {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	const int thread_count = pool->get_thread_count();
+	SafeNumeric<uint64_t> processed;
+
+	MESSAGE("Worker threads: ", thread_count);
+
+	// Tiny elements, so the cost is dominated by scheduling. The number of tasks limits the concurrency.
+	for (int tasks = 1; tasks <= thread_count; tasks *= 2) {
+		const int elements = 1 << 20;
+		processed.set(0);
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < 16; i++) {
+			WorkerThreadPool::GroupID group = pool->add_native_group_task(static_benchmark_group_element, &processed, elements / 16, tasks, true);
+			pool->wait_for_group_task_completion(group);
+		}
+		uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+		MESSAGE("Group tasks, ", tasks, " concurrent: ", processed.get() * 1000000 / elapsed, " elements/s");
+		CHECK(processed.get() == (uint64_t)elements);
+	}
+
+	// Many small tasks posted from pool threads, so they go through the local queues and get stolen.
+	for (int spawners = 1; spawners <= thread_count; spawners *= 2) {
+		processed.set(0);
+		LocalVector<WorkerThreadPool::TaskID> spawner_tasks;
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < spawners * 16; i++) {
+			spawner_tasks.push_back(pool->add_native_task(static_benchmark_spawner, &processed, true));
+		}
+		for (uint32_t i = 0; i < spawner_tasks.size(); i++) {
+			pool->wait_for_task_completion(spawner_tasks[i]);
+		}
+		uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+		MESSAGE("Nested native tasks, ", spawners, " spawners: ", processed.get() * 1000000 / elapsed, " tasks/s");
+		CHECK(processed.get() == (uint64_t)spawners * 16 * 256);
+	}
+}
+
 } // namespace TestWorkerThreadPool
 
 #endif // TEST_WORKER_THREAD_POOL_H
@@ -32,7 +32,9 @@
 #ifndef TEST_VARIANT_H
 #define TEST_VARIANT_H
 
+#include "core/os/os.h"
 #include "core/variant/variant.h"
+#include "core/variant/variant_internal.h"
 #include "core/variant/variant_parser.h"
 
 #include "tests/test_macros.h"
@@ -2217,6 +2219,77 @@ TEST_CASE("[Variant] Operator NOT") {
 	}
 }
 
+TEST_CASE("[Variant] Validated built-in methods for argument types") {
+	const Variant::Type int_int[] = { Variant::INT, Variant::INT };
+	const Variant::Type int_float[] = { Variant::INT, Variant::FLOAT };
+	const Variant::Type unknown_int[] = { Variant::NIL, Variant::INT };
+
+	Variant::ValidatedBuiltInMethod substr = Variant::get_validated_builtin_method_for_arguments(Variant::STRING, "substr", int_int, 2);
+	CHECK(substr == Variant::get_validated_builtin_method(Variant::STRING, "substr"));
+	CHECK(Variant::get_validated_builtin_method_for_arguments(Variant::STRING, "substr", int_float, 2) == nullptr);
+	CHECK(Variant::get_validated_builtin_method_for_arguments(Variant::STRING, "substr", unknown_int, 2) == nullptr);
+	// Default arguments are not filled in by validated calls.
+	CHECK(Variant::get_validated_builtin_method_for_arguments(Variant::STRING, "substr", int_int, 1) == nullptr);
+	// Vararg methods check their arguments themselves.
+	CHECK(Variant::get_validated_builtin_method_for_arguments(Variant::CALLABLE, "call", int_int, 2) == nullptr);
+
+	Variant text = "Hello world";
+	Variant from = 6;
+	Variant length = 5;
+	const Variant *args[] = { &from, &length };
+	Variant ret;
+	VariantInternal::initialize(&ret, Variant::get_builtin_method_return_type(Variant::STRING, "substr"));
+	substr(&text, args, 2, &ret);
+	CHECK(ret == Variant("world"));
+}
+
+TEST_CASE_BENCHMARK("[Variant][Benchmark] Validated built-in method calls") {
+	struct Case {
+		Variant base;
+		StringName method;
+		Vector<Variant> arguments;
+	};
+	const Case cases[] = {
+		{ "Hello world", "length", {} },
+		{ "Hello world", "substr", { 6, 5 } },
+		{ Vector3(1, 2, 3), "dot", { Vector3(4, 5, 6) } },
+		{ Vector3(1, 2, 3), "normalized", {} },
+		{ build_array(1, 2, 3), "size", {} },
+		{ "Hello world", "begins_with", { "Hello" } },
+	};
+	const int iterations = 1000000;
+
+	for (const Case &c : cases) {
+		LocalVector<const Variant *> args;
+		LocalVector<Variant::Type> types;
+		for (const Variant &arg : c.arguments) {
+			args.push_back(&arg);
+			types.push_back(arg.get_type());
+		}
+		Variant base = c.base;
+		Variant ret;
+		Callable::CallError ce;
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < iterations; i++) {
+			base.callp(c.method, args.ptr(), args.size(), ret, ce);
+		}
+		uint64_t callp_usec = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+
+		Variant::ValidatedBuiltInMethod method = Variant::get_validated_builtin_method_for_arguments(base.get_type(), c.method, types.ptr(), types.size());
+		REQUIRE(method != nullptr);
+		const Variant::Type return_type = Variant::get_builtin_method_return_type(base.get_type(), c.method);
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < iterations; i++) {
+			VariantInternal::initialize(&ret, return_type);
+			method(&base, args.ptr(), args.size(), &ret);
+		}
+		uint64_t validated_usec = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+
+		MESSAGE(Variant::get_type_name(base.get_type()), ".", c.method, ": callp ", (uint64_t)iterations * 1000 / callp_usec, " calls/ms, validated ", (uint64_t)iterations * 1000 / validated_usec, " calls/ms");
+	}
+}
+
 } // namespace TestVariant
 
 #endif // TEST_VARIANT_H
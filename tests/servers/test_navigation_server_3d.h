@@ -817,6 +817,28 @@ TEST_SUITE("[Navigation]") {
 	}
 	*/
 
+	TEST_CASE("[NavigationServer3D] Polygons are built and copied without allocating") {
+		const uint64_t allocations = Memory::get_alloc_count();
+
+		gd::Polygon polygon;
+		polygon.points.resize(gd::Polygon::INLINE_POINTS);
+		polygon.edges.resize(gd::Polygon::INLINE_POINTS);
+		for (uint32_t i = 0; i < gd::Polygon::INLINE_POINTS; i++) {
+			polygon.points[i].pos = Vector3(i, 0, i % 2);
+		}
+
+		// The map copies every region polygon when it syncs.
+		gd::Polygon copy = polygon;
+		CHECK(copy.points[3].pos == Vector3(3, 0, 1));
+		CHECK(copy.edges.size() == gd::Polygon::INLINE_POINTS);
+		CHECK(Memory::get_alloc_count() == allocations);
+
+		// Larger polygons still work, they just allocate.
+		polygon.points.push_back(gd::Point());
+		CHECK(polygon.points.size() == gd::Polygon::INLINE_POINTS + 1);
+		CHECK(copy.points.size() == gd::Polygon::INLINE_POINTS);
+	}
+
 	TEST_CASE("[Heap] size") {
 		gd::Heap<int> heap;
 